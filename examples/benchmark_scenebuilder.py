@@ -0,0 +1,45 @@
+""" Compare the construction time of a scene of one million shapes.
+
+    - add      : one Scene.add call per shape (one lock per shape)
+    - list     : Scene(list), filled by a SceneBuilder and published with a single lock
+    - merge    : chunks of shapes built in temporary scenes and moved with Scene.mergeAndClear
+"""
+from openalea.plantgl.all import *
+from time import perf_counter
+
+def make_shapes(nbshapes):
+    geometry = Sphere(1)
+    material = Material()
+    return [Shape(geometry, material, i) for i in range(nbshapes)]
+
+def build_with_add(shapes):
+    scene = Scene()
+    for sh in shapes:
+        scene.add(sh)
+    return scene
+
+def build_from_list(shapes):
+    return Scene(shapes)
+
+def build_with_merge(shapes, chunksize = 10000):
+    scene = Scene()
+    for i in range(0, len(shapes), chunksize):
+        scene.mergeAndClear(Scene(shapes[i:i+chunksize]))
+    return scene
+
+modes = [('add', build_with_add), ('list', build_from_list), ('merge', build_with_merge)]
+
+def benchmark(nbshapes = 1000000, repeat = 3):
+    shapes = make_shapes(nbshapes)
+    for name, builder in modes:
+        timings = []
+        for i in range(repeat):
+            t = perf_counter()
+            scene = builder(shapes)
+            timings.append(perf_counter() - t)
+            assert len(scene) == nbshapes
+            del scene
+        print('{:>8} shapes {:>8} : {:.4f} sec.'.format(nbshapes, name, min(timings)))
+
+if __name__ == '__main__':
+    benchmark()
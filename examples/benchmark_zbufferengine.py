@@ -0,0 +1,55 @@
+""" Compare the rendering time of the different multithreading modes of ZBufferEngine.
+
+    - sequential : single threaded rendering
+    - locking    : multithreaded rendering with per pixel locking
+    - tiled      : multithreaded sort-middle rendering with triangles binned into screen tiles
+
+    Sequential and tiled modes are timed with and without the vectorized rasterization kernel.
+"""
+from openalea.plantgl.all import *
+from random import Random
+from time import perf_counter
+import numpy as np
+
+def random_canopy(nbleaves, seed = 0):
+    rnd = Random(seed)
+    shapes = []
+    for i in range(nbleaves):
+        pos = Vector3(rnd.uniform(-10,10),rnd.uniform(-10,10),rnd.uniform(0,5))
+        pts = [pos, pos+Vector3(rnd.uniform(-.5,.5),rnd.uniform(-.5,.5),rnd.uniform(-.5,.5)), pos+Vector3(rnd.uniform(-.5,.5),rnd.uniform(-.5,.5),rnd.uniform(-.5,.5))]
+        shapes.append(Shape(TriangleSet(pts, [list(range(3))]), id=i))
+    return Scene(shapes)
+
+def render(scene, multithreaded, tiled, simd = True, size = 800, style = eIdBased):
+    z = ZBufferEngine(size, size, renderingStyle=style)
+    z.setOrthographicCamera(-11, 11, -11, 11, 0, 100)
+    z.lookAt((0,0,50),(0,0,0),(0,1,0))
+    z.multithreaded = multithreaded
+    z.tiledrendering = tiled
+    z.simdrendering = simd
+    t = perf_counter()
+    z.process(scene)
+    return perf_counter() - t, z
+
+modes = [('sequential', False, False, False), ('sequential+simd', False, False, True), 
+         ('locking', True, False, False), ('tiled', True, True, False), ('tiled+simd', True, True, True)]
+
+def benchmark(nbleaves = [1000, 10000, 100000], repeat = 3):
+    for nb in nbleaves:
+        scene = random_canopy(nb)
+        ref = None
+        for name, mt, tiled, simd in modes:
+            timings = []
+            for i in range(repeat):
+                dt, z = render(scene, mt, tiled, simd)
+                timings.append(dt)
+            if ref is None: 
+                ref = z
+                identical = True
+            else:
+                identical = np.array_equal(z.getDepthBuffer().to_array(), ref.getDepthBuffer().to_array())
+            print('{:>8} triangles {:>16} : {:.4f} sec. (identical to sequential: {})'.format(nb, name, min(timings), identical))
+
+if __name__ == '__main__':
+    print('SIMD kernel :', getZBufferKernelName())
+    benchmark()
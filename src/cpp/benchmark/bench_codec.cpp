@@ -0,0 +1,155 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+/* ----------------------------------------------------------------------- */
+
+#include "pglbenchmark.h"
+#include "synthetic.h"
+#include <plantgl/algo/codec/binaryprinter.h>
+#include <plantgl/algo/codec/scne_binaryparser.h>
+#include <plantgl/algo/codec/cdc_ply.h>
+#include <plantgl/scenegraph/scene/shape.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+static ScenePtr makeMeshScene(size_t nbTriangles)
+{
+    ScenePtr scene(new Scene());
+    scene->add(Shape3DPtr(new Shape(GeometryPtr(makeGridMesh(nbTriangles)))));
+    return scene;
+}
+
+static int64_t fileSize(const std::string& fname)
+{
+    std::ifstream stream(fname.c_str(), std::ios::binary | std::ios::ate);
+    return int64_t(stream.tellg());
+}
+
+/* ----------------------------------------------------------------------- */
+
+/// Binary serialization in memory of a scene of primitives, the argument being the number of shapes.
+static void BM_BinaryString_RoundTrip(BenchmarkState& state)
+{
+    ScenePtr scene = makePrimitiveScene(size_t(state.range(0)));
+    size_t nbBytes = 0;
+    while (state.keepRunning()) {
+        std::string content = BinaryPrinter::tobinarystring(scene);
+        nbBytes = content.size();
+        doNotOptimize(BinaryParser::frombinarystring(content));
+    }
+    state.setItemsProcessed(int64_t(state.iterations()) * state.range(0));
+    state.setBytesProcessed(int64_t(state.iterations() * nbBytes));
+}
+PGL_BENCHMARK(BM_BinaryString_RoundTrip)->range(1000, 100000);
+
+/** Writing and reading back a bgeom file of a mesh, the argument being the number of triangles.
+    The second argument enables the compression of the arrays. */
+static void BM_BinaryFile_RoundTrip(BenchmarkState& state)
+{
+    const std::string fname("pglbenchmark.bgeom");
+    ScenePtr scene = makeMeshScene(size_t(state.range(0)));
+    bool compressed = state.range(1) != 0;
+    while (state.keepRunning()) {
+        BinaryPrinter::print(scene, fname, NULL, compressed);
+        std::ostringstream output;
+        BinaryParser parser(output);
+        parser.parse(fname);
+        doNotOptimize(parser.getScene());
+    }
+    state.setBytesProcessed(int64_t(state.iterations()) * fileSize(fname));
+    state.setItemsProcessed(int64_t(state.iterations()) * state.range(0));
+    std::remove(fname.c_str());
+}
+PGL_BENCHMARK(BM_BinaryFile_RoundTrip)->args({10000, 0})->args({1000000, 0})->args({1000000, 1});
+
+/// Reading a bgeom file of a mesh, the argument being the number of triangles.
+static void BM_BinaryFile_Read(BenchmarkState& state)
+{
+    const std::string fname("pglbenchmark.bgeom");
+    BinaryPrinter::print(makeMeshScene(size_t(state.range(0))), fname, NULL, state.range(1) != 0);
+    while (state.keepRunning()) {
+        std::ostringstream output;
+        BinaryParser parser(output);
+        parser.parse(fname);
+        doNotOptimize(parser.getScene());
+    }
+    state.setBytesProcessed(int64_t(state.iterations()) * fileSize(fname));
+    state.setItemsProcessed(int64_t(state.iterations()) * state.range(0));
+    std::remove(fname.c_str());
+}
+PGL_BENCHMARK(BM_BinaryFile_Read)->args({10000, 0})->args({1000000, 0})->args({1000000, 1});
+
+/* ----------------------------------------------------------------------- */
+
+/// Writing a binary PLY file of a mesh, the argument being the number of triangles.
+static void BM_PlyCodec_Write(BenchmarkState& state)
+{
+    const std::string fname("pglbenchmark.ply");
+    ScenePtr scene = makeMeshScene(size_t(state.range(0)));
+    PlyCodec codec;
+    while (state.keepRunning()) {
+        codec.write(fname, scene);
+    }
+    state.setBytesProcessed(int64_t(state.iterations()) * fileSize(fname));
+    state.setItemsProcessed(int64_t(state.iterations()) * state.range(0));
+    std::remove(fname.c_str());
+}
+PGL_BENCHMARK(BM_PlyCodec_Write)->range(10000, 1000000);
+
+/// Reading a binary PLY file of a mesh, the argument being the number of triangles.
+static void BM_PlyCodec_Read(BenchmarkState& state)
+{
+    const std::string fname("pglbenchmark.ply");
+    PlyCodec codec;
+    codec.write(fname, makeMeshScene(size_t(state.range(0))));
+    while (state.keepRunning()) {
+        doNotOptimize(codec.read(fname));
+    }
+    state.setBytesProcessed(int64_t(state.iterations()) * fileSize(fname));
+    state.setItemsProcessed(int64_t(state.iterations()) * state.range(0));
+    std::remove(fname.c_str());
+}
+PGL_BENCHMARK(BM_PlyCodec_Read)->range(10000, 1000000);
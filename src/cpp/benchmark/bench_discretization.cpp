@@ -0,0 +1,131 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+/* ----------------------------------------------------------------------- */
+
+#include "pglbenchmark.h"
+#include "synthetic.h"
+#include <plantgl/algo/base/tesselator.h>
+#include <plantgl/algo/base/discretizer.h>
+#include <plantgl/algo/base/bboxcomputer.h>
+#include <plantgl/scenegraph/geometry/explicitmodel.h>
+#include <plantgl/scenegraph/geometry/boundingbox.h>
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/// Triangulation of a primitive, the argument being its resolution.
+template<int Type>
+static void BM_Tesselator(BenchmarkState& state)
+{
+    GeometryPtr geometry = makePrimitive(eSyntheticPrimitive(Type), uchar_t(state.range(0)));
+    Tesselator tesselator;
+    size_t nbTriangles = 0;
+    while (state.keepRunning()) {
+        tesselator.clear();
+        geometry->apply(tesselator);
+        TriangleSetPtr triangles = tesselator.getTriangulation();
+        nbTriangles = triangles ? triangles->getIndexListSize() : 0;
+        doNotOptimize(triangles);
+    }
+    state.setItemsProcessed(int64_t(state.iterations() * nbTriangles));
+    state.setCounter("triangles", double(nbTriangles));
+}
+
+/// Discretization of a primitive, the argument being its resolution.
+template<int Type>
+static void BM_Discretizer(BenchmarkState& state)
+{
+    GeometryPtr geometry = makePrimitive(eSyntheticPrimitive(Type), uchar_t(state.range(0)));
+    Discretizer discretizer;
+    size_t nbPoints = 0;
+    while (state.keepRunning()) {
+        discretizer.clear();
+        geometry->apply(discretizer);
+        ExplicitModelPtr result = discretizer.getDiscretization();
+        nbPoints = result ? result->getPointListSize() : 0;
+        doNotOptimize(result);
+    }
+    state.setItemsProcessed(int64_t(state.iterations() * nbPoints));
+}
+
+#define PGL_PRIMITIVE_BENCHMARKS(function) \
+    PGL_BENCHMARK(function<eSyntheticSphere>)->arg(8)->arg(32)->arg(128); \
+    PGL_BENCHMARK(function<eSyntheticCylinder>)->arg(8)->arg(32)->arg(128); \
+    PGL_BENCHMARK(function<eSyntheticCone>)->arg(8)->arg(32)->arg(128); \
+    PGL_BENCHMARK(function<eSyntheticFrustum>)->arg(8)->arg(32)->arg(128); \
+    PGL_BENCHMARK(function<eSyntheticParaboloid>)->arg(8)->arg(32)->arg(128); \
+    PGL_BENCHMARK(function<eSyntheticBox>)->arg(1); \
+    PGL_BENCHMARK(function<eSyntheticDisc>)->arg(8)->arg(32)->arg(128); \
+    PGL_BENCHMARK(function<eSyntheticRevolution>)->arg(8)->arg(32)->arg(128); \
+    PGL_BENCHMARK(function<eSyntheticExtrusion>)->arg(8)->arg(32)->arg(128); \
+    PGL_BENCHMARK(function<eSyntheticNurbsPatch>)->arg(8)->arg(32)->arg(128);
+
+PGL_PRIMITIVE_BENCHMARKS(BM_Tesselator)
+PGL_PRIMITIVE_BENCHMARKS(BM_Discretizer)
+
+/* ----------------------------------------------------------------------- */
+
+/// Bounding box of a scene of primitives, the argument being the number of shapes.
+static void BM_BBoxComputer(BenchmarkState& state)
+{
+    ScenePtr scene = makePrimitiveScene(size_t(state.range(0)));
+    while (state.keepRunning()) {
+        Discretizer discretizer;
+        BBoxComputer bboxcomputer(discretizer);
+        bboxcomputer.process(scene);
+        doNotOptimize(bboxcomputer.getBoundingBox());
+    }
+    state.setItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+PGL_BENCHMARK(BM_BBoxComputer)->range(1000, 100000);
+
+/// Same as BM_BBoxComputer with several threads.
+static void BM_ParallelSceneBoundingBox(BenchmarkState& state)
+{
+    ScenePtr scene = makePrimitiveScene(size_t(state.range(0)));
+    while (state.keepRunning()) {
+        doNotOptimize(parallelSceneBoundingBox(scene));
+    }
+    state.setItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+PGL_BENCHMARK(BM_ParallelSceneBoundingBox)->range(1000, 100000);
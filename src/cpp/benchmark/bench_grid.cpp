@@ -0,0 +1,140 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+/* ----------------------------------------------------------------------- */
+
+#include "pglbenchmark.h"
+#include "synthetic.h"
+#include <plantgl/algo/grid/kdtree.h>
+#include <plantgl/algo/grid/regularpointgrid.h>
+#include <cmath>
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+static const size_t NB_NEIGHBORS = 16;
+
+/// k nearest neighbors of all the points of a random cloud, the argument being the number of points.
+static void BM_ANNKDTree3_KNN(BenchmarkState& state)
+{
+#ifdef PGL_WITH_ANN
+    Point3ArrayPtr points = makePointCloud(size_t(state.range(0)));
+    ANNKDTree3 tree(points);
+    while (state.keepRunning()) {
+        doNotOptimize(tree.k_nearest_neighbors(NB_NEIGHBORS));
+    }
+    state.setItemsProcessed(int64_t(state.iterations()) * state.range(0));
+#else
+    state.skipWithError("PlantGL built without ANN");
+#endif
+}
+PGL_BENCHMARK(BM_ANNKDTree3_KNN)->range(1000, 1000000);
+
+/// Same as BM_ANNKDTree3_KNN with several threads and a flat result.
+static void BM_ANNKDTree3_KNN_MT(BenchmarkState& state)
+{
+#ifdef PGL_WITH_ANN
+    Point3ArrayPtr points = makePointCloud(size_t(state.range(0)));
+    ANNKDTree3 tree(points);
+    while (state.keepRunning()) {
+        doNotOptimize(tree.k_nearest_neighbors_mt(NB_NEIGHBORS));
+    }
+    state.setItemsProcessed(int64_t(state.iterations()) * state.range(0));
+#else
+    state.skipWithError("PlantGL built without ANN");
+#endif
+}
+PGL_BENCHMARK(BM_ANNKDTree3_KNN_MT)->range(1000, 1000000);
+
+/// Construction of the kd-tree of a random cloud.
+static void BM_ANNKDTree3_Build(BenchmarkState& state)
+{
+#ifdef PGL_WITH_ANN
+    Point3ArrayPtr points = makePointCloud(size_t(state.range(0)));
+    while (state.keepRunning()) {
+        ANNKDTree3 tree(points);
+        doNotOptimize(tree.size());
+    }
+    state.setItemsProcessed(int64_t(state.iterations()) * state.range(0));
+#else
+    state.skipWithError("PlantGL built without ANN");
+#endif
+}
+PGL_BENCHMARK(BM_ANNKDTree3_Build)->range(1000, 1000000);
+
+/* ----------------------------------------------------------------------- */
+
+/** 10000 ball queries in a grid on a random cloud, the argument being the number of points.
+    The radius is chosen so that a ball contains about NB_NEIGHBORS points. */
+static void BM_PointGrid_QueryBallPoint(BenchmarkState& state)
+{
+    const size_t nbQueries = 10000;
+    size_t nbPoints = size_t(state.range(0));
+    Point3ArrayPtr points = makePointCloud(nbPoints);
+    Point3ArrayPtr queries = makePointCloud(nbQueries, 1);
+    real_t radius = std::pow(real_t(3 * NB_NEIGHBORS) / (4 * GEOM_PI * nbPoints), real_t(1) / 3);
+    Point3Grid grid(radius, points);
+    size_t nbFound = 0;
+    while (state.keepRunning()) {
+        nbFound = 0;
+        for (Point3Array::const_iterator it = queries->begin(); it != queries->end(); ++it)
+            nbFound += grid.query_ball_point(*it, radius).size();
+        doNotOptimize(nbFound);
+    }
+    state.setItemsProcessed(int64_t(state.iterations() * nbQueries));
+    state.setCounter("neighbors", double(nbFound) / nbQueries);
+}
+PGL_BENCHMARK(BM_PointGrid_QueryBallPoint)->range(1000, 1000000);
+
+/// Construction of the grid of a random cloud.
+static void BM_PointGrid_Build(BenchmarkState& state)
+{
+    size_t nbPoints = size_t(state.range(0));
+    Point3ArrayPtr points = makePointCloud(nbPoints);
+    real_t radius = std::pow(real_t(3 * NB_NEIGHBORS) / (4 * GEOM_PI * nbPoints), real_t(1) / 3);
+    while (state.keepRunning()) {
+        Point3Grid grid(radius, points);
+        doNotOptimize(grid.size());
+    }
+    state.setItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+PGL_BENCHMARK(BM_PointGrid_Build)->range(1000, 1000000);
@@ -0,0 +1,131 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+/* ----------------------------------------------------------------------- */
+
+#include "pglbenchmark.h"
+#include "synthetic.h"
+#include <plantgl/algo/modelling/pglturtle.h>
+#include <plantgl/algo/modelling/pglturtledrawer.h>
+#include <plantgl/algo/modelling/instancedturtledrawer.h>
+#include <plantgl/scenegraph/scene/shape.h>
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/// Interpret a branching structure of \e nbSegments segments with a lateral branch every 4 segments.
+static void interpret(PglTurtle& turtle, size_t nbSegments)
+{
+    turtle.start();
+    for (size_t i = 0; i < nbSegments; ++i) {
+        turtle.F(1);
+        if (i % 4 == 0) {
+            turtle.push();
+            turtle.rollL(137.5);
+            turtle.up(45);
+            turtle.setWidth(0.05);
+            turtle.F(0.5);
+            turtle.sphere(0.1);
+            turtle.pop();
+        }
+        turtle.left(5);
+    }
+    turtle.stop();
+}
+
+/// Interpretation with the default drawer, the argument being the number of segments.
+static void BM_PglTurtle(BenchmarkState& state)
+{
+    PglTurtle turtle;
+    while (state.keepRunning()) {
+        interpret(turtle, size_t(state.range(0)));
+        doNotOptimize(turtle.getScene());
+    }
+    state.setItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+PGL_BENCHMARK(BM_PglTurtle)->range(1000, 100000);
+
+/// Interpretation with the instanced drawer, including the expansion of the instances.
+static void BM_PglTurtle_Instanced(BenchmarkState& state)
+{
+    PglTurtle turtle(TurtleDrawerPtr(new InstancedTurtleDrawer()));
+    while (state.keepRunning()) {
+        interpret(turtle, size_t(state.range(0)));
+        doNotOptimize(turtle.getScene());
+    }
+    state.setItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+PGL_BENCHMARK(BM_PglTurtle_Instanced)->range(1000, 100000);
+
+/* ----------------------------------------------------------------------- */
+
+/// Filling a scene shape by shape, the argument being the number of shapes.
+static void BM_Scene_Add(BenchmarkState& state)
+{
+    std::vector<Shape3DPtr> shapes;
+    ScenePtr source = makePrimitiveScene(size_t(state.range(0)));
+    shapes.assign(source->begin(), source->end());
+    while (state.keepRunning()) {
+        ScenePtr scene(new Scene());
+        for (std::vector<Shape3DPtr>::const_iterator it = shapes.begin(); it != shapes.end(); ++it)
+            scene->add(*it);
+        doNotOptimize(scene);
+    }
+    state.setItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+PGL_BENCHMARK(BM_Scene_Add)->range(10000, 1000000);
+
+/// Same as BM_Scene_Add with a SceneBuilder.
+static void BM_SceneBuilder(BenchmarkState& state)
+{
+    std::vector<Shape3DPtr> shapes;
+    ScenePtr source = makePrimitiveScene(size_t(state.range(0)));
+    shapes.assign(source->begin(), source->end());
+    while (state.keepRunning()) {
+        SceneBuilder builder(uint_t(shapes.size()));
+        for (std::vector<Shape3DPtr>::const_iterator it = shapes.begin(); it != shapes.end(); ++it)
+            builder.add(*it);
+        doNotOptimize(builder.build());
+    }
+    state.setItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+PGL_BENCHMARK(BM_SceneBuilder)->range(10000, 1000000);
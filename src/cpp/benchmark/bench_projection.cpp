@@ -0,0 +1,75 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+/* ----------------------------------------------------------------------- */
+
+#include "pglbenchmark.h"
+#include "synthetic.h"
+#include <plantgl/algo/projection/zbufferengine.h>
+#include <cmath>
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+enum eZBufferMode { eSingleThreaded, eMultiThreaded, eTiled };
+
+/// Rendering of a scene of primitives in a 800x800 image, the argument being the number of shapes.
+template<int Mode>
+static void BM_ZBufferEngine(BenchmarkState& state)
+{
+    ScenePtr scene = makePrimitiveScene(size_t(state.range(0)));
+    real_t side = std::pow(real_t(state.range(0)), real_t(1) / 3) * 4;
+    Vector3 center(side / 2, side / 2, side / 2);
+    while (state.keepRunning()) {
+        ZBufferEngine engine(800, 800, ZBufferEngine::eIdBased, Color3::BLACK, Shape::NOID, Mode != eSingleThreaded);
+        engine.setTiledRendering(Mode == eTiled);
+        engine.setPerspectiveCamera(60, 1, 0.1, 4 * side);
+        engine.lookAt(center + Vector3(2 * side, 0, 0), center, Vector3::OZ);
+        engine.process(scene);
+        doNotOptimize(engine.getIdBuffer());
+    }
+    state.setItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+PGL_BENCHMARK(BM_ZBufferEngine<eSingleThreaded>)->range(100, 10000);
+PGL_BENCHMARK(BM_ZBufferEngine<eMultiThreaded>)->range(100, 10000);
+PGL_BENCHMARK(BM_ZBufferEngine<eTiled>)->range(100, 10000);
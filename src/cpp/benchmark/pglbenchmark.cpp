@@ -0,0 +1,350 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+/* ----------------------------------------------------------------------- */
+
+#include "pglbenchmark.h"
+#include <plantgl/version.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+BenchmarkState::BenchmarkState(const std::vector<int64_t>& args, uint64_t iterations) :
+    __args(args),
+    __iterations(iterations),
+    __done(0),
+    __running(false),
+    __cpuStart(0),
+    __realTime(0),
+    __cpuTime(0),
+    __itemsProcessed(0),
+    __bytesProcessed(0)
+{
+}
+
+void BenchmarkState::pauseTiming()
+{
+    if (!__running) return;
+    __realTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - __realStart).count();
+    __cpuTime += double(std::clock() - __cpuStart) / CLOCKS_PER_SEC;
+    __running = false;
+}
+
+void BenchmarkState::resumeTiming()
+{
+    if (__running) return;
+    __running = true;
+    __cpuStart = std::clock();
+    __realStart = std::chrono::steady_clock::now();
+}
+
+std::vector<Benchmark *>& PGL(benchmarkRegistry)()
+{
+    static std::vector<Benchmark *> registry;
+    return registry;
+}
+
+Benchmark * PGL(registerBenchmark)(const std::string& name, BenchmarkFunction function)
+{
+    Benchmark * benchmark = new Benchmark(name, function);
+    benchmarkRegistry().push_back(benchmark);
+    return benchmark;
+}
+
+/* ----------------------------------------------------------------------- */
+
+struct BenchmarkResult {
+    std::string name;
+    std::string runName;
+    uint64_t iterations;
+    double realTime;  // seconds per iteration
+    double cpuTime;   // seconds per iteration
+    double itemsPerSecond;
+    double bytesPerSecond;
+    std::map<std::string,double> counters;
+    std::string label;
+    std::string error;
+};
+
+static std::string runName(const Benchmark& benchmark, const std::vector<int64_t>& args)
+{
+    std::ostringstream name;
+    name << benchmark.name();
+    for (std::vector<int64_t>::const_iterator it = args.begin(); it != args.end(); ++it) name << '/' << *it;
+    return name.str();
+}
+
+static BenchmarkResult runBenchmark(const Benchmark& benchmark, const std::vector<int64_t>& args, double minTime)
+{
+    static const uint64_t maxIterations = 1000000000;
+    uint64_t iterations = 1;
+    BenchmarkResult result;
+    result.name = result.runName = runName(benchmark, args);
+    while (true) {
+        BenchmarkState state(args, iterations);
+        benchmark.function()(state);
+        if (!state.error().empty() || state.realTime() >= minTime || iterations >= maxIterations) {
+            result.iterations = std::max<uint64_t>(iterations, 1);
+            result.realTime = state.realTime() / result.iterations;
+            result.cpuTime = state.cpuTime() / result.iterations;
+            result.itemsPerSecond = state.realTime() > 0 ? state.itemsProcessed() / state.realTime() : 0;
+            result.bytesPerSecond = state.realTime() > 0 ? state.bytesProcessed() / state.realTime() : 0;
+            result.counters = state.counters();
+            result.label = state.label();
+            result.error = state.error();
+            return result;
+        }
+        // Predict the number of iterations reaching minTime, as the Google benchmark library does.
+        double multiplier = 10;
+        if (state.realTime() > 0.1 * minTime) multiplier = 1.4 * minTime / state.realTime();
+        uint64_t next = uint64_t(std::ceil(iterations * multiplier));
+        iterations = std::min(maxIterations, std::max(next, iterations + 1));
+    }
+}
+
+/* ----------------------------------------------------------------------- */
+
+static std::string formatTime(double seconds)
+{
+    char buffer[64];
+    if (seconds < 1e-6) std::snprintf(buffer, sizeof(buffer), "%10.1f ns", seconds * 1e9);
+    else if (seconds < 1e-3) std::snprintf(buffer, sizeof(buffer), "%10.2f us", seconds * 1e6);
+    else if (seconds < 1) std::snprintf(buffer, sizeof(buffer), "%10.2f ms", seconds * 1e3);
+    else std::snprintf(buffer, sizeof(buffer), "%10.3f s ", seconds);
+    return buffer;
+}
+
+static std::string formatRate(double rate)
+{
+    char buffer[64];
+    const char * units[] = { "", "k", "M", "G", "T" };
+    size_t unit = 0;
+    while (rate >= 1000 && unit < 4) { rate /= 1000; ++unit; }
+    std::snprintf(buffer, sizeof(buffer), "%.4g%s", rate, units[unit]);
+    return buffer;
+}
+
+static void printResult(const BenchmarkResult& result, size_t nameWidth)
+{
+    std::cout << result.name << std::string(nameWidth > result.name.size() ? nameWidth - result.name.size() : 0, ' ');
+    if (!result.error.empty()) {
+        std::cout << " ERROR: " << result.error << std::endl;
+        return;
+    }
+    std::cout << formatTime(result.realTime) << formatTime(result.cpuTime) << ' ' << std::setw(12) << result.iterations;
+    if (result.itemsPerSecond > 0) std::cout << " items/s=" << formatRate(result.itemsPerSecond);
+    if (result.bytesPerSecond > 0) std::cout << " bytes/s=" << formatRate(result.bytesPerSecond);
+    for (std::map<std::string,double>::const_iterator it = result.counters.begin(); it != result.counters.end(); ++it)
+        std::cout << ' ' << it->first << '=' << formatRate(it->second);
+    if (!result.label.empty()) std::cout << ' ' << result.label;
+    std::cout << std::endl;
+}
+
+static std::string jsonString(const std::string& value)
+{
+    std::string result("\"");
+    for (std::string::const_iterator it = value.begin(); it != value.end(); ++it) {
+        switch (*it) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if ((unsigned char)*it < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", (unsigned char)*it);
+                    result += buffer;
+                }
+                else result += *it;
+        }
+    }
+    return result + '"';
+}
+
+static std::string hostName()
+{
+#ifdef _WIN32
+    const char * name = std::getenv("COMPUTERNAME");
+    return name ? name : "";
+#else
+    char name[256] = { 0 };
+    if (gethostname(name, sizeof(name) - 1) != 0) return "";
+    return name;
+#endif
+}
+
+static bool writeJson(const std::string& fname, const std::string& executable, const std::vector<BenchmarkResult>& results)
+{
+    std::ofstream stream(fname.c_str());
+    if (!stream) return false;
+    char date[64];
+    std::time_t now = std::time(NULL);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+    stream.precision(10);
+    stream << "{\n  \"context\": {\n";
+    stream << "    \"date\": " << jsonString(date) << ",\n";
+    stream << "    \"host_name\": " << jsonString(hostName()) << ",\n";
+    stream << "    \"executable\": " << jsonString(executable) << ",\n";
+    stream << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+    stream << "    \"library_build_type\": \"release\",\n";
+#else
+    stream << "    \"library_build_type\": \"debug\",\n";
+#endif
+    stream << "    \"plantgl_version\": \"" << ((PGL_VERSION >> 16) & 0xff) << '.' << ((PGL_VERSION >> 8) & 0xff) << '.' << (PGL_VERSION & 0xff) << "\",\n";
+#ifdef PGL_USE_DOUBLE
+    stream << "    \"real_precision\": 64\n";
+#else
+    stream << "    \"real_precision\": 32\n";
+#endif
+    stream << "  },\n  \"benchmarks\": [";
+    for (std::vector<BenchmarkResult>::const_iterator it = results.begin(); it != results.end(); ++it) {
+        stream << (it == results.begin() ? "\n" : ",\n") << "    {\n";
+        stream << "      \"name\": " << jsonString(it->name) << ",\n";
+        stream << "      \"run_name\": " << jsonString(it->runName) << ",\n";
+        stream << "      \"run_type\": \"iteration\",\n";
+        stream << "      \"repetitions\": 1,\n      \"repetition_index\": 0,\n      \"threads\": 1,\n";
+        if (!it->error.empty()) {
+            stream << "      \"error_occurred\": true,\n";
+            stream << "      \"error_message\": " << jsonString(it->error) << "\n    }";
+            continue;
+        }
+        stream << "      \"iterations\": " << it->iterations << ",\n";
+        stream << "      \"real_time\": " << it->realTime * 1e9 << ",\n";
+        stream << "      \"cpu_time\": " << it->cpuTime * 1e9 << ",\n";
+        stream << "      \"time_unit\": \"ns\"";
+        if (it->itemsPerSecond > 0) stream << ",\n      \"items_per_second\": " << it->itemsPerSecond;
+        if (it->bytesPerSecond > 0) stream << ",\n      \"bytes_per_second\": " << it->bytesPerSecond;
+        for (std::map<std::string,double>::const_iterator itc = it->counters.begin(); itc != it->counters.end(); ++itc)
+            stream << ",\n      " << jsonString(itc->first) << ": " << itc->second;
+        if (!it->label.empty()) stream << ",\n      \"label\": " << jsonString(it->label);
+        stream << "\n    }";
+    }
+    stream << "\n  ]\n}\n";
+    return (bool)stream;
+}
+
+/* ----------------------------------------------------------------------- */
+
+static void usage(const char * executable)
+{
+    std::cout << "Usage: " << executable << " [options]\n"
+              << "  --benchmark_filter=<regex>   run only the benchmarks whose name matches <regex>\n"
+              << "  --benchmark_min_time=<sec>   minimum time of each run (default 0.5)\n"
+              << "  --benchmark_out=<file>       write the results as JSON in <file>\n"
+              << "  --benchmark_list_tests       list the benchmarks and exit\n";
+}
+
+static bool parseOption(const char * arg, const char * option, std::string& value)
+{
+    size_t len = std::strlen(option);
+    if (std::strncmp(arg, option, len) != 0) return false;
+    if (arg[len] == '=') { value = arg + len + 1; return true; }
+    if (arg[len] == '\0') { value = ""; return true; }
+    return false;
+}
+
+int main(int argc, char ** argv)
+{
+    std::string filter(".*"), outFile, value;
+    double minTime = 0.5;
+    bool listOnly = false;
+    for (int i = 1; i < argc; ++i) {
+        if (parseOption(argv[i], "--benchmark_filter", value)) filter = value;
+        else if (parseOption(argv[i], "--benchmark_min_time", value)) minTime = std::atof(value.c_str());
+        else if (parseOption(argv[i], "--benchmark_out", value)) outFile = value;
+        else if (parseOption(argv[i], "--benchmark_list_tests", value)) listOnly = true;
+        else { usage(argv[0]); return std::strcmp(argv[i], "--help") == 0 ? 0 : 1; }
+    }
+
+    std::regex pattern;
+    try { pattern = std::regex(filter); }
+    catch (const std::regex_error&) { std::cerr << "Invalid filter: " << filter << std::endl; return 1; }
+
+    std::vector<std::pair<Benchmark *, std::vector<int64_t> > > runs;
+    size_t nameWidth = 10;
+    const std::vector<Benchmark *>& registry = benchmarkRegistry();
+    for (std::vector<Benchmark *>::const_iterator it = registry.begin(); it != registry.end(); ++it) {
+        std::vector<std::vector<int64_t> > args = (*it)->runs();
+        if (args.empty()) args.push_back(std::vector<int64_t>());
+        for (std::vector<std::vector<int64_t> >::const_iterator ita = args.begin(); ita != args.end(); ++ita) {
+            std::string name = runName(**it, *ita);
+            if (!std::regex_search(name, pattern)) continue;
+            runs.push_back(std::make_pair(*it, *ita));
+            nameWidth = std::max(nameWidth, name.size());
+        }
+    }
+
+    if (listOnly) {
+        for (size_t i = 0; i < runs.size(); ++i) std::cout << runName(*runs[i].first, runs[i].second) << std::endl;
+        return 0;
+    }
+
+    std::cout << "Benchmark" << std::string(nameWidth - 9, ' ') << "          Time           CPU   Iterations" << std::endl;
+    std::cout << std::string(nameWidth + 42, '-') << std::endl;
+    std::vector<BenchmarkResult> results;
+    for (size_t i = 0; i < runs.size(); ++i) {
+        results.push_back(runBenchmark(*runs[i].first, runs[i].second, minTime));
+        printResult(results.back(), nameWidth);
+    }
+
+    if (!outFile.empty() && !writeJson(outFile, argv[0], results)) {
+        std::cerr << "Could not write " << outFile << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,195 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+/*! \file pglbenchmark.h
+    \brief A minimal benchmark harness for the C++ hot paths of PlantGL.
+
+    Benchmarks are functions taking a BenchmarkState and looping while
+    BenchmarkState::keepRunning() returns true. They are registered with
+    PGL_BENCHMARK and can be run for several arguments, typically the scale
+    of the synthetic data they work on. The runner writes the timings on the
+    console and, with --benchmark_out, as JSON following the layout of the
+    Google benchmark library so that its comparison tools can be used.
+*/
+
+#ifndef __pglbenchmark_h__
+#define __pglbenchmark_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include <plantgl/pgl_namespace.h>
+#include <chrono>
+#include <ctime>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/// State of a benchmark run: its arguments, the number of iterations to do and the timers.
+class BenchmarkState {
+public:
+    BenchmarkState(const std::vector<int64_t>& args, uint64_t iterations);
+
+    /// Returns true while iterations remain. Starts the timers at the first call.
+    bool keepRunning() {
+        if (__done < __iterations) {
+            if (__done++ == 0) resumeTiming();
+            return true;
+        }
+        pauseTiming();
+        return false;
+    }
+
+    /// The \e i th argument of the run.
+    int64_t range(size_t i = 0) const { return __args.at(i); }
+
+    uint64_t iterations() const { return __iterations; }
+
+    /// Exclude the following code from the timings, e.g. to rebuild the input of the next iteration.
+    void pauseTiming();
+    void resumeTiming();
+
+    /// Number of items processed by all the iterations, reported as a rate.
+    void setItemsProcessed(int64_t items) { __itemsProcessed = items; }
+
+    /// Number of bytes processed by all the iterations, reported as a rate.
+    void setBytesProcessed(int64_t bytes) { __bytesProcessed = bytes; }
+
+    /// A value reported as is with the results.
+    void setCounter(const std::string& name, double value) { __counters[name] = value; }
+
+    void setLabel(const std::string& label) { __label = label; }
+
+    /// Abort the benchmark, e.g. when a feature is not available in this build.
+    void skipWithError(const std::string& error) { __error = error; __iterations = __done; }
+
+    double realTime() const { return __realTime; }
+    double cpuTime() const { return __cpuTime; }
+    int64_t itemsProcessed() const { return __itemsProcessed; }
+    int64_t bytesProcessed() const { return __bytesProcessed; }
+    const std::map<std::string,double>& counters() const { return __counters; }
+    const std::string& label() const { return __label; }
+    const std::string& error() const { return __error; }
+
+protected:
+    std::vector<int64_t> __args;
+    uint64_t __iterations;
+    uint64_t __done;
+    bool __running;
+    std::chrono::steady_clock::time_point __realStart;
+    std::clock_t __cpuStart;
+    double __realTime;
+    double __cpuTime;
+    int64_t __itemsProcessed;
+    int64_t __bytesProcessed;
+    std::map<std::string,double> __counters;
+    std::string __label;
+    std::string __error;
+};
+
+typedef void (*BenchmarkFunction)(BenchmarkState&);
+
+/// A registered benchmark and the list of arguments it is run with.
+class Benchmark {
+public:
+    Benchmark(const std::string& name, BenchmarkFunction function) :
+        __name(name), __function(function) { }
+
+    /// Add a run with a single argument.
+    Benchmark * arg(int64_t value) { __args.push_back(std::vector<int64_t>(1,value)); return this; }
+
+    /// Add a run with several arguments.
+    Benchmark * args(const std::vector<int64_t>& values) { __args.push_back(values); return this; }
+
+    /// Add a run for each value from \e start to \e limit, multiplied by \e multiplier each time.
+    Benchmark * range(int64_t start, int64_t limit, int64_t multiplier = 10) {
+        for (int64_t v = start; v <= limit; v *= multiplier) arg(v);
+        return this;
+    }
+
+    const std::string& name() const { return __name; }
+    BenchmarkFunction function() const { return __function; }
+    const std::vector<std::vector<int64_t> >& runs() const { return __args; }
+
+protected:
+    std::string __name;
+    BenchmarkFunction __function;
+    std::vector<std::vector<int64_t> > __args;
+};
+
+/// The registered benchmarks, in registration order.
+std::vector<Benchmark *>& benchmarkRegistry();
+
+/// Register \e function under \e name.
+Benchmark * registerBenchmark(const std::string& name, BenchmarkFunction function);
+
+/// Prevent the compiler from optimizing away the computation of \e value.
+template<class T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void * sink;
+    sink = &value;
+#endif
+}
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+#define PGL_BENCHMARK_CONCAT2(a,b) a##b
+#define PGL_BENCHMARK_CONCAT(a,b) PGL_BENCHMARK_CONCAT2(a,b)
+
+/// Register \e function as a benchmark. Can be followed by ->arg(), ->args() or ->range().
+#define PGL_BENCHMARK(function) \
+    static PGL(Benchmark) * PGL_BENCHMARK_CONCAT(__pgl_benchmark_, __COUNTER__) = \
+        PGL(registerBenchmark)(#function, function)
+
+/* ----------------------------------------------------------------------- */
+
+#endif
@@ -0,0 +1,157 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+/* ----------------------------------------------------------------------- */
+
+#include "synthetic.h"
+#include <plantgl/pgl_geometry.h>
+#include <plantgl/pgl_transformation.h>
+#include <plantgl/pgl_appearance.h>
+#include <plantgl/scenegraph/scene/shape.h>
+#include <plantgl/scenegraph/container/pointmatrix.h>
+#include <cmath>
+#include <random>
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+GeometryPtr PGL(makePrimitive)(eSyntheticPrimitive type, uchar_t resolution)
+{
+    switch (type) {
+        case eSyntheticSphere:
+            return GeometryPtr(new Sphere(1, resolution, resolution));
+        case eSyntheticCylinder:
+            return GeometryPtr(new Cylinder(1, 2, true, resolution));
+        case eSyntheticCone:
+            return GeometryPtr(new Cone(1, 2, true, resolution));
+        case eSyntheticFrustum:
+            return GeometryPtr(new Frustum(1, 2, 0.5, true, resolution));
+        case eSyntheticParaboloid:
+            return GeometryPtr(new Paraboloid(1, 2, 2, true, resolution, resolution));
+        case eSyntheticBox:
+            return GeometryPtr(new Box(Vector3(1, 1, 1)));
+        case eSyntheticDisc:
+            return GeometryPtr(new Disc(1, resolution));
+        case eSyntheticRevolution: {
+            Point2ArrayPtr profile(new Point2Array(resolution));
+            for (uchar_t i = 0; i < resolution; ++i) {
+                real_t t = real_t(i) / (resolution - 1);
+                profile->setAt(i, Vector2(0.5 + 0.3 * std::sin(t * 2 * GEOM_PI), 2 * t));
+            }
+            return GeometryPtr(new Revolution(Curve2DPtr(new Polyline2D(profile)), resolution));
+        }
+        case eSyntheticExtrusion: {
+            Point3ArrayPtr axis(new Point3Array(resolution));
+            for (uchar_t i = 0; i < resolution; ++i) {
+                real_t t = real_t(i) / (resolution - 1);
+                axis->setAt(i, Vector3(std::cos(t * GEOM_PI), std::sin(t * GEOM_PI), 2 * t));
+            }
+            return GeometryPtr(new Extrusion(LineicModelPtr(new Polyline(axis)),
+                                             Curve2DPtr(Polyline2D::Circle(0.2, resolution))));
+        }
+        case eSyntheticNurbsPatch: {
+            Point4MatrixPtr ctrlPoints(new Point4Matrix(4, 4));
+            for (uint_t i = 0; i < 4; ++i)
+                for (uint_t j = 0; j < 4; ++j)
+                    ctrlPoints->setAt(i, j, Vector4(i, j, ((i + j) % 2) ? 1 : -1, 1));
+            return GeometryPtr(new NurbsPatch(ctrlPoints, RealArrayPtr(), RealArrayPtr(), 3, 3, resolution, resolution));
+        }
+        default:
+            return GeometryPtr();
+    }
+}
+
+ScenePtr PGL(makePrimitiveScene)(size_t nbShapes, uchar_t resolution, uint32_t seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<real_t> unit(0, 1);
+    std::uniform_int_distribution<int> types(0, eSyntheticNbPrimitives - 1);
+    real_t side = std::pow(real_t(nbShapes), real_t(1) / 3) * 4;
+
+    std::vector<GeometryPtr> primitives;
+    for (int i = 0; i < eSyntheticNbPrimitives; ++i)
+        primitives.push_back(makePrimitive(eSyntheticPrimitive(i), resolution));
+
+    SceneBuilder builder(nbShapes);
+    for (size_t i = 0; i < nbShapes; ++i) {
+        Vector3 position(unit(generator) * side, unit(generator) * side, unit(generator) * side);
+        real_t scale = 0.5 + unit(generator);
+        GeometryPtr geometry(new Translated(position, GeometryPtr(new Scaled(Vector3(scale, scale, scale), primitives[types(generator)]))));
+        AppearancePtr material(new Material(Color3(uchar_t(unit(generator) * 255), uchar_t(unit(generator) * 255), uchar_t(unit(generator) * 255))));
+        builder.add(Shape3DPtr(new Shape(geometry, material, uint_t(i))));
+    }
+    return builder.build();
+}
+
+TriangleSetPtr PGL(makeGridMesh)(size_t nbTriangles)
+{
+    size_t side = std::max<size_t>(2, size_t(std::sqrt(real_t(nbTriangles) / 2)) + 1);
+    Point3ArrayPtr points(new Point3Array(side * side));
+    Color4ArrayPtr colors(new Color4Array(side * side));
+    Index3ArrayPtr indices(new Index3Array());
+    indices->reserve(2 * (side - 1) * (side - 1));
+    for (size_t i = 0; i < side; ++i)
+        for (size_t j = 0; j < side; ++j) {
+            points->setAt(i * side + j, Vector3(real_t(i), real_t(j), std::sin(real_t(i) * 0.1) * std::cos(real_t(j) * 0.1)));
+            colors->setAt(i * side + j, Color4(uchar_t(i % 256), uchar_t(j % 256), 128, 0));
+        }
+    for (size_t i = 0; i + 1 < side; ++i)
+        for (size_t j = 0; j + 1 < side; ++j) {
+            uint_t p = uint_t(i * side + j);
+            indices->push_back(Index3(p, p + 1, p + uint_t(side)));
+            indices->push_back(Index3(p + 1, p + uint_t(side) + 1, p + uint_t(side)));
+        }
+    TriangleSetPtr mesh(new TriangleSet(points, indices));
+    mesh->getColorList() = colors;
+    mesh->getColorPerVertex() = true;
+    return mesh;
+}
+
+Point3ArrayPtr PGL(makePointCloud)(size_t nbPoints, uint32_t seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<real_t> unit(0, 1);
+    Point3ArrayPtr points(new Point3Array(nbPoints));
+    for (Point3Array::iterator it = points->begin(); it != points->end(); ++it)
+        *it = Vector3(unit(generator), unit(generator), unit(generator));
+    return points;
+}
@@ -0,0 +1,95 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+/*! \file synthetic.h
+    \brief Deterministic synthetic scenes and point clouds used by the benchmarks.
+*/
+
+#ifndef __pglbenchmark_synthetic_h__
+#define __pglbenchmark_synthetic_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include <plantgl/scenegraph/scene/scene.h>
+#include <plantgl/scenegraph/geometry/geometry.h>
+#include <plantgl/scenegraph/geometry/triangleset.h>
+#include <plantgl/scenegraph/container/pointarray.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+enum eSyntheticPrimitive {
+    eSyntheticSphere,
+    eSyntheticCylinder,
+    eSyntheticCone,
+    eSyntheticFrustum,
+    eSyntheticParaboloid,
+    eSyntheticBox,
+    eSyntheticDisc,
+    eSyntheticRevolution,
+    eSyntheticExtrusion,
+    eSyntheticNurbsPatch,
+    eSyntheticNbPrimitives
+};
+
+/// A primitive of type \e type discretized with \e resolution slices, stacks or strides.
+GeometryPtr makePrimitive(eSyntheticPrimitive type, uchar_t resolution);
+
+/** \e nbShapes translated and scaled primitives of random types, each with
+    its own material, spread in a cube whose volume grows with \e nbShapes. */
+ScenePtr makePrimitiveScene(size_t nbShapes, uchar_t resolution = 16, uint32_t seed = 0);
+
+/// A regular grid of about \e nbTriangles triangles, with a colour per vertex.
+TriangleSetPtr makeGridMesh(size_t nbTriangles);
+
+/// \e nbPoints points uniformly distributed in the unit cube.
+Point3ArrayPtr makePointCloud(size_t nbPoints, uint32_t seed = 0);
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#endif
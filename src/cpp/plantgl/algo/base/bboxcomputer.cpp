@@ -46,6 +46,7 @@
 
 #include "bboxcomputer.h"
 #include "discretizer.h"
+#include <deque>
 #include <plantgl/scenegraph/geometry/boundingbox.h>
 #include <plantgl/pgl_scene.h>
 #include <plantgl/pgl_geometry.h>
@@ -1031,3 +1032,66 @@ bool BBoxComputer::process(const Scene& scene){
 }
 
 /* ----------------------------------------------------------------------- */
+
+/// A BBoxComputer merging the bounding boxes of the top level shapes it processes.
+class BBoxAccumulator : public BBoxComputer {
+public:
+  BBoxAccumulator(Discretizer& discretizer) : BBoxComputer(discretizer), __total(), __depth(0) {}
+
+  using BBoxComputer::process;
+
+  virtual bool process(Shape * shape) {
+    ++__depth;
+    bool b = BBoxComputer::process(shape);
+    return accumulate(b);
+  }
+
+  virtual bool process(Inline * geomInline) {
+    ++__depth;
+    bool b = BBoxComputer::process(geomInline);
+    return accumulate(b);
+  }
+
+  BoundingBoxPtr __total;
+
+protected:
+  bool accumulate(bool b) {
+    if (--__depth == 0 && b && __bbox) {
+      if (__total) __total->extend(__bbox);
+      else __total = BoundingBoxPtr(new BoundingBox(*__bbox));
+    }
+    return b;
+  }
+
+  uint_t __depth;
+};
+
+class ParallelBBoxComputer : public ParallelAction {
+public:
+  ParallelBBoxComputer() : __total() {}
+
+  virtual Action * createAction() {
+    __discretizers.emplace_back();
+    return new BBoxAccumulator(__discretizers.back());
+  }
+
+  virtual bool reduce(Action& action) {
+    BoundingBoxPtr bbox = static_cast<BBoxAccumulator&>(action).__total;
+    if (!bbox) return true;
+    if (__total) __total->extend(bbox);
+    else __total = bbox;
+    return true;
+  }
+
+  BoundingBoxPtr __total;
+  std::deque<Discretizer> __discretizers;
+};
+
+BoundingBoxPtr PGL(parallelSceneBoundingBox)(const ScenePtr& scene, uint_t grainsize){
+  if (!scene) return BoundingBoxPtr();
+  ParallelBBoxComputer _bbc;
+  scene->applyParallel(_bbc, grainsize);
+  return _bbc.__total;
+}
+
+/* ----------------------------------------------------------------------- */
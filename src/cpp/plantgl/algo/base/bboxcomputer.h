@@ -236,6 +236,9 @@ protected:
 };
 
 
+/// Compute the bounding box of the objects in the scene \e scene with several threads
+BoundingBoxPtr ALGO_API parallelSceneBoundingBox(const ScenePtr& scene, uint_t grainsize = 0);
+
 /* ----------------------------------------------------------------------- */
 
 PGL_END_NAMESPACE
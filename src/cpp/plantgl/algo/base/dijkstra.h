@@ -47,6 +47,8 @@
 #include <plantgl/tool/util_array.h>
 
 #include <memory>
+#include <vector>
+#include <algorithm>
 
 // #define PGL_USE_PRIORITY_QUEUE
 
@@ -206,8 +208,9 @@ protected:
 
 };
 
-template<class EdgeWeigthEvaluation, class Allocator>
-DijkstraNodeList  dijkstra_shortest_paths_in_a_range(const IndexArrayPtr& connections,
+/// \e connections is a pointer to an IndexArray or a CSRIndexArray.
+template<class GraphPtr, class EdgeWeigthEvaluation, class Allocator>
+DijkstraNodeList  dijkstra_shortest_paths_in_a_range(const GraphPtr& connections,
                                              uint32_t root,
                                              EdgeWeigthEvaluation& distevaluator,
                                              real_t maxdist,
@@ -268,8 +271,8 @@ DijkstraNodeList  dijkstra_shortest_paths_in_a_range(const IndexArrayPtr& connec
 
          nbprocessednodes += 1;
 
-         const Index& nextchildren = connections->getAt(current);
-         for (Index::const_iterator itchildren = nextchildren.begin();
+         const auto& nextchildren = connections->getAt(current);
+         for (auto itchildren = nextchildren.begin();
              itchildren != nextchildren.end(); ++itchildren)
          {
              uint32_t v = *itchildren;
@@ -308,8 +311,8 @@ DijkstraNodeList  dijkstra_shortest_paths_in_a_range(const IndexArrayPtr& connec
  }
 
 
-template<class EdgeWeigthEvaluation>
-DijkstraNodeList  dijkstra_shortest_paths_in_a_range(const IndexArrayPtr& connections,
+template<class GraphPtr, class EdgeWeigthEvaluation>
+DijkstraNodeList  dijkstra_shortest_paths_in_a_range(const GraphPtr& connections,
                                              uint32_t root,
                                              EdgeWeigthEvaluation& distevaluator,
                                              real_t maxdist = REAL_MAX,
@@ -317,8 +320,174 @@ DijkstraNodeList  dijkstra_shortest_paths_in_a_range(const IndexArrayPtr& connec
 
  { return dijkstra_shortest_paths_in_a_range(connections,root,distevaluator,maxdist,maxnbelements,DijkstraAllocator());  }
 
-template<class EdgeWeigthEvaluation>
-std::pair<Uint32Array1Ptr,RealArrayPtr>  dijkstra_shortest_paths(const IndexArrayPtr& connections,
+/**
+    Reusable state for repeated range-limited Dijkstra searches on a same graph.
+
+    Per node arrays are sized once and invalidated in constant time between two searches
+    with a generation stamp: a node whose stamp differs from the current generation is
+    unreached. The queue is an indexed binary heap with decrease-key, so each node
+    appears at most once. Results are appended to a caller-provided buffer, either a
+    DijkstraNodeList or an Index of node ids, in order of increasing distance.
+    A workspace is not shareable between threads; use local() to get the one of the calling thread.
+*/
+class DijkstraWorkspace {
+public:
+    DijkstraWorkspace(size_t nbnodes = 0) : __generation(0) { reserve(nbnodes); }
+
+    /// Grow the per node arrays to hold at least \e nbnodes nodes.
+    void reserve(size_t nbnodes) {
+        if (nbnodes > __stamps.size()) {
+            __stamps.resize(nbnodes, 0);
+            __distances.resize(nbnodes, REAL_MAX);
+            __parents.resize(nbnodes, 0);
+            __heappositions.resize(nbnodes, 0);
+        }
+    }
+
+    /// Free the per node arrays.
+    void release() {
+        std::vector<uint32_t>().swap(__stamps);
+        std::vector<real_t>().swap(__distances);
+        std::vector<uint32_t>().swap(__parents);
+        std::vector<uint32_t>().swap(__heappositions);
+        std::vector<uint32_t>().swap(__heap);
+        __generation = 0;
+    }
+
+    size_t capacity() const { return __stamps.size(); }
+
+    /// The workspace of the calling thread.
+    static DijkstraWorkspace& local() {
+        static thread_local DijkstraWorkspace workspace;
+        return workspace;
+    }
+
+    /** Nodes reachable from \e root within \e maxdist, limited to \e maxnbelements nodes.
+        They are appended to \e result, which is not cleared. Return the number of nodes found.
+        \e connections is a pointer to an IndexArray or a CSRIndexArray. */
+    template<class GraphPtr, class EdgeWeigthEvaluation, class Output>
+    size_t run(const GraphPtr& connections,
+               uint32_t root,
+               EdgeWeigthEvaluation& distevaluator,
+               real_t maxdist,
+               uint32_t maxnbelements,
+               Output& result)
+    {
+        reserve(connections->size());
+        nextGeneration();
+
+        reach(root, root, 0);
+        push(root);
+
+        size_t nbprocessednodes = 0;
+        while (!__heap.empty() && nbprocessednodes < maxnbelements) {
+            uint32_t current = pop();
+            real_t currentdist = __distances[current];
+            append(result, current);
+            ++nbprocessednodes;
+
+            const auto& nextchildren = connections->getAt(current);
+            for (auto itchildren = nextchildren.begin(); itchildren != nextchildren.end(); ++itchildren) {
+                uint32_t v = *itchildren;
+                bool reached = (__stamps[v] == __generation);
+                if (reached && __heappositions[v] == SETTLED) continue;
+
+                real_t distance = distevaluator(current, v) + currentdist;
+                if (distance <= maxdist && (!reached || distance < __distances[v])) {
+                    reach(v, current, distance);
+                    if (!reached) push(v);
+                    else siftUp(__heappositions[v]);
+                }
+            }
+        }
+        return nbprocessednodes;
+    }
+
+protected:
+    static const uint32_t SETTLED = UINT32_MAX;
+
+    void nextGeneration() {
+        __heap.clear();
+        if (++__generation == 0) {
+            // stamps wrapped around: invalidate all of them once.
+            std::fill(__stamps.begin(), __stamps.end(), 0);
+            __generation = 1;
+        }
+    }
+
+    void reach(uint32_t node, uint32_t parent, real_t distance) {
+        __stamps[node] = __generation;
+        __distances[node] = distance;
+        __parents[node] = parent;
+    }
+
+    void append(DijkstraNodeList& result, uint32_t node) const
+    { result.push_back(DijkstraNode(node, __parents[node], __distances[node])); }
+
+    void append(Index& result, uint32_t node) const
+    { result.push_back(node); }
+
+    void place(uint32_t node, size_t pos) {
+        __heap[pos] = node;
+        __heappositions[node] = uint32_t(pos);
+    }
+
+    void push(uint32_t node) {
+        __heap.push_back(node);
+        siftUp(__heap.size() - 1);
+    }
+
+    uint32_t pop() {
+        uint32_t top = __heap.front();
+        uint32_t last = __heap.back();
+        __heap.pop_back();
+        if (!__heap.empty()) {
+            place(last, 0);
+            siftDown(0);
+        }
+        __heappositions[top] = SETTLED;
+        return top;
+    }
+
+    void siftUp(size_t pos) {
+        uint32_t node = __heap[pos];
+        real_t distance = __distances[node];
+        while (pos > 0) {
+            size_t parentpos = (pos - 1) / 2;
+            uint32_t parent = __heap[parentpos];
+            if (!(distance < __distances[parent])) break;
+            place(parent, pos);
+            pos = parentpos;
+        }
+        place(node, pos);
+    }
+
+    void siftDown(size_t pos) {
+        size_t nbelements = __heap.size();
+        uint32_t node = __heap[pos];
+        real_t distance = __distances[node];
+        for (;;) {
+            size_t child = 2 * pos + 1;
+            if (child >= nbelements) break;
+            if (child + 1 < nbelements && __distances[__heap[child + 1]] < __distances[__heap[child]]) ++child;
+            if (!(__distances[__heap[child]] < distance)) break;
+            place(__heap[child], pos);
+            pos = child;
+        }
+        place(node, pos);
+    }
+
+    std::vector<uint32_t> __stamps;
+    std::vector<real_t> __distances;
+    std::vector<uint32_t> __parents;
+    std::vector<uint32_t> __heappositions;
+    std::vector<uint32_t> __heap;
+    uint32_t __generation;
+};
+
+
+template<class GraphPtr, class EdgeWeigthEvaluation>
+std::pair<Uint32Array1Ptr,RealArrayPtr>  dijkstra_shortest_paths(const GraphPtr& connections,
                                    uint32_t root,
                                    EdgeWeigthEvaluation& distevaluator)
  {
@@ -351,8 +520,8 @@ std::pair<Uint32Array1Ptr,RealArrayPtr>  dijkstra_shortest_paths(const IndexArra
          if(colored[current] == white) continue;
 #endif
          colored[current] = white;
-         const Index& nextchildren = connections->getAt(current);
-         for (Index::const_iterator itchildren = nextchildren.begin();
+         const auto& nextchildren = connections->getAt(current);
+         for (auto itchildren = nextchildren.begin();
              itchildren != nextchildren.end(); ++itchildren)
          {
              uint32_t v = *itchildren;
@@ -0,0 +1,227 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+#include "discretizationcache.h"
+#include <plantgl/scenegraph/geometry/mesh.h>
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// object ids are addresses, so the low bits are free to store the kind.
+#define DISCRETIZATIONCACHE_KEY(object, kind) ((object)->getObjectId() | size_t(kind & 7))
+
+DiscretizationCache::DiscretizationCache( size_t maxMemory ) :
+  RefCountObject(),
+  __maxMemory(maxMemory),
+  __nbHits(0),
+  __nbMisses(0),
+  __nbEvictions(0)
+{
+}
+
+DiscretizationCache::~DiscretizationCache( )
+{
+}
+
+DiscretizationCachePtr DiscretizationCache::global( )
+{
+  static DiscretizationCachePtr GLOBAL(new DiscretizationCache());
+  return GLOBAL;
+}
+
+DiscretizationCache::Shard& DiscretizationCache::shard( size_t key )
+{
+  // drop the kind and the alignment bits of the address
+  return __shards[(key >> 4) % NbShards];
+}
+
+ExplicitModelPtr DiscretizationCache::find( const SceneObject * object, uchar_t kind, bool withTexCoord )
+{
+  size_t key = DISCRETIZATIONCACHE_KEY(object, kind);
+  Shard& s = shard(key);
+  std::lock_guard<std::mutex> lock(s.mutex);
+  pgl_hash_map<size_t, EntryList::iterator>::const_iterator it = s.index.find(key);
+  if (it != s.index.end()) {
+    EntryList::iterator entry = it->second;
+    if (!withTexCoord || (is_valid_ptr(dynamic_pointer_cast<Mesh>(entry->discretization)) &&
+                          dynamic_pointer_cast<Mesh>(entry->discretization)->hasTexCoordList())) {
+      s.entries.splice(s.entries.begin(), s.entries, entry);
+      ++__nbHits;
+      return entry->discretization;
+    }
+  }
+  ++__nbMisses;
+  return ExplicitModelPtr();
+}
+
+void DiscretizationCache::insert( SceneObject * object, const ExplicitModelPtr& discretization, uchar_t kind )
+{
+  // objects not managed by reference counting (e.g. on the stack) cannot be retained.
+  if (is_null_ptr(discretization) || object->use_count() == 0) return;
+  size_t key = DISCRETIZATIONCACHE_KEY(object, kind);
+  size_t memory = estimateMemory(discretization);
+  size_t maxMemory = __maxMemory / NbShards;
+  Shard& s = shard(key);
+  std::lock_guard<std::mutex> lock(s.mutex);
+  remove(s, key);
+  if (memory > maxMemory) return;
+  Entry entry;
+  entry.key = key;
+  entry.source = SceneObjectPtr(object);
+  entry.discretization = discretization;
+  entry.memory = memory;
+  s.entries.push_front(entry);
+  s.index[key] = s.entries.begin();
+  s.memory += memory;
+  evict(s, maxMemory);
+}
+
+void DiscretizationCache::evict( Shard& s, size_t maxMemory )
+{
+  while (s.memory > maxMemory && !s.entries.empty()) {
+    s.memory -= s.entries.back().memory;
+    s.index.erase(s.entries.back().key);
+    s.entries.pop_back();
+    ++__nbEvictions;
+  }
+}
+
+void DiscretizationCache::remove( Shard& s, size_t key )
+{
+  pgl_hash_map<size_t, EntryList::iterator>::iterator it = s.index.find(key);
+  if (it != s.index.end()) {
+    s.memory -= it->second->memory;
+    s.entries.erase(it->second);
+    s.index.erase(it);
+  }
+}
+
+void DiscretizationCache::invalidate( const SceneObject * object )
+{
+  for (uchar_t kind = 0; kind < 8; ++kind) {
+    size_t key = DISCRETIZATIONCACHE_KEY(object, kind);
+    Shard& s = shard(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    remove(s, key);
+  }
+}
+
+void DiscretizationCache::clear( )
+{
+  for (size_t i = 0; i < NbShards; ++i) {
+    std::lock_guard<std::mutex> lock(__shards[i].mutex);
+    __shards[i].index.clear();
+    __shards[i].entries.clear();
+    __shards[i].memory = 0;
+  }
+}
+
+void DiscretizationCache::purgeUnreferenced( )
+{
+  for (size_t i = 0; i < NbShards; ++i) {
+    Shard& s = __shards[i];
+    std::lock_guard<std::mutex> lock(s.mutex);
+    for (EntryList::iterator it = s.entries.begin(); it != s.entries.end(); ) {
+      if (it->source->unique()) {
+        s.memory -= it->memory;
+        s.index.erase(it->key);
+        it = s.entries.erase(it);
+      }
+      else ++it;
+    }
+  }
+}
+
+void DiscretizationCache::setMaxMemory( size_t maxMemory )
+{
+  __maxMemory = maxMemory;
+  for (size_t i = 0; i < NbShards; ++i) {
+    std::lock_guard<std::mutex> lock(__shards[i].mutex);
+    evict(__shards[i], maxMemory / NbShards);
+  }
+}
+
+size_t DiscretizationCache::getMemory( ) const
+{
+  size_t memory = 0;
+  for (size_t i = 0; i < NbShards; ++i) {
+    std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(__shards[i].mutex));
+    memory += __shards[i].memory;
+  }
+  return memory;
+}
+
+size_t DiscretizationCache::size( ) const
+{
+  size_t nb = 0;
+  for (size_t i = 0; i < NbShards; ++i) {
+    std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(__shards[i].mutex));
+    nb += __shards[i].index.size();
+  }
+  return nb;
+}
+
+void DiscretizationCache::resetStatistics( )
+{
+  __nbHits = 0;
+  __nbMisses = 0;
+  __nbEvictions = 0;
+}
+
+size_t DiscretizationCache::estimateMemory( const ExplicitModelPtr& discretization )
+{
+  size_t memory = sizeof(ExplicitModel);
+  if (discretization->getPointList()) memory += discretization->getPointListSize() * sizeof(Vector3);
+  if (discretization->getColorList()) memory += discretization->getColorList()->size() * sizeof(Color4);
+  MeshPtr mesh = dynamic_pointer_cast<Mesh>(discretization);
+  if (mesh) {
+    if (mesh->getNormalList()) memory += mesh->getNormalList()->size() * sizeof(Vector3);
+    if (mesh->getTexCoordList()) memory += mesh->getTexCoordList()->size() * sizeof(Vector2);
+    uint_t nbfaces = mesh->getIndexListSize();
+    // faces of a mesh are assumed to have the same size.
+    if (nbfaces > 0) memory += nbfaces * mesh->getFaceSize(0) * sizeof(uint_t);
+  }
+  return memory;
+}
+
+/* ----------------------------------------------------------------------- */
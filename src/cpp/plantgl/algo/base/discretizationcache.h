@@ -0,0 +1,166 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+/*! \file discretizationcache.h
+    \brief Definition of DiscretizationCache, a bounded cache of discretizations shared between threads.
+*/
+
+
+#ifndef __discretizationcache_h__
+#define __discretizationcache_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include "../algo_config.h"
+#include <plantgl/tool/rcobject.h>
+#include <plantgl/tool/util_hashmap.h>
+#include <plantgl/scenegraph/core/sceneobject.h>
+#include <plantgl/scenegraph/geometry/explicitmodel.h>
+#include <atomic>
+#include <list>
+#include <mutex>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+class DiscretizationCache;
+typedef RCPtr<DiscretizationCache> DiscretizationCachePtr;
+
+/**
+   \class DiscretizationCache
+   \brief A thread-safe cache of the discretizations of scene objects with a memory budget.
+
+   Entries are identified by the object id and a kind (Discretizer and Tesselator results
+   are stored separately). When the estimated size of the stored discretizations exceeds
+   the budget, the least recently used entries are evicted. An entry keeps its source object
+   alive so that its id cannot be reused by another object while it is cached. Since scene
+   objects do not notify their modifications, a modified object should be invalidated.
+   The cache is divided into NbShards independently locked shards, each with an equal 
+   part of the budget. A discretization larger than maxMemory / NbShards is thus never cached.
+*/
+
+class ALGO_API DiscretizationCache : public RefCountObject
+{
+public:
+  /// Number of shards sharing the memory budget.
+  static const size_t NbShards = 16;
+
+  /// Constructs a cache with a budget of \e maxMemory bytes.
+  DiscretizationCache( size_t maxMemory = 256 * 1024 * 1024 );
+
+  virtual ~DiscretizationCache( );
+
+  /// The cache shared by the whole process.
+  static DiscretizationCachePtr global( );
+
+  /// Returns the discretization of \e object, or null if absent. A texture flag requires texture coordinates.
+  ExplicitModelPtr find( const SceneObject * object, uchar_t kind = 0, bool withTexCoord = false );
+
+  /// Stores \e discretization as the discretization of \e object. Ignored if larger than getMaxMemory() / NbShards.
+  void insert( SceneObject * object, const ExplicitModelPtr& discretization, uchar_t kind = 0 );
+
+  /// Removes the discretizations of \e object. To call when \e object is modified.
+  void invalidate( const SceneObject * object );
+
+  /// Removes all entries.
+  void clear( );
+
+  /// Removes the entries whose source object is only referenced by \e self.
+  void purgeUnreferenced( );
+
+  size_t getMaxMemory( ) const { return __maxMemory; }
+  void setMaxMemory( size_t maxMemory );
+
+  /// Estimated size in bytes of the stored discretizations.
+  size_t getMemory( ) const;
+  size_t size( ) const;
+
+  uint64_t getNbHits( ) const { return __nbHits; }
+  uint64_t getNbMisses( ) const { return __nbMisses; }
+  uint64_t getNbEvictions( ) const { return __nbEvictions; }
+  void resetStatistics( );
+
+  /// Estimated size in bytes of \e discretization.
+  static size_t estimateMemory( const ExplicitModelPtr& discretization );
+
+protected:
+  struct Entry {
+    size_t key;
+    SceneObjectPtr source;
+    ExplicitModelPtr discretization;
+    size_t memory;
+  };
+
+  typedef std::list<Entry> EntryList;
+
+  struct Shard {
+    std::mutex mutex;
+    /// Entries from the most to the least recently used.
+    EntryList entries;
+    pgl_hash_map<size_t, EntryList::iterator> index;
+    size_t memory;
+    Shard() : memory(0) {}
+  };
+
+  Shard& shard( size_t key );
+  void evict( Shard& shard, size_t maxMemory );
+  void remove( Shard& shard, size_t key );
+
+  Shard __shards[NbShards];
+  size_t __maxMemory;
+
+  std::atomic<uint64_t> __nbHits;
+  std::atomic<uint64_t> __nbMisses;
+  std::atomic<uint64_t> __nbEvictions;
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __discretizationcache_h__
+#endif
@@ -52,6 +52,7 @@
 #include <plantgl/scenegraph/function/function.h>
 
 #include <plantgl/math/util_math.h>
+#include <plantgl/tool/util_profile.h>
 
 #ifdef GEOM_DEBUG
 #include <plantgl/tool/timer.h>
@@ -63,15 +64,40 @@ using namespace std;
 
 /* ----------------------------------------------------------------------- */
 
+bool Discretizer::cache_find(SceneObject * object, bool withTexCoord)
+{
+  if (__sharedCache) {
+    __discretization = __sharedCache->find(object, __cacheKind, withTexCoord);
+    PGL_PROFILE_COUNT(is_valid_ptr(__discretization) ? "discretizer.cache_hits" : "discretizer.cache_misses", 1);
+    return is_valid_ptr(__discretization);
+  }
+  Cache<ExplicitModelPtr>::Iterator _it = __cache.find(object->getObjectId());
+  if ((_it != __cache.end()) && (!withTexCoord || (dynamic_pointer_cast<Mesh>(_it->second))->hasTexCoordList())) {
+     __discretization = ExplicitModelPtr(_it->second);
+    if (__discretization) { PGL_PROFILE_COUNT("discretizer.cache_hits", 1); return true; }
+    else  cerr << "Cache of Discretizer Error !" << endl;
+  }
+  PGL_PROFILE_COUNT("discretizer.cache_misses", 1);
+  __discretization = ExplicitModelPtr();
+  return false;
+}
+
+void Discretizer::cache_insert(SceneObject * object)
+{
+  if (__sharedCache) __sharedCache->insert(object, __discretization, __cacheKind);
+  else __cache.insert(object->getObjectId(),__discretization);
+}
+
+void Discretizer::cache_remove(SceneObject * object)
+{
+  if (__sharedCache) __sharedCache->invalidate(object);
+  else __cache.remove(object->getObjectId());
+}
+
 template <class T> bool Discretizer::check_cache(T * geom)
 {
   if (!geom->unique()) {
-    Cache<ExplicitModelPtr>::Iterator _it = __cache.find(geom->getObjectId());
-    if (! (_it == __cache.end())) {
-       __discretization = ExplicitModelPtr(_it->second);
-      if (__discretization) return true;
-      else  cerr << "Cache of Discretizer Error !" << endl;
-    }
+    if (cache_find(geom)) return true;
   }
   __discretization = ExplicitModelPtr();
   return false;
@@ -80,12 +106,7 @@ template <class T> bool Discretizer::check_cache(T * geom)
 template <class T> bool Discretizer::check_cache_with_tex(T * geom)
 {
   if (!geom->unique()) {
-    Cache<ExplicitModelPtr>::Iterator _it = __cache.find(geom->getObjectId());
-    if ((_it != __cache.end()) && (dynamic_pointer_cast<Mesh>(_it->second))->hasTexCoordList()) {
-       __discretization = ExplicitModelPtr(_it->second);
-      if (__discretization) return true;
-      else  cerr << "Cache of Discretizer Error !" << endl;
-    }
+    if (cache_find(geom, true)) return true;
   }
   __discretization = ExplicitModelPtr();
   return false;
@@ -95,7 +116,7 @@ template <class T>
 void Discretizer::update_cache(T * geom) {
   if (!geom->unique()) {
     if(__discretization && geom->isNamed())__discretization->setName(geom->getName());
-    __cache.insert(geom->getObjectId(),__discretization);
+    cache_insert(geom);
   }
 }
 
@@ -131,6 +152,8 @@ bool Discretizer::transformed(T * geom) {
 Discretizer::Discretizer( ) :
     Action(),
     __cache(),
+    __sharedCache(),
+    __cacheKind(0),
     __discretization(),
     __computeTexCoord(false){
 }
@@ -1567,14 +1590,15 @@ bool Discretizer::process( NurbsCurve * nurbsCurve ) {
   real_t _start = nurbsCurve->getFirstKnot();
   uint_t _size = nurbsCurve->getStride();
   real_t _step =  (nurbsCurve->getLastKnot()-_start) / (real_t) _size;
-  Point3ArrayPtr _pointList(new Point3Array(_size + 1));
+  RealArrayPtr _params(new RealArray(_size + 1));
 
   for (uint_t _i = 0; _i < _size; _i++) {
-    _pointList->setAt(_i,nurbsCurve->getPointAt(_start));
+    _params->setAt(_i,_start);
     _start += _step;
   };
 
-  _pointList->setAt(_size, nurbsCurve->getPointAt(nurbsCurve->getLastKnot()));
+  _params->setAt(_size, nurbsCurve->getLastKnot());
+  Point3ArrayPtr _pointList = nurbsCurve->evaluate(_params);
 
   __discretization = ExplicitModelPtr(new Polyline(_pointList,nurbsCurve->getWidth()));
 
@@ -1595,12 +1619,10 @@ bool Discretizer::process( NurbsPatch * nurbsPatch ) {
   real_t _vStride1 = _vStride - real_t(1);
 
 
-  Point3ArrayPtr _pointList(new Point3Array(_uStride * _vStride));
   Index4ArrayPtr _indexList(new Index4Array( (_uStride - 1) * (_vStride - 1)));
 
   uint_t _cur = 0;
 
-  uint_t _pointCount = 0;
   uint_t _indexCount = 0;
 
   real_t _ufirst=nurbsPatch->getFirstUKnot();
@@ -1611,33 +1633,32 @@ bool Discretizer::process( NurbsPatch * nurbsPatch ) {
   real_t _vlast=nurbsPatch->getLastVKnot();
   real_t _vinter=_vlast-_vfirst;
 
-  for ( real_t _u = 0 ; _u < _uStride1 - GEOM_EPSILON ; ++_u) {
-    for (real_t _v = 0; _v < _vStride1 - GEOM_EPSILON ; ++_v) {
-      _pointList->setAt(_pointCount++,
-                        nurbsPatch->getPointAt(_ufirst + (_u * _uinter) / _uStride1,
-                                               _vfirst + (_v * _vinter) / _vStride1));
+  RealArrayPtr _uParams(new RealArray(_uStride));
+  RealArrayPtr _vParams(new RealArray(_vStride));
+
+  uint_t _uCount = 0;
+  for ( real_t _u = 0 ; _u < _uStride1 - GEOM_EPSILON ; ++_u)
+    _uParams->setAt(_uCount++, _ufirst + (_u * _uinter) / _uStride1);
+  _uParams->setAt(_uCount, _ulast);
+
+  uint_t _vCount = 0;
+  for (real_t _v = 0; _v < _vStride1 - GEOM_EPSILON ; ++_v)
+    _vParams->setAt(_vCount++, _vfirst + (_v * _vinter) / _vStride1);
+  _vParams->setAt(_vCount, _vlast);
+
+  // The whole grid of points is computed in one pass.
+  Point3ArrayPtr _pointList = nurbsPatch->evaluate(_uParams,_vParams);
+
+  for ( uint_t _i = 0 ; _i < _uCount ; ++_i) {
+    for (uint_t _j = 0; _j < _vCount ; ++_j) {
       _indexList->setAt(_indexCount++,
                         Index4(_cur,                _cur + 1,
                                _cur + _vStride + 1, _cur + _vStride));
-
       _cur++;
     };
-
-    _pointList->setAt(_pointCount++,
-                      nurbsPatch->getPointAt(_ufirst + (_u * _uinter) / _uStride1,_vlast));
-     _cur++;
-
+    _cur++;
   };
 
-  for (real_t _v = 0; _v < _vStride1 - GEOM_EPSILON; ++_v ){
-    _pointList->setAt(_pointCount++,
-                       nurbsPatch->getPointAt(_ulast,
-                                               (_vfirst +
-                                                (_v * _vinter) / _vStride1)));
-  }
-
-  _pointList->setAt(_pointCount,nurbsPatch->getPointAt(_ulast,_vlast));
-
   PolylinePtr _skeleton(new Polyline(Vector3(0,0,0),
                                      Vector3(0,0,0)));
 
@@ -2266,14 +2287,15 @@ bool Discretizer::process( NurbsCurve2D * nurbsCurve ) {
   real_t _start = nurbsCurve->getFirstKnot();
   uint_t _size = nurbsCurve->getStride();
   real_t _step =  (nurbsCurve->getLastKnot()-_start) / (real_t) _size;
-  Point3ArrayPtr _pointList(new Point3Array(_size + 1));
+  RealArrayPtr _params(new RealArray(_size + 1));
 
   for (uint_t _i = 0; _i < _size; _i++) {
-    _pointList->setAt(_i,Vector3(nurbsCurve->getPointAt(_start),0));
+    _params->setAt(_i,_start);
     _start += _step;
   };
 
-  _pointList->setAt(_size, Vector3(nurbsCurve->getPointAt(nurbsCurve->getLastKnot()),0));
+  _params->setAt(_size, nurbsCurve->getLastKnot());
+  Point3ArrayPtr _pointList(new Point3Array(*nurbsCurve->evaluate(_params),0));
 
   __discretization = ExplicitModelPtr(new Polyline(_pointList,nurbsCurve->getWidth()));
 
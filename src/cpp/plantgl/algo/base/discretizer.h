@@ -53,6 +53,7 @@
 #include "../algo_config.h"
 #include <plantgl/tool/rcobject.h>
 #include <plantgl/tool/util_cache.h>
+#include "discretizationcache.h"
 #include <plantgl/scenegraph/core/action.h>
 #include <plantgl/scenegraph/geometry/explicitmodel.h>
 
@@ -101,6 +102,12 @@ public:
   /// Returns the last computed discretized  geomety when applying \e self.
   inline ExplicitModelPtr& getDiscretization( )  { return __discretization; }
 
+  /// Uses \e cache, possibly shared with other threads, instead of the cache of \e self. Null to use its own cache.
+  void setSharedCache( const DiscretizationCachePtr& cache ) { __sharedCache = cache; }
+
+  /// Returns the shared cache used by \e self, if any.
+  const DiscretizationCachePtr& getSharedCache( ) const { return __sharedCache; }
+
   /// @name Shape
   //@{
 
@@ -232,9 +239,20 @@ protected:
   template <class T> void update_cache(T * geom);
   template <class T> bool transformed(T * geom);
 
+  /// Sets the discretization to the cached discretization of \e object. Returns whether one was found.
+  bool cache_find(SceneObject * object, bool withTexCoord = false);
+  void cache_insert(SceneObject * object);
+  void cache_remove(SceneObject * object);
+
   /// The cache storing the already discretized geometries.
   Cache<ExplicitModelPtr> __cache;
 
+  /// The shared cache used instead of \e __cache when set.
+  DiscretizationCachePtr __sharedCache;
+
+  /// Kind of the discretizations stored by \e self in a shared cache.
+  uchar_t __cacheKind;
+
   /// The last computed discretized geometry.
   ExplicitModelPtr __discretization;
 
@@ -46,11 +46,12 @@
 #include <plantgl/scenegraph/container/indexarray_iterator.h>
 #include <plantgl/scenegraph/transformation/transformed.h>
 #include <plantgl/tool/util_progress.h>
+#include <plantgl/tool/util_taskscheduler.h>
 #include <plantgl/scenegraph/geometry/boundingbox.h>
 #include <plantgl/algo/grid/kdtree.h>
 
-#include <boost/asio.hpp>
 #include <boost/algorithm/clamp.hpp>
+#include <limits>
 #include <boost/bind.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread.hpp>
@@ -60,8 +61,6 @@
 
 PGL_USING_NAMESPACE
 
-static unsigned int nthreads = boost::thread::hardware_concurrency();
-
 class ThreadAdapter
 {
 public:
@@ -266,14 +265,14 @@ std::pair<Point3ArrayPtr, Index> PGL(add_baricenter_points_of_path)(Point3ArrayP
 	ThreadAdapterAddBaricenterPointsOfPath adapter(point, kclosest, radius);
 	adapter.status = ProgressStatus(path.size(), "Computing baricenter points of path.", 0.1f);
 
-	boost::asio::thread_pool threadPool(nthreads);
+	TaskGroup tasks;
 
 	for (Index::const_iterator it = path.begin(); it != path.end(); ++it) {
-		boost::asio::post(threadPool, boost::bind(&ThreadAdapterAddBaricenterPointsOfPath::operator(), &adapter, *it));
+		tasks.run(boost::bind(&ThreadAdapterAddBaricenterPointsOfPath::operator(), &adapter, *it));
 	}
 
 	adapter.wait(200);
-	threadPool.join();
+	tasks.wait();
 
 	return std::make_pair(adapter.newPoints, adapter.baricenterIndexes);
 }
@@ -354,18 +353,18 @@ RealArrayPtr PGL(get_radii_of_path)(Point3ArrayPtr const &point, IndexArrayPtr c
 	adapter.status = ProgressStatus(totalTasks, "Computing all radius of path.", 0.1f);
 	adapter.status.refresh();
 	
-	boost::asio::thread_pool threadPool(nthreads);
+	TaskGroup tasks;
 
 	for (Index::const_iterator it = path.begin(); it != path.end(); ++it) {
 		Index::const_iterator const next = it + 1;
 		
 		if (next != path.end()) {
-			boost::asio::post(threadPool, boost::bind(&ThreadAdapterRadiiOfPath::operator(), &adapter, it, next));
+			tasks.run(boost::bind(&ThreadAdapterRadiiOfPath::operator(), &adapter, it, next));
 		}
 	}
 
 	adapter.wait(200);
-	threadPool.join();
+	tasks.wait();
 	
 	return adapter.getResult();
 }
@@ -381,7 +380,7 @@ public:
 		m_radius(radius)
 	{}
 
-	void main(Index const &path, RealArrayPtr const &radii, boost::asio::thread_pool &threadPool)
+	void main(Index const &path, RealArrayPtr const &radii, TaskGroup &tasks)
 	{
 		uint_t index = 0;
 		KDTree3 kdtree(m_points);
@@ -405,7 +404,7 @@ public:
 			
 			closestPoints[index] = kdtree.k_closest_points(m_points->getAt(*it), UINT_MAX, std::max(height * 2.0, m_radius * 2.0));
 			
-			boost::asio::post(threadPool, boost::bind(&ThreadAdapterWireSelection::operator(), this, addWire(), boost::ref(closestPoints[index]), center, vector, height));
+			tasks.run(boost::bind(&ThreadAdapterWireSelection::operator(), this, addWire(), boost::ref(closestPoints[index]), center, vector, height));
 			++progress;
 		}
 	}
@@ -481,18 +480,13 @@ Index PGL(select_wire_from_path)(Point3ArrayPtr const &point, Index const &path,
 	adapter.status = ProgressStatus(path.size(), "Selecting all points around path.", 0.1f);
 	adapter.status.refresh();
 
-	// Thread pool
-	boost::asio::thread_pool threadPool(nthreads > 1 ? nthreads - 1 : 1);
-
-	// Main thread
-	boost::thread thread(&ThreadAdapterWireSelection::main, &adapter, boost::ref(path), boost::ref(radii), boost::ref(threadPool));
+	// Main task, spawning the wire selection tasks
+	TaskGroup tasks;
+	tasks.run(boost::bind(&ThreadAdapterWireSelection::main, &adapter, boost::ref(path), boost::ref(radii), boost::ref(tasks)));
 
 	// We wait for all tasks to be completed
 	adapter.wait(200);
-
-	// We terminate the main thread and the thread pool
-	thread.join();
-	threadPool.join();
+	tasks.wait();
 
 	// Final result
 	Index wire;
@@ -972,7 +966,7 @@ std::pair<Index, real_t> PGL(select_pole_from_point)(Point3ArrayPtr const &point
 {
 	srand(time(0));
 
-	boost::asio::thread_pool threadPool(nthreads);
+	TaskGroup tasks;
 	ThreadAdapterRansac adapter(points, 0.14, -1.0, maxAngle);
 
 	adapter.status = ProgressStatus(iterations, "Selecting pole.");
@@ -982,11 +976,11 @@ std::pair<Index, real_t> PGL(select_pole_from_point)(Point3ArrayPtr const &point
 	std::size_t const totalIterations = subIterations * 50;
 
 	for (uint_t i = 0; i < subIterations; ++i) {
-		boost::asio::post(threadPool, boost::bind(&ThreadAdapterRansac::operator(), &adapter, 50));
+		tasks.run(boost::bind(&ThreadAdapterRansac::operator(), &adapter, 50));
 	}
 
 	adapter.wait();
-	threadPool.join();
+	tasks.wait();
 
 	if (adapter.bestCylinder == NULL) {
 		// No cylinder found
@@ -1017,14 +1011,14 @@ std::pair<Index, real_t> PGL(select_pole_points_mt)(Point3ArrayPtr const &point,
 	ThreadAdapterRansac adapter(point, radius, tolerance, 0.261799);
 	adapter.status = ProgressStatus(iterations, "Finding pole.", 0.1f);
 	
-	boost::asio::thread_pool threadPool(nthreads);
+	TaskGroup tasks;
 
 	for (uint_t i = 0; i < iterations; ++i) {
-		boost::asio::post(threadPool, boost::bind(&ThreadAdapterRansac::operator(), &adapter, 1));
+		tasks.run(boost::bind(&ThreadAdapterRansac::operator(), &adapter, 1));
 	}
 	
 	adapter.wait();
-	threadPool.join();
+	tasks.wait();
   
 	return std::make_pair(adapter.bestCylinder->points, adapter.bestCylinder->score(point->size()));
 }
@@ -1238,10 +1232,8 @@ PGL(r_neighborhood)(uint32_t pid, const Point3ArrayPtr &points, const IndexArray
 
   struct PointDistance pdevaluator(points);
 
-  DijkstraNodeList lneighborhood = dijkstra_shortest_paths_in_a_range(adjacencies, pid, pdevaluator, radius);
   Index result;
-  for (DijkstraNodeList::const_iterator itn = lneighborhood.begin(); itn != lneighborhood.end(); ++itn)
-    result.push_back(itn->id);
+  DijkstraWorkspace::local().run(adjacencies, pid, pdevaluator, radius, UINT32_MAX, result);
   return result;
 }
 
@@ -1254,26 +1246,32 @@ PGL(r_neighborhoods)(const Point3ArrayPtr points, const IndexArrayPtr adjacencie
 
   uint32_t current = 0;
   IndexArrayPtr result(new IndexArray(nbPoints));
-  // std::vector<std::vector<std::pair<uint32_t, real_t> > > preinfo(nbPoints);
-  DijkstraReusingAllocator allocator;
+  DijkstraWorkspace& workspace = DijkstraWorkspace::local();
 
   ProgressStatus st(nbPoints, "R-neighborhood computed for %.2f%% of points.");
   for (RealArray::const_iterator itradii = radii->begin(); itradii != radii->end(); ++itradii, ++st) {
-    DijkstraNodeList lneighborhood = dijkstra_shortest_paths_in_a_range(adjacencies, current, pdevaluator, *itradii, UINT32_MAX,
-                                                                allocator);
-    // preinfo[current].clear();
-    Index lres;
-    for (DijkstraNodeList::const_iterator itn = lneighborhood.begin(); itn != lneighborhood.end(); ++itn) {
-      lres.push_back(itn->id);
-      //if (itn->id > current) preinfo[itn->id].push_back(std::pair<uint32_t, real_t>(current, itn->distance));
-    }
-    result->setAt(current, lres);
+    workspace.run(adjacencies, current, pdevaluator, *itradii, UINT32_MAX, result->getAt(current));
     current++;
-
   }
   return result;
 }
 
+IndexArrayPtr
+PGL(r_neighborhoods_mt)(const Point3ArrayPtr points, const IndexArrayPtr adjacencies, const RealArrayPtr radii) {
+  uint32_t nbPoints = points->size();
+  GEOM_ASSERT(nbPoints == adjacencies->size());
+  GEOM_ASSERT(nbPoints == radii->size());
+  struct PointDistance pdevaluator(points);
+
+  IndexArrayPtr result(new IndexArray(nbPoints));
+  parallel_for_range(0, nbPoints, [&](size_t begin, size_t end) {
+    DijkstraWorkspace& workspace = DijkstraWorkspace::local();
+    for (size_t current = begin; current < end; ++current)
+      workspace.run(adjacencies, uint32_t(current), pdevaluator, radii->getAt(current), UINT32_MAX, result->getAt(current));
+  });
+  return result;
+}
+
 class ThreadAdapterRNeighborhoods : public ThreadAdapter
 {
 	const Point3ArrayPtr points;
@@ -1307,16 +1305,7 @@ public:
 
 	void execute(uint32_t current)
 	{
-		DijkstraNodeList const lneighborhood = dijkstra_shortest_paths_in_a_range(adjacencies, current, pdevaluator, radius, UINT32_MAX, DijkstraReusingAllocator());
-		// preinfo[current].clear();
-		Index lres;
-		lres.reserve(lneighborhood.size());
-	  
-		for (DijkstraNodeList::const_iterator itn = lneighborhood.begin(); itn != lneighborhood.end(); ++itn) {
-			lres.push_back(itn->id);
-			//if (itn->id > current) preinfo[itn->id].push_back(std::pair<uint32_t, real_t>(current, itn->distance));
-		}
-		result->setAt(current, lres);
+		DijkstraWorkspace::local().run(adjacencies, current, pdevaluator, radius, UINT32_MAX, result->getAt(current));
 		++progress;
 	}
 };
@@ -1349,20 +1338,20 @@ PGL(r_neighborhoods_mt)(const Point3ArrayPtr points, const IndexArrayPtr adjacen
   GEOM_ASSERT(nbPoints == radii->size());
 
   ThreadAdapterRNeighborhoods adapter(points, adjacencies, radius);
-  boost::asio::thread_pool pool(nthreads);
+  TaskGroup tasks;
 
   adapter.status = ProgressStatus(nbPoints, "R-neighborhood computed for %.2f%% of points.", 0.01f);
   adapter.status.refresh();
 
   for (uint32_t current = 0; current < nbPoints; current += 1000) {
-	  boost::asio::post(pool, boost::bind(&ThreadAdapterRNeighborhoods::operator(), &adapter, current, 1000));
+	  tasks.run(boost::bind(&ThreadAdapterRNeighborhoods::operator(), &adapter, current, 1000));
   }
 
   if (verbose) {
 	  adapter.wait();
   }
 
-  pool.join();
+  tasks.wait();
   return adapter.result;
 }
 
@@ -1391,10 +1380,8 @@ PGL(r_anisotropic_neighborhood)(uint32_t pid, const Point3ArrayPtr points, const
 
   struct PointAnisotropicDistance pdevaluator(points, direction, alpha, beta);
 
-  DijkstraNodeList lneighborhood = dijkstra_shortest_paths_in_a_range(adjacencies, pid, pdevaluator, radius);
   Index result;
-  for (DijkstraNodeList::const_iterator itn = lneighborhood.begin(); itn != lneighborhood.end(); ++itn)
-    result.push_back(itn->id);
+  DijkstraWorkspace::local().run(adjacencies, pid, pdevaluator, radius, UINT32_MAX, result);
   return result;
 }
 
@@ -1409,14 +1396,11 @@ PGL(r_anisotropic_neighborhoods)(const Point3ArrayPtr points, const IndexArrayPt
 
   uint32_t current = 0;
   IndexArrayPtr result(new IndexArray(nbPoints));
+  DijkstraWorkspace& workspace = DijkstraWorkspace::local();
 
   for (RealArray::const_iterator itradii = radii->begin(); itradii != radii->end(); ++itradii) {
     struct PointAnisotropicDistance pdevaluator(points, directions->getAt(current), alpha, beta);
-    DijkstraNodeList lneighborhood = dijkstra_shortest_paths_in_a_range(adjacencies, current, pdevaluator, *itradii);
-    Index lres;
-    for (DijkstraNodeList::const_iterator itn = lneighborhood.begin(); itn != lneighborhood.end(); ++itn)
-      lres.push_back(itn->id);
-    result->setAt(current, lres);
+    workspace.run(adjacencies, current, pdevaluator, *itradii, UINT32_MAX, result->getAt(current));
     ++current;
   }
   return result;
@@ -1434,17 +1418,50 @@ PGL(r_anisotropic_neighborhoods)(const Point3ArrayPtr points, const IndexArrayPt
 
 
   IndexArrayPtr result(new IndexArray(nbPoints));
+  DijkstraWorkspace& workspace = DijkstraWorkspace::local();
   for (uint32_t current = 0; current < nbPoints; ++current) {
     struct PointAnisotropicDistance pdevaluator(points, directions->getAt(current), alpha, beta);
-    DijkstraNodeList lneighborhood = dijkstra_shortest_paths_in_a_range(adjacencies, current, pdevaluator, radius);
-    Index lres;
-    for (DijkstraNodeList::const_iterator itn = lneighborhood.begin(); itn != lneighborhood.end(); ++itn)
-      lres.push_back(itn->id);
-    result->setAt(current, lres);
+    workspace.run(adjacencies, current, pdevaluator, radius, UINT32_MAX, result->getAt(current));
   }
   return result;
 }
 
+// Anisotropic r-neighborhoods of all points in parallel. radius(i) gives the radius of point i.
+template<class RadiusFunction>
+IndexArrayPtr anisotropic_neighborhoods_mt(const Point3ArrayPtr points, const IndexArrayPtr adjacencies,
+                                           const RadiusFunction& radius,
+                                           const Point3ArrayPtr directions,
+                                           const real_t alpha, const real_t beta) {
+  uint32_t nbPoints = points->size();
+  GEOM_ASSERT(nbPoints == adjacencies->size());
+  GEOM_ASSERT(nbPoints == directions->size());
+
+  IndexArrayPtr result(new IndexArray(nbPoints));
+  parallel_for_range(0, nbPoints, [&](size_t begin, size_t end) {
+    DijkstraWorkspace& workspace = DijkstraWorkspace::local();
+    for (size_t current = begin; current < end; ++current) {
+      struct PointAnisotropicDistance pdevaluator(points, directions->getAt(current), alpha, beta);
+      workspace.run(adjacencies, uint32_t(current), pdevaluator, radius(current), UINT32_MAX, result->getAt(current));
+    }
+  });
+  return result;
+}
+
+IndexArrayPtr
+PGL(r_anisotropic_neighborhoods_mt)(const Point3ArrayPtr points, const IndexArrayPtr adjacencies, const RealArrayPtr radii,
+                                    const Point3ArrayPtr directions,
+                                    const real_t alpha, const real_t beta) {
+  GEOM_ASSERT(points->size() == radii->size());
+  return anisotropic_neighborhoods_mt(points, adjacencies, [&](size_t i) { return radii->getAt(i); }, directions, alpha, beta);
+}
+
+IndexArrayPtr
+PGL(r_anisotropic_neighborhoods_mt)(const Point3ArrayPtr points, const IndexArrayPtr adjacencies, real_t radius,
+                                    const Point3ArrayPtr directions,
+                                    const real_t alpha, const real_t beta) {
+  return anisotropic_neighborhoods_mt(points, adjacencies, [radius](size_t) { return radius; }, directions, alpha, beta);
+}
+
 
 real_t
 PGL(density_from_r_neighborhood)(uint32_t pid,
@@ -1512,9 +1529,7 @@ PGL(k_neighborhood)(uint32_t pid, const Point3ArrayPtr points, const IndexArrayP
   } else {
     struct PointDistance pdevaluator(points);
 
-    DijkstraNodeList lneighborhood = dijkstra_shortest_paths_in_a_range(adjacencies, pid, pdevaluator, REAL_MAX, k);
-    for (DijkstraNodeList::const_iterator itn = lneighborhood.begin(); itn != lneighborhood.end(); ++itn)
-      result.push_back(itn->id);
+    DijkstraWorkspace::local().run(adjacencies, pid, pdevaluator, REAL_MAX, k, result);
   }
   return result;
 }
@@ -1527,18 +1542,14 @@ PGL(k_neighborhoods)(const Point3ArrayPtr points, const IndexArrayPtr adjacencie
   struct PointDistance pdevaluator(points);
 
   IndexArrayPtr result(new IndexArray(nbPoints));
+  DijkstraWorkspace& workspace = DijkstraWorkspace::local();
   for (uint32_t current = 0; current < nbPoints; ++current) {
-    Index lres;
-    const Index &candidates = adjacencies->getAt(current);
     /*if (k <= candidates.size()) {
             lres = get_k_closest_from_n(candidates,k,current,points);
         }
         else {*/
-    DijkstraNodeList lneighborhood = dijkstra_shortest_paths_in_a_range(adjacencies, current, pdevaluator, REAL_MAX, k);
-    for (DijkstraNodeList::const_iterator itn = lneighborhood.begin(); itn != lneighborhood.end(); ++itn)
-      lres.push_back(itn->id);
+    workspace.run(adjacencies, current, pdevaluator, REAL_MAX, k, result->getAt(current));
     // }
-    result->setAt(current, lres);
   }
   return result;
 }
@@ -1681,6 +1692,323 @@ PGL(densities_from_k_neighborhood)(const Point3ArrayPtr points,
 }
 
 
+/* ----------------------------------------------------------------------- */
+
+// Fill a CSRIndexArray row by row with rowfunction(i, row, workspace). With several threads,
+// each range of rows is stored in its own array and the arrays are concatenated in order.
+template<class RowFunction>
+CSRIndexArrayPtr build_csr_rows(size_t nbrows, const RowFunction& rowfunction, bool multithreaded) {
+  size_t grainsize = multithreaded ? std::max<size_t>(256, nbrows / (4 * (TaskScheduler::get().nbThreads() + 1))) : std::max<size_t>(nbrows, 1);
+  size_t nbchunks = (nbrows + grainsize - 1) / grainsize;
+  std::vector<CSRIndexArray> chunks(nbchunks);
+  parallel_for_range(0, nbrows, [&](size_t begin, size_t end) {
+    CSRIndexArray& chunk = chunks[begin / grainsize];
+    DijkstraWorkspace& workspace = DijkstraWorkspace::local();
+    Index row;
+    for (size_t i = begin; i < end; ++i) {
+      row.clear();
+      rowfunction(i, row, workspace);
+      chunk.pushRow(row);
+    }
+  }, grainsize);
+
+  CSRIndexArrayPtr result(new CSRIndexArray());
+  size_t nbindices = 0;
+  for (std::vector<CSRIndexArray>::const_iterator it = chunks.begin(); it != chunks.end(); ++it) nbindices += it->getNbIndices();
+  result->reserve(nbrows, nbindices);
+  for (std::vector<CSRIndexArray>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+    result->append(*it);
+    it->clear();
+  }
+  return result;
+}
+
+Index
+PGL(r_neighborhood)(uint32_t pid, const Point3ArrayPtr &points, const CSRIndexArrayPtr &adjacencies, const real_t radius) {
+  GEOM_ASSERT(points->size() == adjacencies->size());
+  struct PointDistance pdevaluator(points);
+  Index result;
+  DijkstraWorkspace::local().run(adjacencies, pid, pdevaluator, radius, UINT32_MAX, result);
+  return result;
+}
+
+static CSRIndexArrayPtr csr_r_neighborhoods(const Point3ArrayPtr points, const CSRIndexArrayPtr adjacencies, real_t radius, bool multithreaded) {
+  GEOM_ASSERT(points->size() == adjacencies->size());
+  struct PointDistance pdevaluator(points);
+  return build_csr_rows(points->size(), [&](size_t current, Index& row, DijkstraWorkspace& workspace) {
+    workspace.run(adjacencies, uint32_t(current), pdevaluator, radius, UINT32_MAX, row);
+  }, multithreaded);
+}
+
+CSRIndexArrayPtr
+PGL(r_neighborhoods)(const Point3ArrayPtr points, const CSRIndexArrayPtr adjacencies, real_t radius) {
+  return csr_r_neighborhoods(points, adjacencies, radius, false);
+}
+
+CSRIndexArrayPtr
+PGL(r_neighborhoods_mt)(const Point3ArrayPtr points, const CSRIndexArrayPtr adjacencies, real_t radius) {
+  return csr_r_neighborhoods(points, adjacencies, radius, true);
+}
+
+Index
+PGL(k_neighborhood)(uint32_t pid, const Point3ArrayPtr points, const CSRIndexArrayPtr adjacencies, const uint32_t k) {
+  GEOM_ASSERT(points->size() == adjacencies->size());
+  CSRIndexArray::Row candidates = adjacencies->getAt(pid);
+  if (k <= candidates.size()) return get_k_closest_from_n(Index(candidates.begin(), candidates.end()), k, pid, points);
+  struct PointDistance pdevaluator(points);
+  Index result;
+  DijkstraWorkspace::local().run(adjacencies, pid, pdevaluator, REAL_MAX, k, result);
+  return result;
+}
+
+static CSRIndexArrayPtr csr_k_neighborhoods(const Point3ArrayPtr points, const CSRIndexArrayPtr adjacencies, const uint32_t k, bool multithreaded) {
+  GEOM_ASSERT(points->size() == adjacencies->size());
+  struct PointDistance pdevaluator(points);
+  // same as k_neighborhoods on IndexArray: the k closest points along the adjacency graph.
+  return build_csr_rows(points->size(), [&](size_t current, Index& row, DijkstraWorkspace& workspace) {
+    workspace.run(adjacencies, uint32_t(current), pdevaluator, REAL_MAX, k, row);
+  }, multithreaded);
+}
+
+CSRIndexArrayPtr
+PGL(k_neighborhoods)(const Point3ArrayPtr points, const CSRIndexArrayPtr adjacencies, const uint32_t k) {
+  return csr_k_neighborhoods(points, adjacencies, k, false);
+}
+
+CSRIndexArrayPtr
+PGL(k_neighborhoods_mt)(const Point3ArrayPtr points, const CSRIndexArrayPtr adjacencies, const uint32_t k) {
+  return csr_k_neighborhoods(points, adjacencies, k, true);
+}
+
+RealArrayPtr
+PGL(densities_from_r_neighborhood)(const Point3ArrayPtr points,
+                                   const CSRIndexArrayPtr adjacencies,
+                                   const real_t radius) {
+  uint32_t nbPoints = points->size();
+  GEOM_ASSERT(nbPoints == adjacencies->size());
+  struct PointDistance pdevaluator(points);
+  RealArrayPtr result(new RealArray(nbPoints));
+  parallel_for_range(0, nbPoints, [&](size_t begin, size_t end) {
+    DijkstraWorkspace& workspace = DijkstraWorkspace::local();
+    Index neighborhood;
+    for (size_t current = begin; current < end; ++current) {
+      neighborhood.clear();
+      workspace.run(adjacencies, uint32_t(current), pdevaluator, radius, UINT32_MAX, neighborhood);
+      result->setAt(current, neighborhood.size() / (radius * radius));
+    }
+  });
+  return result;
+}
+
+RealArrayPtr
+PGL(densities_from_r_neighborhood)(const CSRIndexArrayPtr neighborhood,
+                                   const real_t radius) {
+  uint32_t nbPoints = neighborhood->size();
+  RealArrayPtr result(new RealArray(nbPoints));
+  for (uint32_t current = 0; current < nbPoints; ++current)
+    result->setAt(current, neighborhood->getRowSize(current) / (radius * radius));
+  return result;
+}
+
+RealArrayPtr
+PGL(densities_from_k_neighborhood)(const Point3ArrayPtr points,
+                                   const CSRIndexArrayPtr adjacencies,
+                                   const uint32_t k) {
+  uint32_t nbPoints = points->size();
+  GEOM_ASSERT(nbPoints == adjacencies->size());
+  RealArrayPtr result(new RealArray(nbPoints));
+  parallel_for(0, nbPoints, [&](size_t current) {
+    Index adjacency = (k == 0 ? Index(adjacencies->getAt(current).begin(), adjacencies->getAt(current).end()) : k_neighborhood(uint32_t(current), points, adjacencies, k));
+    real_t radius = pointset_max_distance(uint32_t(current), points, adjacency);
+    result->setAt(current, adjacency.size() / (radius * radius));
+  });
+  return result;
+}
+
+/* ----------------------------------------------------------------------- */
+
+// Eigen decomposition of a symmetric 3x3 matrix by cyclic Jacobi rotations.
+// m is destroyed. Eigen values are sorted in decreasing order and vectors[i] is the unit eigen vector of values[i].
+static void symmetric_eigen3(real_t m[3][3], real_t values[3], Vector3 vectors[3]) {
+  static const int pairs[3][2] = {{0, 1}, {0, 2}, {1, 2}};
+  real_t v[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+  const real_t epsilon = std::numeric_limits<real_t>::epsilon();
+
+  for (int sweep = 0; sweep < 16; ++sweep) {
+    real_t off = m[0][1] * m[0][1] + m[0][2] * m[0][2] + m[1][2] * m[1][2];
+    real_t diag = m[0][0] * m[0][0] + m[1][1] * m[1][1] + m[2][2] * m[2][2];
+    if (off <= epsilon * epsilon * diag) break;
+    for (int r = 0; r < 3; ++r) {
+      int p = pairs[r][0], q = pairs[r][1];
+      real_t apq = m[p][q];
+      if (apq == 0) continue;
+      real_t theta = (m[q][q] - m[p][p]) / (2 * apq);
+      real_t t = (theta >= 0 ? 1 : -1) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+      real_t c = 1 / std::sqrt(t * t + 1);
+      real_t s = t * c;
+      for (int k = 0; k < 3; ++k) {
+        real_t mkp = m[k][p], mkq = m[k][q];
+        m[k][p] = c * mkp - s * mkq;
+        m[k][q] = s * mkp + c * mkq;
+      }
+      for (int k = 0; k < 3; ++k) {
+        real_t mpk = m[p][k], mqk = m[q][k];
+        m[p][k] = c * mpk - s * mqk;
+        m[q][k] = s * mpk + c * mqk;
+      }
+      for (int k = 0; k < 3; ++k) {
+        real_t vkp = v[k][p], vkq = v[k][q];
+        v[k][p] = c * vkp - s * vkq;
+        v[k][q] = s * vkp + c * vkq;
+      }
+    }
+  }
+
+  int order[3] = {0, 1, 2};
+  if (m[order[0]][order[0]] < m[order[1]][order[1]]) std::swap(order[0], order[1]);
+  if (m[order[1]][order[1]] < m[order[2]][order[2]]) std::swap(order[1], order[2]);
+  if (m[order[0]][order[0]] < m[order[1]][order[1]]) std::swap(order[0], order[1]);
+  for (int i = 0; i < 3; ++i) {
+    values[i] = std::max<real_t>(0, m[order[i]][order[i]]);
+    vectors[i] = Vector3(v[0][order[i]], v[1][order[i]], v[2][order[i]]);
+  }
+}
+
+// Centroid and eigen decomposition of the covariance of a group of points, in one pass over the group.
+// Coordinates are taken relative to the first point of the group to limit cancellation.
+template<class Group>
+static size_t pointset_eigen(const Point3ArrayPtr points, const Group &group,
+                             Vector3 &center, real_t values[3], Vector3 vectors[3]) {
+  size_t nbpoints = group.size();
+  if (nbpoints == 0) {
+    center = Vector3::ORIGIN;
+    values[0] = values[1] = values[2] = 0;
+    vectors[0] = Vector3::OX; vectors[1] = Vector3::OY; vectors[2] = Vector3::OZ;
+    return 0;
+  }
+  const Vector3 &origin = points->getAt(*group.begin());
+  const real_t ox = origin.x(), oy = origin.y(), oz = origin.z();
+  real_t sx = 0, sy = 0, sz = 0, sxx = 0, sxy = 0, sxz = 0, syy = 0, syz = 0, szz = 0;
+  for (typename Group::const_iterator it = group.begin(); it != group.end(); ++it) {
+    const Vector3 &p = points->getAt(*it);
+    real_t x = p.x() - ox, y = p.y() - oy, z = p.z() - oz;
+    sx += x; sy += y; sz += z;
+    sxx += x * x; sxy += x * y; sxz += x * z;
+    syy += y * y; syz += y * z; szz += z * z;
+  }
+  real_t n = real_t(nbpoints);
+  real_t mx = sx / n, my = sy / n, mz = sz / n;
+  center = Vector3(ox + mx, oy + my, oz + mz);
+
+  real_t m[3][3];
+  m[0][0] = sxx / n - mx * mx;
+  m[1][1] = syy / n - my * my;
+  m[2][2] = szz / n - mz * mz;
+  m[0][1] = m[1][0] = sxy / n - mx * my;
+  m[0][2] = m[2][0] = sxz / n - mx * mz;
+  m[1][2] = m[2][1] = syz / n - my * mz;
+  symmetric_eigen3(m, values, vectors);
+  return nbpoints;
+}
+
+// Apply pointset_eigen on all groups in parallel and fill the features.
+template<class GroupArrayPtr>
+static PointSetFeatures groups_features(const Point3ArrayPtr points, const GroupArrayPtr groups) {
+  size_t nbgroups = groups->size();
+  PointSetFeatures result;
+  result.centers = Point3ArrayPtr(new Point3Array(nbgroups));
+  result.normals = Point3ArrayPtr(new Point3Array(nbgroups));
+  result.orientations = Point3ArrayPtr(new Point3Array(nbgroups));
+  result.eigenvalues = Point3ArrayPtr(new Point3Array(nbgroups));
+  result.linearity = RealArrayPtr(new RealArray(nbgroups, 0));
+  result.planarity = RealArrayPtr(new RealArray(nbgroups, 0));
+  result.scattering = RealArrayPtr(new RealArray(nbgroups, 0));
+  result.curvature = RealArrayPtr(new RealArray(nbgroups, 0));
+
+  parallel_for_range(0, nbgroups, [&](size_t begin, size_t end) {
+    Vector3 center;
+    real_t values[3];
+    Vector3 vectors[3];
+    for (size_t i = begin; i < end; ++i) {
+      pointset_eigen(points, groups->getAt(i), center, values, vectors);
+      result.centers->setAt(i, center);
+      result.normals->setAt(i, vectors[2]);
+      result.orientations->setAt(i, vectors[0]);
+      result.eigenvalues->setAt(i, Vector3(values[0], values[1], values[2]));
+      real_t sum = values[0] + values[1] + values[2];
+      if (values[0] > 0) {
+        result.linearity->setAt(i, (values[0] - values[1]) / values[0]);
+        result.planarity->setAt(i, (values[1] - values[2]) / values[0]);
+        result.scattering->setAt(i, values[2] / values[0]);
+        result.curvature->setAt(i, values[2] / sum);
+      }
+    }
+  });
+  return result;
+}
+
+PointSetFeatures
+PGL(pointsets_features)(const Point3ArrayPtr points, const IndexArrayPtr groups) {
+  return groups_features(points, groups);
+}
+
+PointSetFeatures
+PGL(pointsets_features)(const Point3ArrayPtr points, const CSRIndexArrayPtr groups) {
+  return groups_features(points, groups);
+}
+
+std::pair<Vector3, Vector3>
+PGL(pointset_plane)(const Point3ArrayPtr points, const Index &group) {
+  Vector3 center;
+  real_t values[3];
+  Vector3 vectors[3];
+  if (group.empty()) pointset_eigen(points, Index(range<Index>(points->size(), 0, 1)), center, values, vectors);
+  else pointset_eigen(points, group, center, values, vectors);
+  return std::pair<Vector3, Vector3>(center, vectors[2]);
+}
+
+Vector3
+PGL(pointset_orientation)(const Point3ArrayPtr points, const Index &group) {
+  Vector3 center;
+  real_t values[3];
+  Vector3 vectors[3];
+  if (group.empty()) pointset_eigen(points, Index(range<Index>(points->size(), 0, 1)), center, values, vectors);
+  else pointset_eigen(points, group, center, values, vectors);
+  return vectors[0];
+}
+
+Vector3
+PGL(pointset_normal)(const Point3ArrayPtr points, const Index &group) {
+  if (group.empty()) return Vector3::ORIGIN;
+  Vector3 center;
+  real_t values[3];
+  Vector3 vectors[3];
+  pointset_eigen(points, group, center, values, vectors);
+  return vectors[2];
+}
+
+Point3ArrayPtr
+PGL(pointsets_orientations)(const Point3ArrayPtr points, const IndexArrayPtr groups) {
+  return pointsets_features(points, groups).orientations;
+}
+
+Point3ArrayPtr
+PGL(pointsets_orientations)(const Point3ArrayPtr points, const CSRIndexArrayPtr groups) {
+  return pointsets_features(points, groups).orientations;
+}
+
+Point3ArrayPtr
+PGL(pointsets_normals)(const Point3ArrayPtr points, const IndexArrayPtr groups) {
+  return pointsets_features(points, groups).normals;
+}
+
+Point3ArrayPtr
+PGL(pointsets_normals)(const Point3ArrayPtr points, const CSRIndexArrayPtr groups) {
+  return pointsets_features(points, groups).normals;
+}
+
+/* ----------------------------------------------------------------------- */
+
 struct PointNormalDistance {
   const Point3ArrayPtr normals;
 
@@ -2080,7 +2408,7 @@ PGL(adaptive_contration)(const Point3ArrayPtr points,
                          const real_t beta) {
 
   RealArrayPtr radii = adaptive_radii(density, minradius, maxradius, densityradiusmap);
-  IndexArrayPtr neighborhoods = r_anisotropic_neighborhoods(points, adjacencies, radii, orientations, alpha, beta);
+  IndexArrayPtr neighborhoods = r_anisotropic_neighborhoods_mt(points, adjacencies, radii, orientations, alpha, beta);
   return centroids_of_groups(points, neighborhoods);
 }
 
@@ -3558,18 +3886,6 @@ PGL(pointset_angulardirections)(const Point3ArrayPtr points, const Vector3 &orig
   return result;
 }
 
-Point3ArrayPtr PGL(pointsets_orientations)(const Point3ArrayPtr points, const IndexArrayPtr groups) {
-  size_t nbPoints = points->size();
-  Point3ArrayPtr result(new Point3Array(nbPoints));
-
-  ProgressStatus st(nbPoints, "orientations computed for %.2f%% of points.");
-  IndexArray::const_iterator itNbrhd = groups->begin();
-  for (Point3Array::iterator itRes = result->begin(); itRes != result->end(); ++itRes, ++itNbrhd, ++st)
-    *itRes = pointset_orientation(points, *itNbrhd);
-
-  return result;
-}
-
 std::pair<uint32_t, real_t>
 PGL(findClosestFromSubset)(const Vector3 &origin, const Point3ArrayPtr points, const Index &group) {
   size_t nbpoints = group.size();
@@ -48,6 +48,7 @@
 #include <plantgl/tool/rcobject.h>
 #include <plantgl/algo/grid/regularpointgrid.h>
 #include <plantgl/scenegraph/container/indexarray.h>
+#include <plantgl/scenegraph/container/csrindexarray.h>
 #include <plantgl/scenegraph/function/function.h>
 #include <plantgl/scenegraph/scene/scene.h>
 #include <plantgl/scenegraph/geometry/pointset.h>
@@ -60,10 +61,9 @@
 PGL_BEGIN_NAMESPACE
 
 
-  template<class PointListType>
-  RCPtr<PointListType> contract_point(RCPtr<PointListType> points, real_t radius) {
+  template<class LocalPointGrid, class PointListType>
+  RCPtr<PointListType> contract_point_with_grid(RCPtr<PointListType> points, real_t radius) {
     typedef typename PointListType::element_type VectorType;
-    typedef PointRefGrid<PointListType> LocalPointGrid;
     typedef typename LocalPointGrid::PointIndexList PointIndexList;
 
     LocalPointGrid grid(radius, points);
@@ -86,6 +86,20 @@ PGL_BEGIN_NAMESPACE
     return result;
   }
 
+  template<class PointListType>
+  RCPtr<PointListType> contract_point(RCPtr<PointListType> points, real_t radius) {
+    typedef typename PointListType::element_type VectorType;
+    static const int NbDimension = Dimension<VectorType>::Nb;
+
+    // A dense grid with many more cells than points is replaced by a sparse one.
+    std::pair<VectorType,VectorType> bounds = points->getBounds();
+    real_t nbcells = 1;
+    for (size_t i = 0; i < NbDimension; ++i) nbcells *= (bounds.second[i] - bounds.first[i]) / radius + 1;
+    if (nbcells > 8 * real_t(points->size()))
+      return contract_point_with_grid<PointRefGrid<PointListType, NbDimension, SparsePointIndexContainer> >(points, radius);
+    return contract_point_with_grid<PointRefGrid<PointListType> >(points, radius);
+  }
+
   ALGO_API Color4ArrayPtr generate_point_color(PointSet &point);
 
   ALGO_API Index
@@ -178,6 +192,9 @@ PGL_BEGIN_NAMESPACE
   ALGO_API IndexArrayPtr
   r_neighborhoods_mt(const Point3ArrayPtr points, const IndexArrayPtr adjacencies, real_t radius, bool verbose = false);
 
+  ALGO_API IndexArrayPtr
+  r_neighborhoods_mt(const Point3ArrayPtr points, const IndexArrayPtr adjacencies, const RealArrayPtr radii);
+
   ALGO_API Index
   r_anisotropic_neighborhood(uint32_t pid, const Point3ArrayPtr points,
                              const IndexArrayPtr adjacencies,
@@ -201,6 +218,23 @@ PGL_BEGIN_NAMESPACE
                               const real_t alpha,
                               const real_t beta);
 
+/// Parallel versions of r_anisotropic_neighborhoods. Each thread reuses its own Dijkstra workspace.
+  ALGO_API IndexArrayPtr
+  r_anisotropic_neighborhoods_mt(const Point3ArrayPtr points,
+                                 const IndexArrayPtr adjacencies,
+                                 const RealArrayPtr radii,
+                                 const Point3ArrayPtr directions,
+                                 const real_t alpha,
+                                 const real_t beta);
+
+  ALGO_API IndexArrayPtr
+  r_anisotropic_neighborhoods_mt(const Point3ArrayPtr points,
+                                 const IndexArrayPtr adjacencies,
+                                 const real_t radius,
+                                 const Point3ArrayPtr directions,
+                                 const real_t alpha,
+                                 const real_t beta);
+
 /// Extended K-Neighborhood computation
   ALGO_API Index
   k_neighborhood(uint32_t pid, const Point3ArrayPtr points, const IndexArrayPtr adjacencies, const uint32_t k);
@@ -208,6 +242,25 @@ PGL_BEGIN_NAMESPACE
   ALGO_API IndexArrayPtr
   k_neighborhoods(const Point3ArrayPtr points, const IndexArrayPtr adjacencies, const uint32_t k);
 
+/// Neighborhood computation on adjacencies stored as CSRIndexArray. The _mt versions use several threads.
+  ALGO_API Index
+  r_neighborhood(uint32_t pid, const Point3ArrayPtr &points, const CSRIndexArrayPtr &adjacencies, const real_t radius);
+
+  ALGO_API CSRIndexArrayPtr
+  r_neighborhoods(const Point3ArrayPtr points, const CSRIndexArrayPtr adjacencies, real_t radius);
+
+  ALGO_API CSRIndexArrayPtr
+  r_neighborhoods_mt(const Point3ArrayPtr points, const CSRIndexArrayPtr adjacencies, real_t radius);
+
+  ALGO_API Index
+  k_neighborhood(uint32_t pid, const Point3ArrayPtr points, const CSRIndexArrayPtr adjacencies, const uint32_t k);
+
+  ALGO_API CSRIndexArrayPtr
+  k_neighborhoods(const Point3ArrayPtr points, const CSRIndexArrayPtr adjacencies, const uint32_t k);
+
+  ALGO_API CSRIndexArrayPtr
+  k_neighborhoods_mt(const Point3ArrayPtr points, const CSRIndexArrayPtr adjacencies, const uint32_t k);
+
 
 // Useful function
 
@@ -310,6 +363,20 @@ PGL_BEGIN_NAMESPACE
                                 const IndexArrayPtr adjacencies,
                                 const uint32_t k = 0);
 
+  ALGO_API RealArrayPtr
+  densities_from_r_neighborhood(const Point3ArrayPtr points,
+                                const CSRIndexArrayPtr adjacencies,
+                                const real_t radius);
+
+  ALGO_API RealArrayPtr
+  densities_from_r_neighborhood(const CSRIndexArrayPtr neighborhood,
+                                const real_t radius);
+
+  ALGO_API RealArrayPtr
+  densities_from_k_neighborhood(const Point3ArrayPtr points,
+                                const CSRIndexArrayPtr adjacencies,
+                                const uint32_t k = 0);
+
 
 
 /// Orientation estimations
@@ -329,6 +396,31 @@ PGL_BEGIN_NAMESPACE
   ALGO_API Point3ArrayPtr
   pointsets_normals(const Point3ArrayPtr points, const IndexArrayPtr groups);
 
+  ALGO_API Point3ArrayPtr
+  pointsets_orientations(const Point3ArrayPtr points, const CSRIndexArrayPtr groups);
+
+  ALGO_API Point3ArrayPtr
+  pointsets_normals(const Point3ArrayPtr points, const CSRIndexArrayPtr groups);
+
+/// Local shape features of groups of points, from the eigen values l1 >= l2 >= l3 of their covariance.
+  struct PointSetFeatures {
+    Point3ArrayPtr centers;       ///< centroid of each group
+    Point3ArrayPtr normals;       ///< unit eigen vector of l3 (arbitrary sign)
+    Point3ArrayPtr orientations;  ///< unit eigen vector of l1 (arbitrary sign)
+    Point3ArrayPtr eigenvalues;   ///< (l1, l2, l3)
+    RealArrayPtr linearity;       ///< (l1 - l2) / l1
+    RealArrayPtr planarity;       ///< (l2 - l3) / l1
+    RealArrayPtr scattering;      ///< l3 / l1
+    RealArrayPtr curvature;       ///< surface variation l3 / (l1 + l2 + l3)
+  };
+
+/// Compute covariance features of all groups in parallel. Does not require CGAL.
+  ALGO_API PointSetFeatures
+  pointsets_features(const Point3ArrayPtr points, const IndexArrayPtr groups);
+
+  ALGO_API PointSetFeatures
+  pointsets_features(const Point3ArrayPtr points, const CSRIndexArrayPtr groups);
+
 
   ALGO_API Point3ArrayPtr
   pointsets_orient_normals(const Point3ArrayPtr normals, const Point3ArrayPtr points, const IndexArrayPtr riemanian);
@@ -179,64 +179,6 @@ PGL::delaunay_triangulation(const Point3ArrayPtr points) {
 
 #endif
 
-std::pair<Vector3, Vector3> PGL::pointset_plane(const Point3ArrayPtr points, const Index &group) {
-#ifdef PGL_WITH_CGAL
-  typedef CGAL::Cartesian<real_t> CK;
-  typedef CK::Point_3 CPoint;
-  typedef CK::Plane_3 CPlane;
-
-  std::list<CPoint> pointdata;
-  if (!group.empty())
-    pointdata = toPoint3List<CPoint>(points, group);
-  else
-
-    pointdata = toPoint3List<CPoint>(points);
-
-  CPlane plane;
-  CPoint center;
-  linear_least_squares_fitting_3(pointdata.begin(), pointdata.end(), plane, center, CGAL::Dimension_tag<0>());
-
-  Vector3 p = toVector3(center);
-  Vector3 dir = dir2Vector3(plane.orthogonal_direction());
-  return std::pair<Vector3, Vector3>(p, dir);
-#else
-#ifdef _MSC_VER
-#pragma message("function 'pointset_plane' disabled. CGAL needed.")
-#else
-#warning "function 'pointset_plane' disabled. CGAL needed"
-#endif
-
-  return std::pair<Vector3, Vector3>(Vector3(0,0,0), Vector3(0,0,0));
-#endif
-}
-
-Vector3 PGL::pointset_orientation(const Point3ArrayPtr points, const Index &group) {
-#ifdef PGL_WITH_CGAL
-  typedef CGAL::Cartesian<real_t> CK;
-  typedef CK::Point_3 CPoint;
-  typedef CK::Line_3 CLine;
-
-  std::list<CPoint> pointdata;
-  if (!group.empty())
-    pointdata = toPoint3List<CPoint>(points, group);
-  else
-    pointdata = toPoint3List<CPoint>(points);
-
-  CLine line;
-  linear_least_squares_fitting_3(pointdata.begin(), pointdata.end(), line, CGAL::Dimension_tag<0>());
-
-  return toVector3(line.to_vector());
-#else
-#ifdef _MSC_VER
-#pragma message("function 'pointset_orientation' disabled. CGAL needed.")
-#else
-#warning "function 'pointset_orientation' disabled. CGAL needed"
-#endif
-
-  return Vector3(0,0,0);
-#endif
-}
-
 ALGO_API Vector3
 PGL::triangleset_orientation(const Point3ArrayPtr points, const Index3ArrayPtr triangles) {
 #ifdef PGL_WITH_CGAL
@@ -330,43 +272,6 @@ PGL::principal_curvatures(const Point3ArrayPtr points, const IndexArrayPtr adjac
 
 }
 
-Vector3 PGL::pointset_normal(const Point3ArrayPtr points, const Index &group) {
-#ifdef PGL_WITH_CGAL
-  typedef CGAL::Cartesian<real_t> CK;
-  typedef CK::Point_3 CPoint;
-  typedef CK::Plane_3 CPlane;
-
-  std::list<CPoint> pointdata;
-  // for (Point3Array::const_iterator it = points->begin(); it != points->end() ; ++it)
-  for (Index::const_iterator it = group.begin(); it != group.end(); ++it)
-    pointdata.push_back(toPoint3<CPoint>(points->getAt(*it)));
-
-  CPlane plane;
-  linear_least_squares_fitting_3(pointdata.begin(), pointdata.end(), plane, CGAL::Dimension_tag<0>());
-
-  return dir2Vector3(plane.orthogonal_direction());
-#else
-#ifdef _MSC_VER
-#pragma message("function 'pointset_normal' disabled. CGAL needed.")
-#else
-#warning "function 'pointset_normal' disabled. CGAL needed"
-#endif
-
-  return Vector3(0,0,0);
-#endif
-}
-
-Point3ArrayPtr
-PGL::pointsets_normals(const Point3ArrayPtr points, const IndexArrayPtr groups) {
-  Point3ArrayPtr result(new Point3Array(points->size()));
-  uint32_t i = 0;
-  for (IndexArray::const_iterator it = groups->begin(); it != groups->end(); ++it, ++i) {
-    result->setAt(i, pointset_normal(points, *it));
-  }
-  return result;
-}
-
-
 real_t mean_over(const Point3ArrayPtr points, const Index &section, int i) {
   real_t v = 0;
   for (Index::const_iterator it = section.begin(); it != section.end(); ++it)
@@ -45,6 +45,7 @@
 
 #include "surfcomputer.h"
 #include "discretizer.h"
+#include <deque>
 
 #include <plantgl/pgl_scene.h>
 #include <plantgl/pgl_geometry.h>
@@ -655,6 +656,64 @@ real_t PGL(sceneSurface)(const Scene& scene){
 
 /* ----------------------------------------------------------------------- */
 
+/// A SurfComputer summing the surfaces of the top level shapes it processes.
+class SurfAccumulator : public SurfComputer {
+public:
+  SurfAccumulator(Discretizer& discretizer) : SurfComputer(discretizer), __total(0), __depth(0) {}
+
+  using SurfComputer::process;
+
+  virtual bool process(Shape * shape) {
+    ++__depth;
+    bool b = SurfComputer::process(shape);
+    return accumulate(b);
+  }
+
+  virtual bool process(Inline * geomInline) {
+    ++__depth;
+    bool b = SurfComputer::process(geomInline);
+    return accumulate(b);
+  }
+
+  real_t __total;
+
+protected:
+  bool accumulate(bool b) {
+    // shapes of inline scenes are already accounted in the inline result
+    if (--__depth == 0 && b) __total += __result;
+    return b;
+  }
+
+  uint_t __depth;
+};
+
+class ParallelSurfComputer : public ParallelAction {
+public:
+  ParallelSurfComputer() : __total(0) {}
+
+  virtual Action * createAction() {
+    __discretizers.emplace_back();
+    return new SurfAccumulator(__discretizers.back());
+  }
+
+  virtual bool reduce(Action& action) {
+    __total += static_cast<SurfAccumulator&>(action).__total;
+    return true;
+  }
+
+  real_t __total;
+  std::deque<Discretizer> __discretizers;
+};
+
+real_t PGL(parallelSceneSurface)(const ScenePtr scene, uint_t grainsize){
+  if (!scene) return 0;
+  ParallelSurfComputer _sfc;
+  scene->applyParallel(_sfc, grainsize);
+  return _sfc.__total;
+}
+
+/* ----------------------------------------------------------------------- */
+
 bool SurfComputer::process( Material * material ) {
   GEOM_ASSERT(material);
   // nothing to do
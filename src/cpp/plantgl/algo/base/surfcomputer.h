@@ -235,6 +235,9 @@ static inline real_t surface(const Vector2& i, const Vector2& j, const Vector2&
 real_t ALGO_API sceneSurface(const ScenePtr scene);
 real_t ALGO_API sceneSurface(const Scene& scene);
 
+/// Compute the surface of the objects in the scene \e _scene with several threads
+real_t ALGO_API parallelSceneSurface(const ScenePtr scene, uint_t grainsize = 0);
+
 /* ------------------------------------------------------------------------- */
 
 // __actn_surfcomputer_h__
@@ -71,17 +71,14 @@ using namespace std;
 
 #define GEOM_TESSELATOR_CHECK_CACHE(geom) \
 if(!geom->unique()){ \
-  Cache<ExplicitModelPtr>::Iterator _it = __cache.find(geom->getObjectId()); \
-  if (! (_it == __cache.end())) { \
-    __discretization = _it->second; \
-    return true; \
-  }} else __discretization= ExplicitModelPtr();
+  if (cache_find(geom)) return true; \
+  } else __discretization= ExplicitModelPtr();
 
 
 #define GEOM_TESSELATOR_UPDATE_CACHE(geom) \
 if(!geom->unique()){ \
   if(geom->isNamed())__discretization->setName(geom->getName()); \
-  __cache.insert(geom->getObjectId(),__discretization); \
+  cache_insert(geom); \
 }
 
 
@@ -90,6 +87,8 @@ if(!geom->unique()){ \
 
 Tesselator::Tesselator( ) :
   Discretizer() {
+  // triangulations are not interchangeable with discretizations in a shared cache
+  __cacheKind = 1;
 }
 
 Tesselator::~Tesselator( )
@@ -368,7 +367,7 @@ bool Tesselator::process( Extrusion * extrusion ){
     d.process(extrusion);
     if(d.getDiscretization()){
       d.getDiscretization()->apply(*this);
-      __cache.remove(d.getDiscretization()->getObjectId());
+      cache_remove(d.getDiscretization().get());
     }
     GEOM_TESSELATOR_UPDATE_CACHE(extrusion);
     return true;
@@ -623,12 +622,10 @@ bool Tesselator::process( NurbsPatch * nurbsPatch ) {
   const real_t _vStride1 = nurbsPatch->getVStride() - 1;
 
 
-  Point3ArrayPtr _pointList(new Point3Array(_uStride * _vStride));
   Index3ArrayPtr _indexList(new Index3Array(2 * (_uStride - 1) * (_vStride - 1)));
 
   uint_t _cur = 0;
 
-  uint_t _pointCount = 0;
   uint_t _indexCount = 0;
   real_t _ufirst=nurbsPatch->getFirstUKnot();
   real_t _ulast=nurbsPatch->getLastUKnot();
@@ -637,15 +634,24 @@ bool Tesselator::process( NurbsPatch * nurbsPatch ) {
   real_t _vlast=nurbsPatch->getLastVKnot();
   real_t _vinter=_vlast-_vfirst;
 
-  for ( real_t _u = 0 ; _u < _uStride1 ; _u ++){
+  RealArrayPtr _uParams(new RealArray(_uStride));
+  RealArrayPtr _vParams(new RealArray(_vStride));
 
-    for (real_t _v = 0; _v < _vStride1; _v ++) {
+  uint_t _uCount = 0;
+  for ( real_t _u = 0 ; _u < _uStride1 ; _u ++)
+    _uParams->setAt(_uCount++, _ufirst + (_u * _uinter) / _uStride1);
+  _uParams->setAt(_uCount, _ulast);
 
-      _pointList->setAt(_pointCount++,
-                        nurbsPatch->getPointAt((_ufirst +
-                                                (_u * _uinter) / _uStride1),
-                                               (_vfirst +
-                                                (_v * _vinter) / _vStride1)));
+  uint_t _vCount = 0;
+  for (real_t _v = 0; _v < _vStride1; _v ++)
+    _vParams->setAt(_vCount++, _vfirst + (_v * _vinter) / _vStride1);
+  _vParams->setAt(_vCount, _vlast);
+
+  // The whole grid of points is computed in one pass.
+  Point3ArrayPtr _pointList = nurbsPatch->evaluate(_uParams,_vParams);
+
+  for ( uint_t _i = 0 ; _i < _uCount ; ++_i){
+    for (uint_t _j = 0; _j < _vCount; ++_j) {
 
       _indexList->setAt(_indexCount++,
                         Index3(_cur,
@@ -659,21 +665,10 @@ bool Tesselator::process( NurbsPatch * nurbsPatch ) {
       _cur++;
     };
 
-    _pointList->setAt(_pointCount++,
-                      nurbsPatch->getPointAt((_u / _uStride1),_vlast));
-
     _cur++;
 
   };
 
-  for (real_t _v = 0; _v < _vStride1; _v ++)
-      _pointList->setAt(_pointCount++,
-                        nurbsPatch->getPointAt(_ulast,
-                                               (_vfirst +
-                                                (_v * _vinter) / _vStride1)));
-
-  _pointList->setAt(_pointCount,nurbsPatch->getPointAt(_ulast,_vlast));
-
   PolylinePtr _skeleton(new Polyline(Vector3(0,0,0),
                                      Vector3(0,0,0)));
 
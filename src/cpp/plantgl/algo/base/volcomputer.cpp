@@ -44,6 +44,7 @@
 
 #include "volcomputer.h"
 #include "discretizer.h"
+#include <deque>
 
 #include <plantgl/pgl_scene.h>
 #include <plantgl/pgl_geometry.h>
@@ -615,6 +616,64 @@ real_t PGL(sceneVolume)(const Scene& scene){
 
 /* ----------------------------------------------------------------------- */
 
+/// A VolComputer summing the volumes of the top level shapes it processes.
+class VolAccumulator : public VolComputer {
+public:
+  VolAccumulator(Discretizer& discretizer) : VolComputer(discretizer), __total(0), __depth(0) {}
+
+  using VolComputer::process;
+
+  virtual bool process(Shape * shape) {
+    ++__depth;
+    bool b = VolComputer::process(shape);
+    return accumulate(b);
+  }
+
+  virtual bool process(Inline * geomInline) {
+    ++__depth;
+    bool b = VolComputer::process(geomInline);
+    return accumulate(b);
+  }
+
+  real_t __total;
+
+protected:
+  bool accumulate(bool b) {
+    // shapes of inline scenes are already accounted in the inline result
+    if (--__depth == 0 && b) __total += __result;
+    return b;
+  }
+
+  uint_t __depth;
+};
+
+class ParallelVolComputer : public ParallelAction {
+public:
+  ParallelVolComputer() : __total(0) {}
+
+  virtual Action * createAction() {
+    __discretizers.emplace_back();
+    return new VolAccumulator(__discretizers.back());
+  }
+
+  virtual bool reduce(Action& action) {
+    __total += static_cast<VolAccumulator&>(action).__total;
+    return true;
+  }
+
+  real_t __total;
+  std::deque<Discretizer> __discretizers;
+};
+
+real_t PGL(parallelSceneVolume)(const ScenePtr scene, uint_t grainsize){
+  if (!scene) return 0;
+  ParallelVolComputer _sfc;
+  scene->applyParallel(_sfc, grainsize);
+  return _sfc.__total;
+}
+
+/* ----------------------------------------------------------------------- */
+
 bool VolComputer::process( Material * material ) {
   GEOM_ASSERT(material);
   // nothing to do
@@ -179,6 +179,9 @@ real_t ALGO_API sceneVolume(const ScenePtr scene);
 
 real_t ALGO_API sceneVolume(const Scene& scene);
 
+/// Compute the volume of the objects in the scene \e _scene with several threads
+real_t ALGO_API parallelSceneVolume(const ScenePtr scene, uint_t grainsize = 0);
+
 /* ------------------------------------------------------------------------- */
 
 // __actn_surfcomputer_h__
@@ -0,0 +1,153 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+/*! \file binaryblock.h
+    \brief Raw array blocks of the GEOM binary format (version 3.0 and above).
+
+    From version 3.0, arrays of fixed-size elements are written as one block:
+    the element count, a codec byte, for compressed blocks the compressed size
+    on two uint32, a padding byte and that many zero bytes so that the payload
+    starts on an 8-byte boundary, then the payload. The payload holds the
+    components of all elements in the native byte order of the writer (given in
+    the file header) and, for reals, in the precision of the file.
+    Arrays of variable-size indices are written as a block of sizes followed by
+    a block of the concatenated indices.
+*/
+
+#ifndef __binaryblock_h__
+#define __binaryblock_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include "codec_config.h"
+#include <plantgl/math/util_vector.h>
+#include <plantgl/scenegraph/appearance/color.h>
+#include <plantgl/scenegraph/container/indexarray.h>
+#include <type_traits>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/// Encoding of the payload of a block.
+enum BinaryBlockCodec {
+    eRawBlock = 0,
+    eZlibBlock = 1
+};
+
+/// Alignment of the payload of a block relative to the beginning of the stream.
+const size_t BINARY_BLOCK_ALIGNMENT = 8;
+
+/// Blocks smaller than this are never compressed.
+const size_t BINARY_BLOCK_MIN_COMPRESSION = 256;
+
+/// Arrays whose elements are written one by one.
+struct BinaryElementTag {};
+
+/// Arrays of elements made of a fixed number of scalars, written as one block.
+struct BinaryRawTag {};
+
+/// Arrays of variable-size indices, written as a block of sizes and a block of values.
+struct BinaryRaggedTag {};
+
+/* ----------------------------------------------------------------------- */
+
+/// Describes how the elements of an array are stored in the binary format.
+template<class T>
+struct BinaryBlockTraits {
+    typedef BinaryElementTag Category;
+};
+
+#define PGL_DECLARE_BINARY_BLOCK_TUPLE(T,S,N) \
+template<> \
+struct BinaryBlockTraits<T> { \
+    typedef BinaryRawTag Category; \
+    typedef S Scalar; \
+    static const size_t Size = N; \
+    static inline const S * components(const T& value) { return value.data(); } \
+    static inline S * components(T& value) { return value.data(); } \
+};
+
+#define PGL_DECLARE_BINARY_BLOCK_SCALAR(T) \
+template<> \
+struct BinaryBlockTraits<T> { \
+    typedef BinaryRawTag Category; \
+    typedef T Scalar; \
+    static const size_t Size = 1; \
+    static inline const T * components(const T& value) { return &value; } \
+    static inline T * components(T& value) { return &value; } \
+};
+
+PGL_DECLARE_BINARY_BLOCK_TUPLE(Vector2,real_t,2)
+PGL_DECLARE_BINARY_BLOCK_TUPLE(Vector3,real_t,3)
+PGL_DECLARE_BINARY_BLOCK_TUPLE(Vector4,real_t,4)
+PGL_DECLARE_BINARY_BLOCK_TUPLE(Color3,uchar_t,3)
+PGL_DECLARE_BINARY_BLOCK_TUPLE(Color4,uchar_t,4)
+PGL_DECLARE_BINARY_BLOCK_TUPLE(Index3,uint_t,3)
+PGL_DECLARE_BINARY_BLOCK_TUPLE(Index4,uint_t,4)
+PGL_DECLARE_BINARY_BLOCK_SCALAR(real_t)
+PGL_DECLARE_BINARY_BLOCK_SCALAR(uint_t)
+
+#undef PGL_DECLARE_BINARY_BLOCK_TUPLE
+#undef PGL_DECLARE_BINARY_BLOCK_SCALAR
+
+template<>
+struct BinaryBlockTraits<Index> {
+    typedef BinaryRaggedTag Category;
+};
+
+/// Whether the components of an array of \e T can be copied at once as an array of \e FileScalar.
+template<class T, class FileScalar>
+inline bool isBinaryBlockPacked() {
+    typedef BinaryBlockTraits<T> Traits;
+    return std::is_same<typename Traits::Scalar, FileScalar>::value &&
+           sizeof(T) == Traits::Size * sizeof(FileScalar);
+}
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#endif
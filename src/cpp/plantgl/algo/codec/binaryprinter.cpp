@@ -43,6 +43,7 @@
 #include <plantgl/tool/dirnames.h>
 #include <plantgl/tool/bfstream.h>
 #include <plantgl/tool/util_enviro.h>
+#include <plantgl/tool/util_profile.h>
 
 
 #include "binaryprinter.h"
@@ -55,6 +56,8 @@
 #include <plantgl/pgl_container.h>
 
 #include <plantgl/algo/base/statisticcomputer.h>
+#include <zlib.h>
+#include <limits>
 
 PGL_USING_NAMESPACE
 
@@ -492,16 +495,17 @@ void BinaryPrinter::write(const Matrix4& val) {
 
 /* ----------------------------------------------------------------------- */
 
-const float BinaryPrinter::BINARY_FORMAT_VERSION(2.5f);
+const float BinaryPrinter::BINARY_FORMAT_VERSION(3.0f);
 
 /* ----------------------------------------------------------------------- */
 
 
-BinaryPrinter::BinaryPrinter( std::ostream& outputStream, bool double_precision  ) :
+BinaryPrinter::BinaryPrinter( std::ostream& outputStream, bool double_precision, bool compressed ) :
   Printer(outputStream,outputStream,outputStream),
   __outputStream(outputStream, PglLittleEndian),
   __tokens(BINARY_FORMAT_VERSION),
-  __double_precision(double_precision){
+  __double_precision(double_precision),
+  __compressed(compressed){
 }
 
 BinaryPrinter::~BinaryPrinter( ) {
@@ -570,16 +574,47 @@ void BinaryPrinter::writeFile(const std::string& var)
 
 void BinaryPrinter::writeTransform4(const Transform4Ptr& var) 
 {  write(var->getMatrix( )); }
+
+/// write a raw block of data
+void BinaryPrinter::writeBlock(const char * data, size_t size)
+{
+    uchar_t codec = eRawBlock;
+    std::vector<Bytef> compressed;
+    if (__compressed && size >= BINARY_BLOCK_MIN_COMPRESSION && size <= size_t(std::numeric_limits<uLong>::max())) {
+        uLongf csize = compressBound(uLong(size));
+        compressed.resize(csize);
+        if (compress2(compressed.data(), &csize, (const Bytef *)data, uLong(size), Z_BEST_SPEED) == Z_OK && csize < size) {
+            codec = eZlibBlock;
+            data = (const char *)compressed.data();
+            size = csize;
+        }
+    }
+    PGL_PROFILE_COUNT("bgeom.block_bytes_written", size);
+    writeUchar(codec);
+    if (codec == eZlibBlock) {
+        uint64_t csize = size;
+        writeUint32(uint32_t(csize & 0xffffffff));
+        writeUint32(uint32_t(csize >> 32));
+    }
+    // padding so that the payload is aligned. Unknown positions are not padded.
+    uchar_t pad = 0;
+    std::streamoff pos = __outputStream.getStream().tellp();
+    if (pos >= 0) pad = uchar_t((BINARY_BLOCK_ALIGNMENT - size_t(pos + 1) % BINARY_BLOCK_ALIGNMENT) % BINARY_BLOCK_ALIGNMENT);
+    writeUchar(pad);
+    static const char zeros[BINARY_BLOCK_ALIGNMENT] = { 0 };
+    if (pad > 0) __outputStream.write(zeros, pad);
+    if (size > 0) __outputStream.write(data, size);
+}
  
 
 /* ----------------------------------------------------------------------- */
-bool BinaryPrinter::print(ScenePtr scene,string filename,const char * comment){
+bool BinaryPrinter::print(ScenePtr scene,string filename,const char * comment, bool compressed){
     std::ofstream stream(filename.c_str(), std::ios::out | std::ios::binary);
     if(!stream)return false;
     else {
         string cwd = get_cwd();
         chg_dir(get_dirname(filename));
-        BinaryPrinter _bp(stream);
+        BinaryPrinter _bp(stream, true, compressed);
         _bp.print(scene,comment);
         chg_dir(cwd);
         return true;
@@ -588,16 +623,17 @@ bool BinaryPrinter::print(ScenePtr scene,string filename,const char * comment){
 
 #include <sstream>
 
-std::string BinaryPrinter::tobinarystring(ScenePtr scene, bool double_precision, const char * comment)
+std::string BinaryPrinter::tobinarystring(ScenePtr scene, bool double_precision, const char * comment, bool compressed)
 {
     std::ostringstream _mystream;
-    BinaryPrinter _bp(_mystream, double_precision);
+    BinaryPrinter _bp(_mystream, double_precision, compressed);
     _bp.print(scene,comment);
     return _mystream.str();
 }
 
 
 bool BinaryPrinter::print(ScenePtr scene,const char * comment){
+    PGL_PROFILE_ZONE("BinaryPrinter::print");
     header(comment);
     StatisticComputer _sc;
     scene->apply(_sc);
@@ -632,6 +668,14 @@ bool BinaryPrinter::header(const char * comment){
 #endif
     // std::cerr << "Assume "<< (precision==32?"simple":"double")<< " precision." << std::endl;
     writeUchar(precision);
+  }
+  if(__tokens.getVersion() >= 3.0f){
+    // byte order of the array blocks
+#if __BYTE_ORDER == __BIG_ENDIAN
+    writeUchar(1);
+#else
+    writeUchar(0);
+#endif
   }
     __outputStream << '#';
     __outputStream << ( comment ? string(comment) : string("a GEOM binary File") ) << '#' ;
@@ -50,6 +50,7 @@
 #define __actn_binaryprinter_h__
 
 #include "printer.h"
+#include "binaryblock.h"
 #include <plantgl/tool/rcobject.h>
 #include <plantgl/tool/bfstream.h>
 
@@ -149,7 +150,7 @@ public:
   static const float BINARY_FORMAT_VERSION;
 
   /** Constructs a Printer with the output streams \e outputStream. */
-  BinaryPrinter( std::ostream& outputStream, bool double_precision = true);
+  BinaryPrinter( std::ostream& outputStream, bool double_precision = true, bool compressed = false);
 
   /// Destructor
   virtual ~BinaryPrinter( );
@@ -285,9 +286,13 @@ public:
   static std::string getCanonicalFilename(const std::string&);
 
   /// Print the scene \e scene in the file \e filename in binary format.
-  static bool print(ScenePtr scene,std::string filename,const char * comment = NULL);
+  static bool print(ScenePtr scene,std::string filename,const char * comment = NULL, bool compressed = false);
 
-  static std::string tobinarystring(ScenePtr scene, bool double_precision = true, const char * comment = NULL);
+  static std::string tobinarystring(ScenePtr scene, bool double_precision = true, const char * comment = NULL, bool compressed = false);
+
+  /// Enable zlib compression of the array blocks.
+  void setCompressed(bool compressed) { __compressed = compressed; }
+  bool isCompressed() const { return __compressed; }
 
 //private :
 
@@ -350,6 +355,11 @@ public:
 
   template<class Array>
   void writeArray(const Array& array){
+    writeArray(array, typename BinaryBlockTraits<typename Array::element_type>::Category());
+  }
+
+  template<class Array>
+  void writeArray(const Array& array, BinaryElementTag){
     uint_t _sizei = array.size();
     writeUint32(_sizei);
     for (typename Array::const_iterator it = array.begin(); it != array.end(); ++it) {
@@ -357,6 +367,68 @@ public:
     };
   }
 
+  template<class Array>
+  void writeArray(const Array& array, BinaryRawTag){
+    typedef typename BinaryBlockTraits<typename Array::element_type>::Scalar Scalar;
+    uint_t _sizei = array.size();
+    writeUint32(_sizei);
+    if (_sizei > 0) writeArrayBlock(array, (const Scalar *)NULL);
+  }
+
+  template<class Array>
+  void writeArray(const Array& array, BinaryRaggedTag){
+    uint_t _sizei = array.size();
+    writeUint32(_sizei);
+    if (_sizei == 0) return;
+    std::vector<uint32_t> _sizes(_sizei);
+    std::vector<uint32_t>::iterator _itsize = _sizes.begin();
+    size_t _total = 0;
+    for (typename Array::const_iterator it = array.begin(); it != array.end(); ++it, ++_itsize) {
+      *_itsize = it->size();
+      _total += it->size();
+    }
+    std::vector<uint32_t> _values;
+    _values.reserve(_total);
+    for (typename Array::const_iterator it = array.begin(); it != array.end(); ++it)
+      _values.insert(_values.end(), it->begin(), it->end());
+    writeBlock((const char *)_sizes.data(), _sizes.size() * sizeof(uint32_t));
+    writeBlock((const char *)_values.data(), _values.size() * sizeof(uint32_t));
+  }
+
+  /// write the components of \e array as a block of scalars of the type of the file.
+  template<class Array, class Scalar>
+  void writeArrayBlock(const Array& array, const Scalar *){
+    writeScalarBlock<Scalar>(array);
+  }
+
+  template<class Array>
+  void writeArrayBlock(const Array& array, const real_t *){
+    if (__double_precision) writeScalarBlock<double>(array);
+    else writeScalarBlock<float>(array);
+  }
+
+  template<class FileScalar, class Array>
+  void writeScalarBlock(const Array& array){
+    typedef typename Array::element_type Element;
+    typedef BinaryBlockTraits<Element> Traits;
+    const size_t _nbscalars = array.size() * Traits::Size;
+    if (isBinaryBlockPacked<Element, FileScalar>()) {
+      writeBlock((const char *)&*array.begin(), _nbscalars * sizeof(FileScalar));
+    }
+    else {
+      std::vector<FileScalar> _buffer(_nbscalars);
+      typename std::vector<FileScalar>::iterator _itb = _buffer.begin();
+      for (typename Array::const_iterator it = array.begin(); it != array.end(); ++it) {
+        const typename Traits::Scalar * _c = Traits::components(*it);
+        for (size_t _k = 0; _k < Traits::Size; ++_k, ++_itb) *_itb = FileScalar(_c[_k]);
+      }
+      writeBlock((const char *)_buffer.data(), _nbscalars * sizeof(FileScalar));
+    }
+  }
+
+  /// write \e size bytes of \e data as a block, compressed if enabled and worth it.
+  void writeBlock(const char * data, size_t size);
+
   template<class Array>
   void dumpArray(const Array& array){
       writeString(PglClassInfo<Array>::name());
@@ -392,6 +464,8 @@ protected:
   TokenCode __tokens;
 
   bool __double_precision;
+
+  bool __compressed;
 };
 
 
@@ -42,15 +42,7 @@
 #define __cdc_ply_h__
 
 #include "codec_config.h"
-#include <plantgl/tool/util_string.h>
 #include <plantgl/scenegraph/scene/factory.h>
-#include <iostream>
-#include <fstream>
-#include <map>
-#include <boost/variant.hpp>
-#include <plantgl/scenegraph/container/colorarray.h>
-#include <plantgl/scenegraph/container/indexarray.h>
-#include <plantgl/tool/util_hashmap.h>
 
 /* ----------------------------------------------------------------------- */
 
@@ -58,126 +50,8 @@ PGL_BEGIN_NAMESPACE
 
 /* ----------------------------------------------------------------------- */
 
+  /// Ply codec. Reading and writing are done with PlyFileReader and PlyFileWriter.
   class CODEC_API PlyCodec : public SceneCodec {
-    typedef boost::variant<float, int, uint_t, char, uchar_t, short, uint16_t, double> propertyType;
-
-    struct SizeVisitor : public boost::static_visitor<> {
-      SizeVisitor()
-              : size(0) {
-      }
-
-      template<typename T>
-      void operator()(T &x) const {
-        this->size = sizeof(x);
-      }
-
-      std::size_t get_size() const {
-        return size;
-      }
-
-    private:
-      mutable std::size_t size;
-    };
-
-    struct ReadVisitor : public boost::static_visitor<> {
-      ReadVisitor(const std::string &str)
-              : str(str) {
-      }
-
-      template<typename T>
-      void operator()(T &x) const {
-        this->value = toNumber<T>(this->str);
-      }
-
-      propertyType get_value() const {
-        return value;
-      }
-
-    private:
-      mutable propertyType value;
-      const std::string str;
-    };
-
-    struct ReinterpretVisitor : public boost::static_visitor<> {
-      ReinterpretVisitor(const char *value)
-              : value(value) {
-      }
-
-      template<typename T>
-      void operator()(T &) const {
-        res = *(T *) (this->value);
-      }
-
-      propertyType get_res() const {
-        return res;
-      }
-
-    private:
-      mutable propertyType res;
-      const char *value;
-    };
-
-    template<typename U>
-    struct GetVisitor : public boost::static_visitor<> {
-      GetVisitor() {
-      }
-
-      template<typename T>
-      void operator()(T &x) const {
-        value = (U) x;
-      }
-
-      U get_value() const {
-        return value;
-      }
-
-    private:
-      mutable U value;
-    };
-
-    struct PropertyElement {
-      const bool isList;
-      const std::string name;
-      const std::string type;
-      const std::string sizetype;
-
-      PropertyElement(const std::string &name, const std::string &type)
-              : isList(false), name(name), type(type) {
-      }
-
-      PropertyElement(const std::string &name, const std::string &sizetype, const std::string &type)
-              : isList(true), name(name), type(type), sizetype(sizetype) {
-      }
-
-      PropertyElement(const PropertyElement &propertyElement)
-              : isList(propertyElement.isList), name(propertyElement.name), type(propertyElement.type), sizetype(propertyElement.sizetype) {
-      }
-
-      PropertyElement &operator=(const PropertyElement &propertyElement) {
-        return *this;
-      }
-    };
-
-    struct SpecElement {
-      std::size_t number;
-      std::vector<PropertyElement> properties;
-
-      SpecElement(const std::size_t &number = 0)
-              : number(number) {
-      }
-
-      SpecElement(const SpecElement &specElement)
-              : number(specElement.number), properties(specElement.properties) {
-      }
-
-      SpecElement &operator=(const SpecElement &specElement) {
-        this->properties = specElement.properties;
-        this->number = specElement.number;
-
-        return *this;
-      }
-    };
-
   public:
     PlyCodec();
 
@@ -186,55 +60,6 @@ PGL_BEGIN_NAMESPACE
     virtual ScenePtr read(const std::string &fname);
 
     virtual bool write(const std::string &fname, const ScenePtr &scene);
-
-  private:
-	struct FormatInfos
-	{
-		std::string keyword;
-		std::string coding;
-		float version;
-	};
-
-	ScenePtr readScene(std::string const &fname);
-
-	void parseAsciiValue(std::ifstream& file, std::map<std::string, SpecElement>::const_iterator const &it, pgl_hash_map_string<std::vector<propertyType> > &element);
-
-	void parseBinaryValue(std::ifstream& file, std::map<std::string, SpecElement>::const_iterator const &it, pgl_hash_map_string<std::vector<propertyType> > &element);
-
-	void parseVertex(std::size_t i, pgl_hash_map_string<std::vector<propertyType> > &element, Point3ArrayPtr const points, Color4ArrayPtr const colors);
-
-	void parseFace(std::size_t i, pgl_hash_map_string<std::vector<propertyType> > const &element, IndexArrayPtr const faces);
-
-	std::ifstream openFile(std::string const &path) const;
-
-	FormatInfos parseFormatInfos(std::ifstream &file) const;
-
-	std::map<std::string, SpecElement> parseHeader(std::ifstream &file, FormatInfos const &format) const;
-
-	std::string parseHeaderElement(std::map<std::string, SpecElement> &specs, std::string const &line) const;
-
-	void parseHeaderProperty(std::map<std::string, SpecElement> &specs, std::string const &line, std::string const &lastSpecName) const;
-
-	std::vector<std::string> parseColorProps(std::map<std::string, SpecElement> const &specs) const;
-
-	bool isBytesReverseNeeded(std::string const &fcoding) const;
-
-	ScenePtr createScene(Point3ArrayPtr points, Color4ArrayPtr colors, IndexArrayPtr faces) const;
-
-    std::string readNextLine(std::ifstream &file) const;
-
-    propertyType readNextValue(std::ifstream &file, propertyType const &type);
-
-    bool colorPropsSortFunction(std::string const &c1, std::string const &c2) const;
-
-    std::vector<std::string> m_fcodingTypes;
-	pgl_hash_map_string<propertyType> m_propertiesTypes;
-    std::vector<std::string> m_knownColorTypes;
-    SizeVisitor sizeVisitor;
-	
-	bool m_reverseBytes;
-	std::vector<char> m_buffer;
-	std::vector<std::string> m_colorProps;
   };
 
 PGL_END_NAMESPACE
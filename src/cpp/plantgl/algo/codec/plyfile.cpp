@@ -0,0 +1,789 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+#include "plyfile.h"
+#include <plantgl/tool/bfstream.h>
+#include <plantgl/tool/util_string.h>
+#include <plantgl/tool/util_taskscheduler.h>
+#include <plantgl/tool/util_mappedfile.h>
+#include <plantgl/tool/util_profile.h>
+#include <plantgl/algo/base/discretizer.h>
+#include <plantgl/scenegraph/scene/scene.h>
+#include <plantgl/scenegraph/scene/shape.h>
+#include <plantgl/scenegraph/geometry/pointset.h>
+#include <plantgl/scenegraph/geometry/triangleset.h>
+#include <plantgl/scenegraph/geometry/faceset.h>
+#include <plantgl/scenegraph/geometry/mesh.h>
+#include <plantgl/scenegraph/appearance/material.h>
+#include <plantgl/scenegraph/appearance/texture.h>
+#include <atomic>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+static const size_t PLY_TYPE_SIZE[] = { 1, 1, 2, 2, 4, 4, 4, 8 };
+
+static bool ply_type(const std::string& name, PlyFileReader::ScalarType& type)
+{
+    if (name == "char" || name == "int8") type = PlyFileReader::Int8;
+    else if (name == "uchar" || name == "uint8") type = PlyFileReader::UInt8;
+    else if (name == "short" || name == "int16") type = PlyFileReader::Int16;
+    else if (name == "ushort" || name == "uint16") type = PlyFileReader::UInt16;
+    else if (name == "int" || name == "int32") type = PlyFileReader::Int32;
+    else if (name == "uint" || name == "uint32") type = PlyFileReader::UInt32;
+    else if (name == "float" || name == "float32") type = PlyFileReader::Float32;
+    else if (name == "double" || name == "float64") type = PlyFileReader::Float64;
+    else return false;
+    return true;
+}
+
+template<class T>
+inline T ply_load(const char * p, bool swap)
+{
+    T value;
+    if (swap) {
+        char tmp[sizeof(T)];
+        flipBytes(p, tmp, sizeof(T));
+        std::memcpy(&value, tmp, sizeof(T));
+    }
+    else std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+inline double ply_scalar(const char * p, PlyFileReader::ScalarType type, bool swap)
+{
+    switch (type) {
+        case PlyFileReader::Int8: return *(const int8_t *)p;
+        case PlyFileReader::UInt8: return *(const uint8_t *)p;
+        case PlyFileReader::Int16: return ply_load<int16_t>(p, swap);
+        case PlyFileReader::UInt16: return ply_load<uint16_t>(p, swap);
+        case PlyFileReader::Int32: return ply_load<int32_t>(p, swap);
+        case PlyFileReader::UInt32: return ply_load<uint32_t>(p, swap);
+        case PlyFileReader::Float32: return ply_load<float>(p, swap);
+        default: return ply_load<double>(p, swap);
+    }
+}
+
+inline size_t ply_count(const char * p, PlyFileReader::ScalarType type, bool swap)
+{
+    double count = ply_scalar(p, type, swap);
+    if (count < 0) throw std::runtime_error("Invalid list size");
+    return (size_t)count;
+}
+
+inline bool ply_need_swap(PlyFileReader::Format format)
+{
+    return (format == PlyFileReader::BinaryLittleEndian && __BYTE_ORDER == __BIG_ENDIAN) ||
+           (format == PlyFileReader::BinaryBigEndian && __BYTE_ORDER == __LITTLE_ENDIAN);
+}
+
+/// Sequential reader of ascii values in [p,end).
+struct PlyAsciiTokenizer {
+    const char * p;
+    const char * end;
+
+    PlyAsciiTokenizer(const char * begin, const char * end) : p(begin), end(end) {}
+
+    double next() {
+        while (p != end && isspace((unsigned char)*p)) ++p;
+        if (p == end) throw std::runtime_error("Truncated file");
+        char buffer[64];
+        size_t n = 0;
+        while (p != end && !isspace((unsigned char)*p) && n < sizeof(buffer) - 1) buffer[n++] = *p++;
+        buffer[n] = '\0';
+        char * last = NULL;
+        double value = strtod(buffer, &last);
+        if (last == buffer) throw std::runtime_error("Invalid value");
+        return value;
+    }
+};
+
+/// Call f(element, record, property, listIndex, value) for all the ascii values,
+/// up to element \b lastElement included. listIndex is -1 for scalars and list sizes.
+/// At the end of each record, f is called with property equal to the number of properties.
+template<class Function>
+static void ply_walk_ascii(const std::vector<PlyFileReader::Element>& elements, size_t lastElement,
+                           const char * begin, const char * end, Function f)
+{
+    PlyAsciiTokenizer tokens(begin, end);
+    for (size_t e = 0; e <= lastElement && e < elements.size(); ++e) {
+        const PlyFileReader::Element& element = elements[e];
+        for (size_t i = 0; i < element.count; ++i) {
+            for (size_t j = 0; j < element.properties.size(); ++j) {
+                double value = tokens.next();
+                f(e, i, j, -1, value);
+                if (element.properties[j].isList) {
+                    if (value < 0) throw std::runtime_error("Invalid list size");
+                    for (int k = 0; k < (int)value; ++k) f(e, i, j, k, tokens.next());
+                }
+            }
+            f(e, i, element.properties.size(), -1, 0.0);
+        }
+    }
+}
+
+/* ----------------------------------------------------------------------- */
+
+enum PlyVertexRole { eX, eY, eZ, eNX, eNY, eNZ, eRed, eGreen, eBlue, eAlpha, eNbRoles };
+
+/// Association between vertex properties and output arrays.
+struct PlyVertexLayout {
+    int property[eNbRoles];
+    std::vector<int> roles;
+    bool floatColor;
+    Point3Array::iterator points;
+    Point3Array::iterator normals;
+    Color4Array::iterator colors;
+    bool hasPoints, hasNormals, hasColors;
+
+    PlyVertexLayout(const PlyFileReader::Element& vertex, uint_t content) :
+        roles(vertex.properties.size(), -1), floatColor(false),
+        hasPoints(false), hasNormals(false), hasColors(false)
+    {
+        static const char * names[eNbRoles][2] = {
+            { "x", "x" }, { "y", "y" }, { "z", "z" },
+            { "nx", "nx" }, { "ny", "ny" }, { "nz", "nz" },
+            { "red", "diffuse_red" }, { "green", "diffuse_green" }, { "blue", "diffuse_blue" },
+            { "alpha", "diffuse_alpha" } };
+        for (int r = 0; r < eNbRoles; ++r) {
+            property[r] = vertex.findProperty(names[r][0]);
+            if (property[r] < 0) property[r] = vertex.findProperty(names[r][1]);
+            if (property[r] >= 0 && vertex.properties[property[r]].isList) property[r] = -1;
+        }
+        hasPoints = (content & PlyFileReader::Points) && property[eX] >= 0 && property[eY] >= 0 && property[eZ] >= 0;
+        hasNormals = (content & PlyFileReader::Normals) && property[eNX] >= 0 && property[eNY] >= 0 && property[eNZ] >= 0;
+        hasColors = (content & PlyFileReader::Colors) && property[eRed] >= 0 && property[eGreen] >= 0 && property[eBlue] >= 0;
+        if (hasColors) {
+            PlyFileReader::ScalarType t = vertex.properties[property[eRed]].type;
+            floatColor = (t == PlyFileReader::Float32 || t == PlyFileReader::Float64);
+        }
+        for (int r = 0; r < eNbRoles; ++r) {
+            if (property[r] < 0) continue;
+            if ((r <= eZ && hasPoints) || (r >= eNX && r <= eNZ && hasNormals) || (r >= eRed && hasColors))
+                roles[property[r]] = r;
+        }
+    }
+
+    inline uchar_t toColor(double value) const {
+        if (floatColor) value *= 255;
+        return (uchar_t)(value < 0 ? 0 : (value > 255 ? 255 : value));
+    }
+
+    inline void store(size_t i, const double * values) const {
+        if (hasPoints) points[i] = Vector3(values[eX], values[eY], values[eZ]);
+        if (hasNormals) normals[i] = Vector3(values[eNX], values[eNY], values[eNZ]);
+        if (hasColors)
+            // PlantGL stores transparency whereas PLY stores opacity
+            colors[i] = Color4(toColor(values[eRed]), toColor(values[eGreen]), toColor(values[eBlue]),
+                               property[eAlpha] >= 0 ? 255 - toColor(values[eAlpha]) : 0);
+    }
+};
+
+/* ----------------------------------------------------------------------- */
+
+int PlyFileReader::Element::findProperty(const std::string& name) const
+{
+    for (size_t i = 0; i < properties.size(); ++i)
+        if (properties[i].name == name) return (int)i;
+    return -1;
+}
+
+PlyFileReader::PlyFileReader(const std::string& fname) :
+    __file(new MappedFile(fname)),
+    __format(Ascii),
+    __data(NULL)
+{
+    try {
+        parseHeader();
+    }
+    catch (...) {
+        delete __file;
+        throw;
+    }
+}
+
+PlyFileReader::~PlyFileReader()
+{
+    delete __file;
+}
+
+void PlyFileReader::parseHeader()
+{
+    const char * p = __file->begin();
+    const char * end = __file->end();
+    bool first = true;
+    bool hasFormat = false;
+
+    while (true) {
+        if (p == end) throw std::runtime_error("Truncated header");
+        const char * lineEnd = (const char *)memchr(p, '\n', end - p);
+        if (!lineEnd) throw std::runtime_error("Truncated header");
+        std::string line = strip(std::string(p, lineEnd));
+        p = lineEnd + 1;
+
+        if (first) {
+            // The file header must start by 'ply' to be considered valid
+            if (line != "ply") throw std::runtime_error("Invalid format");
+            first = false;
+            continue;
+        }
+        if (line == "end_header") break;
+
+        std::vector<std::string> tokens = split(line);
+        if (tokens.empty() || tokens[0] == "comment" || tokens[0] == "obj_info") continue;
+
+        if (tokens[0] == "format") {
+            if (tokens.size() < 3) throw std::runtime_error("Truncated header");
+            if (tokens[1] == "ascii") __format = Ascii;
+            else if (tokens[1] == "binary_little_endian") __format = BinaryLittleEndian;
+            else if (tokens[1] == "binary_big_endian") __format = BinaryBigEndian;
+            else throw std::runtime_error("Invalid format");
+            hasFormat = true;
+        }
+        else if (tokens[0] == "element") {
+            if (tokens.size() < 3) throw std::runtime_error("Invalid header");
+            Element element;
+            element.name = tokens[1];
+            element.count = toNumber<size_t>(tokens[2]);
+            element.recordSize = 0;
+            __elements.push_back(element);
+        }
+        else if (tokens[0] == "property") {
+            if (__elements.empty()) throw std::runtime_error("Invalid header");
+            Property property;
+            property.offset = 0;
+            property.sizeType = UInt8;
+            if (tokens.size() == 3) {
+                property.isList = false;
+                if (!ply_type(tokens[1], property.type)) throw std::runtime_error("Invalid header");
+                property.name = tokens[2];
+            }
+            else if (tokens.size() == 5 && tokens[1] == "list") {
+                property.isList = true;
+                if (!ply_type(tokens[2], property.sizeType) || !ply_type(tokens[3], property.type))
+                    throw std::runtime_error("Invalid header");
+                property.name = tokens[4];
+            }
+            else throw std::runtime_error("Invalid header");
+            __elements.back().properties.push_back(property);
+        }
+    }
+    if (!hasFormat) throw std::runtime_error("Invalid format");
+    __data = p;
+
+    // Compile the record layouts
+    for (std::vector<Element>::iterator it = __elements.begin(); it != __elements.end(); ++it) {
+        size_t offset = 0;
+        bool fixed = true;
+        for (std::vector<Property>::iterator prop = it->properties.begin(); prop != it->properties.end(); ++prop) {
+            prop->offset = offset;
+            if (prop->isList) fixed = false;
+            else offset += PLY_TYPE_SIZE[prop->type];
+        }
+        it->recordSize = fixed ? offset : 0;
+    }
+}
+
+size_t PlyFileReader::elementDataSize(size_t elementId, const char * begin) const
+{
+    const Element& element = __elements[elementId];
+    const char * end = __file->end();
+    if (element.recordSize > 0) {
+        size_t size = element.count * element.recordSize;
+        if (size > size_t(end - begin)) throw std::runtime_error("Truncated file");
+        return size;
+    }
+    bool swap = ply_need_swap(__format);
+    const char * p = begin;
+    for (size_t i = 0; i < element.count; ++i) {
+        for (std::vector<Property>::const_iterator prop = element.properties.begin(); prop != element.properties.end(); ++prop) {
+            if (prop->isList) {
+                if (PLY_TYPE_SIZE[prop->sizeType] > size_t(end - p)) throw std::runtime_error("Truncated file");
+                size_t count = ply_count(p, prop->sizeType, swap);
+                p += PLY_TYPE_SIZE[prop->sizeType];
+                if (count * PLY_TYPE_SIZE[prop->type] > size_t(end - p)) throw std::runtime_error("Truncated file");
+                p += count * PLY_TYPE_SIZE[prop->type];
+            }
+            else {
+                if (PLY_TYPE_SIZE[prop->type] > size_t(end - p)) throw std::runtime_error("Truncated file");
+                p += PLY_TYPE_SIZE[prop->type];
+            }
+        }
+    }
+    return p - begin;
+}
+
+void PlyFileReader::read(uint_t content)
+{
+    PGL_PROFILE_ZONE("PlyFileReader::read");
+    PGL_PROFILE_COUNT("ply.bytes_parsed", __file->end() - __data);
+    __points = Point3ArrayPtr();
+    __colors = Color4ArrayPtr();
+    __normals = Point3ArrayPtr();
+    __triangles = Index3ArrayPtr();
+    __faces = IndexArrayPtr();
+
+    if (__format == Ascii) readAscii(content);
+    else readBinary(content);
+}
+
+/// Prepare the output arrays of the vertex element.
+static void ply_allocate_vertex(PlyVertexLayout& layout, size_t count,
+                                Point3ArrayPtr& points, Point3ArrayPtr& normals, Color4ArrayPtr& colors)
+{
+    if (layout.hasPoints) { points = Point3ArrayPtr(new Point3Array(count)); layout.points = points->begin(); }
+    if (layout.hasNormals) { normals = Point3ArrayPtr(new Point3Array(count)); layout.normals = normals->begin(); }
+    if (layout.hasColors) { colors = Color4ArrayPtr(new Color4Array(count)); layout.colors = colors->begin(); }
+}
+
+/// Return the faces as triangles when all of them have 3 vertices.
+static Index3ArrayPtr ply_as_triangles(const IndexArrayPtr& faces)
+{
+    for (IndexArray::const_iterator it = faces->begin(); it != faces->end(); ++it)
+        if (it->size() != 3) return Index3ArrayPtr();
+    Index3ArrayPtr triangles(new Index3Array(faces->size()));
+    Index3Array::iterator itTriangle = triangles->begin();
+    for (IndexArray::const_iterator it = faces->begin(); it != faces->end(); ++it, ++itTriangle)
+        *itTriangle = Index3(it->getAt(0), it->getAt(1), it->getAt(2));
+    return triangles;
+}
+
+void PlyFileReader::readBinary(uint_t content)
+{
+    const bool swap = ply_need_swap(__format);
+    const char * end = __file->end();
+    const char * p = __data;
+
+    bool needVertex = (content & (Points | Colors | Normals)) != 0;
+    bool needFace = (content & Faces) != 0;
+
+    for (size_t e = 0; e < __elements.size() && (needVertex || needFace); ++e) {
+        const Element& element = __elements[e];
+
+        if (element.name == "vertex" && needVertex) {
+            needVertex = false;
+            if (element.recordSize == 0) throw std::runtime_error("Unsupported vertex layout");
+            size_t size = elementDataSize(e, p);
+            PlyVertexLayout layout(element, content);
+            ply_allocate_vertex(layout, element.count, __points, __normals, __colors);
+            const char * block = p;
+            parallel_for_range(0, element.count, [&](size_t begin, size_t stop) {
+                double values[eNbRoles] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+                for (size_t i = begin; i < stop; ++i) {
+                    const char * record = block + i * element.recordSize;
+                    for (size_t j = 0; j < layout.roles.size(); ++j) {
+                        int role = layout.roles[j];
+                        if (role >= 0) values[role] = ply_scalar(record + element.properties[j].offset, element.properties[j].type, swap);
+                    }
+                    layout.store(i, values);
+                }
+            });
+            p += size;
+            continue;
+        }
+
+        if (element.name == "face" && needFace) {
+            needFace = false;
+            int listId = element.findProperty("vertex_indices");
+            if (listId < 0) listId = element.findProperty("vertex_index");
+            if (listId < 0 || !element.properties[listId].isList) {
+                p += elementDataSize(e, p);
+                continue;
+            }
+            const Property& list = element.properties[listId];
+            const size_t sizeSize = PLY_TYPE_SIZE[list.sizeType];
+            const size_t indexSize = PLY_TYPE_SIZE[list.type];
+
+            // Triangle layout: the list is the only variable part and always has 3 entries.
+            bool triangleLayout = true;
+            size_t prefix = 0, stride = 0;
+            for (size_t j = 0; j < element.properties.size(); ++j) {
+                if ((int)j == listId) { stride += sizeSize + 3 * indexSize; continue; }
+                if (element.properties[j].isList) { triangleLayout = false; break; }
+                if ((int)j < listId) prefix += PLY_TYPE_SIZE[element.properties[j].type];
+                stride += PLY_TYPE_SIZE[element.properties[j].type];
+            }
+            if (triangleLayout && element.count * stride <= size_t(end - p)) {
+                std::atomic<bool> allTriangles(true);
+                const char * block = p;
+                parallel_for_range(0, element.count, [&](size_t begin, size_t stop) {
+                    for (size_t i = begin; i < stop && allTriangles; ++i)
+                        if (ply_count(block + i * stride + prefix, list.sizeType, swap) != 3) { allTriangles = false; }
+                });
+                triangleLayout = allTriangles;
+            }
+            else triangleLayout = false;
+
+            if (triangleLayout) {
+                __triangles = Index3ArrayPtr(new Index3Array(element.count));
+                Index3Array::iterator triangles = __triangles->begin();
+                const char * block = p + prefix + sizeSize;
+                parallel_for_range(0, element.count, [&](size_t begin, size_t stop) {
+                    for (size_t i = begin; i < stop; ++i) {
+                        const char * record = block + i * stride;
+                        triangles[i] = Index3((uint_t)ply_scalar(record, list.type, swap),
+                                              (uint_t)ply_scalar(record + indexSize, list.type, swap),
+                                              (uint_t)ply_scalar(record + 2 * indexSize, list.type, swap));
+                    }
+                });
+                p += element.count * stride;
+            }
+            else {
+                // General polygons are decoded sequentially.
+                __faces = IndexArrayPtr(new IndexArray(element.count));
+                IndexArray::iterator faces = __faces->begin();
+                for (size_t i = 0; i < element.count; ++i, ++faces) {
+                    for (size_t j = 0; j < element.properties.size(); ++j) {
+                        const Property& prop = element.properties[j];
+                        if (!prop.isList) {
+                            if (PLY_TYPE_SIZE[prop.type] > size_t(end - p)) throw std::runtime_error("Truncated file");
+                            p += PLY_TYPE_SIZE[prop.type];
+                            continue;
+                        }
+                        if (PLY_TYPE_SIZE[prop.sizeType] > size_t(end - p)) throw std::runtime_error("Truncated file");
+                        size_t count = ply_count(p, prop.sizeType, swap);
+                        p += PLY_TYPE_SIZE[prop.sizeType];
+                        size_t size = PLY_TYPE_SIZE[prop.type];
+                        if (count * size > size_t(end - p)) throw std::runtime_error("Truncated file");
+                        if ((int)j == listId) {
+                            faces->reserve(count);
+                            for (size_t k = 0; k < count; ++k)
+                                faces->push_back((uint_t)ply_scalar(p + k * size, prop.type, swap));
+                        }
+                        p += count * size;
+                    }
+                }
+                if ((__triangles = ply_as_triangles(__faces))) __faces = IndexArrayPtr();
+            }
+            continue;
+        }
+
+        p += elementDataSize(e, p);
+    }
+}
+
+void PlyFileReader::readAscii(uint_t content)
+{
+    int vertexId = -1, faceId = -1, listId = -1;
+    for (size_t e = 0; e < __elements.size(); ++e) {
+        if (__elements[e].name == "vertex" && vertexId < 0 && (content & (Points | Colors | Normals))) vertexId = (int)e;
+        else if (__elements[e].name == "face" && faceId < 0 && (content & Faces)) {
+            listId = __elements[e].findProperty("vertex_indices");
+            if (listId < 0) listId = __elements[e].findProperty("vertex_index");
+            if (listId >= 0 && __elements[e].properties[listId].isList) faceId = (int)e;
+        }
+    }
+    if (vertexId < 0 && faceId < 0) return;
+
+    PlyVertexLayout layout(vertexId >= 0 ? __elements[vertexId] : Element(), content);
+    if (vertexId >= 0) ply_allocate_vertex(layout, __elements[vertexId].count, __points, __normals, __colors);
+    if (faceId >= 0) __faces = IndexArrayPtr(new IndexArray(__elements[faceId].count));
+
+    double values[eNbRoles] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    size_t lastElement = (size_t)std::max(vertexId, faceId);
+    const size_t nbVertexProperties = layout.roles.size();
+    IndexArray::iterator faces = faceId >= 0 ? __faces->begin() : IndexArray::iterator();
+
+    ply_walk_ascii(__elements, lastElement, __data, __file->end(),
+        [&](size_t e, size_t i, size_t j, int k, double value) {
+            if ((int)e == vertexId) {
+                if (j == nbVertexProperties) layout.store(i, values);
+                else if (k < 0 && layout.roles[j] >= 0) values[layout.roles[j]] = value;
+            }
+            else if ((int)e == faceId && (int)j == listId && k >= 0) faces[i].push_back((uint_t)value);
+        });
+
+    if (__faces && (__triangles = ply_as_triangles(__faces))) __faces = IndexArrayPtr();
+}
+
+RealArrayPtr PlyFileReader::readProperty(const std::string& elementName, const std::string& propertyName)
+{
+    size_t elementId = 0;
+    while (elementId < __elements.size() && __elements[elementId].name != elementName) ++elementId;
+    if (elementId == __elements.size()) throw std::runtime_error("Unknown element: " + elementName);
+    const Element& element = __elements[elementId];
+    int propertyId = element.findProperty(propertyName);
+    if (propertyId < 0) throw std::runtime_error("Unknown property: " + propertyName);
+    const Property& property = element.properties[propertyId];
+    if (property.isList) throw std::runtime_error("List property not supported: " + propertyName);
+
+    RealArrayPtr result(new RealArray(element.count));
+    RealArray::iterator values = result->begin();
+
+    if (__format == Ascii) {
+        ply_walk_ascii(__elements, elementId, __data, __file->end(),
+            [&](size_t e, size_t i, size_t j, int k, double value) {
+                if (e == elementId && (int)j == propertyId && k < 0) values[i] = value;
+            });
+        return result;
+    }
+
+    const bool swap = ply_need_swap(__format);
+    const char * p = __data;
+    for (size_t e = 0; e < elementId; ++e) p += elementDataSize(e, p);
+    if (element.recordSize > 0) {
+        elementDataSize(elementId, p); // bounds check
+        parallel_for_range(0, element.count, [&](size_t begin, size_t stop) {
+            for (size_t i = begin; i < stop; ++i)
+                values[i] = ply_scalar(p + i * element.recordSize + property.offset, property.type, swap);
+        });
+    }
+    else {
+        elementDataSize(elementId, p); // bounds check
+        for (size_t i = 0; i < element.count; ++i) {
+            for (size_t j = 0; j < element.properties.size(); ++j) {
+                const Property& prop = element.properties[j];
+                if (prop.isList) {
+                    size_t count = ply_count(p, prop.sizeType, swap);
+                    p += PLY_TYPE_SIZE[prop.sizeType] + count * PLY_TYPE_SIZE[prop.type];
+                }
+                else {
+                    if ((int)j == propertyId) values[i] = ply_scalar(p, prop.type, swap);
+                    p += PLY_TYPE_SIZE[prop.type];
+                }
+            }
+        }
+    }
+    return result;
+}
+
+ScenePtr PlyFileReader::toScene() const
+{
+    ScenePtr scene(new Scene());
+    if (!__points) return scene;
+
+    GeometryPtr geometry;
+    if (__triangles && !__triangles->empty()) {
+        if (__normals || __colors)
+            geometry = GeometryPtr(new TriangleSet(__points, __triangles, __normals, Index3ArrayPtr(), __colors));
+        else
+            geometry = GeometryPtr(new TriangleSet(__points, __triangles));
+    }
+    else if (__faces && !__faces->empty()) {
+        if (__normals || __colors)
+            geometry = GeometryPtr(new FaceSet(__points, __faces, __normals, IndexArrayPtr(), __colors));
+        else
+            geometry = GeometryPtr(new FaceSet(__points, __faces));
+    }
+    else geometry = GeometryPtr(new PointSet(__points, __colors));
+
+    scene->add(ShapePtr(new Shape(geometry)));
+    return scene;
+}
+
+/* ----------------------------------------------------------------------- */
+
+/// Binary output buffer flushed to the file when full.
+class PlyOutputBuffer {
+public:
+    PlyOutputBuffer(std::ostream& stream, bool swap, size_t capacity) :
+        __stream(stream), __swap(swap), __capacity(std::max<size_t>(capacity, 64))
+    { __buffer.reserve(__capacity); }
+
+    ~PlyOutputBuffer() { flush(); }
+
+    template<class T>
+    inline void put(T value) {
+        char bytes[sizeof(T)];
+        if (__swap) {
+            char tmp[sizeof(T)];
+            std::memcpy(tmp, &value, sizeof(T));
+            flipBytes(tmp, bytes, sizeof(T));
+        }
+        else std::memcpy(bytes, &value, sizeof(T));
+        __buffer.insert(__buffer.end(), bytes, bytes + sizeof(T));
+        if (__buffer.size() >= __capacity) flush();
+    }
+
+    void flush() {
+        if (!__buffer.empty()) __stream.write(&__buffer[0], __buffer.size());
+        __buffer.clear();
+    }
+
+private:
+    std::ostream& __stream;
+    bool __swap;
+    size_t __capacity;
+    std::vector<char> __buffer;
+};
+
+/// Points, colors and faces collected from a shape.
+struct PlyShapeData {
+    Point3ArrayPtr points;
+    Color4ArrayPtr colors;
+    Color4 color;
+    MeshPtr mesh;
+    IndexArrayPtr faces;
+};
+
+static void ply_write_header(std::ostream& stream, bool bigEndian, size_t nbVertex, size_t nbFace, const char * comment)
+{
+    stream << "ply\nformat " << (bigEndian ? "binary_big_endian" : "binary_little_endian") << " 1.0\n";
+    if (comment) stream << "comment " << comment << '\n';
+    stream << "element vertex " << nbVertex << '\n';
+    stream << "property float x\nproperty float y\nproperty float z\n";
+    stream << "property uchar diffuse_red\nproperty uchar diffuse_green\nproperty uchar diffuse_blue\n";
+    stream << "element face " << nbFace << '\n';
+    stream << "property list uchar int vertex_indices\n";
+    stream << "end_header\n";
+}
+
+static bool ply_write_data(const std::string& fname, bool bigEndian, size_t bufferSize,
+                           const std::vector<PlyShapeData>& shapes, const char * comment)
+{
+    size_t nbVertex = 0, nbFace = 0;
+    for (std::vector<PlyShapeData>::const_iterator it = shapes.begin(); it != shapes.end(); ++it) {
+        nbVertex += it->points->size();
+        if (it->mesh) nbFace += it->mesh->getIndexListSize();
+        else if (it->faces) nbFace += it->faces->size();
+    }
+
+    PGL_PROFILE_ZONE("PlyFileWriter::write");
+    std::ofstream stream(fname.c_str(), std::ios::binary);
+    if (!stream) return false;
+    ply_write_header(stream, bigEndian, nbVertex, nbFace, comment);
+
+    const bool swap = (bigEndian != (__BYTE_ORDER == __BIG_ENDIAN));
+    {
+        PlyOutputBuffer buffer(stream, swap, bufferSize);
+        for (std::vector<PlyShapeData>::const_iterator it = shapes.begin(); it != shapes.end(); ++it) {
+            const bool perVertex = it->colors && it->colors->size() == it->points->size();
+            Color4Array::const_iterator itColor = perVertex ? it->colors->begin() : Color4Array::const_iterator();
+            for (Point3Array::const_iterator itPoint = it->points->begin(); itPoint != it->points->end(); ++itPoint) {
+                buffer.put<float>((float)itPoint->x());
+                buffer.put<float>((float)itPoint->y());
+                buffer.put<float>((float)itPoint->z());
+                const Color4& color = perVertex ? *itColor++ : it->color;
+                buffer.put<uchar_t>(color.getRed());
+                buffer.put<uchar_t>(color.getGreen());
+                buffer.put<uchar_t>(color.getBlue());
+            }
+        }
+        int32_t offset = 0;
+        for (std::vector<PlyShapeData>::const_iterator it = shapes.begin(); it != shapes.end(); ++it) {
+            if (it->mesh) {
+                const Mesh& mesh = *it->mesh;
+                for (uint_t i = 0; i < mesh.getIndexListSize(); ++i) {
+                    uint_t size = mesh.getFaceSize(i);
+                    buffer.put<uchar_t>((uchar_t)size);
+                    for (uint_t j = 0; j < size; ++j) buffer.put<int32_t>((int32_t)mesh.getFacePointIndexAt(i, j) + offset);
+                }
+            }
+            else if (it->faces) {
+                for (IndexArray::const_iterator itFace = it->faces->begin(); itFace != it->faces->end(); ++itFace) {
+                    buffer.put<uchar_t>((uchar_t)itFace->size());
+                    for (Index::const_iterator itIndex = itFace->begin(); itIndex != itFace->end(); ++itIndex)
+                        buffer.put<int32_t>((int32_t)*itIndex + offset);
+                }
+            }
+            offset += (int32_t)it->points->size();
+        }
+    }
+    return bool(stream);
+}
+
+/// Collect the discretized meshes and point sets of the shapes of \b scene.
+static void ply_collect(const ScenePtr& scene, Discretizer& discretizer, std::vector<PlyShapeData>& shapes)
+{
+    for (Scene::const_iterator it = scene->begin(); it != scene->end(); ++it) {
+        ShapePtr shape = dynamic_pointer_cast<Shape>(*it);
+        if (!shape || !shape->getGeometry()) continue;
+        if (!shape->getGeometry()->apply(discretizer)) continue;
+        ExplicitModelPtr model = discretizer.getDiscretization();
+        if (!model || !model->getPointList()) continue;
+
+        PlyShapeData data;
+        data.points = model->getPointList();
+        data.color = Color4(160, 160, 160, 0);
+        MaterialPtr material = dynamic_pointer_cast<Material>(shape->getAppearance());
+        if (material) data.color = Color4(material->getAmbient());
+        else if (dynamic_pointer_cast<Texture2D>(shape->getAppearance())) data.color = Color4(0, 0, 0, 0);
+
+        data.mesh = dynamic_pointer_cast<Mesh>(model);
+        if (data.mesh) {
+            if (data.mesh->getColorPerVertex() && data.mesh->hasColorList())
+                data.colors = data.mesh->getColorList();
+        }
+        else if (dynamic_pointer_cast<PointSet>(model)) {
+            if (model->hasColorList()) data.colors = model->getColorList();
+        }
+        else continue;
+        shapes.push_back(data);
+    }
+}
+
+PlyFileWriter::PlyFileWriter(bool bigEndian, size_t bufferSize) :
+    __bigEndian(bigEndian),
+    __bufferSize(bufferSize)
+{
+}
+
+bool PlyFileWriter::write(const std::string& fname, const ScenePtr& scene, const char * comment)
+{
+    if (!scene) return false;
+    Discretizer discretizer;
+    std::vector<PlyShapeData> shapes;
+    ply_collect(scene, discretizer, shapes);
+    return ply_write_data(fname, __bigEndian, __bufferSize, shapes, comment);
+}
+
+bool PlyFileWriter::write(const std::string& fname,
+                          const Point3ArrayPtr& points,
+                          const Color4ArrayPtr& colors,
+                          const IndexArrayPtr& faces,
+                          const char * comment)
+{
+    if (!points) return false;
+    PlyShapeData data;
+    data.points = points;
+    data.colors = colors;
+    data.color = Color4(160, 160, 160, 0);
+    data.faces = faces;
+    std::vector<PlyShapeData> shapes(1, data);
+    return ply_write_data(fname, __bigEndian, __bufferSize, shapes, comment);
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,204 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file plyfile.h
+    \brief Fast PLY reading and writing directly into PlantGL arrays.
+*/
+
+#ifndef __plyfile_h__
+#define __plyfile_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include "codec_config.h"
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <plantgl/scenegraph/container/colorarray.h>
+#include <plantgl/scenegraph/container/indexarray.h>
+#include <plantgl/tool/util_array.h>
+#include <string>
+#include <vector>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+class Scene;
+typedef RCPtr<Scene> ScenePtr;
+class MappedFile;
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class PlyFileReader
+   \brief A PLY reader that memory-maps the file and decodes the vertex and face
+   blocks directly into PlantGL arrays.
+
+   The header is compiled into a record layout (byte offset of each property).
+   Binary elements with fixed size records, and triangle faces, are decoded
+   in parallel chunks. Errors are reported with std::runtime_error.
+*/
+class CODEC_API PlyFileReader
+{
+public:
+    /// Parts of the file to decode.
+    enum Content {
+        Points = 1,
+        Colors = 2,
+        Normals = 4,
+        Faces = 8,
+        AllContent = Points | Colors | Normals | Faces
+    };
+
+    enum Format {
+        Ascii,
+        BinaryLittleEndian,
+        BinaryBigEndian
+    };
+
+    enum ScalarType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+    struct Property {
+        std::string name;
+        ScalarType type;
+        bool isList;
+        ScalarType sizeType;
+        /// Byte offset in the record. Only meaningful for fixed size records.
+        size_t offset;
+    };
+
+    struct Element {
+        std::string name;
+        size_t count;
+        std::vector<Property> properties;
+        /// Size in bytes of a record, or 0 if records contain lists.
+        size_t recordSize;
+
+        /// Index of the property \b name or -1.
+        int findProperty(const std::string& name) const;
+    };
+
+    /// Open \b fname and parse its header.
+    PlyFileReader(const std::string& fname);
+
+    ~PlyFileReader();
+
+    Format getFormat() const { return __format; }
+
+    const std::vector<Element>& getElements() const { return __elements; }
+
+    /// Decode the vertex and face elements. Only the parts in \b content are filled.
+    void read(uint_t content = AllContent);
+
+    /// Decode a single scalar property of an element.
+    RealArrayPtr readProperty(const std::string& element, const std::string& property);
+
+    const Point3ArrayPtr& getPoints() const { return __points; }
+    const Color4ArrayPtr& getColors() const { return __colors; }
+    const Point3ArrayPtr& getNormals() const { return __normals; }
+
+    /// Returns the faces when all of them are triangles.
+    const Index3ArrayPtr& getTriangles() const { return __triangles; }
+
+    /// Returns the faces when some of them are not triangles.
+    const IndexArrayPtr& getFaces() const { return __faces; }
+
+    /// Build a scene with a PointSet, a TriangleSet or a FaceSet from the decoded data.
+    ScenePtr toScene() const;
+
+protected:
+    void parseHeader();
+    size_t elementDataSize(size_t elementId, const char * begin) const;
+    void readBinary(uint_t content);
+    void readAscii(uint_t content);
+
+    MappedFile * __file;
+    Format __format;
+    std::vector<Element> __elements;
+    const char * __data;
+
+    Point3ArrayPtr __points;
+    Color4ArrayPtr __colors;
+    Point3ArrayPtr __normals;
+    Index3ArrayPtr __triangles;
+    IndexArrayPtr __faces;
+
+private:
+    PlyFileReader(const PlyFileReader&);
+    PlyFileReader& operator=(const PlyFileReader&);
+};
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class PlyFileWriter
+   \brief A buffered binary PLY writer.
+
+   Shapes are discretized and their points and faces are encoded into a
+   memory buffer that is flushed to the file in large blocks. The output
+   layout is the one of PlyPrinter: float coordinates, uchar diffuse colors
+   and a list of int vertex indices per face.
+*/
+class CODEC_API PlyFileWriter
+{
+public:
+    PlyFileWriter(bool bigEndian = false, size_t bufferSize = 1 << 20);
+
+    /// Write all the shapes of \b scene in \b fname.
+    bool write(const std::string& fname, const ScenePtr& scene, const char * comment = NULL);
+
+    /// Write the given points, colors and faces in \b fname. \b colors and \b faces can be null.
+    bool write(const std::string& fname,
+               const Point3ArrayPtr& points,
+               const Color4ArrayPtr& colors,
+               const IndexArrayPtr& faces,
+               const char * comment = NULL);
+
+protected:
+    bool __bigEndian;
+    size_t __bufferSize;
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#endif // __plyfile_h__
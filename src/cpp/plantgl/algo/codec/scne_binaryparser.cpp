@@ -52,14 +52,18 @@
 #include <plantgl/scenegraph/core/pgl_messages.h>
 #include <plantgl/tool/timer.h>
 #include <plantgl/tool/bfstream.h>
+#include <plantgl/tool/util_mappedfile.h>
 #include <plantgl/tool/dirnames.h>
 #include <plantgl/tool/util_enviro.h>
+#include <plantgl/tool/util_profile.h>
 
 #include "scne_parser.h"
 
 #include <iostream>
 
 #include <typeinfo>
+#include <stdexcept>
+#include <zlib.h>
 
 PGL_USING_NAMESPACE
 
@@ -132,9 +136,7 @@ bool PGL(isParserVerbose)()
     uint_t _sizej = readUint32(); \
     if (_sizej > 0){ \
       obj = type##Ptr (new type(_sizej)); \
-      for (type::iterator _it = obj->begin();_it != obj->end() && !stream->eof(); _it++) { \
-      *_it = read##primitive(); \
-      }; \
+      readArrayContent(*obj); \
     }; \
   };
 
@@ -142,9 +144,7 @@ bool PGL(isParserVerbose)()
     uint_t _sizej  = readUint32(); \
     if (_sizej > 0){ \
       obj = IndexArrayPtr(new IndexArray(_sizej)); \
-      for (IndexArray::iterator _it = obj->begin();_it != obj->end() && !stream->eof(); _it++) { \
-        *_it = readIndex(); \
-      }; \
+      readArrayContent(*obj); \
     }; \
   };
 
@@ -286,7 +286,8 @@ BinaryParser::BinaryParser(ostream& output,int max_errors, fistream * _stream) :
     __currents(45,uint_t(0)),
     __result(),
     __assigntime(0),
-    __double_precision(false){
+    __double_precision(false),
+    __swap_bytes(false){
     for(uint_t i=0;i<45;i++)__mem[i]=NULL;
 }
 
@@ -464,6 +465,64 @@ Index BinaryParser::readIndex()
   return val;
 }
 
+bool BinaryParser::hasArrayBlocks() const
+{ return __tokens && __tokens->getVersion() >= 3.0f; }
+
+/// read a block of data
+bool BinaryParser::readBlock(size_t size, std::vector<char>& buffer, const char *& data)
+{
+  uchar_t codec = readUchar();
+  uint64_t csize = size;
+  if (codec == eZlibBlock) {
+      uint64_t low = readUint32();
+      uint64_t high = readUint32();
+      csize = low | (high << 32);
+  }
+  else if (codec != eRawBlock) {
+      __outputStream << "*** ERROR: Unknown block codec ! [ Value=" << int(codec) << " ]" <<  endl;
+      __errors_count++;
+      return false;
+  }
+  uchar_t pad = readUchar();
+  if (pad >= BINARY_BLOCK_ALIGNMENT) {
+      __outputStream << "*** ERROR: Invalid block padding ! [ Value=" << int(pad) << " ]" <<  endl;
+      __errors_count++;
+      return false;
+  }
+  char zeros[BINARY_BLOCK_ALIGNMENT];
+  if (pad > 0) stream->read(zeros, pad);
+  if (size == 0) {
+      data = NULL;
+      return (bool)*stream;
+  }
+  PGL_PROFILE_COUNT("bgeom.block_bytes_read", csize);
+
+  mappedfistream * mapped = dynamic_cast<mappedfistream *>(stream);
+  if (mapped) data = mapped->consume(csize);
+  else {
+      buffer.resize(csize);
+      stream->read(buffer.data(), csize);
+      data = (*stream ? buffer.data() : NULL);
+  }
+  if (!data || !*stream) {
+      __outputStream << "*** ERROR: Truncated block of " << csize << " bytes." <<  endl;
+      __errors_count++;
+      return false;
+  }
+  if (codec == eZlibBlock) {
+      std::vector<char> decoded(size);
+      uLongf dsize = uLongf(size);
+      if (uncompress((Bytef *)decoded.data(), &dsize, (const Bytef *)data, uLong(csize)) != Z_OK || dsize != size) {
+          __outputStream << "*** ERROR: Corrupted compressed block." <<  endl;
+          __errors_count++;
+          return false;
+      }
+      buffer.swap(decoded);
+      data = buffer.data();
+  }
+  return true;
+}
+
 /* ----------------------------------------------------------------------- */
 
 const string& BinaryParser::getComment() const {
@@ -551,6 +610,19 @@ bool BinaryParser::readHeader(){
   else {
     __double_precision = false;
   }
+  __swap_bytes = false;
+  if(_version >= 3.0f){
+      uchar_t byteorder = readUchar();
+      if (byteorder > 1){
+        __outputStream << "*** ERROR: Byte order not valid ! [ Value=" << int(byteorder) << " ]" <<  endl;
+        return false;
+      }
+#if __BYTE_ORDER == __BIG_ENDIAN
+      __swap_bytes = (byteorder == 0);
+#else
+      __swap_bytes = (byteorder == 1);
+#endif
+  }
 #ifdef GEOM_DEBUG
   std::cerr << "Assume "<< (!__double_precision?"simple":"double")<< " precision." << std::endl;
 #endif
@@ -625,8 +697,15 @@ bool BinaryParser::readSceneHeader(){
 /* ----------------------------------------------------------------------- */
 bool BinaryParser::open(const std::string& filename)
 {
-    stream = new bifstream(filename.c_str());
-    stream->setByteOrder(PglLittleEndian);
+    try {
+        // array blocks are then accessed in place in the mapped file
+        stream = new mappedfistream(filename, PglLittleEndian);
+        return true;
+    }
+    catch (const std::runtime_error&) {
+        stream = new bifstream(filename.c_str());
+        stream->setByteOrder(PglLittleEndian);
+    }
 
     if(!*stream){
         pglErrorEx(PGLERRORMSG(C_FILE_OPEN_ERR_s),filename.c_str());
@@ -667,6 +746,7 @@ bool BinaryParser::parse(const string& filename){
 }
 
 bool BinaryParser::parse(){
+    PGL_PROFILE_ZONE("BinaryParser::parse");
     if(!readHeader())return false;
     if(!readSceneHeader())return false;
     PglErrorStream::Binder psb(__outputStream);
@@ -55,6 +55,7 @@
 #include <vector>
 #include <iostream>
 #include "codec_config.h"
+#include "binaryblock.h"
 #include <plantgl/tool/rcobject.h>
 #include <plantgl/math/util_math.h>
 #include <plantgl/math/util_vector.h>
@@ -62,12 +63,8 @@
 #include <plantgl/tool/util_cache.h>
 #include <plantgl/scenegraph/appearance/color.h>
 #include <plantgl/scenegraph/container/indexarray.h>
-
-/* ----------------------------------------------------------------------- */
-
-PGL_BEGIN_NAMESPACE
-class fistream;
-PGL_END_NAMESPACE
+#include <plantgl/tool/bfstream.h>
+#include <cstring>
 
 /* ----------------------------------------------------------------------- */
 
@@ -380,13 +377,103 @@ public:
   RCPtr<Array> readArray() {
       uint32_t _sizei = readUint32();
       RCPtr<Array> result(new Array(_sizei));
-      uint32_t pid = 0;
-      for(typename Array::iterator it = result->begin(); it != result->end(); ++it, ++pid){
+      if (_sizei > 0) readArrayContent(*result);
+      return result;
+  }
+
+  /// read the elements of \e array, already sized with the count read from stream.
+  template <class Array>
+  void readArrayContent(Array& array) {
+      readArrayContent(array, typename BinaryBlockTraits<typename Array::element_type>::Category());
+  }
+
+  template <class Array>
+  void readArrayContent(Array& array, BinaryElementTag) {
+      for(typename Array::iterator it = array.begin(); it != array.end() && !stream->eof(); ++it){
           *it = read<typename Array::element_type>();
       }
-      return result;
   }
 
+  template <class Array>
+  void readArrayContent(Array& array, BinaryRawTag) {
+      typedef typename BinaryBlockTraits<typename Array::element_type>::Scalar Scalar;
+      if (!hasArrayBlocks()) readArrayContent(array, BinaryElementTag());
+      else readArrayBlock(array, (Scalar *)NULL);
+  }
+
+  template <class Array>
+  void readArrayContent(Array& array, BinaryRaggedTag) {
+      if (!hasArrayBlocks()) {
+          readArrayContent(array, BinaryElementTag());
+          return;
+      }
+      std::vector<char> _buffer;
+      const char * _data = NULL;
+      if (!readBlock(array.size() * sizeof(uint32_t), _buffer, _data)) return;
+      std::vector<uint32_t> _sizes(array.size());
+      readScalars<uint32_t>(_data, _sizes.data(), _sizes.size());
+      size_t _total = 0;
+      for (std::vector<uint32_t>::const_iterator it = _sizes.begin(); it != _sizes.end(); ++it) _total += *it;
+      if (!readBlock(_total * sizeof(uint32_t), _buffer, _data)) return;
+      std::vector<uint32_t>::const_iterator _itsize = _sizes.begin();
+      for (typename Array::iterator it = array.begin(); it != array.end(); ++it, ++_itsize) {
+          if (*_itsize == 0) continue;
+          typename Array::element_type _index(*_itsize);
+          readScalars<uint32_t>(_data, &*_index.begin(), *_itsize);
+          _data += *_itsize * sizeof(uint32_t);
+          *it = _index;
+      }
+  }
+
+  template <class Array, class Scalar>
+  void readArrayBlock(Array& array, Scalar *) {
+      readScalarBlock<Scalar>(array);
+  }
+
+  template <class Array>
+  void readArrayBlock(Array& array, real_t *) {
+      if (__double_precision) readScalarBlock<double>(array);
+      else readScalarBlock<float>(array);
+  }
+
+  /// read a block of scalars of the type of the file into the components of \e array.
+  template <class FileScalar, class Array>
+  void readScalarBlock(Array& array) {
+      typedef typename Array::element_type Element;
+      typedef BinaryBlockTraits<Element> Traits;
+      const size_t _nbscalars = array.size() * Traits::Size;
+      std::vector<char> _buffer;
+      const char * _data = NULL;
+      if (!readBlock(_nbscalars * sizeof(FileScalar), _buffer, _data)) return;
+      if (!__swap_bytes && isBinaryBlockPacked<Element, FileScalar>()) {
+          memcpy((char *)&*array.begin(), _data, _nbscalars * sizeof(FileScalar));
+      }
+      else {
+          for (typename Array::iterator it = array.begin(); it != array.end(); ++it) {
+              readScalars<FileScalar>(_data, Traits::components(*it), Traits::Size);
+              _data += Traits::Size * sizeof(FileScalar);
+          }
+      }
+  }
+
+  /// convert \e nb scalars of type \e FileScalar stored at \e data into \e result.
+  template <class FileScalar, class Scalar>
+  void readScalars(const char * data, Scalar * result, size_t nb) {
+      for (size_t i = 0; i < nb; ++i, data += sizeof(FileScalar)) {
+          FileScalar _value;
+          if (__swap_bytes) flipBytes(data, (char *)&_value, sizeof(FileScalar));
+          else memcpy(&_value, data, sizeof(FileScalar));
+          result[i] = Scalar(_value);
+      }
+  }
+
+  /** read a block of \e size bytes once decoded. \e data points either in the mapped file
+      or in \e buffer. Returns false on error. */
+  bool readBlock(size_t size, std::vector<char>& buffer, const char *& data);
+
+  /// Whether arrays are stored as blocks in the current file.
+  bool hasArrayBlocks() const;
+
   template <class Array>
   RCPtr<Array> loadArray() {
       std::string classname = read<std::string>();
@@ -458,6 +545,9 @@ public:
 
   bool __double_precision;
 
+  /// Whether the array blocks have to be byte swapped.
+  bool __swap_bytes;
+
 };
 
 template<>
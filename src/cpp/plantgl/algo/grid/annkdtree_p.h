@@ -49,6 +49,9 @@
 #include "../algo_config.h"
 #include <plantgl/scenegraph/container/pointarray.h>
 #include <plantgl/scenegraph/container/indexarray.h>
+#include "flatkdtree_p.h"
+#include <memory>
+#include <mutex>
 
 #ifdef PGL_WITH_ANN
 #include <ANN/ANN.h>
@@ -182,6 +185,10 @@ class ANNKDTreeInternal
     ANNkd_tree __kdtree;
     size_t __nbpoints;
 
+    // thread safe copy of the tree used for the batched queries. Built on first use.
+    std::unique_ptr<FlatKDTree<VectorType> > __flattree;
+    std::mutex __flattreemutex;
+
     public:
 
         ANNKDTreeInternal(const PointContainerPtr points) :
@@ -232,6 +239,19 @@ class ANNKDTreeInternal
         }
 
         inline size_t size() { return __nbpoints; }
+
+        const FlatKDTree<VectorType>& flatTree()
+        {
+            std::lock_guard<std::mutex> lock(__flattreemutex);
+            if (!__flattree) {
+                std::vector<VectorType> points(__nbpoints);
+                for (size_t i = 0; i < __nbpoints; ++i)
+                    for (uchar_t d = 0; d < VectorType::size(); ++d)
+                        points[i][d] = __pointdata[i][d];
+                __flattree.reset(new FlatKDTree<VectorType>(points));
+            }
+            return *__flattree;
+        }
 };
 
 
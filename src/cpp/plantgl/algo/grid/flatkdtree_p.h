@@ -0,0 +1,308 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/* ----------------------------------------------------------------------- */
+
+#ifndef __flatkdtree_p__
+#define __flatkdtree_p__
+
+#include "../algo_config.h"
+#include <plantgl/scenegraph/container/csrindexarray.h>
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <plantgl/tool/util_taskscheduler.h>
+#include <algorithm>
+#include <vector>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class FlatKDTree
+   \brief A static kd-tree stored in flat arrays that can be queried from several threads.
+
+   ANN searches use global variables and thus cannot be run concurrently.
+   This tree is used for the batched queries of the KDTree classes. Each thread
+   passes its own SearchBuffer so that no allocation occurs once buffers are warm.
+*/
+template<class VectorType>
+class FlatKDTree
+{
+public:
+    typedef std::pair<real_t, uint_t> Candidate;
+
+    /// Per thread storage reused between queries.
+    struct SearchBuffer {
+        std::vector<Candidate> candidates;
+        std::vector<std::pair<uint_t, real_t> > stack;
+    };
+
+    FlatKDTree(std::vector<VectorType>& points) :
+        __rank(points.size())
+    {
+        __points.swap(points);
+        __ids.resize(__points.size());
+        for (uint_t i = 0; i < __ids.size(); ++i) __ids[i] = i;
+        if (!__points.empty()) {
+            __nodes.reserve(2 * (__points.size() / LeafSize + 1));
+            build(0, __points.size());
+        }
+        // store the points in tree order for locality of the leaves
+        std::vector<VectorType> sorted(__points.size());
+        for (uint_t i = 0; i < __ids.size(); ++i) {
+            sorted[i] = __points[__ids[i]];
+            __rank[__ids[i]] = i;
+        }
+        __points.swap(sorted);
+    }
+
+    inline size_t size() const { return __points.size(); }
+
+    /// The k closest points of the point \e pid, itself excluded, sorted by increasing distance.
+    void k_closest(uint_t pid, size_t k, SearchBuffer& buffer) const
+    {
+        std::vector<Candidate>& heap = buffer.candidates;
+        heap.clear();
+        if (k == 0 || __nodes.empty()) return;
+        const VectorType& query = __points[__rank[pid]];
+        std::vector<std::pair<uint_t, real_t> >& stack = buffer.stack;
+        stack.clear();
+        stack.push_back(std::make_pair(0, real_t(0)));
+        while (!stack.empty()) {
+            uint_t nodeid = stack.back().first;
+            real_t lowerbound = stack.back().second;
+            stack.pop_back();
+            if (heap.size() == k && lowerbound >= heap.front().first) continue;
+            const Node& node = __nodes[nodeid];
+            if (node.left == 0) {
+                for (uint_t i = node.begin; i < node.end; ++i) {
+                    if (__ids[i] == pid) continue;
+                    real_t d = sqrDistance(query, __points[i]);
+                    if (heap.size() < k) {
+                        heap.push_back(Candidate(d, __ids[i]));
+                        std::push_heap(heap.begin(), heap.end());
+                    }
+                    else if (d < heap.front().first) {
+                        std::pop_heap(heap.begin(), heap.end());
+                        heap.back() = Candidate(d, __ids[i]);
+                        std::push_heap(heap.begin(), heap.end());
+                    }
+                }
+            }
+            else pushChildren(node, query, lowerbound, stack);
+        }
+        std::sort_heap(heap.begin(), heap.end());
+    }
+
+    /// The points at a distance lower or equal to \e radius of the point \e pid, itself excluded, sorted by increasing distance.
+    void r_closest(uint_t pid, real_t radius, SearchBuffer& buffer) const
+    {
+        std::vector<Candidate>& result = buffer.candidates;
+        result.clear();
+        if (__nodes.empty()) return;
+        real_t sqrRadius = radius * radius;
+        const VectorType& query = __points[__rank[pid]];
+        std::vector<std::pair<uint_t, real_t> >& stack = buffer.stack;
+        stack.clear();
+        stack.push_back(std::make_pair(0, real_t(0)));
+        while (!stack.empty()) {
+            uint_t nodeid = stack.back().first;
+            real_t lowerbound = stack.back().second;
+            stack.pop_back();
+            if (lowerbound > sqrRadius) continue;
+            const Node& node = __nodes[nodeid];
+            if (node.left == 0) {
+                for (uint_t i = node.begin; i < node.end; ++i) {
+                    if (__ids[i] == pid) continue;
+                    real_t d = sqrDistance(query, __points[i]);
+                    if (d <= sqrRadius) result.push_back(Candidate(d, __ids[i]));
+                }
+            }
+            else pushChildren(node, query, lowerbound, stack);
+        }
+        std::sort(result.begin(), result.end());
+    }
+
+    /// Grain size used to split \e nbPoints queries among threads.
+    static size_t grainSize(size_t nbPoints)
+    { return std::max<size_t>(256, nbPoints / (4 * (TaskScheduler::get().nbThreads() + 1))); }
+
+    /// The k closest points of all the points. All rows have min(k, size()-1) elements.
+    CSRIndexArrayPtr k_nearest_neighbors(size_t k, RealArrayPtr * distances = NULL) const
+    {
+        size_t nbPoints = size();
+        size_t rowsize = std::min<size_t>(k, nbPoints > 0 ? nbPoints - 1 : 0);
+        CSRIndexArrayPtr result(new CSRIndexArray(nbPoints, rowsize));
+        std::vector<uint_t>& indices = result->getIndices();
+        real_t * dists = NULL;
+        if (distances) {
+            *distances = RealArrayPtr(new RealArray(nbPoints * rowsize));
+            dists = (*distances)->data();
+        }
+        parallel_for_range(0, nbPoints, [&](size_t begin, size_t end) {
+            SearchBuffer buffer;
+            for (size_t pid = begin; pid < end; ++pid) {
+                k_closest(uint_t(pid), rowsize, buffer);
+                size_t offset = pid * rowsize;
+                for (size_t i = 0; i < rowsize; ++i) {
+                    indices[offset + i] = buffer.candidates[i].second;
+                    if (dists) dists[offset + i] = sqrt(buffer.candidates[i].first);
+                }
+            }
+        }, grainSize(nbPoints));
+        return result;
+    }
+
+    /// The points at a distance lower or equal to \e radius of all the points.
+    CSRIndexArrayPtr r_nearest_neighbors(real_t radius, RealArrayPtr * distances = NULL) const
+    {
+        size_t nbPoints = size();
+        size_t grainsize = grainSize(nbPoints);
+        size_t nbchunks = (nbPoints + grainsize - 1) / grainsize;
+        std::vector<CSRIndexArray> chunks(nbchunks);
+        std::vector<std::vector<real_t> > chunkdists(distances ? nbchunks : 0);
+        parallel_for_range(0, nbPoints, [&](size_t begin, size_t end) {
+            size_t chunkid = begin / grainsize;
+            CSRIndexArray& chunk = chunks[chunkid];
+            SearchBuffer buffer;
+            std::vector<uint_t> row;
+            for (size_t pid = begin; pid < end; ++pid) {
+                r_closest(uint_t(pid), radius, buffer);
+                row.clear();
+                for (typename std::vector<Candidate>::const_iterator it = buffer.candidates.begin(); it != buffer.candidates.end(); ++it) {
+                    row.push_back(it->second);
+                    if (distances) chunkdists[chunkid].push_back(sqrt(it->first));
+                }
+                chunk.pushRow(row);
+            }
+        }, grainsize);
+
+        size_t nbindices = 0;
+        for (typename std::vector<CSRIndexArray>::const_iterator it = chunks.begin(); it != chunks.end(); ++it) nbindices += it->getNbIndices();
+        CSRIndexArrayPtr result(new CSRIndexArray());
+        result->reserve(nbPoints, nbindices);
+        for (typename std::vector<CSRIndexArray>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+            result->append(*it);
+            it->clear();
+        }
+        if (distances) {
+            *distances = RealArrayPtr(new RealArray(nbindices));
+            RealArray::iterator itd = (*distances)->begin();
+            for (size_t c = 0; c < nbchunks; ++c)
+                itd = std::copy(chunkdists[c].begin(), chunkdists[c].end(), itd);
+        }
+        return result;
+    }
+
+protected:
+    enum { LeafSize = 8 };
+
+    /// A node covers __ids[begin:end]. Leaves have no children (left == 0, as the root is never a child).
+    struct Node {
+        real_t split;
+        uint_t dim;
+        uint_t begin, end;
+        uint_t left, right;
+    };
+
+    static inline real_t sqrDistance(const VectorType& a, const VectorType& b) {
+        real_t d = 0;
+        for (uchar_t i = 0; i < VectorType::size(); ++i) { real_t c = a[i] - b[i]; d += c * c; }
+        return d;
+    }
+
+    inline void pushChildren(const Node& node, const VectorType& query, real_t lowerbound,
+                             std::vector<std::pair<uint_t, real_t> >& stack) const {
+        real_t diff = query[node.dim] - node.split;
+        uint_t nearchild = diff < 0 ? node.left : node.right;
+        uint_t farchild = diff < 0 ? node.right : node.left;
+        // the far child is pushed first so that the near one is visited first.
+        stack.push_back(std::make_pair(farchild, std::max(lowerbound, diff * diff)));
+        stack.push_back(std::make_pair(nearchild, lowerbound));
+    }
+
+    uint_t build(size_t begin, size_t end) {
+        uint_t nodeid = __nodes.size();
+        Node node;
+        node.begin = begin; node.end = end; node.left = node.right = 0;
+        node.dim = 0; node.split = 0;
+        __nodes.push_back(node);
+        if (end - begin <= LeafSize) return nodeid;
+
+        // split along the dimension of largest extent
+        VectorType lower = __points[__ids[begin]], upper = lower;
+        for (size_t i = begin + 1; i < end; ++i) {
+            const VectorType& p = __points[__ids[i]];
+            for (uchar_t d = 0; d < VectorType::size(); ++d) {
+                if (p[d] < lower[d]) lower[d] = p[d];
+                else if (p[d] > upper[d]) upper[d] = p[d];
+            }
+        }
+        uchar_t dim = 0;
+        for (uchar_t d = 1; d < VectorType::size(); ++d)
+            if (upper[d] - lower[d] > upper[dim] - lower[dim]) dim = d;
+
+        size_t mid = (begin + end) / 2;
+        std::nth_element(__ids.begin() + begin, __ids.begin() + mid, __ids.begin() + end,
+                         [this, dim](uint_t a, uint_t b) { return __points[a][dim] < __points[b][dim]; });
+        real_t split = __points[__ids[mid]][dim];
+
+        uint_t left = build(begin, mid);
+        uint_t right = build(mid, end);
+        Node& n = __nodes[nodeid];
+        n.dim = dim; n.split = split; n.left = left; n.right = right;
+        return nodeid;
+    }
+
+    std::vector<VectorType> __points;
+    std::vector<uint_t> __ids;
+    std::vector<uint_t> __rank;
+    std::vector<Node> __nodes;
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#endif
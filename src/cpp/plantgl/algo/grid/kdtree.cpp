@@ -74,6 +74,12 @@ PGL_USING_NAMESPACE
     IndexArrayPtr PGL(ANN##basename)::r_nearest_neighbors(real_t radius)  \
     { return __internal->r_nearest_neighbors(radius); } \
     \
+    CSRIndexArrayPtr PGL(ANN##basename)::k_nearest_neighbors_mt(size_t k, RealArrayPtr * distances)  \
+    { return __internal->flatTree().k_nearest_neighbors(k, distances); } \
+    \
+    CSRIndexArrayPtr PGL(ANN##basename)::r_nearest_neighbors_mt(real_t radius, RealArrayPtr * distances)  \
+    { return __internal->flatTree().r_nearest_neighbors(radius, distances); } \
+    \
     size_t PGL(ANN##basename)::size()  const \
     { return __internal->size(); } \
 
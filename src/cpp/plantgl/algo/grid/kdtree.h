@@ -53,6 +53,8 @@
 #include "../algo_config.h"
 #include <plantgl/scenegraph/container/pointarray.h>
 #include <plantgl/scenegraph/container/indexarray.h>
+#include <plantgl/scenegraph/container/csrindexarray.h>
+#include <plantgl/tool/util_array.h>
 
 /* ----------------------------------------------------------------------- */
 
@@ -92,6 +94,13 @@ public:
 
     virtual IndexArrayPtr r_nearest_neighbors(real_t radius) = 0;
 
+    /// k nearest neighbors of all the points, computed in parallel into a flat array.
+    /// If \e distances is given, it receives the distances aligned with the indices.
+    virtual CSRIndexArrayPtr k_nearest_neighbors_mt(size_t k, RealArrayPtr * distances = NULL) = 0;
+
+    /// Neighbors at a distance lower or equal to \e radius of all the points, computed in parallel.
+    virtual CSRIndexArrayPtr r_nearest_neighbors_mt(real_t radius, RealArrayPtr * distances = NULL) = 0;
+
     virtual size_t size() const = 0;
 
 };
@@ -124,6 +133,8 @@ class ANNKDTree4Internal;
         virtual Index k_closest_points(const VectorType& pointclass, size_t k, real_t maxdist = REAL_MAX);  \
         virtual IndexArrayPtr k_nearest_neighbors(size_t k) ; \
         virtual IndexArrayPtr r_nearest_neighbors(real_t radius) ; \
+        virtual CSRIndexArrayPtr k_nearest_neighbors_mt(size_t k, RealArrayPtr * distances = NULL) ; \
+        virtual CSRIndexArrayPtr r_nearest_neighbors_mt(real_t radius, RealArrayPtr * distances = NULL) ; \
         virtual size_t size() const; \
         protected: \
         ANN##basename##Internal * __internal; \
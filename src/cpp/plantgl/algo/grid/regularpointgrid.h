@@ -43,6 +43,7 @@
 #define __regularpointgrid_h__
 
 #include <vector>
+#include <algorithm>
 #include <plantgl/math/util_math.h>
 #include <plantgl/math/util_vector.h>
 #include <plantgl/scenegraph/container/pointarray.h>
@@ -88,16 +89,25 @@ bool is_point_in_cone(const VectorType& point,
 
 /* ----------------------------------------------------------------------- */
 
+/// Storage of all the cells of the grid, empty or not.
+typedef VectorContainer<std::vector<size_t> > DensePointIndexContainer;
+
+/// Storage of the occupied cells of the grid only, for large and mostly empty grids.
+typedef HashContainer<std::vector<size_t> > SparsePointIndexContainer;
+
+/* ----------------------------------------------------------------------- */
+
 template <class PointContainer,
         class ContainerPolicy = LocalContainerPolicy<PointContainer>,
         int NbDimension =
-Dimension<typename PointContainer::element_type>::Nb >
+Dimension<typename PointContainer::element_type>::Nb,
+        class CellContainer = DensePointIndexContainer >
 class PointGrid : public ContainerPolicy, public
-SpatialArrayN<std::vector<size_t>,typename PointContainer::element_type,NbDimension>
+SpatialArrayN<std::vector<size_t>,typename PointContainer::element_type,NbDimension,CellContainer>
 {
 public:
     typedef
-SpatialArrayN<std::vector<size_t>,typename PointContainer::element_type,NbDimension> SpatialBase;
+SpatialArrayN<std::vector<size_t>,typename PointContainer::element_type,NbDimension,CellContainer> SpatialBase;
     typedef typename SpatialBase::Base Base;
 
     typedef PointContainer ContainerType;
@@ -322,10 +332,25 @@ SpatialArrayN<std::vector<size_t>,typename PointContainer::element_type,NbDimens
     inline void disable_points(const PointIndexList& pids)
     { disable_points(pids.begin(), pids.end()); }
 
+    /// Disable a set of points. Points are grouped by voxel so that each voxel is scanned only once.
     template<class ConstIterator>
     void disable_points(ConstIterator begin, ConstIterator end) {
+            std::vector<std::pair<VoxelId, PointIndex> > cells;
             for(ConstIterator itPointIndex = begin; itPointIndex != end; ++itPointIndex){
-                    disable_point(*itPointIndex);
+                    cells.push_back(std::pair<VoxelId, PointIndex>(this->cellIdFromPoint(points().getAt(*itPointIndex)), *itPointIndex));
+            }
+            std::sort(cells.begin(), cells.end());
+            typename std::vector<std::pair<VoxelId, PointIndex> >::const_iterator itCell = cells.begin();
+            while(itCell != cells.end()){
+                    typename std::vector<std::pair<VoxelId, PointIndex> >::const_iterator itCellEnd = itCell;
+                    while(itCellEnd != cells.end() && itCellEnd->first == itCell->first) ++itCellEnd;
+                    PointIndexList& voxelpointlist = this->getAt(itCell->first);
+                    voxelpointlist.erase(std::remove_if(voxelpointlist.begin(), voxelpointlist.end(),
+                                                        [itCell, itCellEnd](PointIndex pid) {
+                                                            return std::binary_search(itCell, itCellEnd, std::pair<VoxelId, PointIndex>(itCell->first, pid));
+                                                        }),
+                                         voxelpointlist.end());
+                    itCell = itCellEnd;
             }
     }
 
@@ -449,13 +474,14 @@ protected:
 };
 
 template <class PointContainer, int NbDimension =
-Dimension<typename PointContainer::element_type>::Nb >
-class PointRefGrid : public PointGrid<PointContainer,ContainerReferencePolicy<PointContainer>,  NbDimension>
+Dimension<typename PointContainer::element_type>::Nb,
+        class CellContainer = DensePointIndexContainer >
+class PointRefGrid : public PointGrid<PointContainer,ContainerReferencePolicy<PointContainer>,  NbDimension, CellContainer>
 {
 public:
     typedef typename PointContainer::element_type VectorType;
     typedef RCPtr<PointContainer> PointContainerPtr;
-    typedef PointGrid<PointContainer,ContainerReferencePolicy<PointContainer>, NbDimension> ParentGridType;
+    typedef PointGrid<PointContainer,ContainerReferencePolicy<PointContainer>, NbDimension, CellContainer> ParentGridType;
 
     PointRefGrid(const VectorType& voxelsize,
               const VectorType& minpoint,
@@ -497,5 +523,22 @@ typedef RCPtr<Point4RefGrid> Point4RefGridPtr;
 
 /* ----------------------------------------------------------------------- */
 
+typedef PointGrid<Point2Array, LocalContainerPolicy<Point2Array>, 2, SparsePointIndexContainer> SparsePoint2Grid;
+typedef PointGrid<Point3Array, LocalContainerPolicy<Point3Array>, 3, SparsePointIndexContainer> SparsePoint3Grid;
+typedef PointGrid<Point4Array, LocalContainerPolicy<Point4Array>, 4, SparsePointIndexContainer> SparsePoint4Grid;
+typedef RCPtr<SparsePoint2Grid> SparsePoint2GridPtr;
+typedef RCPtr<SparsePoint3Grid> SparsePoint3GridPtr;
+typedef RCPtr<SparsePoint4Grid> SparsePoint4GridPtr;
+
+typedef PointRefGrid<Point2Array, 2, SparsePointIndexContainer> SparsePoint2RefGrid;
+typedef PointRefGrid<Point3Array, 3, SparsePointIndexContainer> SparsePoint3RefGrid;
+typedef PointRefGrid<Point4Array, 4, SparsePointIndexContainer> SparsePoint4RefGrid;
+
+typedef RCPtr<SparsePoint2RefGrid> SparsePoint2RefGridPtr;
+typedef RCPtr<SparsePoint3RefGrid> SparsePoint3RefGridPtr;
+typedef RCPtr<SparsePoint4RefGrid> SparsePoint4RefGridPtr;
+
+/* ----------------------------------------------------------------------- */
+
 PGL_END_NAMESPACE
 #endif
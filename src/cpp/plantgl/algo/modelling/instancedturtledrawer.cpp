@@ -0,0 +1,301 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+#include "instancedturtledrawer.h"
+#include <plantgl/algo/base/tesselator.h>
+#include <plantgl/scenegraph/geometry/sphere.h>
+#include <plantgl/scenegraph/geometry/cylinder.h>
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <plantgl/scenegraph/container/indexarray.h>
+#include <plantgl/scenegraph/scene/shape.h>
+#include <plantgl/math/util_math.h>
+#include <plantgl/tool/util_taskscheduler.h>
+
+PGL_USING_NAMESPACE
+
+#define FABS(a) (a < 0 ? -(a) : a)
+
+/*----------------------------------------------------------*/
+
+InstancedTurtleDrawer::InstancedTurtleDrawer() :
+    PglTurtleDrawer(),
+    __expandedInstances(0),
+    __expandedShapes(0)
+{ }
+
+InstancedTurtleDrawer::~InstancedTurtleDrawer() { }
+
+void InstancedTurtleDrawer::reset()
+{
+    PglTurtleDrawer::reset();
+    __instances.clear();
+    __appearances.clear();
+    __appearanceIndex.clear();
+    __expandedScene = ScenePtr();
+}
+
+bool InstancedTurtleDrawer::isInstanciable(const AppearancePtr& appearance, const FrameInfo& frameinfo) const
+{
+    // textures need texture coordinates and projected geometries a dedicated node.
+    return !frameinfo.screenprojection && (is_null_ptr(appearance) || !appearance->isTexture());
+}
+
+void InstancedTurtleDrawer::addInstance(ePrimitiveType type, const id_pair ids, const AppearancePtr& appearance, uint_t resolution,
+                                        const Vector3& xaxis, const Vector3& yaxis, const Vector3& zaxis, const Vector3& position,
+                                        real_t bottomradius, real_t topradius)
+{
+    std::pair<std::unordered_map<const Appearance *, uint_t>::iterator, bool> app =
+        __appearanceIndex.insert(std::make_pair(appearance.get(), uint_t(__appearances.size())));
+    if (app.second) __appearances.push_back(appearance);
+
+    Instance instance;
+    instance.type = type;
+    instance.resolution = resolution;
+    instance.appearance = app.first->second;
+    instance.id = ids.id;
+    instance.parent_id = ids.parent_id;
+    for (int i = 0; i < 3; ++i) {
+        instance.frame[4*i]   = xaxis[i];
+        instance.frame[4*i+1] = yaxis[i];
+        instance.frame[4*i+2] = zaxis[i];
+        instance.frame[4*i+3] = position[i];
+    }
+    instance.radius[0] = bottomradius;
+    instance.radius[1] = topradius;
+    __instances.push_back(instance);
+}
+
+/*----------------------------------------------------------*/
+
+// The frames follow PglTurtleDrawer::transform: local X is up, local Y is -left and local Z is heading.
+
+void InstancedTurtleDrawer::cylinder(const id_pair ids,
+                                     AppearancePtr appearance,
+                                     const FrameInfo& frameinfo,
+                                     real_t length,
+                                     real_t radius,
+                                     uint_t sectionResolution)
+{
+    if (fabs(length) <= GEOM_EPSILON) return;
+    if (FABS(radius) < GEOM_EPSILON || !isInstanciable(appearance, frameinfo)) {
+        PglTurtleDrawer::cylinder(ids, appearance, frameinfo, length, radius, sectionResolution);
+        return;
+    }
+    if ( frameinfo.scaling !=  Vector3(1,1,1) &&
+        (frameinfo.scaling.x() == frameinfo.scaling.y()))
+        radius *= frameinfo.scaling.x();
+    addInstance(eCylinder, ids, appearance, sectionResolution,
+                frameinfo.up * radius, -frameinfo.left * radius, frameinfo.heading * (length * frameinfo.scaling.z()),
+                frameinfo.position, radius, radius);
+}
+
+void InstancedTurtleDrawer::frustum(const id_pair ids,
+                                    AppearancePtr appearance,
+                                    const FrameInfo& frameinfo,
+                                    real_t length,
+                                    real_t baseradius,
+                                    real_t topradius,
+                                    uint_t sectionResolution)
+{
+    if (fabs(length) <= GEOM_EPSILON) return;
+    if (FABS(baseradius) <= GEOM_EPSILON || !isInstanciable(appearance, frameinfo)) {
+        PglTurtleDrawer::frustum(ids, appearance, frameinfo, length, baseradius, topradius, sectionResolution);
+        return;
+    }
+    real_t taper = topradius/baseradius;
+    if (frameinfo.scaling !=  Vector3(1,1,1) &&
+        (frameinfo.scaling.x() == frameinfo.scaling.y()))
+        baseradius *= frameinfo.scaling.x();
+    if (FABS(taper) < GEOM_EPSILON) taper = 0;
+    ePrimitiveType type = (FABS(taper-1.0) < GEOM_EPSILON ? eCylinder : eFrustum);
+    addInstance(type, ids, appearance, sectionResolution,
+                frameinfo.up * baseradius, -frameinfo.left * baseradius, frameinfo.heading * (length * frameinfo.scaling.z()),
+                frameinfo.position, baseradius, type == eCylinder ? baseradius : baseradius * taper);
+}
+
+void InstancedTurtleDrawer::sphere(const id_pair ids,
+                                   AppearancePtr appearance,
+                                   const FrameInfo& frameinfo,
+                                   real_t radius,
+                                   uint_t sectionResolution)
+{
+    if (!isInstanciable(appearance, frameinfo)) {
+        PglTurtleDrawer::sphere(ids, appearance, frameinfo, radius, sectionResolution);
+        return;
+    }
+    Vector3 scaling;
+    uint_t resolution = sectionResolution;
+    if (sectionResolution == Cylinder::DEFAULT_SLICES){
+        scaling = frameinfo.scaling * radius;
+        resolution = 0;
+    }
+    else {
+        // same sizing rule as PglTurtleDrawer::sphere
+        bool anisotropicscaling = !( frameinfo.scaling !=  Vector3(1,1,1) &&
+                                    (frameinfo.scaling.x() == frameinfo.scaling.y() &&
+                                     frameinfo.scaling.y() == frameinfo.scaling.z() ));
+        real_t r = (anisotropicscaling ? radius * frameinfo.scaling.x() : radius);
+        scaling = Vector3(r, r, r);
+    }
+    addInstance(eSphere, ids, appearance, resolution,
+                frameinfo.up * scaling.x(), -frameinfo.left * scaling.y(), frameinfo.heading * scaling.z(),
+                frameinfo.position, radius, radius);
+}
+
+/*----------------------------------------------------------*/
+
+TriangleSetPtr InstancedTurtleDrawer::unitSphere(uint_t resolution) const
+{
+    std::map<uint_t, TriangleSetPtr>::const_iterator it = __unitSpheres.find(resolution);
+    if (it != __unitSpheres.end()) return it->second;
+
+    SpherePtr sphere(resolution == 0 ? new Sphere(1) : new Sphere(1, uchar_t(resolution), uchar_t(resolution)));
+    Tesselator t;
+    sphere->apply(t);
+    TriangleSetPtr result = t.getTriangulation();
+    __unitSpheres[resolution] = result;
+    return result;
+}
+
+const ScenePtr& InstancedTurtleDrawer::getScene() const
+{
+    if (__instances.empty()) return __scene;
+    // the expanded scene is rebuilt only if instances or shapes were added since the last call.
+    if (is_null_ptr(__expandedScene) || __expandedInstances != __instances.size() || __expandedShapes != __scene->size()) {
+        __expandedScene = ScenePtr(new Scene(*__scene));
+        __expandedScene->merge(expand());
+        __expandedInstances = __instances.size();
+        __expandedShapes = __scene->size();
+    }
+    return __expandedScene;
+}
+
+ScenePtr InstancedTurtleDrawer::expand() const
+{
+    ScenePtr result(new Scene());
+    size_t nbinstances = __instances.size();
+    if (nbinstances == 0) return result;
+
+    // size of each instance and position in its appearance group
+    size_t nbgroups = __appearances.size();
+    std::vector<size_t> pointOffset(nbinstances), triangleOffset(nbinstances);
+    std::vector<size_t> groupPoints(nbgroups, 0), groupTriangles(nbgroups, 0);
+    std::vector<const TriangleSet *> spheres(nbinstances, NULL);
+
+    for (size_t i = 0; i < nbinstances; ++i) {
+        const Instance& instance = __instances[i];
+        size_t nbpoints, nbtriangles;
+        if (instance.type == eSphere) {
+            spheres[i] = unitSphere(instance.resolution).get();
+            nbpoints = spheres[i]->getPointList()->size();
+            nbtriangles = spheres[i]->getIndexList()->size();
+        }
+        else if (instance.type == eFrustum && instance.radius[1] == 0) {
+            nbpoints = instance.resolution + 1;
+            nbtriangles = instance.resolution;
+        }
+        else {
+            nbpoints = 2 * instance.resolution;
+            nbtriangles = 2 * instance.resolution;
+        }
+        pointOffset[i] = groupPoints[instance.appearance];
+        triangleOffset[i] = groupTriangles[instance.appearance];
+        groupPoints[instance.appearance] += nbpoints;
+        groupTriangles[instance.appearance] += nbtriangles;
+    }
+
+    std::vector<Point3ArrayPtr> points(nbgroups);
+    std::vector<Index3ArrayPtr> indices(nbgroups);
+    for (size_t g = 0; g < nbgroups; ++g) {
+        points[g] = Point3ArrayPtr(new Point3Array(groupPoints[g]));
+        indices[g] = Index3ArrayPtr(new Index3Array(groupTriangles[g]));
+    }
+
+    parallel_for_range(0, nbinstances, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const Instance& instance = __instances[i];
+            Point3Array::iterator pts = points[instance.appearance]->begin() + pointOffset[i];
+            Index3Array::iterator tris = indices[instance.appearance]->begin() + triangleOffset[i];
+            uint_t start = uint_t(pointOffset[i]);
+
+            // mirrored frames reverse the orientation of the faces
+            const real_t * f = instance.frame;
+            real_t det = f[0]*(f[5]*f[10]-f[6]*f[9]) - f[1]*(f[4]*f[10]-f[6]*f[8]) + f[2]*(f[4]*f[9]-f[5]*f[8]);
+            bool flip = det < 0;
+            #define SET_TRIANGLE(a,b,c) (*tris++ = (flip ? Index3(start+(a),start+(c),start+(b)) : Index3(start+(a),start+(b),start+(c))))
+
+            if (instance.type == eSphere) {
+                const TriangleSet * sphere = spheres[i];
+                for (Point3Array::const_iterator it = sphere->getPointList()->begin(); it != sphere->getPointList()->end(); ++it, ++pts)
+                    *pts = instance.transform(it->x(), it->y(), it->z());
+                for (Index3Array::const_iterator it = sphere->getIndexList()->begin(); it != sphere->getIndexList()->end(); ++it)
+                    SET_TRIANGLE(it->getAt(0), it->getAt(1), it->getAt(2));
+            }
+            else {
+                uint_t res = instance.resolution;
+                real_t taper = (instance.type == eCylinder ? 1 : instance.radius[1] / instance.radius[0]);
+                bool apex = (taper == 0);
+                real_t angle = 2 * GEOM_PI / res;
+                for (uint_t k = 0; k < res; ++k) {
+                    real_t c = cos(k * angle), s = sin(k * angle);
+                    pts[k] = instance.transform(c, s, 0);
+                    if (!apex) pts[res + k] = instance.transform(taper * c, taper * s, 1);
+                }
+                if (apex) pts[res] = instance.transform(0, 0, 1);
+                for (uint_t k = 0; k < res; ++k) {
+                    uint_t k1 = (k + 1 == res ? 0 : k + 1);
+                    if (apex) SET_TRIANGLE(k, k1, res);
+                    else {
+                        SET_TRIANGLE(k, k1, res + k1);
+                        SET_TRIANGLE(k, res + k1, res + k);
+                    }
+                }
+            }
+            #undef SET_TRIANGLE
+        }
+    });
+
+    for (size_t g = 0; g < nbgroups; ++g)
+        if (groupTriangles[g] > 0)
+            result->add(ShapePtr(new Shape(GeometryPtr(new TriangleSet(points[g], indices[g])), __appearances[g])));
+    return result;
+}
+
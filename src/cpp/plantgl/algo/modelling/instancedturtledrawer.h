@@ -0,0 +1,158 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#ifndef __PGL_INSTANCEDTURTLEDRAWER_H__
+#define __PGL_INSTANCEDTURTLEDRAWER_H__
+
+#include "pglturtledrawer.h"
+
+#include <plantgl/scenegraph/geometry/triangleset.h>
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+
+PGL_BEGIN_NAMESPACE
+
+/**
+   \class InstancedTurtleDrawer
+   \brief A turtle drawer that records cylinders, frustums, cones and spheres
+   in a compact instance table instead of building one scene graph node chain per primitive.
+
+   Each instance stores its primitive type, the 3x4 affine frame that maps the unit
+   primitive into the scene, its radii and its ids. The table can be consumed directly
+   or expanded into one merged TriangleSet per appearance. Other primitives, textured
+   appearances and screen projected geometries are drawn as with PglTurtleDrawer.
+*/
+class ALGO_API InstancedTurtleDrawer : public PglTurtleDrawer {
+public:
+
+    enum ePrimitiveType {
+        eCylinder, //!< Unit cylinder of radius 1 along Z between 0 and 1.
+        eFrustum,  //!< Unit frustum of base radius 1 along Z between 0 and 1 and top radius radius[1]/radius[0].
+        eSphere    //!< Unit sphere centered on the origin.
+    };
+
+    struct Instance {
+        uint_t type;        //!< ePrimitiveType
+        uint_t resolution;  //!< Section resolution (0 for default sphere)
+        uint_t appearance;  //!< Index in the appearance table
+        uint_t id;
+        uint_t parent_id;
+        real_t frame[12];   //!< Row-major 3x4 affine transformation of the unit primitive
+        real_t radius[2];   //!< Bottom and top radius (sphere radius for both for spheres)
+
+        Vector3 transform(real_t x, real_t y, real_t z) const
+        { return Vector3(frame[0]*x+frame[1]*y+frame[2]*z+frame[3],
+                         frame[4]*x+frame[5]*y+frame[6]*z+frame[7],
+                         frame[8]*x+frame[9]*y+frame[10]*z+frame[11]); }
+    };
+
+    typedef std::vector<Instance> InstanceTable;
+
+    InstancedTurtleDrawer();
+
+    virtual ~InstancedTurtleDrawer();
+
+    virtual void  reset();
+
+    /// Return the scene with the instances expanded into one TriangleSet per appearance.
+    virtual const ScenePtr& getScene() const;
+
+    /// Expand the instances into a scene containing one merged TriangleSet per appearance.
+    ScenePtr expand() const;
+
+    const InstanceTable& getInstances() const { return __instances; }
+
+    const std::vector<AppearancePtr>& getAppearances() const { return __appearances; }
+
+    /// Return the scene of the primitives that were not instanced.
+    const ScenePtr& getNonInstancedScene() const { return __scene; }
+
+    virtual void cylinder(const id_pair ids,
+                          AppearancePtr appearance,
+                          const FrameInfo& frameinfo,
+                          real_t length,
+                          real_t radius,
+                          uint_t sectionResolution);
+
+    virtual void frustum( const id_pair ids,
+                          AppearancePtr appearance,
+                          const FrameInfo& frameinfo,
+                          real_t length,
+                          real_t baseradius,
+                          real_t topradius,
+                          uint_t sectionResolution);
+
+    virtual void sphere(const id_pair ids,
+                        AppearancePtr appearance,
+                        const FrameInfo& frameinfo,
+                        real_t radius,
+                        uint_t sectionResolution);
+
+protected:
+
+    bool isInstanciable(const AppearancePtr& appearance, const FrameInfo& frameinfo) const;
+
+    void addInstance(ePrimitiveType type, const id_pair ids, const AppearancePtr& appearance, uint_t resolution,
+                     const Vector3& xaxis, const Vector3& yaxis, const Vector3& zaxis, const Vector3& position,
+                     real_t bottomradius, real_t topradius);
+
+    TriangleSetPtr unitSphere(uint_t resolution) const;
+
+    InstanceTable __instances;
+    std::vector<AppearancePtr> __appearances;
+    std::unordered_map<const Appearance *, uint_t> __appearanceIndex;
+
+    mutable std::map<uint_t, TriangleSetPtr> __unitSpheres;
+    mutable ScenePtr __expandedScene;
+    mutable size_t __expandedInstances;
+    mutable size_t __expandedShapes;
+};
+
+typedef RCPtr<InstancedTurtleDrawer> InstancedTurtleDrawerPtr;
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+#endif
+
@@ -64,7 +64,7 @@ public:
 
     virtual ~PglTurtleDrawer();
 
-    const ScenePtr& getScene() const
+    virtual const ScenePtr& getScene() const
     { return __scene;  }
 
     virtual void  reset();
@@ -43,6 +43,8 @@
 #include "../base/pointmanipulation.h"
 #include <plantgl/scenegraph/container/indexarray_iterator.h>
 #include <plantgl/math/util_math.h>
+#include <plantgl/tool/util_taskscheduler.h>
+#include <plantgl/tool/util_profile.h>
 
 PGL_USING_NAMESPACE
 
@@ -535,3 +537,207 @@ Vector3 GraphColonization::junction_point(size_t nid1, size_t nid2) const
     return centroid_of_group(attractors, junction_components(nid1,nid2));
 }
 /* ----------------------------------------------------------------------- */
+
+const uint32_t SpaceColonizationEngine::NOID(UINT32_MAX);
+
+SpaceColonizationEngine::SpaceColonizationEngine(const Point3ArrayPtr _attractors,
+                                                 real_t _nodelength,
+                                                 real_t _kill_radius,
+                                                 real_t _perception_radius,
+                                                 const Vector3& rootnode,
+                                                 real_t voxelsize):
+    nodelength(_nodelength),
+    kill_radius(_kill_radius),
+    perception_radius(_perception_radius),
+    min_nb_pt_per_bud(1),
+    nbIteration(0),
+    attractors(_attractors),
+    skeletonnodes(new Point3Array(1, rootnode)),
+    skeletonparents(new Uint32Array1(1, 0)),
+    nbalive(0)
+{
+    init(voxelsize);
+}
+
+SpaceColonizationEngine::SpaceColonizationEngine(const Point3ArrayPtr _attractors,
+                                                 real_t _nodelength,
+                                                 real_t _kill_radius,
+                                                 real_t _perception_radius,
+                                                 const Point3ArrayPtr initialskeletonnodes,
+                                                 const Uint32ArrayPtr initialskeletonparents,
+                                                 real_t voxelsize):
+    nodelength(_nodelength),
+    kill_radius(_kill_radius),
+    perception_radius(_perception_radius),
+    min_nb_pt_per_bud(1),
+    nbIteration(0),
+    attractors(_attractors),
+    skeletonnodes(new Point3Array(*initialskeletonnodes)),
+    skeletonparents(is_null_ptr(initialskeletonparents) ? new Uint32Array1(range<Uint32Array1>(initialskeletonnodes->size(), 0, 1)) : new Uint32Array1(*initialskeletonparents)),
+    nbalive(0)
+{
+    init(voxelsize);
+}
+
+SpaceColonizationEngine::~SpaceColonizationEngine()
+{
+}
+
+void SpaceColonizationEngine::init(real_t voxelsize)
+{
+    // voxels of half the perception radius keep both the number of voxels and of tested points per query low.
+    attractor_grid = Point3GridPtr(new Point3Grid(voxelsize > 0 ? voxelsize : perception_radius / 2, attractors));
+    size_t nbattractors = attractors->size();
+    nearestnode.assign(nbattractors, NOID);
+    nearestdistance.assign(nbattractors, REAL_MAX);
+    alive.assign(nbattractors, 1);
+    nbalive = nbattractors;
+    newnodes = range<Index>(skeletonnodes->size(), 0, 1);
+    modified.assign(skeletonnodes->size(), 0);
+}
+
+void SpaceColonizationEngine::update_assignments(const Index& nodes)
+{
+    struct Candidate {
+        uint32_t attractor;
+        uint32_t node;
+        real_t distance;
+    };
+
+    // scan the voxels around each node in parallel. Candidates of each range of nodes are
+    // stored separately and merged in node order so that ties are resolved as in a sequential run.
+    size_t nbnodes = nodes.size();
+    size_t grainsize = std::max<size_t>(64, nbnodes / (4 * (TaskScheduler::get().nbThreads() + 1)));
+    std::vector<std::vector<Candidate> > chunks((nbnodes + grainsize - 1) / grainsize);
+    parallel_for_range(0, nbnodes, [&](size_t begin, size_t end) {
+        std::vector<Candidate>& candidates = chunks[begin / grainsize];
+        real_t sqperception = perception_radius * perception_radius;
+        real_t sqkill = kill_radius * kill_radius;
+        for (size_t i = begin; i < end; ++i) {
+            uint32_t nid = nodes[i];
+            const Vector3& position = skeletonnodes->getAt(nid);
+            const real_t * p = position.data();
+            Point3Grid::VoxelIdList voxels = attractor_grid->query_voxels_around_point(position, perception_radius);
+            for (Point3Grid::VoxelIdList::const_iterator itvoxel = voxels.begin(); itvoxel != voxels.end(); ++itvoxel) {
+                const AttractorList& voxelattractors = attractor_grid->getVoxelPointIndices(*itvoxel);
+                for (AttractorList::const_iterator it = voxelattractors.begin(); it != voxelattractors.end(); ++it) {
+                    const real_t * a = attractors->getAt(*it).data();
+                    real_t dx = a[0] - p[0], dy = a[1] - p[1], dz = a[2] - p[2];
+                    real_t sqdistance = dx * dx + dy * dy + dz * dz;
+                    if (sqdistance > sqperception || !alive[*it]) continue;
+                    // assignments are only modified in the sequential merge, so they can be read here.
+                    if (sqdistance > sqkill && nearestnode[*it] != NOID && !(sqdistance < nearestdistance[*it] * nearestdistance[*it])) continue;
+                    Candidate candidate = { uint32_t(*it), nid, std::sqrt(sqdistance) };
+                    candidates.push_back(candidate);
+                }
+            }
+        }
+    }, grainsize);
+
+    modified.resize(skeletonnodes->size(), 0);
+    AttractorList killed;
+    for (std::vector<std::vector<Candidate> >::const_iterator itchunk = chunks.begin(); itchunk != chunks.end(); ++itchunk) {
+        for (std::vector<Candidate>::const_iterator it = itchunk->begin(); it != itchunk->end(); ++it) {
+            uint32_t aid = it->attractor;
+            if (!alive[aid]) continue;
+            uint32_t previous = nearestnode[aid];
+            if (it->distance <= kill_radius) {
+                alive[aid] = 0;
+                nearestnode[aid] = NOID;
+                killed.push_back(aid);
+                if (previous != NOID) modified[previous] = 1;
+            }
+            else if (previous == NOID) {
+                nearestnode[aid] = it->node;
+                nearestdistance[aid] = it->distance;
+                assigned.push_back(aid);
+                modified[it->node] = 1;
+            }
+            else if (it->distance < nearestdistance[aid]) {
+                nearestnode[aid] = it->node;
+                nearestdistance[aid] = it->distance;
+                modified[previous] = 1;
+                modified[it->node] = 1;
+            }
+        }
+    }
+
+    if (!killed.empty()) {
+        nbalive -= killed.size();
+        assigned.erase(std::remove_if(assigned.begin(), assigned.end(), [this](uint32_t aid) { return !alive[aid]; }), assigned.end());
+        attractor_grid->disable_points(killed);
+    }
+}
+
+void SpaceColonizationEngine::grow()
+{
+    // bucket the assigned attractors by nearest node.
+    size_t nbnodes = skeletonnodes->size();
+    std::vector<uint32_t> offsets(nbnodes + 1, 0);
+    for (std::vector<uint32_t>::const_iterator it = assigned.begin(); it != assigned.end(); ++it)
+        ++offsets[nearestnode[*it] + 1];
+    Index growingnodes;
+    for (size_t nid = 0; nid < nbnodes; ++nid) {
+        // a node whose attractors did not change since its last growth would only duplicate its previous child.
+        if (modified[nid] && offsets[nid + 1] >= std::max<size_t>(min_nb_pt_per_bud, 1)) growingnodes.push_back(nid);
+        modified[nid] = 0;
+        offsets[nid + 1] += offsets[nid];
+    }
+    std::vector<uint32_t> nodeattractors(assigned.size());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (std::vector<uint32_t>::const_iterator it = assigned.begin(); it != assigned.end(); ++it)
+        nodeattractors[fill[nearestnode[*it]]++] = *it;
+
+    size_t nbgrowing = growingnodes.size();
+    std::vector<Vector3> newpositions(nbgrowing);
+    std::vector<uchar_t> valid(nbgrowing, 0);
+    parallel_for(0, nbgrowing, [&](size_t i) {
+        uint32_t nid = growingnodes[i];
+        const Vector3& position = skeletonnodes->getAt(nid);
+        Vector3 meandirection;
+        for (uint32_t j = offsets[nid]; j < offsets[nid + 1]; ++j)
+            meandirection += direction(attractors->getAt(nodeattractors[j]) - position);
+        real_t length = norm(meandirection);
+        if (length > GEOM_EPSILON) {
+            newpositions[i] = position + meandirection * (nodelength / length);
+            valid[i] = 1;
+        }
+    });
+
+    newnodes.clear();
+    for (size_t i = 0; i < nbgrowing; ++i) {
+        if (!valid[i]) continue;
+        newnodes.push_back(skeletonnodes->size());
+        skeletonnodes->push_back(newpositions[i]);
+        skeletonparents->push_back(growingnodes[i]);
+    }
+}
+
+size_t SpaceColonizationEngine::step()
+{
+    PGL_PROFILE_ZONE("SpaceColonizationEngine::step");
+    update_assignments(newnodes);
+    grow();
+    ++nbIteration;
+    PGL_PROFILE_COUNT("spacecolonization.new_nodes", newnodes.size());
+    return newnodes.size();
+}
+
+void SpaceColonizationEngine::run()
+{
+    while (!atEnd()) step();
+}
+
+void SpaceColonizationEngine::iterate(size_t nbsteps)
+{
+    for(size_t i = 0; i < nbsteps && !atEnd(); ++i) step();
+}
+
+IndexArrayPtr SpaceColonizationEngine::get_children() const { uint32_t root; IndexArrayPtr ch = determine_children(skeletonparents,root); return ch; }
+
+SpaceColonizationEngine::Uint32ArrayPtr SpaceColonizationEngine::get_nearest_nodes() const
+{
+    return Uint32ArrayPtr(new Uint32Array1(nearestnode.begin(), nearestnode.end()));
+}
+
+/* ----------------------------------------------------------------------- */
@@ -265,6 +265,98 @@ class ALGO_API GraphColonization : public SpaceColonization {
 
 typedef RCPtr<GraphColonization> GraphColonizationPtr;
 
+/* ----------------------------------------------------------------------- */
+
+/**
+    Space colonization growth where each attractor stores the id of its nearest node
+    and its distance in flat arrays.
+
+    At each step, only the nodes created at the previous step query the attractor grid:
+    attractors closer than kill_radius are removed and the others are reassigned if the
+    new node is nearer. Every node attracted by at least min_nb_pt_per_bud attractors then
+    grows a new node of length nodelength toward the mean direction of its attractors, unless
+    its set of attractors is unchanged since its last growth.
+    Queries and growth directions are computed in parallel; results do not depend on
+    the number of threads. A null voxelsize sets the grid voxels to half the perception_radius.
+*/
+class ALGO_API SpaceColonizationEngine : public RefCountObject {
+    public:
+        typedef Point3Grid::PointIndexList AttractorList;
+        typedef Uint32Array1Ptr Uint32ArrayPtr;
+
+        static const uint32_t NOID;
+
+        SpaceColonizationEngine(const Point3ArrayPtr attractors,
+                                real_t nodelength,
+                                real_t kill_radius,
+                                real_t perception_radius,
+                                const Vector3& rootnode,
+                                real_t voxelsize = 0);
+
+        /// Start from an existing skeleton. All its nodes take part in the first assignment.
+        SpaceColonizationEngine(const Point3ArrayPtr attractors,
+                                real_t nodelength,
+                                real_t kill_radius,
+                                real_t perception_radius,
+                                const Point3ArrayPtr initialskeletonnodes,
+                                const Uint32ArrayPtr initialskeletonparents,
+                                real_t voxelsize = 0);
+
+        virtual ~SpaceColonizationEngine();
+
+        /// Apply one growth step. Return the number of created nodes.
+        size_t step();
+        void run();
+        void iterate(size_t nbsteps);
+
+        inline bool atEnd() const { return newnodes.empty(); }
+
+        inline Point3ArrayPtr get_nodes() const { return skeletonnodes; }
+        inline Uint32ArrayPtr get_parents() const { return skeletonparents; }
+        IndexArrayPtr get_children() const;
+        inline Point3GridPtr get_grid() const { return attractor_grid; }
+
+        /// Nodes created at the last step.
+        inline const Index& get_new_nodes() const { return newnodes; }
+
+        /// Nearest node of each attractor within perception_radius, or NOID.
+        Uint32ArrayPtr get_nearest_nodes() const;
+
+        /// Number of attractors not yet removed.
+        inline size_t nbAliveAttractors() const { return nbalive; }
+
+        real_t nodelength;
+        real_t kill_radius;
+        real_t perception_radius;
+        size_t min_nb_pt_per_bud;
+        size_t nbIteration;
+
+    protected:
+        void init(real_t voxelsize);
+
+        /// Update nearest nodes and remove killed attractors around the given nodes.
+        void update_assignments(const Index& nodes);
+
+        /// Compute the new nodes of all attracted nodes and add them to the skeleton.
+        void grow();
+
+        Point3ArrayPtr attractors;
+        Point3GridPtr attractor_grid;
+        Point3ArrayPtr skeletonnodes;
+        Uint32ArrayPtr skeletonparents;
+
+        std::vector<uint32_t> nearestnode;
+        std::vector<real_t> nearestdistance;
+        std::vector<uchar_t> alive;
+        std::vector<uint32_t> assigned;
+        std::vector<uchar_t> modified;
+        size_t nbalive;
+
+        Index newnodes;
+};
+
+typedef RCPtr<SpaceColonizationEngine> SpaceColonizationEnginePtr;
+
 PGL_END_NAMESPACE
 
 #endif
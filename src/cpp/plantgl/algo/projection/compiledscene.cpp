@@ -0,0 +1,176 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/* ----------------------------------------------------------------------- */
+
+#include "compiledscene.h"
+#include "projectionrenderer.h"
+#include <plantgl/tool/util_taskscheduler.h>
+#include <plantgl/tool/util_hashmap.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+CompiledScene::CompiledScene(const ScenePtr& scene, const DiscretizationCachePtr& cache):
+    TriangleSoup(),
+    __scene(scene),
+    __discretizationCache(cache),
+    __nbupdated(0)
+{
+    update();
+}
+
+CompiledScene::~CompiledScene()
+{
+}
+
+CompiledScene::ShapeRecord CompiledScene::_record(const Shape3DPtr& shape)
+{
+    ShapeRecord record;
+    record.shape = shape;
+    record.id = Shape::NOID;
+    record.valid = true;
+    record.first = 0;
+    record.count = 0;
+    ShapePtr sh = dynamic_pointer_cast<Shape>(shape);
+    if (is_valid_ptr(sh)) {
+        record.geometry = sh->geometry;
+        record.appearance = sh->appearance;
+        record.id = sh->getId();
+    }
+    return record;
+}
+
+bool CompiledScene::isUpToDate() const
+{
+    if (is_null_ptr(__scene)) return __records.empty();
+    if (__scene->size() != __records.size()) return false;
+    size_t i = 0;
+    for (Scene::const_iterator it = __scene->begin(); it != __scene->end(); ++it, ++i){
+        const ShapeRecord& previous = __records[i];
+        if (!previous.valid || !(_record(*it) == previous)) return false;
+    }
+    return true;
+}
+
+void CompiledScene::invalidate()
+{
+    for (std::vector<ShapeRecord>::iterator it = __records.begin(); it != __records.end(); ++it)
+        it->valid = false;
+}
+
+void CompiledScene::invalidateShape(uint32_t id)
+{
+    for (std::vector<ShapeRecord>::iterator it = __records.begin(); it != __records.end(); ++it)
+        if (it->id == id) it->valid = false;
+}
+
+bool CompiledScene::update()
+{
+    __nbupdated = 0;
+    size_t nbshapes = (is_null_ptr(__scene) ? 0 : __scene->size());
+
+    // Match the shapes of the scene with the previously compiled ones.
+    pgl_hash_map<size_t, size_t> previousindex;
+    for (size_t i = 0; i < __records.size(); ++i)
+        if (__records[i].valid) previousindex[size_t(__records[i].shape.get())] = i;
+
+    const size_t NOSOURCE = size_t(-1);
+    std::vector<ShapeRecord> records;
+    std::vector<size_t> sources;
+    std::vector<size_t> totessellate;
+    records.reserve(nbshapes);
+    sources.reserve(nbshapes);
+    bool changed = (nbshapes != __records.size());
+    for (size_t i = 0; i < nbshapes; ++i){
+        ShapeRecord record = _record(__scene->getAt(i));
+        pgl_hash_map<size_t, size_t>::const_iterator itprevious = previousindex.find(size_t(record.shape.get()));
+        size_t source = NOSOURCE;
+        if (itprevious != previousindex.end() && __records[itprevious->second] == record) 
+            source = itprevious->second;
+        else 
+            totessellate.push_back(i);
+        if (source != i) changed = true;
+        records.push_back(record);
+        sources.push_back(source);
+    }
+
+    if (!changed) return false;
+
+    // Tessellation of the new or modified shapes, each in its own soup.
+    std::vector<TriangleSoup> soups(totessellate.size());
+    parallel_for_range(0, totessellate.size(), [&](size_t begin, size_t end) {
+        TriangleSoupBuilder builder(NULL);
+        Discretizer d;
+        Tesselator t;
+        d.setSharedCache(__discretizationCache);
+        t.setSharedCache(__discretizationCache);
+        ProjectionRenderer r(builder, t, d);
+        for (size_t j = begin; j < end; ++j){
+            builder.setSoup(&soups[j]);
+            records[totessellate[j]].shape->apply(r);
+        }
+    });
+
+    // Gather the triangles in scene order.
+    TriangleSoup result;
+    size_t nbtriangles = 0;
+    for (size_t i = 0, j = 0; i < nbshapes; ++i){
+        if (sources[i] == NOSOURCE) nbtriangles += soups[j++].size();
+        else nbtriangles += __records[sources[i]].count;
+    }
+    result.reserve(nbtriangles);
+    for (size_t i = 0, j = 0; i < nbshapes; ++i){
+        records[i].first = result.size();
+        if (sources[i] == NOSOURCE) result.append(soups[j++]);
+        else result.append(*this, __records[sources[i]].first, __records[sources[i]].count);
+        records[i].count = result.size() - records[i].first;
+    }
+
+    swap(result);
+    __records.swap(records);
+    __nbupdated = totessellate.size();
+    return true;
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,131 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+/*! \file compiledscene.h
+    \brief Definition of CompiledScene, a persistent triangle soup of a scene.
+*/
+
+
+
+#ifndef __CompiledScene_h__
+#define __CompiledScene_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include "trianglesoup.h"
+#include <plantgl/scenegraph/scene/shape.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/** 
+    \class CompiledScene
+    \brief A TriangleSoup bound to a scene and kept up to date incrementally.
+
+    update() compares each shape of the scene with the one compiled previously 
+    (same shape, geometry, appearance and id). Only the shapes that were added or 
+    modified are tessellated again; the triangles of the others are reused. 
+    Modifications made in place inside a geometry cannot be detected this way and 
+    should be notified with invalidate or invalidateShape.
+*/
+
+/* ----------------------------------------------------------------------- */
+
+class ALGO_API CompiledScene : public TriangleSoup {
+public:
+    CompiledScene(const ScenePtr& scene, const DiscretizationCachePtr& cache = DiscretizationCachePtr());
+    virtual ~CompiledScene();
+
+    const ScenePtr& getScene() const { return __scene; }
+    void setScene(const ScenePtr& scene) { __scene = scene; }
+
+    /// Tessellation cache shared with other threads and engines. Null for a cache per update.
+    const DiscretizationCachePtr& getDiscretizationCache() const { return __discretizationCache; }
+    void setDiscretizationCache(const DiscretizationCachePtr& cache) { __discretizationCache = cache; }
+
+    /// Tessellate the shapes added or modified since the last update. Return whether the triangles changed.
+    bool update();
+
+    /// Return whether the scene changed since the last update.
+    bool isUpToDate() const;
+
+    /// Force the tessellation of all the shapes at next update.
+    void invalidate();
+
+    /// Force the tessellation of the shapes with the given id at next update.
+    void invalidateShape(uint32_t id);
+
+    /// Number of shapes tessellated at the last update.
+    size_t getNbUpdatedShapes() const { return __nbupdated; }
+
+protected:
+    struct ShapeRecord {
+        Shape3DPtr shape;
+        RefCountObjectPtr geometry;
+        RefCountObjectPtr appearance;
+        uint32_t id;
+        bool valid;
+        size_t first, count;
+
+        bool operator==(const ShapeRecord& other) const 
+        { return shape == other.shape && geometry == other.geometry && appearance == other.appearance && id == other.id; }
+    };
+
+    static ShapeRecord _record(const Shape3DPtr& shape);
+
+    ScenePtr __scene;
+    DiscretizationCachePtr __discretizationCache;
+    std::vector<ShapeRecord> __records;
+    size_t __nbupdated;
+};
+
+typedef RCPtr<CompiledScene> CompiledScenePtr;
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+#endif
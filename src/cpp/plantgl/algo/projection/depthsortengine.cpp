@@ -93,6 +93,26 @@ void DepthSortEngine::iprocess(TriangleSetPtr triangles, AppearancePtr appearanc
 	#endif
 }
 
+void DepthSortEngine::process(const TriangleSoupPtr& soup)
+{
+    beginProcess();
+	#ifdef PGL_WITH_CGAL
+    // the soup is already in world space
+    __camera->pushModelTransformation();
+    __camera->transformModelIdentity();
+    for (size_t i = 0; i < soup->size(); ++i)
+        processTriangle(soup->getVertexAt(i,0), soup->getVertexAt(i,1), soup->getVertexAt(i,2), soup->getIdAt(i));
+    __camera->popModelTransformation();
+	#endif
+    endProcess();
+}
+
+void DepthSortEngine::process(const CompiledScenePtr& compiled)
+{
+    compiled->update();
+    process(TriangleSoupPtr(compiled));
+}
+
 void DepthSortEngine::iprocess(PolylinePtr polyline, MaterialPtr material, uint32_t id, ProjectionCameraPtr camera, uint32_t threadid )
 {
 
@@ -677,7 +697,7 @@ DepthSortEngine::_processTriangle( PolygonInfo polygon,
 
 ScenePtr DepthSortEngine::getResult(Color4::eColor4Format format, bool cameraCoordinates) const
 {
-    ScenePtr scene(new Scene());
+    SceneBuilder scene(__polygonlist.size());
     for(PolygonInfoList::const_iterator it = __polygonlist.begin(); it != __polygonlist.end(); ++it){
         Color4 col = Color4::fromUint(it->id, format);
         Material * mat = new Material(Color3(col));
@@ -690,14 +710,14 @@ ScenePtr DepthSortEngine::getResult(Color4::eColor4Format format, bool cameraCoo
                 *itP = __camera->cameraToWorld(*itP);
             }
         }
-        scene->add(ShapePtr(new Shape(GeometryPtr(new TriangleSet(lpoints,Index3ArrayPtr(new Index3Array(1,Index3(0,1,2))))), AppearancePtr(mat), it->id)));
+        scene.add(ShapePtr(new Shape(GeometryPtr(new TriangleSet(lpoints,Index3ArrayPtr(new Index3Array(1,Index3(0,1,2))))), AppearancePtr(mat), it->id)));
     }
-    return scene;
+    return scene.build();
 }
 
 ScenePtr DepthSortEngine::getProjectionResult(Color4::eColor4Format format, bool cameraCoordinates) const
 {
-    ScenePtr scene(new Scene());
+    SceneBuilder scene(__polygonlist.size());
     for(PolygonInfoList::const_iterator it = __polygonlist.begin(); it != __polygonlist.end(); ++it){
         Color4 col = Color4::fromUint(it->id, format);
         Material * mat = new Material(Color3(col));
@@ -714,9 +734,9 @@ ScenePtr DepthSortEngine::getProjectionResult(Color4::eColor4Format format, bool
                 itP->z() = 0;
             }
         }
-        scene->add(ShapePtr(new Shape(GeometryPtr(new TriangleSet(lpoints,Index3ArrayPtr(new Index3Array(1,Index3(0,1,2))))), AppearancePtr(mat), it->id)));
+        scene.add(ShapePtr(new Shape(GeometryPtr(new TriangleSet(lpoints,Index3ArrayPtr(new Index3Array(1,Index3(0,1,2))))), AppearancePtr(mat), it->id)));
     }
-    return scene;
+    return scene.build();
 }
 
 #endif
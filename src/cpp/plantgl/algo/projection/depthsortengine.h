@@ -59,6 +59,7 @@
 #include <plantgl/tool/rcobject.h>
 #include <plantgl/scenegraph/scene/scene.h>
 #include "projectionengine.h"
+#include "compiledscene.h"
 #include <list>
 
 /* ----------------------------------------------------------------------- */
@@ -84,6 +85,14 @@ public :
 
     void processTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, uint32_t id);
 
+    using ProjectionEngine::process;
+
+    /// Process the world-space triangles of soup.
+    void process(const TriangleSoupPtr& soup);
+
+    /// Update compiled with the modifications of its scene and process it.
+    void process(const CompiledScenePtr& compiled);
+
     ScenePtr getResult(Color4::eColor4Format format = Color4::eARGB, bool cameraCoordinates = true) const;
     ScenePtr getProjectionResult(Color4::eColor4Format format = Color4::eARGB, bool cameraCoordinates = true) const;
 
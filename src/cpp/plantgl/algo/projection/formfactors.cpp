@@ -0,0 +1,452 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+#include "formfactors.h"
+#include "zbufferengine.h"
+#include "projectioncamera.h"
+#include <plantgl/scenegraph/scene/shape.h>
+#include <plantgl/tool/util_taskscheduler.h>
+#include <plantgl/tool/util_hashmap.h>
+#include <plantgl/tool/util_profile.h>
+#include <algorithm>
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+FormFactorMatrix::FormFactorMatrix(size_t nbColumns) :
+    RefCountObject(),
+    __nbColumns(nbColumns),
+    __offsets(1, 0)
+{
+}
+
+FormFactorMatrix::FormFactorMatrix(size_t nbColumns, 
+                                   const std::vector<offset_type>& offsets, 
+                                   const std::vector<uint32_t>& columns, 
+                                   const std::vector<real_t>& values) :
+    RefCountObject(),
+    __nbColumns(nbColumns),
+    __offsets(offsets),
+    __columns(columns),
+    __values(values)
+{
+    if (__offsets.empty()) __offsets.push_back(0);
+    GEOM_ASSERT(__offsets.back() == __columns.size() && __columns.size() == __values.size());
+}
+
+FormFactorMatrix::~FormFactorMatrix()
+{
+}
+
+real_t FormFactorMatrix::getAt(size_t i, size_t j) const
+{
+    const uint32_t * begin = getRowColumns(i);
+    const uint32_t * end = begin + getRowSize(i);
+    const uint32_t * it = std::lower_bound(begin, end, uint32_t(j));
+    if (it != end && *it == j) return __values[__offsets[i] + (it - begin)];
+    return 0;
+}
+
+real_t FormFactorMatrix::getRowSum(size_t i) const
+{
+    real_t result = 0;
+    const real_t * values = getRowValues(i);
+    for (size_t k = 0, n = getRowSize(i); k < n; ++k) result += values[k];
+    return result;
+}
+
+void FormFactorMatrix::pushRow(const uint32_t * colbegin, const uint32_t * colend, const real_t * values)
+{
+    __columns.insert(__columns.end(), colbegin, colend);
+    __values.insert(__values.end(), values, values + (colend - colbegin));
+    __offsets.push_back(__columns.size());
+}
+
+void FormFactorMatrix::append(const FormFactorMatrix& other)
+{
+    GEOM_ASSERT(other.__nbColumns == __nbColumns);
+    offset_type shift = __offsets.back();
+    __offsets.reserve(__offsets.size() + other.getNbRows());
+    for (std::vector<offset_type>::const_iterator it = other.__offsets.begin() + 1; it != other.__offsets.end(); ++it)
+        __offsets.push_back(*it + shift);
+    __columns.insert(__columns.end(), other.__columns.begin(), other.__columns.end());
+    __values.insert(__values.end(), other.__values.begin(), other.__values.end());
+}
+
+void FormFactorMatrix::scale(real_t factor)
+{
+    for (std::vector<real_t>::iterator it = __values.begin(); it != __values.end(); ++it) *it *= factor;
+}
+
+std::vector<FormFactorMatrixPtr> FormFactorMatrix::transpose(const std::vector<FormFactorMatrixPtr>& blocks, size_t blockSize)
+{
+    std::vector<FormFactorMatrixPtr> result;
+    if (blocks.empty()) return result;
+    blockSize = std::max<size_t>(1, blockSize);
+    size_t nbrows = 0;
+    for (std::vector<FormFactorMatrixPtr>::const_iterator itBlock = blocks.begin(); itBlock != blocks.end(); ++itBlock) 
+        nbrows += (*itBlock)->getNbRows();
+    const size_t nbcolumns = blocks.front()->getNbColumns();
+    const size_t nbblocks = (nbcolumns + blockSize - 1) / blockSize;
+
+    // size of each transposed row
+    std::vector<offset_type> counts(nbcolumns, 0);
+    for (std::vector<FormFactorMatrixPtr>::const_iterator itBlock = blocks.begin(); itBlock != blocks.end(); ++itBlock) {
+        const std::vector<uint32_t>& columns = (*itBlock)->getColumns();
+        for (std::vector<uint32_t>::const_iterator it = columns.begin(); it != columns.end(); ++it) ++counts[*it];
+    }
+
+    // allocation of the transposed blocks. counts becomes the insertion position of each transposed row in its block.
+    result.reserve(nbblocks);
+    for (size_t k = 0; k < nbblocks; ++k) {
+        FormFactorMatrixPtr block(new FormFactorMatrix(nbrows));
+        size_t first = k * blockSize, last = std::min(nbcolumns, first + blockSize);
+        block->__offsets.resize(last - first + 1);
+        for (size_t j = first; j < last; ++j) {
+            block->__offsets[j - first + 1] = block->__offsets[j - first] + counts[j];
+            counts[j] = block->__offsets[j - first];
+        }
+        block->__columns.resize(block->__offsets.back());
+        block->__values.resize(block->__offsets.back());
+        result.push_back(block);
+    }
+
+    // a single pass on the values, each one being sent to the block of its column. Rows are visited in order so transposed rows are sorted.
+    uint32_t row = 0;
+    for (std::vector<FormFactorMatrixPtr>::const_iterator itBlock = blocks.begin(); itBlock != blocks.end(); ++itBlock) {
+        const FormFactorMatrix& block = **itBlock;
+        for (size_t i = 0; i < block.getNbRows(); ++i, ++row) {
+            const uint32_t * rowcolumns = block.getRowColumns(i);
+            const real_t * rowvalues = block.getRowValues(i);
+            for (size_t k = 0, n = block.getRowSize(i); k < n; ++k) {
+                uint32_t j = rowcolumns[k];
+                FormFactorMatrix& target = *result[j / blockSize];
+                offset_type pos = counts[j]++;
+                target.__columns[pos] = row;
+                target.__values[pos] = rowvalues[k];
+            }
+        }
+    }
+    return result;
+}
+
+void FormFactorMatrix::getTriplets(std::vector<uint32_t>& rows, std::vector<uint32_t>& columns, std::vector<real_t>& values) const
+{
+    rows.resize(getNbNonZeros());
+    for (size_t i = 0; i < getNbRows(); ++i)
+        std::fill(rows.begin() + __offsets[i], rows.begin() + __offsets[i+1], uint32_t(i));
+    columns = __columns;
+    values = __values;
+}
+
+RealArray2Ptr FormFactorMatrix::toDense() const
+{
+    RealArray2Ptr result(new RealArray2(uint_t(getNbRows()), uint_t(__nbColumns), real_t(0)));
+    for (size_t i = 0; i < getNbRows(); ++i) {
+        const uint32_t * columns = getRowColumns(i);
+        const real_t * values = getRowValues(i);
+        for (size_t k = 0, n = getRowSize(i); k < n; ++k) result->setAt(i, columns[k], values[k]);
+    }
+    return result;
+}
+
+/* ----------------------------------------------------------------------- */
+
+#define FORMFACTOR_LEAF_SIZE 8
+
+static inline void ff_extend(Vector3& lower, Vector3& upper, const Vector3& p)
+{
+    lower = Min(lower, p);
+    upper = Max(upper, p);
+}
+
+/// Squared distance from p to the box [lower, upper].
+static inline real_t ff_boxdist2(const Vector3& p, const Vector3& lower, const Vector3& upper)
+{
+    real_t d2 = 0;
+    for (int k = 0; k < 3; ++k) {
+        real_t d = 0;
+        if (p[k] < lower[k]) d = lower[k] - p[k];
+        else if (p[k] > upper[k]) d = p[k] - upper[k];
+        d2 += d * d;
+    }
+    return d2;
+}
+
+/// Whether the box [lower, upper] lies entirely behind the plane (center, normal).
+static inline bool ff_behind(const Vector3& center, const Vector3& normal, const Vector3& lower, const Vector3& upper)
+{
+    // farthest corner in the normal direction
+    Vector3 support(normal.x() > 0 ? upper.x() : lower.x(),
+                    normal.y() > 0 ? upper.y() : lower.y(),
+                    normal.z() > 0 ? upper.z() : lower.z());
+    return dot(support - center, normal) <= 0;
+}
+
+FormFactorEngine::FormFactorEngine(const Point3ArrayPtr& points, 
+                                   const Index3ArrayPtr& triangles, 
+                                   const Point3ArrayPtr& normals,
+                                   bool ccw) :
+    RefCountObject(),
+    __points(points),
+    __triangles(triangles),
+    __normals(normals),
+    __ccw(ccw),
+    __discretization(200),
+    __solidangle(true),
+    __tolerance(0),
+    __maxdistance(REAL_MAX)
+{
+    build();
+}
+
+FormFactorEngine::~FormFactorEngine()
+{
+}
+
+void FormFactorEngine::build()
+{
+    size_t nbtriangles = __triangles->size();
+    __nodes.clear();
+    __order.resize(nbtriangles);
+    __areas.resize(nbtriangles);
+    if (nbtriangles == 0) return;
+
+    std::vector<Vector3> lowers(nbtriangles), uppers(nbtriangles), centroids(nbtriangles);
+    for (size_t i = 0; i < nbtriangles; ++i) {
+        const Index3& t = __triangles->getAt(i);
+        const Vector3& a = __points->getAt(t[0]);
+        const Vector3& b = __points->getAt(t[1]);
+        const Vector3& c = __points->getAt(t[2]);
+        lowers[i] = uppers[i] = a;
+        ff_extend(lowers[i], uppers[i], b);
+        ff_extend(lowers[i], uppers[i], c);
+        centroids[i] = (a + b + c) / 3;
+        __areas[i] = norm(cross(b - a, c - a)) / 2;
+        __order[i] = i;
+    }
+
+    __nodes.reserve(2 * nbtriangles / FORMFACTOR_LEAF_SIZE + 1);
+    __nodes.push_back(Node());
+
+    struct Task { uint32_t node, begin, end; };
+    std::vector<Task> tasks;
+    Task root = { 0, 0, uint32_t(nbtriangles) };
+    tasks.push_back(root);
+    while (!tasks.empty()) {
+        Task task = tasks.back();
+        tasks.pop_back();
+
+        Vector3 lower(REAL_MAX, REAL_MAX, REAL_MAX), upper(-REAL_MAX, -REAL_MAX, -REAL_MAX);
+        Vector3 clower = lower, cupper = upper;
+        real_t maxArea = 0;
+        for (uint32_t i = task.begin; i < task.end; ++i) {
+            uint32_t t = __order[i];
+            ff_extend(lower, upper, lowers[t]);
+            ff_extend(lower, upper, uppers[t]);
+            ff_extend(clower, cupper, centroids[t]);
+            maxArea = std::max(maxArea, __areas[t]);
+        }
+        Node& node = __nodes[task.node];
+        node.lower = lower;
+        node.upper = upper;
+        node.maxArea = maxArea;
+        node.first = task.begin;
+        node.count = task.end - task.begin;
+        if (node.count <= FORMFACTOR_LEAF_SIZE) continue;
+
+        // median split along the largest extent of the centroids
+        Vector3 extent = cupper - clower;
+        int axis = (extent.x() > extent.y() ? (extent.x() > extent.z() ? 0 : 2) : (extent.y() > extent.z() ? 1 : 2));
+        if (extent[axis] <= 0) continue;
+        uint32_t mid = (task.begin + task.end) / 2;
+        std::nth_element(__order.begin() + task.begin, __order.begin() + mid, __order.begin() + task.end,
+                         [&centroids, axis](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+
+        uint32_t children = __nodes.size();
+        __nodes.push_back(Node());
+        __nodes.push_back(Node());
+        __nodes[task.node].first = children;
+        __nodes[task.node].count = 0;
+        Task lefttask = { children, task.begin, mid };
+        Task righttask = { children + 1, mid, task.end };
+        tasks.push_back(righttask);
+        tasks.push_back(lefttask);
+    }
+}
+
+void FormFactorEngine::selectReceivers(uint32_t emitter, const Vector3& center, const Vector3& normal, std::vector<uint32_t>& receivers) const
+{
+    if (__nodes.empty()) return;
+    const real_t maxdist2 = (__maxdistance < REAL_MAX ? __maxdistance * __maxdistance : REAL_MAX);
+
+    // test a box containing triangles of area at most maxArea.
+    auto culled = [&](const Vector3& lower, const Vector3& upper, real_t maxArea) {
+        if (ff_behind(center, normal, lower, upper)) return true;
+        real_t d2 = ff_boxdist2(center, lower, upper);
+        if (d2 > maxdist2) return true;
+        return (__tolerance > 0 && d2 > 0 && maxArea < __tolerance * d2);
+    };
+
+    std::vector<uint32_t> stack(1, 0);
+    while (!stack.empty()) {
+        const Node& node = __nodes[stack.back()];
+        stack.pop_back();
+        if (culled(node.lower, node.upper, node.maxArea)) continue;
+        if (node.count == 0) {
+            stack.push_back(node.first + 1);
+            stack.push_back(node.first);
+            continue;
+        }
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            uint32_t t = __order[i];
+            if (t == emitter) continue;
+            const Index3& tr = __triangles->getAt(t);
+            Vector3 lower = __points->getAt(tr[0]), upper = lower;
+            ff_extend(lower, upper, __points->getAt(tr[1]));
+            ff_extend(lower, upper, __points->getAt(tr[2]));
+            if (!culled(lower, upper, __areas[t])) receivers.push_back(t);
+        }
+    }
+}
+
+FormFactorMatrixPtr FormFactorEngine::compute() const
+{
+    return compute(0, size());
+}
+
+FormFactorMatrixPtr FormFactorEngine::compute(size_t begin, size_t end) const
+{
+    PGL_PROFILE_ZONE("FormFactorEngine::compute");
+    end = std::min(end, size());
+    begin = std::min(begin, end);
+    size_t nbemitters = end - begin;
+    const uint16_t resolution = __discretization;
+
+    // weight of each pixel of the hemispherical view, in the layout of the id buffer
+    std::vector<real_t> weights(size_t(resolution) * resolution, 1);
+    if (__solidangle) {
+        ProjectionCameraPtr camera = ProjectionCamera::sphericalCamera(180, 0, REAL_MAX);
+        for (uint16_t x = 0; x < resolution; ++x)
+            for (uint16_t y = 0; y < resolution; ++y)
+                weights[size_t(x) * resolution + y] = camera->solidAngle(x, y, resolution, resolution);
+    }
+
+    // the rows of each emitter are computed independently and gathered at the end.
+    std::vector<std::vector<uint32_t> > rowcolumns(nbemitters);
+    std::vector<std::vector<real_t> > rowvalues(nbemitters);
+
+    parallel_for_range(begin, end, [&](size_t subbegin, size_t subend) {
+        ZBufferEngine engine(resolution, resolution, ZBufferEngine::eIdBased, Color3::BLACK, Shape::NOID, false);
+        engine.setHemisphericCamera();
+        // buffers of a blank view, restored before each emitter
+        const std::vector<real_t> blankdepth(engine.getDepthBuffer()->begin(), engine.getDepthBuffer()->end());
+        RealArray2Ptr depth = engine.getDepthBuffer();
+        Uint32Array2Ptr ids = engine.getIdBuffer();
+
+        std::vector<uint32_t> receivers;
+        pgl_hash_map<uint32_t, real_t> histogram;
+        std::vector<std::pair<uint32_t, real_t> > row;
+        const Color4 color = Color4::BLACK;
+
+        for (size_t id = subbegin; id < subend; ++id) {
+            const Index3& tr = __triangles->getAt(id);
+            const Vector3& v0 = __points->getAt(tr[0]);
+            const Vector3& v1 = __points->getAt(tr[1]);
+            const Vector3& v2 = __points->getAt(tr[2]);
+            Vector3 center = (v0 + v1 + v2) / 3;
+            Vector3 normal = (is_valid_ptr(__normals) ? __normals->getAt(id) : cross(v1 - v0, v2 - v0));
+            if (normal.normalize() <= GEOM_EPSILON) continue;
+
+            receivers.clear();
+            selectReceivers(uint32_t(id), center, normal, receivers);
+            PGL_PROFILE_COUNT("formfactors.receivers", receivers.size());
+            PGL_PROFILE_COUNT("formfactors.culled", size() - 1 - receivers.size());
+            if (receivers.empty()) continue;
+
+            std::copy(blankdepth.begin(), blankdepth.end(), depth->begin());
+            std::fill(ids->begin(), ids->end(), Shape::NOID);
+            engine.lookAt(center, center + normal, v0 - center);
+            engine.beginProcess();
+            for (std::vector<uint32_t>::const_iterator it = receivers.begin(); it != receivers.end(); ++it) {
+                const Index3& rtr = __triangles->getAt(*it);
+                engine.renderTriangle(__points->getAt(rtr[0]), __points->getAt(rtr[1]), __points->getAt(rtr[2]),
+                                      color, color, color, __ccw, *it);
+            }
+            engine.endProcess();
+
+            histogram.clear();
+            Uint32Array2::const_iterator itId = ids->begin();
+            for (std::vector<real_t>::const_iterator itW = weights.begin(); itW != weights.end(); ++itW, ++itId)
+                if (*itId != Shape::NOID) histogram[*itId] += *itW;
+
+            row.assign(histogram.begin(), histogram.end());
+            std::sort(row.begin(), row.end());
+            std::vector<uint32_t>& columns = rowcolumns[id - begin];
+            std::vector<real_t>& values = rowvalues[id - begin];
+            columns.resize(row.size());
+            values.resize(row.size());
+            for (size_t k = 0; k < row.size(); ++k) { columns[k] = row[k].first; values[k] = row[k].second; }
+        }
+    });
+
+    size_t nbnonzeros = 0;
+    for (size_t i = 0; i < nbemitters; ++i) nbnonzeros += rowcolumns[i].size();
+    std::vector<FormFactorMatrix::offset_type> offsets;
+    std::vector<uint32_t> columns;
+    std::vector<real_t> values;
+    offsets.reserve(nbemitters + 1);
+    columns.reserve(nbnonzeros);
+    values.reserve(nbnonzeros);
+    offsets.push_back(0);
+    for (size_t i = 0; i < nbemitters; ++i) {
+        columns.insert(columns.end(), rowcolumns[i].begin(), rowcolumns[i].end());
+        values.insert(values.end(), rowvalues[i].begin(), rowvalues[i].end());
+        offsets.push_back(columns.size());
+        std::vector<uint32_t>().swap(rowcolumns[i]);
+        std::vector<real_t>().swap(rowvalues[i]);
+    }
+    return FormFactorMatrixPtr(new FormFactorMatrix(size(), offsets, columns, values));
+}
+
+/* ----------------------------------------------------------------------- */
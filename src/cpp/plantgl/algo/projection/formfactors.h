@@ -0,0 +1,222 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+/*! \file formfactors.h
+    \brief Definition of FormFactorEngine, a sparse and parallel computation of form factors between triangles.
+*/
+
+
+
+#ifndef __formfactors_h__
+#define __formfactors_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include "../algo_config.h"
+#include <plantgl/math/util_vector.h>
+#include <plantgl/tool/util_array2.h>
+#include <plantgl/tool/rcobject.h>
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <plantgl/scenegraph/container/indexarray.h>
+#include <vector>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+    \class FormFactorMatrix
+    \brief A sparse matrix of form factors stored in compressed sparse row format.
+
+    Row \e i gives the receivers seen from the emitter \e i. Its column indices are 
+    columns[offsets[i]:offsets[i+1]], sorted, and its values are at the same positions 
+    in values.
+*/
+
+class ALGO_API FormFactorMatrix : public RefCountObject {
+public:
+    typedef uint64_t offset_type;
+
+    /// Constructs a matrix with no row and \e nbColumns columns.
+    FormFactorMatrix(size_t nbColumns = 0);
+
+    /// Constructs from the offsets (of size nbRows+1, starting with 0), the column indices and the values.
+    FormFactorMatrix(size_t nbColumns, 
+                     const std::vector<offset_type>& offsets, 
+                     const std::vector<uint32_t>& columns, 
+                     const std::vector<real_t>& values);
+
+    virtual ~FormFactorMatrix();
+
+    inline size_t getNbRows() const { return __offsets.size() - 1; }
+    inline size_t getNbColumns() const { return __nbColumns; }
+    inline size_t getNbNonZeros() const { return __values.size(); }
+
+    inline size_t getRowSize(size_t i) const { return size_t(__offsets[i+1] - __offsets[i]); }
+    inline const uint32_t * getRowColumns(size_t i) const { return __columns.data() + __offsets[i]; }
+    inline const real_t * getRowValues(size_t i) const { return __values.data() + __offsets[i]; }
+
+    /// Value at row \e i and column \e j. 0 if it is not stored.
+    real_t getAt(size_t i, size_t j) const;
+
+    /// Sum of the values of row \e i.
+    real_t getRowSum(size_t i) const;
+
+    inline const std::vector<offset_type>& getOffsets() const { return __offsets; }
+    inline const std::vector<uint32_t>& getColumns() const { return __columns; }
+    inline const std::vector<real_t>& getValues() const { return __values; }
+
+    /// Appends a row with the values at the sorted columns [colbegin, colend).
+    void pushRow(const uint32_t * colbegin, const uint32_t * colend, const real_t * values);
+
+    /// Appends the rows of \e other, that should have the same number of columns.
+    void append(const FormFactorMatrix& other);
+
+    /// Multiplies all the values by \e factor, e.g. 1/(2*pi) to turn solid angles into fractions of the hemisphere.
+    void scale(real_t factor);
+
+    /// Transpose of the matrix made of the consecutive row \e blocks, split in blocks of \e blockSize rows.
+    static std::vector<RCPtr<FormFactorMatrix> > transpose(const std::vector<RCPtr<FormFactorMatrix> >& blocks, size_t blockSize);
+
+    /// Coordinate (triplet) representation of the non zero values.
+    void getTriplets(std::vector<uint32_t>& rows, std::vector<uint32_t>& columns, std::vector<real_t>& values) const;
+
+    /// Dense copy of \e self.
+    RealArray2Ptr toDense() const;
+
+protected:
+    size_t __nbColumns;
+    std::vector<offset_type> __offsets;
+    std::vector<uint32_t> __columns;
+    std::vector<real_t> __values;
+};
+
+typedef RCPtr<FormFactorMatrix> FormFactorMatrixPtr;
+
+/* ----------------------------------------------------------------------- */
+
+/**
+    \class FormFactorEngine
+    \brief Compute the form factors between the triangles of a mesh.
+
+    For each emitter triangle, the other triangles are rendered with a hemispherical 
+    camera placed at its center and oriented along its normal. The form factor with a 
+    receiver is the sum of the solid angles (or the number) of the pixels where it is 
+    visible. Emitters are distributed among the threads of the TaskScheduler, each 
+    thread reusing its own ZBufferEngine.
+
+    The receivers are selected with a bounding volume hierarchy : those entirely behind 
+    the emitter, farther than the maximal distance or whose estimated solid angle 
+    (area / squared distance) is lower than the tolerance are not rendered. A null 
+    tolerance gives the exact result. Culled receivers do not occlude the others.
+*/
+
+class ALGO_API FormFactorEngine : public RefCountObject {
+public:
+    FormFactorEngine(const Point3ArrayPtr& points, 
+                     const Index3ArrayPtr& triangles, 
+                     const Point3ArrayPtr& normals = Point3ArrayPtr(),
+                     bool ccw = true);
+
+    virtual ~FormFactorEngine();
+
+    /// Size in pixels of the hemispherical views.
+    inline uint16_t getDiscretization() const { return __discretization; }
+    inline void setDiscretization(uint16_t value) { __discretization = value; }
+
+    /// Whether pixels are weighted by their solid angle or simply counted.
+    inline bool isSolidAngle() const { return __solidangle; }
+    inline void setSolidAngle(bool value) { __solidangle = value; }
+
+    /// Minimal estimated solid angle (in steradians) of the rendered receivers.
+    inline real_t getTolerance() const { return __tolerance; }
+    inline void setTolerance(real_t value) { __tolerance = value; }
+
+    /// Maximal distance between an emitter and its receivers.
+    inline real_t getMaxDistance() const { return __maxdistance; }
+    inline void setMaxDistance(real_t value) { __maxdistance = value; }
+
+    inline size_t size() const { return __triangles->size(); }
+
+    /// Form factors of all the triangles.
+    FormFactorMatrixPtr compute() const;
+
+    /// Form factors of the emitters [begin, end). Row k of the result is emitter begin+k.
+    FormFactorMatrixPtr compute(size_t begin, size_t end) const;
+
+protected:
+    struct Node {
+        Vector3 lower, upper;
+        real_t maxArea;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    void build();
+
+    /// Append to \e receivers the triangles that may contribute to the emitter at \e center.
+    void selectReceivers(uint32_t emitter, const Vector3& center, const Vector3& normal, std::vector<uint32_t>& receivers) const;
+
+    Point3ArrayPtr __points;
+    Index3ArrayPtr __triangles;
+    Point3ArrayPtr __normals;
+    bool __ccw;
+    uint16_t __discretization;
+    bool __solidangle;
+    real_t __tolerance;
+    real_t __maxdistance;
+
+    std::vector<Node> __nodes;
+    std::vector<uint32_t> __order;
+    std::vector<real_t> __areas;
+};
+
+typedef RCPtr<FormFactorEngine> FormFactorEnginePtr;
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+#endif
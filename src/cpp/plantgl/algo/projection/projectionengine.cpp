@@ -54,7 +54,8 @@ PGL_USING_NAMESPACE
 
 
 ProjectionEngine::ProjectionEngine():
-    __camera(0)
+    __camera(0),
+    __discretizationCache()
 {
     setOrthographicCamera(-1, 1, -1, 1, 0, 2);
     lookAt(Vector3(0,1,0),Vector3(0,0,0),Vector3(0,0,1));
@@ -69,6 +70,8 @@ void ProjectionEngine::process(ScenePtr scene)
 {
     Discretizer d;
     Tesselator t;
+    d.setSharedCache(__discretizationCache);
+    t.setSharedCache(__discretizationCache);
     ProjectionRenderer r(*this, t, d);
     beginProcess();
     scene->apply(r);
@@ -57,6 +57,7 @@
 #include <plantgl/scenegraph/scene/scene.h>
 #include <plantgl/scenegraph/appearance/material.h>
 #include <plantgl/scenegraph/appearance/texture.h>
+#include <plantgl/algo/base/discretizationcache.h>
 
 /* ----------------------------------------------------------------------- */
 
@@ -92,6 +93,7 @@ public :
       { __camera->lookAt(eyePosition3D, center3D, upVector3D); }
 
       const ProjectionCameraPtr& camera() const { return __camera; }
+      void setCamera(const ProjectionCameraPtr& camera) { __camera = camera; }
 
       inline void transformModel(const Matrix4& transform)
       {  __camera->transformModel(transform); }
@@ -117,9 +119,9 @@ public :
 
       virtual void process(ScenePtr scene);
 
-      void process(TriangleSetPtr triangles, AppearancePtr appearance, uint32_t id) { iprocess(triangles, appearance,id,__camera); }
-      void process(PolylinePtr polyline, MaterialPtr material, uint32_t id)  { iprocess(polyline, material, id, __camera); }
-      void process(PointSetPtr pointset, MaterialPtr material, uint32_t id)  { iprocess(pointset, material, id, __camera); }
+      void process(TriangleSetPtr triangles, AppearancePtr appearance, uint32_t id) { beginProcess(); iprocess(triangles, appearance,id,__camera); endProcess(); }
+      void process(PolylinePtr polyline, MaterialPtr material, uint32_t id)  { beginProcess(); iprocess(polyline, material, id, __camera); endProcess(); }
+      void process(PointSetPtr pointset, MaterialPtr material, uint32_t id)  { beginProcess(); iprocess(pointset, material, id, __camera); endProcess(); }
 
       virtual void iprocess(TriangleSetPtr triangles, AppearancePtr appearance, uint32_t id, ProjectionCameraPtr camera = ProjectionCameraPtr(), uint32_t threadid = 0) = 0;
       virtual void iprocess(PolylinePtr polyline, MaterialPtr material, uint32_t id, ProjectionCameraPtr camera = ProjectionCameraPtr(), uint32_t threadid = 0) = 0;
@@ -128,8 +130,13 @@ public :
       virtual void beginProcess() {}
       virtual void endProcess() {}
 
+      /// Store the tessellations in \e cache, shared between threads and engines. Null for a cache per process.
+      void setDiscretizationCache(const DiscretizationCachePtr& cache) { __discretizationCache = cache; }
+      const DiscretizationCachePtr& getDiscretizationCache() const { return __discretizationCache; }
+
 protected:
     ProjectionCameraPtr __camera;
+    DiscretizationCachePtr __discretizationCache;
 
 
 };
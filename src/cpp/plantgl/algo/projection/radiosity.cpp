@@ -0,0 +1,318 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+#include "radiosity.h"
+#include <plantgl/tool/util_taskscheduler.h>
+#include <plantgl/tool/util_profile.h>
+#include <plantgl/tool/errormsg.h>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+RadiositySolver::RadiositySolver(const FormFactorMatrixPtr& formfactors, size_t blockSize) :
+    RefCountObject()
+{
+    init(std::vector<FormFactorMatrixPtr>(1, formfactors), blockSize);
+}
+
+RadiositySolver::RadiositySolver(const std::vector<FormFactorMatrixPtr>& blocks, size_t blockSize) :
+    RefCountObject()
+{
+    init(blocks, blockSize);
+}
+
+RadiositySolver::~RadiositySolver()
+{
+}
+
+void RadiositySolver::init(const std::vector<FormFactorMatrixPtr>& blocks, size_t blockSize)
+{
+    PGL_PROFILE_ZONE("RadiositySolver::init");
+    __blockSize = std::max<size_t>(1, blockSize);
+    __size = 0;
+    for (std::vector<FormFactorMatrixPtr>::const_iterator it = blocks.begin(); it != blocks.end(); ++it) {
+        __size += (*it)->getNbRows();
+        GEOM_ASSERT((*it)->getNbColumns() == (*blocks.begin())->getNbColumns());
+    }
+    // only the transposed matrix is kept
+    if (__size > 0) __transposed = FormFactorMatrix::transpose(blocks, __blockSize);
+    __nbBands = 0;
+    __method = eGaussSeidel;
+    __tolerance = 1e-6;
+    __maxIterations = 100;
+    __nbIterations = 0;
+    __residual = 0;
+}
+
+real_t RadiositySolver::property(const RealArray2Ptr& property, size_t i, size_t b) const
+{
+    if (is_null_ptr(property)) return 0;
+    size_t row = (property->getRowNb() == 1 ? 0 : i);
+    size_t column = (property->getColumnNb() == 1 ? 0 : b);
+    return property->getAt(row, column);
+}
+
+/* ----------------------------------------------------------------------- */
+
+bool RadiositySolver::solve(const RealArray2Ptr& incident)
+{
+    PGL_PROFILE_ZONE("RadiositySolver::solve");
+    __nbIterations = 0;
+    __residual = 0;
+    __energy.clear();
+    if (is_null_ptr(incident) || incident->getRowNb() != __size) {
+        pglError("RadiositySolver : the incident energy should have one row per triangle (%lu).", (unsigned long)__size);
+        return false;
+    }
+    for (const RealArray2Ptr& p : { __reflectance, __transmittance }) {
+        if (is_valid_ptr(p) && ((p->getRowNb() != 1 && p->getRowNb() != __size) || 
+                                (p->getColumnNb() != 1 && p->getColumnNb() != incident->getColumnNb()))) {
+            pglError("RadiositySolver : optical properties should have one row per triangle and one column per band.");
+            return false;
+        }
+    }
+
+    __nbBands = incident->getColumnNb();
+    std::vector<real_t> initial(incident->begin(), incident->end());
+    __scattering.resize(__size * __nbBands);
+    for (size_t i = 0; i < __size; ++i)
+        for (size_t b = 0; b < __nbBands; ++b)
+            __scattering[i * __nbBands + b] = property(__reflectance, i, b) + property(__transmittance, i, b);
+
+    switch (__method) {
+        case eJacobi: jacobi(initial); break;
+        case eGaussSeidel: gaussSeidel(initial); break;
+        case eProgressiveRefinement: progressiveRefinement(initial); break;
+    }
+    return __residual <= __tolerance;
+}
+
+void RadiositySolver::exitance(const std::vector<real_t>& energy, std::vector<real_t>& result) const
+{
+    result.resize(energy.size());
+    parallel_for_range(0, energy.size(), [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) result[k] = energy[k] * __scattering[k];
+    });
+}
+
+/// Largest absolute change between \e previous and \e current relative to the largest value of \e current.
+static real_t rad_residual(const std::vector<real_t>& previous, const std::vector<real_t>& current)
+{
+    real_t maxdiff = 0, maxvalue = 0;
+    for (size_t k = 0; k < current.size(); ++k) {
+        maxdiff = std::max(maxdiff, std::fabs(current[k] - previous[k]));
+        maxvalue = std::max(maxvalue, std::fabs(current[k]));
+    }
+    return (maxvalue > 0 ? maxdiff / maxvalue : 0);
+}
+
+void RadiositySolver::jacobi(const std::vector<real_t>& incident)
+{
+    const size_t nbbands = __nbBands;
+    __energy = incident;
+    std::vector<real_t> exit, next(incident.size());
+    __residual = (__size > 0 ? REAL_MAX : 0);
+    while (__nbIterations < __maxIterations && __residual > __tolerance) {
+        exitance(__energy, exit);
+        size_t first = 0;
+        for (std::vector<FormFactorMatrixPtr>::const_iterator itBlock = __transposed.begin(); itBlock != __transposed.end(); ++itBlock) {
+            const FormFactorMatrix& block = **itBlock;
+            parallel_for_range(0, block.getNbRows(), [&](size_t begin, size_t end) {
+                for (size_t r = begin; r < end; ++r) {
+                    size_t j = first + r;
+                    const uint32_t * emitters = block.getRowColumns(r);
+                    const real_t * factors = block.getRowValues(r);
+                    real_t * result = &next[j * nbbands];
+                    for (size_t b = 0; b < nbbands; ++b) result[b] = incident[j * nbbands + b];
+                    for (size_t k = 0, n = block.getRowSize(r); k < n; ++k) {
+                        const real_t * source = &exit[size_t(emitters[k]) * nbbands];
+                        for (size_t b = 0; b < nbbands; ++b) result[b] += factors[k] * source[b];
+                    }
+                }
+            });
+            first += block.getNbRows();
+        }
+        __residual = rad_residual(__energy, next);
+        __energy.swap(next);
+        ++__nbIterations;
+    }
+}
+
+void RadiositySolver::gaussSeidel(const std::vector<real_t>& incident)
+{
+    const size_t nbbands = __nbBands;
+    __energy = incident;
+    std::vector<real_t> previous, exit, current;
+    __residual = (__size > 0 ? REAL_MAX : 0);
+    while (__nbIterations < __maxIterations && __residual > __tolerance) {
+        previous = __energy;
+        exitance(__energy, exit);
+        // exitances updated during the sweep. Those of the other ranges of a block are read from exit.
+        current = exit;
+        size_t first = 0;
+        for (std::vector<FormFactorMatrixPtr>::const_iterator itBlock = __transposed.begin(); itBlock != __transposed.end(); ++itBlock) {
+            const FormFactorMatrix& block = **itBlock;
+            parallel_for_range(0, block.getNbRows(), [&](size_t begin, size_t end) {
+                const uint32_t rangebegin = uint32_t(first + begin), rangeend = uint32_t(first + end), blockbegin = uint32_t(first);
+                for (size_t r = begin; r < end; ++r) {
+                    size_t j = first + r;
+                    const uint32_t * emitters = block.getRowColumns(r);
+                    const real_t * factors = block.getRowValues(r);
+                    real_t * result = &__energy[j * nbbands];
+                    for (size_t b = 0; b < nbbands; ++b) result[b] = incident[j * nbbands + b];
+                    for (size_t k = 0, n = block.getRowSize(r); k < n; ++k) {
+                        uint32_t i = emitters[k];
+                        bool updated = (i < blockbegin) || (i >= rangebegin && i < rangeend);
+                        const real_t * source = (updated ? &current[size_t(i) * nbbands] : &exit[size_t(i) * nbbands]);
+                        for (size_t b = 0; b < nbbands; ++b) result[b] += factors[k] * source[b];
+                    }
+                    for (size_t b = 0; b < nbbands; ++b) current[j * nbbands + b] = result[b] * __scattering[j * nbbands + b];
+                }
+            });
+            first += block.getNbRows();
+        }
+        __residual = rad_residual(previous, __energy);
+        ++__nbIterations;
+    }
+}
+
+void RadiositySolver::progressiveRefinement(const std::vector<real_t>& incident)
+{
+    const size_t nbbands = __nbBands;
+    __energy = incident;
+    std::vector<real_t> unshot;
+    exitance(incident, unshot);
+    real_t initial = std::accumulate(unshot.begin(), unshot.end(), real_t(0));
+    __residual = 0;
+    if (initial <= 0) return;
+
+    std::vector<real_t> totals(__size);
+    // energy shot by each triangle at the current iteration
+    std::vector<real_t> shot(__size * nbbands, 0);
+    std::vector<uchar_t> isshooter(__size, false);
+    std::vector<uint32_t> shooters;
+    __residual = 1;
+    while (__nbIterations < __maxIterations && __residual > __tolerance) {
+        real_t maxunshot = 0;
+        for (size_t i = 0; i < __size; ++i) {
+            totals[i] = std::accumulate(unshot.begin() + i * nbbands, unshot.begin() + (i + 1) * nbbands, real_t(0));
+            maxunshot = std::max(maxunshot, totals[i]);
+        }
+        shooters.clear();
+        for (size_t i = 0; i < __size; ++i) {
+            if (totals[i] > 0 && totals[i] >= maxunshot / 4) {
+                shooters.push_back(uint32_t(i));
+                isshooter[i] = true;
+                std::copy(unshot.begin() + i * nbbands, unshot.begin() + (i + 1) * nbbands, shot.begin() + i * nbbands);
+                std::fill(unshot.begin() + i * nbbands, unshot.begin() + (i + 1) * nbbands, real_t(0));
+            }
+        }
+
+        // each receiver gathers the energy of the shooters among its emitters.
+        size_t first = 0;
+        for (std::vector<FormFactorMatrixPtr>::const_iterator itBlock = __transposed.begin(); itBlock != __transposed.end(); ++itBlock) {
+            const FormFactorMatrix& block = **itBlock;
+            parallel_for_range(0, block.getNbRows(), [&](size_t begin, size_t end) {
+                for (size_t r = begin; r < end; ++r) {
+                    size_t j = first + r;
+                    const uint32_t * emitters = block.getRowColumns(r);
+                    const real_t * factors = block.getRowValues(r);
+                    for (size_t k = 0, n = block.getRowSize(r); k < n; ++k) {
+                        size_t i = emitters[k];
+                        if (!isshooter[i]) continue;
+                        for (size_t b = 0; b < nbbands; ++b) {
+                            real_t received = factors[k] * shot[i * nbbands + b];
+                            __energy[j * nbbands + b] += received;
+                            unshot[j * nbbands + b] += received * __scattering[j * nbbands + b];
+                        }
+                    }
+                }
+            });
+            first += block.getNbRows();
+        }
+        for (std::vector<uint32_t>::const_iterator it = shooters.begin(); it != shooters.end(); ++it) isshooter[*it] = false;
+        __residual = std::accumulate(unshot.begin(), unshot.end(), real_t(0)) / initial;
+        ++__nbIterations;
+    }
+}
+
+/* ----------------------------------------------------------------------- */
+
+RealArray2Ptr RadiositySolver::toArray(const std::vector<real_t>& values) const
+{
+    if (__energy.empty()) return RealArray2Ptr();
+    RealArray2Ptr result(new RealArray2(uint_t(__size), uint_t(__nbBands)));
+    std::copy(values.begin(), values.end(), result->begin());
+    return result;
+}
+
+RealArray2Ptr RadiositySolver::getIntercepted() const
+{
+    return toArray(__energy);
+}
+
+RealArray2Ptr RadiositySolver::getAbsorbed() const
+{
+    std::vector<real_t> result(__energy.size());
+    for (size_t k = 0; k < __energy.size(); ++k) result[k] = __energy[k] * (1 - __scattering[k]);
+    return toArray(result);
+}
+
+RealArray2Ptr RadiositySolver::getReflected() const
+{
+    std::vector<real_t> result(__energy.size());
+    for (size_t k = 0; k < __energy.size(); ++k) result[k] = __energy[k] * property(__reflectance, k / __nbBands, k % __nbBands);
+    return toArray(result);
+}
+
+RealArray2Ptr RadiositySolver::getTransmitted() const
+{
+    std::vector<real_t> result(__energy.size());
+    for (size_t k = 0; k < __energy.size(); ++k) result[k] = __energy[k] * property(__transmittance, k / __nbBands, k % __nbBands);
+    return toArray(result);
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,174 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+/*! \file radiosity.h
+    \brief Definition of RadiositySolver, an iterative multiple scattering solver on sparse form factors.
+*/
+
+
+
+#ifndef __radiosity_h__
+#define __radiosity_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include "formfactors.h"
+#include <vector>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+    \class RadiositySolver
+    \brief Solve the multiple scattering of light between triangles on several wavebands.
+
+    F[i,j] is the fraction of the energy scattered by triangle i that is intercepted 
+    by triangle j (form factors of solid angles should be scaled by 1/(2*pi) first). 
+    Each triangle scatters the fraction reflectance + transmittance of the energy it 
+    intercepts, its two sides being not distinguished. The total intercepted energy E 
+    is the solution of E[j] = E0[j] + sum_i F[i,j] * (reflectance[i] + transmittance[i]) * E[i]
+    where E0 is the incident energy, solved independently for each waveband.
+
+    Energies and optical properties are given as arrays of one row per triangle and one 
+    column per waveband. Optical properties with a single row apply to all the triangles.
+
+    The form factors are given as a matrix or as its blocks of rows, as produced by 
+    FormFactorEngine::compute(begin, end). They are transposed once at construction in 
+    blocks of blockSize receivers and only this transposed copy is kept. All the methods 
+    gather on it, block by block, each block being processed in parallel. Gauss-Seidel is 
+    exact within each parallel range and Jacobi between ranges of the same block. 
+    Progressive refinement shoots at each iteration the unshot energy of the triangles 
+    having at least a quarter of the maximal unshot energy.
+*/
+
+class ALGO_API RadiositySolver : public RefCountObject {
+public:
+    enum eMethod {
+        eJacobi = 0,
+        eGaussSeidel = 1,
+        eProgressiveRefinement = 2
+    };
+
+    RadiositySolver(const FormFactorMatrixPtr& formfactors, size_t blockSize = 65536);
+    RadiositySolver(const std::vector<FormFactorMatrixPtr>& blocks, size_t blockSize = 65536);
+    virtual ~RadiositySolver();
+
+    /// Number of triangles.
+    inline size_t size() const { return __size; }
+
+    inline eMethod getMethod() const { return __method; }
+    inline void setMethod(eMethod method) { __method = method; }
+
+    /** Convergence threshold. Jacobi and Gauss-Seidel stop when the largest change of energy 
+        relative to the largest energy is below it. Progressive refinement stops when the 
+        unshot energy relative to the initially scattered energy is below it. */
+    inline real_t getTolerance() const { return __tolerance; }
+    inline void setTolerance(real_t value) { __tolerance = value; }
+
+    inline uint32_t getMaxIterations() const { return __maxIterations; }
+    inline void setMaxIterations(uint32_t value) { __maxIterations = value; }
+
+    inline const RealArray2Ptr& getReflectance() const { return __reflectance; }
+    inline void setReflectance(const RealArray2Ptr& value) { __reflectance = value; }
+
+    inline const RealArray2Ptr& getTransmittance() const { return __transmittance; }
+    inline void setTransmittance(const RealArray2Ptr& value) { __transmittance = value; }
+
+    /// Solve for the incident energy \e incident. Return whether it converged.
+    bool solve(const RealArray2Ptr& incident);
+
+    /// Number of iterations and last convergence criterion of the last solve.
+    inline uint32_t getNbIterations() const { return __nbIterations; }
+    inline real_t getResidual() const { return __residual; }
+
+    inline size_t getNbBands() const { return __nbBands; }
+
+    /// Total energy intercepted by each triangle.
+    RealArray2Ptr getIntercepted() const;
+    /// Intercepted energy times (1 - reflectance - transmittance).
+    RealArray2Ptr getAbsorbed() const;
+    RealArray2Ptr getReflected() const;
+    RealArray2Ptr getTransmitted() const;
+
+protected:
+    void init(const std::vector<FormFactorMatrixPtr>& blocks, size_t blockSize);
+
+    real_t property(const RealArray2Ptr& property, size_t i, size_t b) const;
+
+    void jacobi(const std::vector<real_t>& incident);
+    void gaussSeidel(const std::vector<real_t>& incident);
+    void progressiveRefinement(const std::vector<real_t>& incident);
+
+    /// Energies multiplied by the scattering coefficients.
+    void exitance(const std::vector<real_t>& energy, std::vector<real_t>& result) const;
+    RealArray2Ptr toArray(const std::vector<real_t>& values) const;
+
+    /// Transposed form factors : row j of block k gives the emitters seen by triangle k * blockSize + j.
+    std::vector<FormFactorMatrixPtr> __transposed;
+    size_t __blockSize;
+    size_t __size;
+    size_t __nbBands;
+
+    eMethod __method;
+    real_t __tolerance;
+    uint32_t __maxIterations;
+    RealArray2Ptr __reflectance;
+    RealArray2Ptr __transmittance;
+
+    /// Reflectance + transmittance of each triangle and band.
+    std::vector<real_t> __scattering;
+    std::vector<real_t> __energy;
+    uint32_t __nbIterations;
+    real_t __residual;
+};
+
+typedef RCPtr<RadiositySolver> RadiositySolverPtr;
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+#endif
@@ -0,0 +1,172 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/* ----------------------------------------------------------------------- */
+
+#include "trianglesoup.h"
+#include "projectionengine.h"
+#include "projectionrenderer.h"
+#include <plantgl/scenegraph/appearance/material.h>
+#include <plantgl/tool/util_taskscheduler.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+TriangleSoupBuilder::TriangleSoupBuilder(TriangleSoup * soup) : 
+    ProjectionEngine(), __soup(soup) 
+{
+}
+
+void TriangleSoupBuilder::iprocess(TriangleSetPtr triangles, AppearancePtr appearance, uint32_t id, ProjectionCameraPtr camera, uint32_t threadid)
+{
+    if (is_null_ptr(camera)) camera = __camera;
+    Matrix4 transform = camera->getModelTransformationMatrix();
+    bool ccw = triangles->getCCW();
+    bool hasColor = triangles->hasColorList();
+    Color4 color = Color4::BLACK;
+    if (!hasColor) {
+        MaterialPtr material = dynamic_pointer_cast<Material>(appearance);
+        if (is_valid_ptr(material)) color = Color4(material->getAmbient(), material->getTransparency());
+    }
+    size_t nbfaces = triangles->getIndexListSize();
+    for(uint32_t itidx = 0; itidx < nbfaces; ++itidx){
+        Vector3 v0 = transform * triangles->getFacePointAt(itidx,0);
+        Vector3 v1 = transform * triangles->getFacePointAt(itidx,1);
+        Vector3 v2 = transform * triangles->getFacePointAt(itidx,2);
+        if (hasColor) color = Color4::interpolate(triangles->getFaceColorAt(itidx,0), 1/3., triangles->getFaceColorAt(itidx,1), 1/3., triangles->getFaceColorAt(itidx,2), 1/3.);
+        if (ccw) __soup->addTriangle(v0, v1, v2, id, color);
+        else __soup->addTriangle(v0, v2, v1, id, color);
+    }
+}
+
+void TriangleSoupBuilder::iprocess(PolylinePtr polyline, MaterialPtr material, uint32_t id, ProjectionCameraPtr camera, uint32_t threadid) 
+{ 
+}
+
+void TriangleSoupBuilder::iprocess(PointSetPtr pointset, MaterialPtr material, uint32_t id, ProjectionCameraPtr camera, uint32_t threadid) 
+{ 
+}
+
+/* ----------------------------------------------------------------------- */
+
+TriangleSoup::TriangleSoup()
+{
+}
+
+TriangleSoup::TriangleSoup(const ScenePtr& scene, const DiscretizationCachePtr& cache)
+{
+    size_t msize = scene->size();
+    if (msize == 0) return;
+
+    // Each chunk of shapes is tessellated in its own soup. They are concatenated in scene order.
+    size_t nbchunks = pglMin(msize, 4 * (TaskScheduler::get().nbThreads() + 1));
+    size_t grainsize = (msize + nbchunks - 1) / nbchunks;
+    nbchunks = (msize + grainsize - 1) / grainsize;
+    std::vector<TriangleSoup> chunks(nbchunks);
+
+    parallel_for_range(0, msize, [&](size_t begin, size_t end) {
+        TriangleSoupBuilder builder(&chunks[begin / grainsize]);
+        Discretizer d;
+        Tesselator t;
+        d.setSharedCache(cache);
+        t.setSharedCache(cache);
+        ProjectionRenderer r(builder, t, d);
+        for (Scene::const_iterator it = scene->begin() + begin; it != scene->begin() + end; ++it)
+            (*it)->apply(r);
+    }, grainsize);
+
+    size_t nbtriangles = 0;
+    for (std::vector<TriangleSoup>::const_iterator it = chunks.begin(); it != chunks.end(); ++it)
+        nbtriangles += it->size();
+    reserve(nbtriangles);
+    for (std::vector<TriangleSoup>::const_iterator it = chunks.begin(); it != chunks.end(); ++it)
+        append(*it);
+}
+
+TriangleSoup::~TriangleSoup()
+{
+}
+
+void TriangleSoup::addTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, uint32_t id, const Color4& color)
+{
+    __vertices.push_back(v0);
+    __vertices.push_back(v1);
+    __vertices.push_back(v2);
+    __ids.push_back(id);
+    __colors.push_back(color);
+}
+
+void TriangleSoup::append(const TriangleSoup& other)
+{
+    append(other, 0, other.size());
+}
+
+void TriangleSoup::append(const TriangleSoup& other, size_t first, size_t count)
+{
+    __vertices.insert(__vertices.end(), other.__vertices.begin() + 3*first, other.__vertices.begin() + 3*(first+count));
+    __ids.insert(__ids.end(), other.__ids.begin() + first, other.__ids.begin() + first + count);
+    __colors.insert(__colors.end(), other.__colors.begin() + first, other.__colors.begin() + first + count);
+}
+
+void TriangleSoup::reserve(size_t nbtriangles)
+{
+    __vertices.reserve(3*nbtriangles);
+    __ids.reserve(nbtriangles);
+    __colors.reserve(nbtriangles);
+}
+
+void TriangleSoup::clear()
+{
+    __vertices.clear();
+    __ids.clear();
+    __colors.clear();
+}
+
+void TriangleSoup::swap(TriangleSoup& other)
+{
+    __vertices.swap(other.__vertices);
+    __ids.swap(other.__ids);
+    __colors.swap(other.__colors);
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,140 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+/*! \file trianglesoup.h
+    \brief Definition of TriangleSoup, a flat buffer of world-space triangles.
+*/
+
+
+
+#ifndef __TriangleSoup_h__
+#define __TriangleSoup_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include "../algo_config.h"
+#include <plantgl/math/util_vector.h>
+#include <plantgl/tool/rcobject.h>
+#include <plantgl/scenegraph/appearance/color.h>
+#include <plantgl/scenegraph/scene/scene.h>
+#include "projectionengine.h"
+#include <vector>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/** 
+    \class TriangleSoup
+    \brief The triangles of a scene, tessellated and transformed in world space once,
+    with the id of the shape they come from and a flat colour. 
+
+    Triangles are stored with a counter clockwise orientation. The colour of a triangle 
+    is the mean of its colours for meshes with a color list and the ambient colour of 
+    the material otherwise (black for other appearances). Polylines and point sets 
+    of the scene are ignored. Such a buffer can be rendered from many points of view 
+    without traversing the scene again (see ZBufferEngine::process(TriangleSoupPtr)).
+*/
+
+/* ----------------------------------------------------------------------- */
+
+class ALGO_API TriangleSoup : public RefCountObject {
+public:
+    TriangleSoup();
+    /// Tessellate the shapes of scene. Shapes are processed in parallel, optionally sharing a tessellation cache.
+    TriangleSoup(const ScenePtr& scene, const DiscretizationCachePtr& cache = DiscretizationCachePtr());
+    virtual ~TriangleSoup();
+
+    void addTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, uint32_t id, const Color4& color = Color4::BLACK);
+    void append(const TriangleSoup& other);
+    /// Append count triangles of other starting at first.
+    void append(const TriangleSoup& other, size_t first, size_t count);
+    void reserve(size_t nbtriangles);
+    void clear();
+    void swap(TriangleSoup& other);
+
+    inline size_t size() const { return __ids.size(); }
+    inline bool empty() const { return __ids.empty(); }
+
+    inline const Vector3& getVertexAt(size_t triangle, uint32_t vertex) const { return __vertices[3*triangle+vertex]; }
+    inline uint32_t getIdAt(size_t triangle) const { return __ids[triangle]; }
+    inline const Color4& getColorAt(size_t triangle) const { return __colors[triangle]; }
+
+    /// Vertices of the triangles, 3 consecutive vertices per triangle.
+    const std::vector<Vector3>& getVertices() const { return __vertices; }
+    const std::vector<uint32_t>& getIds() const { return __ids; }
+    const std::vector<Color4>& getColors() const { return __colors; }
+
+protected:
+    std::vector<Vector3> __vertices;
+    std::vector<uint32_t> __ids;
+    std::vector<Color4> __colors;
+};
+
+typedef RCPtr<TriangleSoup> TriangleSoupPtr;
+
+/* ----------------------------------------------------------------------- */
+
+/// A ProjectionEngine that records the world-space triangles produced by a ProjectionRenderer into a TriangleSoup.
+class ALGO_API TriangleSoupBuilder : public ProjectionEngine {
+public:
+    TriangleSoupBuilder(TriangleSoup * soup);
+
+    void setSoup(TriangleSoup * soup) { __soup = soup; }
+    TriangleSoup * getSoup() const { return __soup; }
+
+    virtual void iprocess(TriangleSetPtr triangles, AppearancePtr appearance, uint32_t id, ProjectionCameraPtr camera = ProjectionCameraPtr(), uint32_t threadid = 0);
+    virtual void iprocess(PolylinePtr polyline, MaterialPtr material, uint32_t id, ProjectionCameraPtr camera = ProjectionCameraPtr(), uint32_t threadid = 0);
+    virtual void iprocess(PointSetPtr pointset, MaterialPtr material, uint32_t id, ProjectionCameraPtr camera = ProjectionCameraPtr(), uint32_t threadid = 0);
+
+protected:
+    TriangleSoup * __soup;
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+#endif
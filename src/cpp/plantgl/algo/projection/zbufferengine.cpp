@@ -45,10 +45,11 @@
 #include "zbufferengine.h"
 #include "projectionrenderer.h"
 #include "projection_util.h"
-#include <boost/asio.hpp>
-#include <boost/thread.hpp>
+#include "formfactors.h"
+#include <plantgl/algo/base/bboxcomputer.h>
+#include <plantgl/algo/base/discretizer.h>
+#include <plantgl/tool/util_profile.h>
 #include <boost/bind.hpp>
-#include <chrono>
 /* ----------------------------------------------------------------------- */
 
 PGL_USING_NAMESPACE
@@ -73,7 +74,15 @@ ZBufferEngine::ZBufferEngine(uint16_t imageWidth,
     __triangleshader((style != eDepthOnly) ? new TriangleShaderSelector(this) : NULL),
     __triangleshaderset(NULL),
     __multithreaded(multithreaded),
-    __culling(culling)
+    __culling(culling),
+    __tiledRendering(false),
+    __tileSize(32),
+    __simdRendering(true),
+    __occlusionCulling(false),
+    __frontToBackOrdering(false),
+    __nbCulledTriangles(0),
+    __nbRasterizedTriangles(0),
+    __nbCulledShapes(0)
 {
     beginProcess();
 }    
@@ -107,14 +116,30 @@ void ZBufferEngine::beginProcess()
         __imageMutex = getImageMutex(__imageWidth, __imageHeight);
     }
 
+    if (__occlusionCulling) _hizInit();
+
+    if (__tiledRendering) _initTriangleBins();
+
 }
 
 void ZBufferEngine::endProcess()
 {
 
     if(__multithreaded){
-        ThreadManager::get().join();
+        __tasks.wait();
     }
+
+    if(__tiledRendering){
+        _flushTiles();
+    }
+}
+
+void ZBufferEngine::setTileSize(uint16_t tileSize)
+{
+    _clearTiles();
+    __tileSize = pglMax<uint16_t>(1, tileSize);
+    for (std::vector<TriangleBin>::iterator itBin = __triangleBins.begin(); itBin != __triangleBins.end(); ++itBin)
+        itBin->tiles.clear();
 }
 
 void ZBufferEngine::setHemisphericCamera(real_t nearValue, real_t farValue)
@@ -234,18 +259,7 @@ bool ZBufferEngine::_tryRenderRaster(uint32_t x, uint32_t y, real_t z, const Col
     if (isTotallyTransparent(rasterColor.getAlpha())) return false;
 
     if(tryLock(x,y)){
-        if (isVisible(x,y,z)) {
-            __depthBuffer->setAt(x, y, z);
-            if(__style & eColorBased){
-                setFrameBufferAt(x, y, rasterColor);
-            }
-            if(__style & eIdBased){
-                __idBuffer->setAt(x, y, id);
-            }
-            if(__style & eOrientationBased){
-                __idBuffer->setAt(x, y, orientation);
-            }
-        }
+        _writeRaster(x, y, z, rasterColor, id, orientation);
         unlock(x,y);
         return true;
     }
@@ -253,6 +267,32 @@ bool ZBufferEngine::_tryRenderRaster(uint32_t x, uint32_t y, real_t z, const Col
 
 }
 
+void ZBufferEngine::_writeRaster(uint32_t x, uint32_t y, real_t z, const Color4& rasterColor, const uint32_t id, const bool orientation)
+{
+    if (isVisible(x,y,z)) {
+        __depthBuffer->setAt(x, y, z);
+        if(__style & eColorBased){
+            setFrameBufferAt(x, y, rasterColor);
+        }
+        if(__style & eIdBased){
+            __idBuffer->setAt(x, y, id);
+        }
+        if(__style & eOrientationBased){
+            __idBuffer->setAt(x, y, orientation);
+        }
+    }
+}
+
+void ZBufferEngine::_renderFragment(const struct Fragment& fragment, FragmentQueue& failqueue, bool lockfree)
+{
+    if (lockfree) {
+        // the pixel is owned by the calling thread.
+        if (!isTotallyTransparent(fragment.color.getAlpha()))
+            _writeRaster(fragment.x, fragment.y, fragment.z, fragment.color, fragment.id, fragment.orientation);
+    }
+    else _tryRenderRaster(fragment, failqueue);
+}
+
 void ZBufferEngine::setLight(const Vector3& lightPosition, const Color3& lightColor, bool directional)
 {
     __light->set(lightPosition, lightColor, directional);
@@ -275,12 +315,13 @@ void ZBufferEngine::iprocess(TriangleSetPtr triangles, AppearancePtr appearance,
     triangles->checkNormalList();
 
     size_t nbfaces = triangles->getIndexListSize();
+    PGL_PROFILE_COUNT("zbuffer.triangles", nbfaces);
     bool hasColor = triangles->hasColorList();
 
     TriangleShaderPtr shader;
     if (getRenderingStyle() & eColorBased){
         if (threadid != 0) {
-            assert(threadid <= ThreadManager::get().nb_threads());
+            assert(threadid <= TaskScheduler::get().nbThreads());
             //printf("session %u\n", threadid);
             shader = __triangleshaderset[threadid-1];
         }
@@ -302,7 +343,7 @@ void ZBufferEngine::iprocess(TriangleSetPtr triangles, AppearancePtr appearance,
         }
       
         // shader->initEnv(_camera, __light);
-        renderShadedTriangle(v0, v1, v2, ccw, id, shader, _camera);
+        renderShadedTriangle(v0, v1, v2, ccw, id, shader, _camera, threadid);
 
     }
     // printf("end process TriangleSetPtr\n");
@@ -310,7 +351,7 @@ void ZBufferEngine::iprocess(TriangleSetPtr triangles, AppearancePtr appearance,
 }
 
 
-void ZBufferEngine::renderShadedTriangle(const TOOLS(Vector3)& v0, const TOOLS(Vector3)& v1_, const TOOLS(Vector3)& v2_, bool ccw, const uint32_t id, const TriangleShaderPtr& shader,  const ProjectionCameraPtr& camera)
+void ZBufferEngine::renderShadedTriangle(const TOOLS(Vector3)& v0, const TOOLS(Vector3)& v1_, const TOOLS(Vector3)& v2_, bool ccw, const uint32_t id, const TriangleShaderPtr& shader,  const ProjectionCameraPtr& camera, uint32_t threadid)
 {
     Vector3 v1 = v1_;
     Vector3 v2 = v2_;
@@ -381,14 +422,18 @@ void ZBufferEngine::renderShadedTriangle(const TOOLS(Vector3)& v0, const TOOLS(V
     int32_t y0 = pglMax(int32_t(0), (int32_t)(std::floor(ymin)));
     int32_t y1 = pglMin(int32_t(__imageHeight) - 1, (int32_t)(std::ceil(ymax)));
 
-    if (__multithreaded && (x1-x0+1)*(y1-y0+1) > 20) {
+    if (__tiledRendering) {
+        _binTriangle(Index4(x0,x1,y0,y1), v0Raster, v1Raster, v2Raster, v0Cam, v1Cam, v2Cam, id, 
+                     (is_valid_ptr(shader) && (getRenderingStyle() & eColorBased)) ? TriangleShaderPtr(shader->copy()) : shader, camera, threadid);
+    }
+    else if (__multithreaded && (x1-x0+1)*(y1-y0+1) > 20) {
         std::tuple<Vector3,Vector3,Vector3> vRasters(v0Raster, v1Raster, v2Raster);
         std::tuple<Vector3,Vector3,Vector3> vCams(v0Cam,v1Cam,v2Cam);
 
-        ThreadManager::get().new_task(boost::bind(&ZBufferEngine::rasterizeMT, this, Index4(x0,x1,y0,y1), 
+        __tasks.run(boost::bind(&ZBufferEngine::rasterizeMT, this, Index4(x0,x1,y0,y1), 
                                                   // v0Raster, v1Raster, v2Raster, v0Cam,v1Cam,v2Cam,
                                                   vRasters, vCams, id, 
-                                                  (getRenderingStyle() & eColorBased) ? TriangleShaderPtr(shader->copy()) : shader, ProjectionCameraPtr(camera->copy())));
+                                                  (is_valid_ptr(shader) && (getRenderingStyle() & eColorBased)) ? TriangleShaderPtr(shader->copy()) : shader, ProjectionCameraPtr(camera->copy())));
     }
     else {
         rasterize(x0,x1,y0,y1,v0Raster,v1Raster,v2Raster,v0Cam,v1Cam,v2Cam,id,shader,camera);
@@ -410,6 +455,76 @@ void ZBufferEngine::rasterizeMT(const Index4& rect,
               id,shader,camera);  
 }
 
+void ZBufferEngine::_binTriangle(const Index4& rect,
+                                 const Vector3& v0Raster, const Vector3& v1Raster, const Vector3& v2Raster, 
+                                 const Vector3& v0Cam, const Vector3& v1Cam, const Vector3& v2Cam, 
+                                 const uint32_t id, 
+                                 const TriangleShaderPtr& shader, const ProjectionCameraPtr& camera, uint32_t threadid)
+{
+    // Only the thread with the given threadid writes in this bin. No lock required.
+    // The bins are sized in beginProcess : resizing here would move the bins used by other threads.
+    GEOM_ASSERT(threadid < __triangleBins.size());
+    TriangleBin& bin = __triangleBins[threadid];
+
+    uint32_t nbtilesx = _nbTilesX();
+    if (bin.tiles.empty()) bin.tiles.resize(nbtilesx * _nbTilesY());
+
+    uint32_t triangleid = bin.triangles.size();
+    BinnedTriangle triangle = { rect, v0Raster, v1Raster, v2Raster, v0Cam, v1Cam, v2Cam, id, shader, camera };
+    bin.triangles.push_back(triangle);
+
+    for (uint32_t ty = rect[2] / __tileSize; ty <= rect[3] / __tileSize; ++ty)
+        for (uint32_t tx = rect[0] / __tileSize; tx <= rect[1] / __tileSize; ++tx)
+            bin.tiles[ty * nbtilesx + tx].push_back(triangleid);
+}
+
+void ZBufferEngine::_rasterizeTile(uint32_t tileid)
+{
+    uint32_t nbtilesx = _nbTilesX();
+    uint32_t x0 = (tileid % nbtilesx) * __tileSize;
+    uint32_t y0 = (tileid / nbtilesx) * __tileSize;
+    Index4 clip(x0, pglMin<uint32_t>(x0 + __tileSize, __imageWidth) - 1, 
+                y0, pglMin<uint32_t>(y0 + __tileSize, __imageHeight) - 1);
+
+    // Bins are processed in producer order, and triangles of a bin in submission order.
+    // Each pixel thus receives its fragments in the same order as with sequential rendering.
+    for (std::vector<TriangleBin>::const_iterator itBin = __triangleBins.begin(); itBin != __triangleBins.end(); ++itBin){
+        if (itBin->tiles.empty()) continue;
+        const std::vector<uint32_t>& tile = itBin->tiles[tileid];
+        for (std::vector<uint32_t>::const_iterator itTri = tile.begin(); itTri != tile.end(); ++itTri){
+            const BinnedTriangle& t = itBin->triangles[*itTri];
+            _rasterize(t.rect, clip, t.v0Raster, t.v1Raster, t.v2Raster, t.v0Cam, t.v1Cam, t.v2Cam, t.id, t.shader, t.camera, true);
+        }
+    }
+}
+
+void ZBufferEngine::_flushTiles()
+{
+    uint32_t nbtiles = _nbTilesX() * _nbTilesY();
+    for (uint32_t tileid = 0; tileid < nbtiles; ++tileid) {
+        bool empty = true;
+        for (std::vector<TriangleBin>::const_iterator itBin = __triangleBins.begin(); itBin != __triangleBins.end() && empty; ++itBin)
+            empty = itBin->tiles.empty() || itBin->tiles[tileid].empty();
+        if (empty) continue;
+
+        if (__multithreaded) 
+            __tasks.run(boost::bind(&ZBufferEngine::_rasterizeTile, this, tileid));
+        else 
+            _rasterizeTile(tileid);
+    }
+    if (__multithreaded) __tasks.wait();
+    _clearTiles();
+}
+
+void ZBufferEngine::_clearTiles()
+{
+    for (std::vector<TriangleBin>::iterator itBin = __triangleBins.begin(); itBin != __triangleBins.end(); ++itBin){
+        itBin->triangles.clear();
+        for (std::vector<std::vector<uint32_t> >::iterator itTile = itBin->tiles.begin(); itTile != itBin->tiles.end(); ++itTile)
+            itTile->clear();
+    }
+}
+
 void findorder(real_t * zs, int& firstpoint, int& secpoint, int& thirdpoint){
     firstpoint = 0; secpoint = 1; thirdpoint = 2;
     if (zs[firstpoint] < zs[secpoint]) std::swap(firstpoint, secpoint);
@@ -438,6 +553,18 @@ void ZBufferEngine::rasterize(int32_t x0, int32_t x1, int32_t y0, int32_t y1,
                               TOOLS(Vector3) v0Cam, TOOLS(Vector3) v1Cam, TOOLS(Vector3) v2Cam, const uint32_t id, 
                               const TriangleShaderPtr& shader, const ProjectionCameraPtr& camera)
 {
+    Index4 rect(x0, x1, y0, y1);
+    _rasterize(rect, rect, v0Raster, v1Raster, v2Raster, v0Cam, v1Cam, v2Cam, id, shader, camera, false);
+}
+
+void ZBufferEngine::_rasterize(const Index4& rect, const Index4& clip,
+                               TOOLS(Vector3) v0Raster, TOOLS(Vector3) v1Raster, TOOLS(Vector3) v2Raster, 
+                               const TOOLS(Vector3)& v0Cam, const TOOLS(Vector3)& v1Cam, const TOOLS(Vector3)& v2Cam, 
+                               const uint32_t id, 
+                               const TriangleShaderPtr& shader, const ProjectionCameraPtr& camera, bool lockfree)
+{
+    // rect is the raster bounding box of the triangle. Only pixels inside clip are rendered.
+    int32_t x0 = rect[0], x1 = rect[1], y0 = rect[2], y1 = rect[3];
 
     if (__culling == ZBufferEngine::eBothFaceCulling) return;
 
@@ -470,15 +597,40 @@ void ZBufferEngine::rasterize(int32_t x0, int32_t x1, int32_t y0, int32_t y1,
 
     // Inner loop
     if ((x0 == x1) && (y0 == y1)) {
-        if (camera->isValidPixel(x0,y0,__imageWidth, __imageHeight)){
+        if (x0 >= int32_t(clip[0]) && x0 <= int32_t(clip[1]) && y0 >= int32_t(clip[2]) && y0 <= int32_t(clip[3]) &&
+            camera->isValidPixel(x0,y0,__imageWidth, __imageHeight)){
             real_t z = (z0+z1+z2)/3;
             real_t w0 = 1/3.;
-            _tryRenderRaster(Fragment(x0,y0,z, is_valid_ptr(shader) ? shader->process(x0, y0, z, (w0 * z / z0), (w0 * z / z1), (w0 * z / z2)) : Color4::BLACK, id, true), fragqueue );
+            _renderFragment(Fragment(x0,y0,z, is_valid_ptr(shader) ? shader->process(x0, y0, z, (w0 * z / z0), (w0 * z / z1), (w0 * z / z2)) : Color4::BLACK, id, true), fragqueue, lockfree );
         }
     }
     else {
-        for (int32_t y = y0; y <= y1; ++y) {
-            for (int32_t x = x0; x <= x1; ++x) {
+        int32_t cx0 = pglMax<int32_t>(x0, clip[0]), cx1 = pglMin<int32_t>(x1, clip[1]);
+        int32_t cy0 = pglMax<int32_t>(y0, clip[2]), cy1 = pglMin<int32_t>(y1, clip[3]);
+
+        if (_useHiZ(camera, lockfree)) {
+            // the depth of the fragments is at least the min depth of the vertices (up to the tolerance on the barycentric weights).
+            real_t zmin = min3(z0, z1, z2);
+            if (area != 0 && zmin > 0 && _isOccluded(Index4(cx0, cx1, cy0, cy1), zmin / (1 + 1e-4))) {
+                ++__nbCulledTriangles;
+                return;
+            }
+            ++__nbRasterizedTriangles;
+            _hizTouch(Index4(cx0, cx1, cy0, cy1));
+        }
+
+        // vectorized rasterization when no other thread can write the pixels
+        ZBufferKernel kernel = NULL;
+        if (__simdRendering && camera->methodType() == ProjectionCamera::eProjection && 
+            (lockfree || !__multithreaded) && cy1 - cy0 + 1 >= ZBUFFER_KERNEL_BLOCK) 
+            kernel = getZBufferKernel();
+        if (kernel) {
+            _rasterizeBlocks(kernel, Index4(cx0, cx1, cy0, cy1), v0Raster, v1Raster, v2Raster, z0, z1, z2, area, id, shader, camera);
+            return;
+        }
+
+        for (int32_t y = cy0; y <= cy1; ++y) {
+            for (int32_t x = cx0; x <= cx1; ++x) {
 
                 Vector2 pixelSample(x + 0.5, y + 0.5);
                 if (camera->methodType() == ProjectionCamera::eProjection){
@@ -502,7 +654,7 @@ void ZBufferEngine::rasterize(int32_t x0, int32_t x1, int32_t y0, int32_t y1,
 
                         // Depth-buffer test
                         if (camera->isInZRange(z)){
-                            _tryRenderRaster(Fragment(x,y,z, is_valid_ptr(shader) ? shader->process(x, y, z, (w0 * z / z0), (w1 * z / z1), (w2 * z / z2)) : Color4::BLACK, id, intersection == eFrontFaceIntersection), fragqueue );
+                            _renderFragment(Fragment(x,y,z, is_valid_ptr(shader) ? shader->process(x, y, z, (w0 * z / z0), (w1 * z / z1), (w2 * z / z2)) : Color4::BLACK, id, intersection == eFrontFaceIntersection), fragqueue, lockfree );
                         }
                     }
                 }
@@ -521,7 +673,7 @@ void ZBufferEngine::rasterize(int32_t x0, int32_t x1, int32_t y0, int32_t y1,
                             real_t w1 = norm(cross(v2Cam-v0Cam, v2Cam-intersection));
                             real_t w2 = norm(cross(v0Cam-v1Cam, v0Cam-intersection));
                             real_t z = norm(intersection);
-                            _tryRenderRaster(Fragment(x,y,z, is_valid_ptr(shader) ? shader->process(x, y, z, (w0 / area), (w1 / area), (w2 / area)) : Color4::BLACK, id, orientation), fragqueue );
+                            _renderFragment(Fragment(x,y,z, is_valid_ptr(shader) ? shader->process(x, y, z, (w0 / area), (w1 / area), (w2 / area)) : Color4::BLACK, id, orientation), fragqueue, lockfree );
                         }
                     }
                 }
@@ -537,6 +689,50 @@ void ZBufferEngine::rasterize(int32_t x0, int32_t x1, int32_t y0, int32_t y1,
 
 
 
+void ZBufferEngine::_rasterizeBlocks(ZBufferKernel kernel, const Index4& clip,
+                                     const Vector3& v0Raster, const Vector3& v1Raster, const Vector3& v2Raster, 
+                                     real_t z0, real_t z1, real_t z2, real_t area,
+                                     const uint32_t id, 
+                                     const TriangleShaderPtr& shader, const ProjectionCameraPtr& camera)
+{
+    // v0Raster, v1Raster and v2Raster have their z already inverted.
+    ZBufferKernelTriangle t = { v0Raster.x(), v0Raster.y(), v0Raster.z(),
+                                v1Raster.x(), v1Raster.y(), v1Raster.z(),
+                                v2Raster.x(), v2Raster.y(), v2Raster.z(),
+                                area, camera->near, camera->far,
+                                __culling != eFrontFaceCulling, __culling != eBackFaceCulling };
+
+    int32_t cx0 = clip[0], cx1 = clip[1], cy0 = clip[2], cy1 = clip[3];
+
+    // depth and id only : fragments are written directly by the kernel.
+    bool direct = is_null_ptr(shader) && !(__style & eColorBased) && !(__style & eOrientationBased);
+
+    ZBufferKernelBlock block;
+    for (int32_t x = cx0; x <= cx1; ++x) {
+        // columns of the buffers are contiguous
+        real_t * depth = &__depthBuffer->getAt(x, 0);
+        uint32_t * ids = ((__style & eIdBased) ? &__idBuffer->getAt(x, 0) : NULL);
+        for (int32_t y = cy0; y <= cy1; y += ZBUFFER_KERNEL_BLOCK) {
+            // the last block is shifted to end on cy1. Pixels already written fail the depth test.
+            int32_t by = pglMin<int32_t>(y, cy1 - ZBUFFER_KERNEL_BLOCK + 1);
+            if (direct) {
+                kernel(t, x, by, depth + by, ids ? ids + by : NULL, id, NULL);
+            }
+            else {
+                kernel(t, x, by, depth + by, NULL, id, &block);
+                for (int32_t i = 0; block.visible != 0; ++i, block.visible >>= 1, block.frontfacing >>= 1) {
+                    if ((block.visible & 1) == 0) continue;
+                    real_t z = block.z[i];
+                    Color4 color = (is_valid_ptr(shader) ? shader->process(x, by+i, z, (block.w0[i] * z / z0), (block.w1[i] * z / z1), (block.w2[i] * z / z2)) : Color4::BLACK);
+                    if (!isTotallyTransparent(color.getAlpha()))
+                        _writeRaster(x, by+i, z, color, id, (block.frontfacing & 1) != 0);
+                }
+            }
+        }
+    }
+}
+
+
 void ZBufferEngine::renderTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, 
                                      const Color4& c0,  const Color4& c1,  const Color4& c2, 
                                      bool ccw, const uint32_t id, ProjectionCameraPtr camera)
@@ -716,10 +912,12 @@ ImagePtr ZBufferEngine::getTexture(const ImageTexturePtr imgdef)
 
 void ZBufferEngine::process(ScenePtr scene)
 {
+    PGL_PROFILE_ZONE("ZBufferEngine::process");
+    if (__frontToBackOrdering) scene = _sortFrontToBack(scene);
     beginProcess();
     size_t msize = scene->size();
     if(__multithreaded && msize > 100){
-        size_t nbthreads = ThreadManager::get().nb_threads();
+        size_t nbthreads = TaskScheduler::get().nbThreads();
         size_t nbShapePerThread = (msize / nbthreads);
         if (nbShapePerThread * nbthreads < msize) { nbShapePerThread += 1; }
 
@@ -736,7 +934,7 @@ void ZBufferEngine::process(ScenePtr scene)
             Scene::const_iterator itbegin = scene->begin() + i ;
             Scene::const_iterator itend = scene->begin() + pglMin(msize, i + nbShapePerThread);
 
-            ThreadManager::get().new_task(boost::bind(&ZBufferEngine::processScene, this, itbegin, itend, ProjectionCameraPtr(__camera->copy()),threadid));
+            __tasks.run(boost::bind(&ZBufferEngine::processScene, this, itbegin, itend, ProjectionCameraPtr(__camera->copy()),threadid));
 
             
         }
@@ -747,13 +945,217 @@ void ZBufferEngine::process(ScenePtr scene)
     endProcess();
 }
 
+void ZBufferEngine::process(const TriangleSoupPtr& soup)
+{
+    PGL_PROFILE_ZONE("ZBufferEngine::process");
+    PGL_PROFILE_COUNT("zbuffer.triangles", soup->size());
+    beginProcess();
+    TriangleShaderPtr shader;
+    ColorBasedShader * colorshader = NULL;
+    if (getRenderingStyle() & eColorBased) {
+        colorshader = new ColorBasedShader(this);
+        shader = TriangleShaderPtr(colorshader);
+    }
+    // the soup is already in world space
+    __camera->pushModelTransformation();
+    __camera->transformModelIdentity();
+    for (size_t i = 0; i < soup->size(); ++i) {
+        if (colorshader) {
+            const Color4& color = soup->getColorAt(i);
+            colorshader->setColors(color, color, color);
+        }
+        renderShadedTriangle(soup->getVertexAt(i,0), soup->getVertexAt(i,1), soup->getVertexAt(i,2), true, soup->getIdAt(i), shader, __camera);
+    }
+    __camera->popModelTransformation();
+    endProcess();
+}
+
+void ZBufferEngine::process(const CompiledScenePtr& compiled)
+{
+    compiled->update();
+    process(TriangleSoupPtr(compiled));
+}
+
+std::vector<ZBufferEngine::IdHistogram> ZBufferEngine::multiViewIdHistograms(const TriangleSoupPtr& soup, 
+                                                                            const std::vector<ProjectionCameraPtr>& cameras,
+                                                                            uint16_t imageWidth, uint16_t imageHeight,
+                                                                            bool solidangle,
+                                                                            eFaceCulling culling)
+{
+    std::vector<IdHistogram> result(cameras.size());
+    // One single threaded engine per view. The views are rendered in parallel.
+    parallel_for(0, cameras.size(), [&](size_t i) {
+        ZBufferEngine view(imageWidth, imageHeight, eIdBased, Color3::BLACK, Shape::NOID, false, culling);
+        view.setCamera(cameras[i]->copy());
+        // the soup is already in world space
+        view.camera()->transformModelIdentity();
+        view.process(soup);
+        result[i] = view.idhistogram(solidangle);
+    }, 1);
+    return result;
+}
+
+std::vector<ZBufferEngine::IdHistogram> ZBufferEngine::multiViewIdHistograms(ScenePtr scene, 
+                                                                            const std::vector<ProjectionCameraPtr>& cameras,
+                                                                            uint16_t imageWidth, uint16_t imageHeight,
+                                                                            bool solidangle,
+                                                                            eFaceCulling culling)
+{
+    return multiViewIdHistograms(TriangleSoupPtr(new TriangleSoup(scene)), cameras, imageWidth, imageHeight, solidangle, culling);
+}
+
 void ZBufferEngine::processScene(Scene::const_iterator scene_begin, Scene::const_iterator scene_end, ProjectionCameraPtr camera, uint32_t threadid)
 {
+    PGL_PROFILE_ZONE("ZBufferEngine::processScene");
     Discretizer d;
     Tesselator t;
+    d.setSharedCache(__discretizationCache);
+    t.setSharedCache(__discretizationCache);
     ProjectionRenderer r(*this, camera, t, d, threadid);
-    for (Scene::const_iterator it = scene_begin; it != scene_end; ++it)
+    // shapes are tested against the depth buffer only if it is written as they are processed.
+    bool shapeculling = __occlusionCulling && !__multithreaded && !__tiledRendering && _useHiZ(camera, false);
+    BBoxComputer bbc(d);
+    for (Scene::const_iterator it = scene_begin; it != scene_end; ++it) {
+        if (shapeculling && (*it)->apply(bbc) && _isOccluded(bbc.getBoundingBox(), camera)) {
+            ++__nbCulledShapes;
+            continue;
+        }
         (*it)->apply(r);
+    }
+}
+
+void ZBufferEngine::resetCullingStatistics()
+{
+    __nbCulledTriangles = 0;
+    __nbRasterizedTriangles = 0;
+    __nbCulledShapes = 0;
+}
+
+void ZBufferEngine::_initTriangleBins()
+{
+    // one bin per possible producer thread. Bin 0 is used by the calling thread.
+    size_t nbbins = TaskScheduler::get().nbThreads()+1;
+    if (__triangleBins.size() < nbbins) __triangleBins.resize(nbbins);
+}
+
+void ZBufferEngine::setTiledRendering(bool value)
+{
+    __tiledRendering = value;
+    // triangles can be binned directly, without a new beginProcess.
+    if (value) _initTriangleBins();
+}
+
+void ZBufferEngine::setOcclusionCulling(bool value)
+{
+    __occlusionCulling = value;
+    // triangles can be rendered directly, without a new beginProcess.
+    if (value) _hizInit();
+    else { __hizMax.clear(); __hizDirty.clear(); }
+}
+
+bool ZBufferEngine::_useHiZ(const ProjectionCameraPtr& camera, bool lockfree) const
+{
+    if (!__occlusionCulling || camera->methodType() != ProjectionCamera::eProjection) return false;
+    if (__hizMax.empty()) return false;
+    // in tiled rendering, the tiles of the hierarchical depth buffer should not be shared by two screen tiles.
+    if (lockfree) return (__tileSize % PGL_HIZ_TILE_SIZE) == 0;
+    return !__multithreaded;
+}
+
+void ZBufferEngine::_hizInit()
+{
+    size_t nbtiles = ((__imageWidth + PGL_HIZ_TILE_SIZE - 1) / PGL_HIZ_TILE_SIZE) * ((__imageHeight + PGL_HIZ_TILE_SIZE - 1) / PGL_HIZ_TILE_SIZE);
+    // the depth buffer may have been modified since the last process.
+    __hizMax.assign(nbtiles, REAL_MAX);
+    __hizDirty.assign(nbtiles, 1);
+}
+
+real_t ZBufferEngine::_hizTileMax(uint32_t tx, uint32_t ty)
+{
+    // Depths only decrease during rendering so an outdated max is still an upper bound.
+    size_t tileid = ty * ((__imageWidth + PGL_HIZ_TILE_SIZE - 1) / PGL_HIZ_TILE_SIZE) + tx;
+    if (__hizDirty[tileid]) {
+        real_t zmax = -REAL_MAX;
+        uint32_t xend = pglMin<uint32_t>(__imageWidth, (tx + 1) * PGL_HIZ_TILE_SIZE);
+        uint32_t yend = pglMin<uint32_t>(__imageHeight, (ty + 1) * PGL_HIZ_TILE_SIZE);
+        for (uint32_t x = tx * PGL_HIZ_TILE_SIZE; x < xend; ++x)
+            for (uint32_t y = ty * PGL_HIZ_TILE_SIZE; y < yend; ++y)
+                zmax = pglMax(zmax, __depthBuffer->getAt(x, y));
+        __hizMax[tileid] = zmax;
+        __hizDirty[tileid] = 0;
+    }
+    return __hizMax[tileid];
+}
+
+void ZBufferEngine::_hizTouch(const Index4& clip)
+{
+    uint32_t nbtilesx = (__imageWidth + PGL_HIZ_TILE_SIZE - 1) / PGL_HIZ_TILE_SIZE;
+    for (uint32_t ty = clip[2] / PGL_HIZ_TILE_SIZE; ty <= clip[3] / PGL_HIZ_TILE_SIZE; ++ty)
+        for (uint32_t tx = clip[0] / PGL_HIZ_TILE_SIZE; tx <= clip[1] / PGL_HIZ_TILE_SIZE; ++tx)
+            __hizDirty[ty * nbtilesx + tx] = 1;
+}
+
+bool ZBufferEngine::_isOccluded(const Index4& clip, real_t zmin)
+{
+    if (clip[0] > clip[1] || clip[2] > clip[3]) return false;
+    for (uint32_t ty = clip[2] / PGL_HIZ_TILE_SIZE; ty <= clip[3] / PGL_HIZ_TILE_SIZE; ++ty)
+        for (uint32_t tx = clip[0] / PGL_HIZ_TILE_SIZE; tx <= clip[1] / PGL_HIZ_TILE_SIZE; ++tx)
+            if (_hizTileMax(tx, ty) > zmin) return false;
+    return true;
+}
+
+bool ZBufferEngine::_isOccluded(const BoundingBoxPtr& bbox, const ProjectionCameraPtr& camera)
+{
+    if (is_null_ptr(bbox)) return false;
+    const Vector3& ll = bbox->getLowerLeftCorner();
+    const Vector3& ur = bbox->getUpperRightCorner();
+    real_t xmin = REAL_MAX, ymin = REAL_MAX, zmin = REAL_MAX;
+    real_t xmax = -REAL_MAX, ymax = -REAL_MAX;
+    for (int i = 0; i < 8; ++i) {
+        Vector3 corner((i & 1) ? ur.x() : ll.x(), (i & 2) ? ur.y() : ll.y(), (i & 4) ? ur.z() : ll.z());
+        Vector3 raster = camera->cameraToRaster(camera->worldToCamera(corner), __imageWidth, __imageHeight);
+        // the projection of the box is the hull of the projection of its corners only if they are in front of the camera.
+        if (!(raster.z() > 0)) return false;
+        xmin = pglMin(xmin, raster.x()); xmax = pglMax(xmax, raster.x());
+        ymin = pglMin(ymin, raster.y()); ymax = pglMax(ymax, raster.y());
+        zmin = pglMin(zmin, raster.z());
+    }
+    // margin for the rounding of the raster coordinates of the vertices
+    int32_t x0 = pglMax<int32_t>(0, (int32_t)std::floor(xmin) - 1);
+    int32_t x1 = pglMin<int32_t>(int32_t(__imageWidth) - 1, (int32_t)std::ceil(xmax) + 1);
+    int32_t y0 = pglMax<int32_t>(0, (int32_t)std::floor(ymin) - 1);
+    int32_t y1 = pglMin<int32_t>(int32_t(__imageHeight) - 1, (int32_t)std::ceil(ymax) + 1);
+    if (x0 > x1 || y0 > y1) return false;
+    return _isOccluded(Index4(x0, x1, y0, y1), zmin / (1 + 1e-4));
+}
+
+ScenePtr ZBufferEngine::_sortFrontToBack(const ScenePtr& scene) const
+{
+    Discretizer d;
+    d.setSharedCache(__discretizationCache);
+    BBoxComputer bbc(d);
+    const Vector3& eye = __camera->position();
+    std::vector<std::pair<real_t, uint32_t> > order;
+    order.reserve(scene->size());
+    uint32_t i = 0;
+    for (Scene::const_iterator it = scene->begin(); it != scene->end(); ++it, ++i){
+        real_t distance = REAL_MAX;
+        if ((*it)->apply(bbc) && is_valid_ptr(bbc.getBoundingBox())) {
+            // distance from the eye to the box
+            const Vector3& ll = bbc.getBoundingBox()->getLowerLeftCorner();
+            const Vector3& ur = bbc.getBoundingBox()->getUpperRightCorner();
+            Vector3 delta(pglMax<real_t>(0, pglMax(ll.x() - eye.x(), eye.x() - ur.x())),
+                          pglMax<real_t>(0, pglMax(ll.y() - eye.y(), eye.y() - ur.y())),
+                          pglMax<real_t>(0, pglMax(ll.z() - eye.z(), eye.z() - ur.z())));
+            distance = normSquared(delta);
+        }
+        order.push_back(std::pair<real_t, uint32_t>(distance, i));
+    }
+    std::stable_sort(order.begin(), order.end());
+    ScenePtr result(new Scene(scene->size()));
+    for (i = 0; i < order.size(); ++i)
+        result->setAt(i, scene->getAt(order[i].second));
+    return result;
 }
 
 
@@ -875,60 +1277,6 @@ void ZBufferEngine::_bufferPeriodizationStep(int32_t xDiff, int32_t yDiff, real_
 }
 
 
-boost::asio::thread_pool * 
-ThreadManager::getPool()
-{
-    if(__pool == NULL) __pool = new boost::asio::thread_pool(__nb_threads);
-    return __pool;
-}
-
-ThreadManager::ThreadManager(): 
-    __pool(NULL),
-    __condition_lock(__condition_mutex),
-    __nb_threads(boost::thread::hardware_concurrency()+1),
-    __nb_tasks(0)
-{}
-
-ThreadManager::~ThreadManager()
-{
-    if(__pool != NULL) delete __pool;
-}
-
-void ThreadManager::new_task(std::function<void()> task){
-    ++__nb_tasks;
-    boost::asio::post(*getPool(), boost::bind(&ThreadManager::process_task, this, task));    
-    //boost::asio::post(*__pool, task);    
-}
-
-void ThreadManager::process_task(std::function<void()> task)
-{
-    task();
-    __threadend_mutex.lock();
-    --__nb_tasks;
-    __condition.notify_one();
-    __threadend_mutex.unlock();
-}
-
-void ThreadManager::join()
-{
-    while(!hasCompletedTasks()){
-        __condition.wait_for(__condition_lock, std::chrono::milliseconds(10), std::bind(&ThreadManager::hasCompletedTasks, this));
-    }
-    // __condition.wait(__condition_lock, std::bind(&ThreadManager::hasCompletedTasks, this));
-}
-
-
-bool ThreadManager::hasCompletedTasks() const { 
-    // printf("rendering nb task : %u\n", uint32_t(__nb_tasks));
-    return __nb_tasks == 0; 
-}
-
-// Singleton access
-ThreadManager& ThreadManager::get() { return ThreadManager::THREADMANAGER; }
-
-ThreadManager ThreadManager::THREADMANAGER;
-
-
 ImageMutexPtr ZBufferEngine::IMAGEMUTEX;
 
 
@@ -1126,35 +1474,9 @@ RealArray2Ptr PGL(formFactors)(const Point3ArrayPtr& points,
                                uint16_t discretization,
                                bool solidangle)
 {
-    RealArray2Ptr result(new RealArray2(triangles->size(),triangles->size(),0));
-    uint32_t id = 0;
-    Color4 color = Color4::BLACK;
-    for(Index3Array::const_iterator it = triangles->begin(); it != triangles->end(); ++it, ++id){
-        const Vector3& v0 = points->getAt((*it)[0]); 
-        const Vector3& v1 = points->getAt((*it)[1]); 
-        const Vector3& v2 = points->getAt((*it)[2]); 
-        Vector3 center = (v0+v1+v2)/3;
-        Vector3 normal = (is_valid_ptr(normals) ? normals->getAt(id) : cross(v1-v0,v2-v0));
-        if(normal.normalize() > GEOM_EPSILON){
-            Vector3 up = v0-center;
-            ZBufferEngine ze(discretization,discretization,ZBufferEngine::eIdBased, Color3::BLACK, Shape::NOID, true);
-            ze.setHemisphericCamera();
-            ze.lookAt(center, center+normal, up);
-            uint32_t id2 = 0;
-            ze.beginProcess();
-            for(Index3Array::const_iterator it2 = triangles->begin(); it2 != triangles->end(); ++it2, ++id2){
-                if (it2 != it){
-                    ze.renderTriangle(points->getAt((*it2)[0]), points->getAt((*it2)[1]), points->getAt((*it2)[2]), 
-                                      color, color, color, ccw, id2);
-                }
-            }
-            ze.endProcess();
-            pgl_hash_map<uint32_t,uint32_t> histo = ze.idhistogram(solidangle);
-            for (pgl_hash_map<uint32_t,uint32_t>::const_iterator histoit = histo.begin(); histoit != histo.end(); ++histoit){
-                result->setAt(id, histoit->first, histoit->second);
-            }
-        }
-    }
-    return result;
+    FormFactorEngine engine(points, triangles, normals, ccw);
+    engine.setDiscretization(discretization);
+    engine.setSolidAngle(solidangle);
+    return engine.compute()->toDense();
 }
 
@@ -54,6 +54,7 @@
 #include <plantgl/tool/util_array2.h>
 #include <plantgl/tool/util_cache.h>
 #include <plantgl/tool/rcobject.h>
+#include <plantgl/tool/util_taskscheduler.h>
 #include <plantgl/scenegraph/container/indexarray.h>
 #include "../algo_config.h"
 #include "shading.h"
@@ -61,57 +62,25 @@
 #include "projectionengine.h"
 #include "framebuffermanager.h"
 #include "imagemutex.h"
-#include <condition_variable>
-// #include <boost/fiber/mutex.hpp>
+#include "trianglesoup.h"
+#include "compiledscene.h"
+#include "zbufferkernel.h"
+#include <plantgl/scenegraph/geometry/boundingbox.h>
 #include <atomic>
 #include <functional>
 #include <tuple>
 #include <queue>
+#include <vector>
 
 /* ----------------------------------------------------------------------- */
 
+/// Size in pixels of the tiles of the hierarchical depth buffer used for occlusion culling.
+#define PGL_HIZ_TILE_SIZE 8
 
-namespace boost { namespace asio { class thread_pool; };};
-
-PGL_BEGIN_NAMESPACE
-
-class ThreadManager;
-
-class ThreadManager {
-public:
-    ~ThreadManager();
-
-    void new_task(std::function<void()> task);
-    void join();
-    size_t nb_threads() { return __nb_threads; }
-
-    // Singleton access
-    static ThreadManager& get();
-protected:
-
-
-    ThreadManager();
-    boost::asio::thread_pool * getPool();
-
-    bool hasActiveTasks() const { return __nb_tasks > 0; }
-    bool hasCompletedTasks() const ;
-
-    void process_task(std::function<void()> task);
-
-    boost::asio::thread_pool * __pool;
-    size_t __nb_threads;
-
-    std::atomic<uint32_t> __nb_tasks;
-    std::condition_variable  __condition;
-    std::mutex   __condition_mutex;
-    std::unique_lock< std::mutex > __condition_lock ;
-    std::mutex   __threadend_mutex;
-
-    static ThreadManager THREADMANAGER;
-};
-
+/* ----------------------------------------------------------------------- */
 
 
+PGL_BEGIN_NAMESPACE
 
 /* ----------------------------------------------------------------------- */
 
@@ -148,6 +117,8 @@ public :
         eIdAndColorAndOrientationBased = 7,
     } ;
 
+    typedef pgl_hash_map<uint32_t,uint32_t> IdHistogram;
+
     enum eFaceIntersection {
         eBackFaceIntersection   = -1,
         eNoIntersection         = 0,
@@ -219,7 +190,7 @@ public :
 
   ImagePtr getTexture(const ImageTexturePtr imgdef);
 
-  void renderShadedTriangle(const TOOLS(Vector3)& v0, const TOOLS(Vector3)& v1, const TOOLS(Vector3)& v2, bool ccw = true, const uint32_t id = 0, const TriangleShaderPtr& shader = TriangleShaderPtr(), const ProjectionCameraPtr& camera = ProjectionCameraPtr());
+  void renderShadedTriangle(const TOOLS(Vector3)& v0, const TOOLS(Vector3)& v1, const TOOLS(Vector3)& v2, bool ccw = true, const uint32_t id = 0, const TriangleShaderPtr& shader = TriangleShaderPtr(), const ProjectionCameraPtr& camera = ProjectionCameraPtr(), uint32_t threadid = 0);
   void renderShadedTriangleMT(const TOOLS(Vector3)& v0, const TOOLS(Vector3)& v1, const TOOLS(Vector3)& v2, bool ccw = true, const uint32_t id = 0, const TriangleShaderPtr& shader = TriangleShaderPtr(), const ProjectionCameraPtr& camera = ProjectionCameraPtr());
 
   TriangleShaderPtr getShader() const { return __triangleshader; }
@@ -238,11 +209,68 @@ public :
   bool isMultiThreaded() const { return __multithreaded; }
   void setMultiThreaded(bool value) { __multithreaded = value; }
 
+  /** Tiled (sort-middle) rendering. Triangles are first binned into screen tiles of 
+      tileSize x tileSize pixels and rasterized at endProcess, each tile being owned 
+      by a single worker. No pixel locking is needed and the result is identical to 
+      the single-threaded rendering. Points and segments are still rendered directly. */
+  bool isTiledRendering() const { return __tiledRendering; }
+  void setTiledRendering(bool value);
+
+  uint16_t getTileSize() const { return __tileSize; }
+  void setTileSize(uint16_t tileSize);
+
+  /** Use the vectorized rasterization kernel (see getZBufferKernel) when possible : projection 
+      cameras, with pixels owned by the rendering thread (single threaded or tiled rendering). 
+      Result is identical to the scalar rasterization. Enabled by default. */
+  bool isSIMDRendering() const { return __simdRendering; }
+  void setSIMDRendering(bool value) { __simdRendering = value; }
+
+  /** Occlusion culling with a coarse depth buffer storing the max depth of each tile of 
+      PGL_HIZ_TILE_SIZE x PGL_HIZ_TILE_SIZE pixels. Triangles, and shapes through their 
+      bounding box, lying behind the max depth of all the tiles they cover are not rasterized. 
+      The test is conservative and the result is identical. Used with projection cameras when 
+      pixels are owned by the rendering thread (single threaded or tiled rendering). */
+  bool isOcclusionCulling() const { return __occlusionCulling; }
+  void setOcclusionCulling(bool value);
+
+  /** Render the shapes of a scene sorted by distance to the camera to make occlusion culling 
+      more efficient. Among fragments closer than GEOM_EPSILON, the first one rendered is kept 
+      so the result may differ in such cases. */
+  bool isFrontToBackOrdering() const { return __frontToBackOrdering; }
+  void setFrontToBackOrdering(bool value) { __frontToBackOrdering = value; }
+
+  /// Statistics of occlusion culling since the last reset.
+  uint64_t getNbCulledTriangles() const { return __nbCulledTriangles; }
+  uint64_t getNbRasterizedTriangles() const { return __nbRasterizedTriangles; }
+  uint64_t getNbCulledShapes() const { return __nbCulledShapes; }
+  void resetCullingStatistics();
+
   void setFaceCulling(eFaceCulling culling) { __culling = culling; }
   const eFaceCulling getFaceCulling() const { return __culling; }
 
   virtual void process(ScenePtr scene);
 
+  /// Render the world-space triangles of soup with the current camera, using their flat colour.
+  void process(const TriangleSoupPtr& soup);
+
+  /// Update compiled with the modifications of its scene and render it.
+  void process(const CompiledScenePtr& compiled);
+
+  /** Render soup from each camera in parallel, each view having its own depth and id buffers 
+      of imageWidth x imageHeight pixels, and return the idhistogram of each view. 
+      The scene is tessellated only once for all the views. */
+  static std::vector<IdHistogram> multiViewIdHistograms(const TriangleSoupPtr& soup, 
+                                                        const std::vector<ProjectionCameraPtr>& cameras,
+                                                        uint16_t imageWidth, uint16_t imageHeight,
+                                                        bool solidangle = true,
+                                                        eFaceCulling culling = eNoCulling);
+
+  static std::vector<IdHistogram> multiViewIdHistograms(ScenePtr scene, 
+                                                        const std::vector<ProjectionCameraPtr>& cameras,
+                                                        uint16_t imageWidth, uint16_t imageHeight,
+                                                        bool solidangle = true,
+                                                        eFaceCulling culling = eNoCulling);
+
   std::tuple<PGL(Point3ArrayPtr),PGL(Color3ArrayPtr),PGL(Uint32Array1Ptr)> grabZBufferPoints(real_t jitter = 0, real_t raywidth = 0) const;
   ScenePtr grabSortedZBufferPoints(real_t jitter = 0, real_t raywidth = 0) const;
   
@@ -264,8 +292,37 @@ protected :
 
   typedef std::queue<Fragment> FragmentQueue;
 
+  struct BinnedTriangle {
+        Index4 rect;
+        Vector3 v0Raster, v1Raster, v2Raster;
+        Vector3 v0Cam, v1Cam, v2Cam;
+        uint32_t id;
+        TriangleShaderPtr shader;
+        ProjectionCameraPtr camera;
+  };
+
+  // Triangles binned by one producer thread and, for each tile, the indices of the triangles that overlap it.
+  struct TriangleBin {
+        std::vector<BinnedTriangle> triangles;
+        std::vector<std::vector<uint32_t> > tiles;
+  };
+
   bool _tryRenderRaster(uint32_t x, uint32_t y, real_t z, const Color4& rasterColor, const uint32_t id = Shape::NOID, const bool orientation = true);
   void _tryRenderRaster(const struct Fragment& fragment, FragmentQueue& failqueue);
+  void _writeRaster(uint32_t x, uint32_t y, real_t z, const Color4& rasterColor, const uint32_t id, const bool orientation);
+  void _renderFragment(const struct Fragment& fragment, FragmentQueue& failqueue, bool lockfree);
+
+  void _binTriangle(const Index4& rect,
+                    const Vector3& v0Raster, const Vector3& v1Raster, const Vector3& v2Raster, 
+                    const Vector3& v0Cam, const Vector3& v1Cam, const Vector3& v2Cam, 
+                    const uint32_t id, 
+                    const TriangleShaderPtr& shader, const ProjectionCameraPtr& camera, uint32_t threadid);
+  void _rasterizeTile(uint32_t tileid);
+  void _flushTiles();
+  void _clearTiles();
+  void _initTriangleBins();
+  inline uint32_t _nbTilesX() const { return (__imageWidth + __tileSize - 1) / __tileSize; }
+  inline uint32_t _nbTilesY() const { return (__imageHeight + __tileSize - 1) / __tileSize; }
 
   void _renderSegment(uchar dim, const TOOLS(Vector3)& v0Raster, const TOOLS(Vector3)& v1Raster, const Color4& c0, const Color4& c1, const uint32_t width, const uint32_t id);
   void _bufferPeriodizationStep(int32_t xDiff, int32_t yDiff, real_t zDiff, bool useDefaultColor = true, const Color3& defaultcolor = Color3(0,0,0));
@@ -275,11 +332,30 @@ protected :
                  TOOLS(Vector3) v0Cam, TOOLS(Vector3) v1Cam, TOOLS(Vector3) v2Cam, 
                  const uint32_t id, 
                  const TriangleShaderPtr& shader, const ProjectionCameraPtr& camera);
+  void _rasterize(const Index4& rect, const Index4& clip,
+                  TOOLS(Vector3) v0Raster, TOOLS(Vector3) v1Raster, TOOLS(Vector3) v2Raster, 
+                  const TOOLS(Vector3)& v0Cam, const TOOLS(Vector3)& v1Cam, const TOOLS(Vector3)& v2Cam, 
+                  const uint32_t id, 
+                  const TriangleShaderPtr& shader, const ProjectionCameraPtr& camera, bool lockfree);
+  void _rasterizeBlocks(ZBufferKernel kernel, const Index4& clip,
+                        const TOOLS(Vector3)& v0Raster, const TOOLS(Vector3)& v1Raster, const TOOLS(Vector3)& v2Raster, 
+                        real_t z0, real_t z1, real_t z2, real_t area,
+                        const uint32_t id, 
+                        const TriangleShaderPtr& shader, const ProjectionCameraPtr& camera);
   void rasterizeMT(const Index4& rect,
                    const std::tuple<Vector3,Vector3,Vector3>& vRasters, const std::tuple<Vector3,Vector3,Vector3>& vCams,
                    const uint32_t id, 
                    const TriangleShaderPtr& shader, const ProjectionCameraPtr& camera);
 
+  // Hierarchical depth buffer
+  bool _useHiZ(const ProjectionCameraPtr& camera, bool lockfree) const;
+  void _hizInit();
+  real_t _hizTileMax(uint32_t tx, uint32_t ty);
+  void _hizTouch(const Index4& clip);
+  bool _isOccluded(const Index4& clip, real_t zmin);
+  bool _isOccluded(const BoundingBoxPtr& bbox, const ProjectionCameraPtr& camera);
+  ScenePtr _sortFrontToBack(const ScenePtr& scene) const;
+
   void processScene(Scene::const_iterator scene_begin, Scene::const_iterator scene_end, ProjectionCameraPtr camera, uint32_t threadid = 0);
   void processSceneMT(Scene::const_iterator scene_begin, Scene::const_iterator scene_end, ProjectionCameraPtr camera, uint32_t threadid = 0);
 
@@ -306,6 +382,22 @@ protected :
 
   bool __multithreaded;
   ImageMutexPtr __imageMutex;
+  TaskGroup __tasks;
+
+  bool __tiledRendering;
+  uint16_t __tileSize;
+  std::vector<TriangleBin> __triangleBins;
+
+  bool __simdRendering;
+
+  bool __occlusionCulling;
+  bool __frontToBackOrdering;
+  // max depth and validity of each tile of the hierarchical depth buffer
+  std::vector<real_t> __hizMax;
+  std::vector<uchar_t> __hizDirty;
+  std::atomic<uint64_t> __nbCulledTriangles;
+  std::atomic<uint64_t> __nbRasterizedTriangles;
+  std::atomic<uint64_t> __nbCulledShapes;
 
 
   static ImageMutexPtr getImageMutex(uint16_t imageWidth, uint16_t imageHeight);
@@ -319,6 +411,7 @@ private:
 };
 
 
+/// Dense form factors between triangles. See FormFactorEngine for the sparse and culled version.
 RealArray2Ptr ALGO_API formFactors(const Point3ArrayPtr& points, 
                                    const Index3ArrayPtr& triangles, 
                                    const Point3ArrayPtr& normals = Point3ArrayPtr(),
@@ -0,0 +1,257 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/* ----------------------------------------------------------------------- */
+
+#include "zbufferkernel.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(PGL_USE_DOUBLE) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define PGL_ZBUFFER_SIMD
+#include <immintrin.h>
+#endif
+
+/* ----------------------------------------------------------------------- */
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#ifdef PGL_ZBUFFER_SIMD
+
+/* 
+   Kernels are compiled for their instruction set with a target attribute, the rest of 
+   the library keeping the default architecture. FMA is deliberately not enabled so that 
+   products and sums are rounded as in the scalar code.
+*/
+
+#define PGL_TARGET(arch) __attribute__((target(arch)))
+
+/* ----------------------------------------------------------------------- */
+
+PGL_TARGET("avx2")
+static void zbufferKernelAVX2(const ZBufferKernelTriangle& t, int32_t x, int32_t y, 
+                              real_t * depth, uint32_t * ids, uint32_t id, ZBufferKernelBlock * block)
+{
+    const __m256d eps = _mm256_set1_pd(GEOM_EPSILON);
+    const __m256d meps = _mm256_set1_pd(-GEOM_EPSILON);
+
+    const __m256d px = _mm256_set1_pd(x + 0.5);
+    const __m256d x0 = _mm256_set1_pd(t.x0), y0 = _mm256_set1_pd(t.y0);
+    const __m256d x1 = _mm256_set1_pd(t.x1), y1 = _mm256_set1_pd(t.y1);
+    const __m256d x2 = _mm256_set1_pd(t.x2), y2 = _mm256_set1_pd(t.y2);
+
+    // edge functions : w = (px - ax) * (by - ay) - (py - ay) * (bx - ax)
+    const __m256d dx0 = _mm256_sub_pd(px, x1), ey0 = _mm256_sub_pd(y2, y1), ex0 = _mm256_sub_pd(x2, x1);
+    const __m256d dx1 = _mm256_sub_pd(px, x2), ey1 = _mm256_sub_pd(y0, y2), ex1 = _mm256_sub_pd(x0, x2);
+    const __m256d dx2 = _mm256_sub_pd(px, x0), ey2 = _mm256_sub_pd(y1, y0), ex2 = _mm256_sub_pd(x1, x0);
+
+    const __m256d area = _mm256_set1_pd(t.area);
+    const __m256d iz0 = _mm256_set1_pd(t.iz0), iz1 = _mm256_set1_pd(t.iz1), iz2 = _mm256_set1_pd(t.iz2);
+    const __m256d one = _mm256_set1_pd(1.);
+    const __m256d znear = _mm256_set1_pd(t.near), zfar = _mm256_set1_pd(t.far);
+    const __m256d keepfront = _mm256_castsi256_pd(_mm256_set1_epi64x(t.front ? -1 : 0));
+    const __m256d keepback = _mm256_castsi256_pd(_mm256_set1_epi64x(t.back ? -1 : 0));
+    const __m256i packlow = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m128i idvalue = _mm_set1_epi32(int32_t(id));
+
+    if (block) { block->visible = 0; block->frontfacing = 0; }
+
+    for (int32_t i = 0; i < ZBUFFER_KERNEL_BLOCK; i += 4) {
+        __m256d py = _mm256_add_pd(_mm256_cvtepi32_pd(_mm_add_epi32(_mm_set1_epi32(y + i), _mm_setr_epi32(0, 1, 2, 3))), _mm256_set1_pd(0.5));
+
+        __m256d w0 = _mm256_sub_pd(_mm256_mul_pd(dx0, ey0), _mm256_mul_pd(_mm256_sub_pd(py, y1), ex0));
+        __m256d w1 = _mm256_sub_pd(_mm256_mul_pd(dx1, ey1), _mm256_mul_pd(_mm256_sub_pd(py, y2), ex1));
+        __m256d w2 = _mm256_sub_pd(_mm256_mul_pd(dx2, ey2), _mm256_mul_pd(_mm256_sub_pd(py, y0), ex2));
+
+        // intersection sign test and culling
+        __m256d front = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(w0, meps, _CMP_GT_OQ), _mm256_cmp_pd(w1, meps, _CMP_GT_OQ)), _mm256_cmp_pd(w2, meps, _CMP_GT_OQ));
+        __m256d back = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(w0, eps, _CMP_LT_OQ), _mm256_cmp_pd(w1, eps, _CMP_LT_OQ)), _mm256_cmp_pd(w2, eps, _CMP_LT_OQ));
+        back = _mm256_andnot_pd(front, back);
+        __m256d mask = _mm256_or_pd(_mm256_and_pd(front, keepfront), _mm256_and_pd(back, keepback));
+        if (_mm256_movemask_pd(mask) == 0) continue;
+
+        w0 = _mm256_div_pd(w0, area);
+        w1 = _mm256_div_pd(w1, area);
+        w2 = _mm256_div_pd(w2, area);
+
+        __m256d oneOverZ = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(iz0, w0), _mm256_mul_pd(iz1, w1)), _mm256_mul_pd(iz2, w2));
+        __m256d z = _mm256_div_pd(one, oneOverZ);
+
+        // depth range of the camera
+        mask = _mm256_and_pd(mask, _mm256_cmp_pd(_mm256_sub_pd(z, znear), meps, _CMP_GE_OQ));
+        mask = _mm256_and_pd(mask, _mm256_cmp_pd(_mm256_sub_pd(z, zfar), eps, _CMP_LE_OQ));
+
+        // depth test
+        __m256d cz = _mm256_loadu_pd(depth + i);
+        mask = _mm256_and_pd(mask, _mm256_cmp_pd(z, cz, _CMP_LT_OQ));
+        mask = _mm256_and_pd(mask, _mm256_cmp_pd(_mm256_sub_pd(cz, z), eps, _CMP_GT_OQ));
+
+        int visible = _mm256_movemask_pd(mask);
+        if (visible == 0) continue;
+
+        if (block) {
+            block->visible |= uint32_t(visible) << i;
+            block->frontfacing |= uint32_t(_mm256_movemask_pd(_mm256_and_pd(mask, front))) << i;
+            _mm256_storeu_pd(block->z + i, z);
+            _mm256_storeu_pd(block->w0 + i, w0);
+            _mm256_storeu_pd(block->w1 + i, w1);
+            _mm256_storeu_pd(block->w2 + i, w2);
+        }
+        else {
+            _mm256_storeu_pd(depth + i, _mm256_blendv_pd(cz, z, mask));
+            if (ids) {
+                __m128i idmask = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_castpd_si256(mask), packlow));
+                _mm_maskstore_epi32((int *)(ids + i), idmask, idvalue);
+            }
+        }
+    }
+}
+
+/* ----------------------------------------------------------------------- */
+
+PGL_TARGET("sse2")
+static void zbufferKernelSSE2(const ZBufferKernelTriangle& t, int32_t x, int32_t y, 
+                              real_t * depth, uint32_t * ids, uint32_t id, ZBufferKernelBlock * block)
+{
+    const __m128d eps = _mm_set1_pd(GEOM_EPSILON);
+    const __m128d meps = _mm_set1_pd(-GEOM_EPSILON);
+
+    const __m128d px = _mm_set1_pd(x + 0.5);
+    const __m128d x0 = _mm_set1_pd(t.x0), y0 = _mm_set1_pd(t.y0);
+    const __m128d x1 = _mm_set1_pd(t.x1), y1 = _mm_set1_pd(t.y1);
+    const __m128d x2 = _mm_set1_pd(t.x2), y2 = _mm_set1_pd(t.y2);
+
+    const __m128d dx0 = _mm_sub_pd(px, x1), ey0 = _mm_sub_pd(y2, y1), ex0 = _mm_sub_pd(x2, x1);
+    const __m128d dx1 = _mm_sub_pd(px, x2), ey1 = _mm_sub_pd(y0, y2), ex1 = _mm_sub_pd(x0, x2);
+    const __m128d dx2 = _mm_sub_pd(px, x0), ey2 = _mm_sub_pd(y1, y0), ex2 = _mm_sub_pd(x1, x0);
+
+    const __m128d area = _mm_set1_pd(t.area);
+    const __m128d iz0 = _mm_set1_pd(t.iz0), iz1 = _mm_set1_pd(t.iz1), iz2 = _mm_set1_pd(t.iz2);
+    const __m128d one = _mm_set1_pd(1.);
+    const __m128d znear = _mm_set1_pd(t.near), zfar = _mm_set1_pd(t.far);
+    const __m128d keepfront = _mm_castsi128_pd(_mm_set1_epi32(t.front ? -1 : 0));
+    const __m128d keepback = _mm_castsi128_pd(_mm_set1_epi32(t.back ? -1 : 0));
+
+    if (block) { block->visible = 0; block->frontfacing = 0; }
+
+    for (int32_t i = 0; i < ZBUFFER_KERNEL_BLOCK; i += 2) {
+        __m128d py = _mm_add_pd(_mm_cvtepi32_pd(_mm_setr_epi32(y + i, y + i + 1, 0, 0)), _mm_set1_pd(0.5));
+
+        __m128d w0 = _mm_sub_pd(_mm_mul_pd(dx0, ey0), _mm_mul_pd(_mm_sub_pd(py, y1), ex0));
+        __m128d w1 = _mm_sub_pd(_mm_mul_pd(dx1, ey1), _mm_mul_pd(_mm_sub_pd(py, y2), ex1));
+        __m128d w2 = _mm_sub_pd(_mm_mul_pd(dx2, ey2), _mm_mul_pd(_mm_sub_pd(py, y0), ex2));
+
+        __m128d front = _mm_and_pd(_mm_and_pd(_mm_cmpgt_pd(w0, meps), _mm_cmpgt_pd(w1, meps)), _mm_cmpgt_pd(w2, meps));
+        __m128d back = _mm_and_pd(_mm_and_pd(_mm_cmplt_pd(w0, eps), _mm_cmplt_pd(w1, eps)), _mm_cmplt_pd(w2, eps));
+        back = _mm_andnot_pd(front, back);
+        __m128d mask = _mm_or_pd(_mm_and_pd(front, keepfront), _mm_and_pd(back, keepback));
+        if (_mm_movemask_pd(mask) == 0) continue;
+
+        w0 = _mm_div_pd(w0, area);
+        w1 = _mm_div_pd(w1, area);
+        w2 = _mm_div_pd(w2, area);
+
+        __m128d oneOverZ = _mm_add_pd(_mm_add_pd(_mm_mul_pd(iz0, w0), _mm_mul_pd(iz1, w1)), _mm_mul_pd(iz2, w2));
+        __m128d z = _mm_div_pd(one, oneOverZ);
+
+        mask = _mm_and_pd(mask, _mm_cmpge_pd(_mm_sub_pd(z, znear), meps));
+        mask = _mm_and_pd(mask, _mm_cmple_pd(_mm_sub_pd(z, zfar), eps));
+
+        __m128d cz = _mm_loadu_pd(depth + i);
+        mask = _mm_and_pd(mask, _mm_cmplt_pd(z, cz));
+        mask = _mm_and_pd(mask, _mm_cmpgt_pd(_mm_sub_pd(cz, z), eps));
+
+        int visible = _mm_movemask_pd(mask);
+        if (visible == 0) continue;
+
+        if (block) {
+            block->visible |= uint32_t(visible) << i;
+            block->frontfacing |= uint32_t(_mm_movemask_pd(_mm_and_pd(mask, front))) << i;
+            _mm_storeu_pd(block->z + i, z);
+            _mm_storeu_pd(block->w0 + i, w0);
+            _mm_storeu_pd(block->w1 + i, w1);
+            _mm_storeu_pd(block->w2 + i, w2);
+        }
+        else {
+            _mm_storeu_pd(depth + i, _mm_or_pd(_mm_and_pd(mask, z), _mm_andnot_pd(mask, cz)));
+            if (ids) {
+                if (visible & 1) ids[i] = id;
+                if (visible & 2) ids[i+1] = id;
+            }
+        }
+    }
+}
+
+#endif
+
+/* ----------------------------------------------------------------------- */
+
+static ZBufferKernel selectZBufferKernel(const char *& name)
+{
+    const char * env = getenv("PGL_ZBUFFER_KERNEL");
+    bool forcescalar = (env != NULL && strcmp(env, "scalar") == 0);
+    bool forcesse2 = (env != NULL && strcmp(env, "sse2") == 0);
+#ifdef PGL_ZBUFFER_SIMD
+    if (!forcescalar) {
+        __builtin_cpu_init();
+        if (!forcesse2 && __builtin_cpu_supports("avx2")) { name = "avx2"; return &zbufferKernelAVX2; }
+        if (__builtin_cpu_supports("sse2")) { name = "sse2"; return &zbufferKernelSSE2; }
+    }
+#endif
+    name = "scalar";
+    return NULL;
+}
+
+static const char * ZBUFFERKERNELNAME = "scalar";
+static ZBufferKernel ZBUFFERKERNEL = selectZBufferKernel(ZBUFFERKERNELNAME);
+
+ZBufferKernel PGL(getZBufferKernel)()
+{
+    return ZBUFFERKERNEL;
+}
+
+const char * PGL(getZBufferKernelName)()
+{
+    return ZBUFFERKERNELNAME;
+}
+
+/* ----------------------------------------------------------------------- */
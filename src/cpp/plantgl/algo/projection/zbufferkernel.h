@@ -0,0 +1,111 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+/*! \file zbufferkernel.h
+    \brief Vectorized kernels for the rasterization of triangles in ZBufferEngine.
+*/
+
+
+
+#ifndef __ZBufferKernel_h__
+#define __ZBufferKernel_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include <plantgl/tool/util_types.h>
+#include "../algo_config.h"
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/// Number of consecutive pixels processed by a call to a ZBufferKernel.
+#define ZBUFFER_KERNEL_BLOCK 8
+
+/// A triangle in raster space ready for rasterization by a ZBufferKernel.
+struct ZBufferKernelTriangle {
+    // raster coordinates of the vertices. iz is the inverse of the depth.
+    real_t x0, y0, iz0;
+    real_t x1, y1, iz1;
+    real_t x2, y2, iz2;
+    // signed area (edge function of the 3 vertices)
+    real_t area;
+    // depth range of the camera
+    real_t near, far;
+    // whether front and back facing fragments are kept
+    bool front, back;
+};
+
+/// Fragments of a block of pixels that passed the coverage, depth range and depth tests.
+struct ZBufferKernelBlock {
+    // bit i is set if pixel i is visible / front facing.
+    uint32_t visible;
+    uint32_t frontfacing;
+    real_t z[ZBUFFER_KERNEL_BLOCK];
+    // normalized barycentric weights
+    real_t w0[ZBUFFER_KERNEL_BLOCK];
+    real_t w1[ZBUFFER_KERNEL_BLOCK];
+    real_t w2[ZBUFFER_KERNEL_BLOCK];
+};
+
+/** Rasterize the ZBUFFER_KERNEL_BLOCK pixels (x, y+i) of a column of the image. 
+    depth points to the depth of pixel (x,y) and the column is contiguous in memory.
+    If block is null, depth (and ids if not null) are written directly for the visible pixels.
+    Otherwise nothing is written and the visible fragments are returned in block to be shaded. 
+    The computations are done in the same order as the scalar rasterization and give identical results. */
+typedef void (*ZBufferKernel)(const ZBufferKernelTriangle& triangle, int32_t x, int32_t y, 
+                              real_t * depth, uint32_t * ids, uint32_t id, ZBufferKernelBlock * block);
+
+/// The best kernel supported by the processor (AVX2 or SSE2), or NULL if no vectorized kernel is available.
+ALGO_API ZBufferKernel getZBufferKernel();
+
+/// Name of the kernel returned by getZBufferKernel.
+ALGO_API const char * getZBufferKernelName();
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+#endif
@@ -0,0 +1,411 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/* ----------------------------------------------------------------------- */
+
+#include "bvhraycaster.h"
+#include <plantgl/tool/util_taskscheduler.h>
+#include <algorithm>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#define BVH_NB_BINS 16
+// bounds the traversal stack. Deeper ranges are split by count.
+#define BVH_MAX_DEPTH 60
+
+namespace {
+
+    inline real_t bbox_area(const Vector3& lower, const Vector3& upper) {
+        Vector3 d = upper - lower;
+        return 2 * (d.x() * d.y() + d.y() * d.z() + d.z() * d.x());
+    }
+
+    inline void bbox_extend(Vector3& lower, Vector3& upper, const Vector3& p) {
+        for (uchar_t i = 0; i < 3; ++i) {
+            if (p[i] < lower[i]) lower[i] = p[i];
+            if (p[i] > upper[i]) upper[i] = p[i];
+        }
+    }
+
+    struct Bin {
+        Bin() : lower(REAL_MAX, REAL_MAX, REAL_MAX), upper(-REAL_MAX, -REAL_MAX, -REAL_MAX), count(0) {}
+        Vector3 lower, upper;
+        uint32_t count;
+    };
+
+    struct BuildData {
+        std::vector<Vector3> lowers, uppers, centroids;
+        std::vector<uint32_t> indices;
+    };
+
+    // Binned surface area heuristic. Return false if the range should be a leaf.
+    // Otherwise data.indices[begin:end] is partitioned at mid.
+    bool sah_split(BuildData& data, uint32_t begin, uint32_t end,
+                   const Vector3& lower, const Vector3& upper,
+                   const Vector3& clower, const Vector3& cupper,
+                   uint32_t maxLeafSize, uint32_t& mid)
+    {
+        uint32_t count = end - begin;
+        real_t bestcost = REAL_MAX;
+        int bestaxis = -1;
+        uint32_t bestsplit = 0;
+        for (uchar_t axis = 0; axis < 3; ++axis) {
+            real_t extent = cupper[axis] - clower[axis];
+            if (extent <= 0) continue;
+            real_t scale = BVH_NB_BINS / extent;
+            Bin bins[BVH_NB_BINS];
+            for (uint32_t i = begin; i < end; ++i) {
+                uint32_t t = data.indices[i];
+                uint32_t b = std::min<uint32_t>(BVH_NB_BINS - 1, uint32_t((data.centroids[t][axis] - clower[axis]) * scale));
+                bins[b].count++;
+                bbox_extend(bins[b].lower, bins[b].upper, data.lowers[t]);
+                bbox_extend(bins[b].lower, bins[b].upper, data.uppers[t]);
+            }
+            real_t rightareas[BVH_NB_BINS];
+            uint32_t rightcounts[BVH_NB_BINS];
+            Bin right;
+            for (int b = BVH_NB_BINS - 1; b > 0; --b) {
+                right.count += bins[b].count;
+                bbox_extend(right.lower, right.upper, bins[b].lower);
+                bbox_extend(right.lower, right.upper, bins[b].upper);
+                rightcounts[b] = right.count;
+                rightareas[b] = right.count > 0 ? bbox_area(right.lower, right.upper) : 0;
+            }
+            Bin left;
+            for (uint32_t b = 0; b < BVH_NB_BINS - 1; ++b) {
+                left.count += bins[b].count;
+                bbox_extend(left.lower, left.upper, bins[b].lower);
+                bbox_extend(left.lower, left.upper, bins[b].upper);
+                if (left.count == 0 || rightcounts[b + 1] == 0) continue;
+                real_t cost = left.count * bbox_area(left.lower, left.upper) + rightcounts[b + 1] * rightareas[b + 1];
+                if (cost < bestcost) { bestcost = cost; bestaxis = axis; bestsplit = b + 1; }
+            }
+        }
+
+        if (bestaxis < 0) {
+            // all centroids are identical: split by count
+            mid = (begin + end) / 2;
+            return true;
+        }
+
+        // compared to a leaf, with traversal and intersection costs of 1
+        real_t area = bbox_area(lower, upper);
+        if (area > 0 && 1 + bestcost / area >= count && count <= 4 * maxLeafSize) return false;
+
+        real_t cmin = clower[bestaxis];
+        real_t scale = BVH_NB_BINS / (cupper[bestaxis] - cmin);
+        std::vector<uint32_t>::iterator itmid =
+            std::partition(data.indices.begin() + begin, data.indices.begin() + end,
+                [&](uint32_t t) {
+                    return std::min<uint32_t>(BVH_NB_BINS - 1, uint32_t((data.centroids[t][bestaxis] - cmin) * scale)) < bestsplit;
+                });
+        mid = uint32_t(itmid - data.indices.begin());
+        if (mid == begin || mid == end) mid = (begin + end) / 2;
+        return true;
+    }
+
+    // Slab test. Return the entry distance or REAL_MAX if the box is missed.
+    inline real_t ray_box(const Vector3& origin, const Vector3& invdir,
+                          const Vector3& lower, const Vector3& upper, real_t maxdist) {
+        real_t tmin = 0, tmax = maxdist;
+        for (uchar_t i = 0; i < 3; ++i) {
+            real_t t0 = (lower[i] - origin[i]) * invdir[i];
+            real_t t1 = (upper[i] - origin[i]) * invdir[i];
+            if (t0 > t1) std::swap(t0, t1);
+            if (t0 > tmin) tmin = t0;
+            if (t1 < tmax) tmax = t1;
+            if (tmin > tmax) return REAL_MAX;
+        }
+        return tmin;
+    }
+
+    struct FirstHitFunctor {
+        FirstHitFunctor(RayHit& h) : hit(h), found(false) {}
+        inline bool operator()(uint32_t triangle, real_t t, real_t u, real_t v, real_t& maxdist) {
+            hit.triangle = triangle; hit.distance = t; hit.u = u; hit.v = v;
+            maxdist = t;
+            found = true;
+            return false;
+        }
+        RayHit& hit;
+        bool found;
+    };
+
+    struct AnyHitFunctor {
+        AnyHitFunctor() : found(false) {}
+        inline bool operator()(uint32_t, real_t, real_t, real_t, real_t&) { found = true; return true; }
+        bool found;
+    };
+
+    struct AllHitsFunctor {
+        AllHitsFunctor(std::vector<RayHit>& h) : hits(h) {}
+        inline bool operator()(uint32_t triangle, real_t t, real_t u, real_t v, real_t&) {
+            RayHit hit;
+            hit.triangle = triangle; hit.distance = t; hit.u = u; hit.v = v;
+            hits.push_back(hit);
+            return false;
+        }
+        std::vector<RayHit>& hits;
+    };
+
+    inline bool hit_distance_order(const RayHit& a, const RayHit& b) { return a.distance < b.distance; }
+}
+
+/* ----------------------------------------------------------------------- */
+
+BVHRayCaster::BVHRayCaster(const TriangleSoupPtr& soup, uint32_t maxLeafSize):
+    RefCountObject(),
+    __soup(soup)
+{
+    build(maxLeafSize);
+}
+
+BVHRayCaster::BVHRayCaster(const ScenePtr& scene, const DiscretizationCachePtr& cache, uint32_t maxLeafSize):
+    RefCountObject(),
+    __soup(new TriangleSoup(scene, cache))
+{
+    build(maxLeafSize);
+}
+
+BVHRayCaster::~BVHRayCaster()
+{
+}
+
+void BVHRayCaster::build(uint32_t maxLeafSize)
+{
+    __nodes.clear();
+    __triangles.clear();
+    if (is_null_ptr(__soup) || __soup->empty()) return;
+    if (maxLeafSize == 0) maxLeafSize = 1;
+
+    size_t nbtriangles = __soup->size();
+    BuildData data;
+    data.lowers.resize(nbtriangles);
+    data.uppers.resize(nbtriangles);
+    data.centroids.resize(nbtriangles);
+    data.indices.resize(nbtriangles);
+    for (size_t i = 0; i < nbtriangles; ++i) {
+        const Vector3& a = __soup->getVertexAt(i, 0);
+        data.lowers[i] = data.uppers[i] = a;
+        bbox_extend(data.lowers[i], data.uppers[i], __soup->getVertexAt(i, 1));
+        bbox_extend(data.lowers[i], data.uppers[i], __soup->getVertexAt(i, 2));
+        data.centroids[i] = (data.lowers[i] + data.uppers[i]) / 2;
+        data.indices[i] = i;
+    }
+
+    __nodes.reserve(2 * nbtriangles / maxLeafSize + 1);
+    __nodes.push_back(Node());
+
+    // (node, begin, end, depth) of the ranges to process
+    struct Task { uint32_t node, begin, end, depth; };
+    std::vector<Task> tasks;
+    Task root = { 0, 0, uint32_t(nbtriangles), 0 };
+    tasks.push_back(root);
+    while (!tasks.empty()) {
+        Task task = tasks.back();
+        tasks.pop_back();
+
+        Vector3 lower(REAL_MAX, REAL_MAX, REAL_MAX), upper(-REAL_MAX, -REAL_MAX, -REAL_MAX);
+        Vector3 clower = lower, cupper = upper;
+        for (uint32_t i = task.begin; i < task.end; ++i) {
+            uint32_t t = data.indices[i];
+            bbox_extend(lower, upper, data.lowers[t]);
+            bbox_extend(lower, upper, data.uppers[t]);
+            bbox_extend(clower, cupper, data.centroids[t]);
+        }
+        __nodes[task.node].lower = lower;
+        __nodes[task.node].upper = upper;
+        __nodes[task.node].first = task.begin;
+        uint32_t count = task.end - task.begin;
+        __nodes[task.node].count = count;
+        if (count <= maxLeafSize) continue;
+
+        uint32_t mid = (task.begin + task.end) / 2;
+        if (task.depth >= BVH_MAX_DEPTH) {
+            // split by count to bound the depth
+            if (count <= 64 * maxLeafSize) continue;
+        }
+        else if (!sah_split(data, task.begin, task.end, lower, upper, clower, cupper, maxLeafSize, mid)) continue;
+
+        uint32_t children = __nodes.size();
+        __nodes.push_back(Node());
+        __nodes.push_back(Node());
+        __nodes[task.node].first = children;
+        __nodes[task.node].count = 0;
+        Task lefttask = { children, task.begin, mid, task.depth + 1 };
+        Task righttask = { children + 1, mid, task.end, task.depth + 1 };
+        tasks.push_back(righttask);
+        tasks.push_back(lefttask);
+    }
+
+    __triangles.resize(nbtriangles);
+    for (size_t i = 0; i < nbtriangles; ++i) {
+        uint32_t t = data.indices[i];
+        Triangle& tr = __triangles[i];
+        tr.v0 = __soup->getVertexAt(t, 0);
+        tr.e1 = __soup->getVertexAt(t, 1) - tr.v0;
+        tr.e2 = __soup->getVertexAt(t, 2) - tr.v0;
+        tr.index = t;
+    }
+}
+
+template<class HitFunctor>
+void BVHRayCaster::traverse(const Ray& ray, real_t maxdist, HitFunctor& functor) const
+{
+    if (__nodes.empty()) return;
+    const Vector3& origin = ray.getOrigin();
+    const Vector3& dir = ray.getDirection();
+    Vector3 invdir(1 / dir.x(), 1 / dir.y(), 1 / dir.z());
+
+    // nodes are pushed with their entry distance to skip those farther than the current hit
+    uint32_t stack[2 * BVH_MAX_DEPTH + 4];
+    real_t stackdist[2 * BVH_MAX_DEPTH + 4];
+    int top = 0;
+    real_t rootdist = ray_box(origin, invdir, __nodes[0].lower, __nodes[0].upper, maxdist);
+    if (rootdist == REAL_MAX) return;
+    stack[top] = 0; stackdist[top] = rootdist; ++top;
+
+    while (top > 0) {
+        --top;
+        if (stackdist[top] > maxdist) continue;
+        const Node& node = __nodes[stack[top]];
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                // Moller-Trumbore test
+                const Triangle& tr = __triangles[i];
+                Vector3 p(dir.y() * tr.e2.z() - dir.z() * tr.e2.y(),
+                          dir.z() * tr.e2.x() - dir.x() * tr.e2.z(),
+                          dir.x() * tr.e2.y() - dir.y() * tr.e2.x());
+                real_t det = tr.e1.x() * p.x() + tr.e1.y() * p.y() + tr.e1.z() * p.z();
+                if (fabs(det) < GEOM_EPSILON * GEOM_EPSILON) continue;
+                real_t invdet = 1 / det;
+                Vector3 s = origin - tr.v0;
+                real_t u = (s.x() * p.x() + s.y() * p.y() + s.z() * p.z()) * invdet;
+                if (u < 0 || u > 1) continue;
+                Vector3 q(s.y() * tr.e1.z() - s.z() * tr.e1.y(),
+                          s.z() * tr.e1.x() - s.x() * tr.e1.z(),
+                          s.x() * tr.e1.y() - s.y() * tr.e1.x());
+                real_t v = (dir.x() * q.x() + dir.y() * q.y() + dir.z() * q.z()) * invdet;
+                if (v < 0 || u + v > 1) continue;
+                real_t t = (tr.e2.x() * q.x() + tr.e2.y() * q.y() + tr.e2.z() * q.z()) * invdet;
+                if (t <= 0 || t > maxdist) continue;
+                if (functor(tr.index, t, u, v, maxdist)) return;
+            }
+        }
+        else {
+            real_t d0 = ray_box(origin, invdir, __nodes[node.first].lower, __nodes[node.first].upper, maxdist);
+            real_t d1 = ray_box(origin, invdir, __nodes[node.first + 1].lower, __nodes[node.first + 1].upper, maxdist);
+            uint32_t near = node.first, far = node.first + 1;
+            if (d1 < d0) { std::swap(d0, d1); std::swap(near, far); }
+            if (d1 != REAL_MAX) { stack[top] = far; stackdist[top] = d1; ++top; }
+            if (d0 != REAL_MAX) { stack[top] = near; stackdist[top] = d0; ++top; }
+        }
+    }
+}
+
+bool BVHRayCaster::firstHit(const Ray& ray, RayHit& hit, real_t maxdist) const
+{
+    hit = RayHit();
+    FirstHitFunctor functor(hit);
+    traverse(ray, maxdist, functor);
+    if (functor.found) hit.id = __soup->getIdAt(hit.triangle);
+    return functor.found;
+}
+
+bool BVHRayCaster::anyHit(const Ray& ray, real_t maxdist) const
+{
+    AnyHitFunctor functor;
+    traverse(ray, maxdist, functor);
+    return functor.found;
+}
+
+size_t BVHRayCaster::allHits(const Ray& ray, std::vector<RayHit>& hits, real_t maxdist) const
+{
+    size_t first = hits.size();
+    AllHitsFunctor functor(hits);
+    traverse(ray, maxdist, functor);
+    for (std::vector<RayHit>::iterator it = hits.begin() + first; it != hits.end(); ++it)
+        it->id = __soup->getIdAt(it->triangle);
+    std::sort(hits.begin() + first, hits.end(), hit_distance_order);
+    return hits.size() - first;
+}
+
+void BVHRayCaster::firstHits(const std::vector<Ray>& rays, std::vector<RayHit>& hits, real_t maxdist) const
+{
+    hits.resize(rays.size());
+    parallel_for(0, rays.size(), [&](size_t i) { firstHit(rays[i], hits[i], maxdist); }, 256);
+}
+
+void BVHRayCaster::anyHits(const std::vector<Ray>& rays, std::vector<uchar_t>& hits, real_t maxdist) const
+{
+    hits.resize(rays.size());
+    parallel_for(0, rays.size(), [&](size_t i) { hits[i] = anyHit(rays[i], maxdist); }, 256);
+}
+
+void BVHRayCaster::allHits(const std::vector<Ray>& rays, std::vector<RayHit>& hits, std::vector<size_t>& offsets, real_t maxdist) const
+{
+    // hits are collected per range of rays and concatenated in order
+    const size_t grainsize = 256;
+    size_t nbchunks = (rays.size() + grainsize - 1) / grainsize;
+    std::vector<std::vector<RayHit> > chunkhits(nbchunks);
+    std::vector<size_t> counts(rays.size());
+    parallel_for_range(0, rays.size(), [&](size_t begin, size_t end) {
+        std::vector<RayHit>& chunk = chunkhits[begin / grainsize];
+        for (size_t i = begin; i < end; ++i) counts[i] = allHits(rays[i], chunk, maxdist);
+    }, grainsize);
+
+    offsets.resize(rays.size() + 1);
+    offsets[0] = 0;
+    for (size_t i = 0; i < rays.size(); ++i) offsets[i + 1] = offsets[i] + counts[i];
+    hits.clear();
+    hits.reserve(offsets.back());
+    for (size_t c = 0; c < nbchunks; ++c)
+        hits.insert(hits.end(), chunkhits[c].begin(), chunkhits[c].end());
+}
+
+BoundingBoxPtr BVHRayCaster::getBoundingBox() const
+{
+    if (__nodes.empty()) return BoundingBoxPtr();
+    return BoundingBoxPtr(new BoundingBox(__nodes[0].lower, __nodes[0].upper));
+}
@@ -0,0 +1,156 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+/*! \file bvhraycaster.h
+    \brief Definition of BVHRayCaster, a ray casting engine accelerated by a bounding volume hierarchy.
+*/
+
+#ifndef __bvhraycaster_h__
+#define __bvhraycaster_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include "ray.h"
+#include "../algo_config.h"
+#include "../projection/trianglesoup.h"
+#include <plantgl/tool/rcobject.h>
+#include <vector>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/// The intersection of a ray with a triangle of a BVHRayCaster.
+struct ALGO_API RayHit {
+    RayHit() : triangle(UINT32_MAX), id(Shape::NOID), distance(REAL_MAX), u(0), v(0) {}
+
+    inline bool isValid() const { return triangle != UINT32_MAX; }
+
+    /// Position of the triangle in the TriangleSoup.
+    uint32_t triangle;
+    /// Id of the shape of the triangle.
+    uint32_t id;
+    /// Distance from the ray origin.
+    real_t distance;
+    /// Barycentric coordinates of the hit: hit = (1-u-v) * v0 + u * v1 + v * v2.
+    real_t u, v;
+};
+
+/* ----------------------------------------------------------------------- */
+
+/**
+    \class BVHRayCaster
+    \brief Cast rays into the triangles of a scene using a bounding volume hierarchy.
+
+    The scene is tessellated once into a TriangleSoup and a BVH is built on it with
+    the surface area heuristic. Queries are read-only and can be done from several
+    threads. The batched versions split the rays among the threads of the TaskScheduler.
+    Triangles are two-sided and hits are reported at a strictly positive distance.
+*/
+
+/* ----------------------------------------------------------------------- */
+
+class ALGO_API BVHRayCaster : public RefCountObject {
+public:
+    BVHRayCaster(const TriangleSoupPtr& soup, uint32_t maxLeafSize = 4);
+    BVHRayCaster(const ScenePtr& scene, const DiscretizationCachePtr& cache = DiscretizationCachePtr(), uint32_t maxLeafSize = 4);
+    virtual ~BVHRayCaster();
+
+    /// Closest intersection of ray closer than maxdist. Return false if there is none.
+    bool firstHit(const Ray& ray, RayHit& hit, real_t maxdist = REAL_MAX) const;
+
+    /// Whether ray intersects a triangle closer than maxdist. Stops at the first intersection found.
+    bool anyHit(const Ray& ray, real_t maxdist = REAL_MAX) const;
+
+    /// Append all the intersections of ray closer than maxdist to hits, sorted by distance. Return their number.
+    size_t allHits(const Ray& ray, std::vector<RayHit>& hits, real_t maxdist = REAL_MAX) const;
+
+    /// Batched firstHit. hits[i] is invalid if rays[i] hits nothing.
+    void firstHits(const std::vector<Ray>& rays, std::vector<RayHit>& hits, real_t maxdist = REAL_MAX) const;
+
+    /// Batched anyHit.
+    void anyHits(const std::vector<Ray>& rays, std::vector<uchar_t>& hits, real_t maxdist = REAL_MAX) const;
+
+    /// Batched allHits. The hits of rays[i] are hits[offsets[i]:offsets[i+1]].
+    void allHits(const std::vector<Ray>& rays, std::vector<RayHit>& hits, std::vector<size_t>& offsets, real_t maxdist = REAL_MAX) const;
+
+    inline const TriangleSoupPtr& getTriangleSoup() const { return __soup; }
+    inline size_t size() const { return __triangles.size(); }
+    inline size_t getNbNodes() const { return __nodes.size(); }
+
+    /// Bounding box of all the triangles. Null if empty.
+    BoundingBoxPtr getBoundingBox() const;
+
+protected:
+    /// A leaf has count > 0 triangles starting at first. An inner node has its two children at first and first+1.
+    struct Node {
+        Vector3 lower, upper;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    /// Triangles are stored in BVH order with the data needed by the intersection test.
+    struct Triangle {
+        Vector3 v0, e1, e2;
+        uint32_t index;
+    };
+
+    void build(uint32_t maxLeafSize);
+
+    template<class HitFunctor>
+    void traverse(const Ray& ray, real_t maxdist, HitFunctor& functor) const;
+
+    TriangleSoupPtr __soup;
+    std::vector<Node> __nodes;
+    std::vector<Triangle> __triangles;
+};
+
+typedef RCPtr<BVHRayCaster> BVHRayCasterPtr;
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+#endif
@@ -68,6 +68,7 @@
 #include "plantgl/algo/codec/dtafile.h"
 #include "plantgl/algo/codec/ligfile.h"
 #include "plantgl/algo/codec/vgsfile.h"
+#include "plantgl/algo/codec/plyfile.h"
 #include "plantgl/algo/codec/scne_binaryparser.h"
 #include "plantgl/algo/codec/scne_scanner.h"
 #include "plantgl/algo/codec/scne_parser.h"
@@ -0,0 +1,118 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+#include "csrindexarray.h"
+#include <algorithm>
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+CSRIndexArray::CSRIndexArray( size_t nbRows ) :
+  RefCountObject(),
+  __offsets(nbRows + 1, 0),
+  __indices() {
+}
+
+CSRIndexArray::CSRIndexArray( size_t nbRows, size_t rowSize ) :
+  RefCountObject(),
+  __offsets(nbRows + 1),
+  __indices(nbRows * rowSize, 0) {
+  for (size_t i = 0; i <= nbRows; ++i) __offsets[i] = i * rowSize;
+}
+
+CSRIndexArray::CSRIndexArray( const std::vector<offset_type>& offsets, const std::vector<uint_t>& indices ) :
+  RefCountObject(),
+  __offsets(offsets),
+  __indices(indices) {
+  if (__offsets.empty()) __offsets.push_back(0);
+  GEOM_ASSERT(__offsets.front() == 0 && __offsets.back() == __indices.size());
+}
+
+CSRIndexArray::CSRIndexArray( const IndexArray& array ) :
+  RefCountObject(),
+  __offsets(),
+  __indices() {
+  size_t nbindices = 0;
+  for (IndexArray::const_iterator it = array.begin(); it != array.end(); ++it) nbindices += it->size();
+  __offsets.reserve(array.size() + 1);
+  __indices.reserve(nbindices);
+  __offsets.push_back(0);
+  for (IndexArray::const_iterator it = array.begin(); it != array.end(); ++it) pushRow(*it);
+}
+
+CSRIndexArray::~CSRIndexArray( ) {
+}
+
+void CSRIndexArray::append( const CSRIndexArray& other ) {
+  offset_type shift = __indices.size();
+  __indices.insert(__indices.end(), other.__indices.begin(), other.__indices.end());
+  __offsets.reserve(__offsets.size() + other.size());
+  for (std::vector<offset_type>::const_iterator it = other.__offsets.begin() + 1; it != other.__offsets.end(); ++it)
+    __offsets.push_back(*it + shift);
+}
+
+void CSRIndexArray::reserve( size_t nbRows, size_t nbIndices ) {
+  __offsets.reserve(__offsets.size() + nbRows);
+  __indices.reserve(__indices.size() + nbIndices);
+}
+
+void CSRIndexArray::clear( ) {
+  __offsets.assign(1, 0);
+  __indices.clear();
+}
+
+IndexArrayPtr CSRIndexArray::toIndexArray( ) const {
+  IndexArrayPtr result(new IndexArray(size()));
+  IndexArray::iterator itres = result->begin();
+  for (size_t i = 0; i < size(); ++i, ++itres) {
+    Row row = getAt(i);
+    *itres = Index(row.begin(), row.end());
+  }
+  return result;
+}
+
+bool CSRIndexArray::isValid( size_t nbIndices ) const {
+  return std::find_if(__indices.begin(), __indices.end(), [nbIndices](uint_t i) { return i >= nbIndices; }) == __indices.end();
+}
+
+/* ----------------------------------------------------------------------- */
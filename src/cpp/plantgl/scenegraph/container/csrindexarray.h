@@ -0,0 +1,176 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+/*! \file csrindexarray.h
+    \brief Definition of the container class CSRIndexArray.
+*/
+
+#ifndef __csrindexarray_h__
+#define __csrindexarray_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include "indexarray.h"
+#include <plantgl/tool/rcobject.h>
+#include <vector>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class CSRIndexArray
+   \brief An array of lists of indices stored in compressed sparse row format.
+
+   The indices of all the rows are stored contiguously. Row \e i is made of the
+   indices in the range [offsets[i], offsets[i+1]). Compared to an IndexArray,
+   it does not require an allocation per row. Rows are read-only once appended.
+*/
+
+/* ----------------------------------------------------------------------- */
+
+class SG_API CSRIndexArray : public RefCountObject
+{
+public:
+  typedef uint_t value_type;
+  typedef uint64_t offset_type;
+
+  /// A read-only view on the indices of a row.
+  class Row {
+  public:
+    typedef const uint_t * const_iterator;
+    typedef const uint_t * iterator;
+    typedef uint_t value_type;
+
+    Row(const uint_t * begin, const uint_t * end) : __begin(begin), __end(end) {}
+
+    inline const_iterator begin() const { return __begin; }
+    inline const_iterator end() const { return __end; }
+    inline size_t size() const { return __end - __begin; }
+    inline bool empty() const { return __begin == __end; }
+    inline uint_t operator[](size_t i) const { return __begin[i]; }
+    inline uint_t getAt(size_t i) const { return __begin[i]; }
+
+  protected:
+    const uint_t * __begin;
+    const uint_t * __end;
+  };
+
+  typedef Row element_type;
+
+  /// Constructs an array with \e nbRows empty rows.
+  CSRIndexArray( size_t nbRows = 0 );
+
+  /// Constructs an array with \e nbRows rows of \e rowSize indices initialized to 0.
+  CSRIndexArray( size_t nbRows, size_t rowSize );
+
+  /// Constructs from the offsets (of size nbRows+1, starting with 0) and the indices.
+  CSRIndexArray( const std::vector<offset_type>& offsets, const std::vector<uint_t>& indices );
+
+  /// Constructs a copy of \e array.
+  CSRIndexArray( const IndexArray& array );
+
+  virtual ~CSRIndexArray( );
+
+  /// Returns the number of rows.
+  inline size_t size( ) const { return __offsets.size() - 1; }
+  inline bool empty( ) const { return size() == 0; }
+
+  /// Returns the row \e i.
+  inline Row getAt( size_t i ) const
+  { return Row(__indices.data() + __offsets[i], __indices.data() + __offsets[i+1]); }
+
+  inline Row operator[]( size_t i ) const { return getAt(i); }
+
+  inline size_t getRowSize( size_t i ) const { return size_t(__offsets[i+1] - __offsets[i]); }
+
+  /// Returns the total number of indices.
+  inline size_t getNbIndices( ) const { return __indices.size(); }
+
+  inline const std::vector<offset_type>& getOffsets( ) const { return __offsets; }
+  inline const std::vector<uint_t>& getIndices( ) const { return __indices; }
+
+  /// Gives write access to the indices. The row structure cannot be changed this way.
+  inline std::vector<uint_t>& getIndices( ) { return __indices; }
+
+  /// Appends a row made of the indices in [begin, end).
+  template <class InIterator>
+  void pushRow( InIterator begin, InIterator end ) {
+    __indices.insert(__indices.end(), begin, end);
+    __offsets.push_back(__indices.size());
+  }
+
+  template <class Container>
+  inline void pushRow( const Container& row ) { pushRow(row.begin(), row.end()); }
+
+  /// Appends the rows of \e other.
+  void append( const CSRIndexArray& other );
+
+  /// Reserves memory for \e nbRows additional rows and \e nbIndices additional indices.
+  void reserve( size_t nbRows, size_t nbIndices );
+
+  /// Removes all rows.
+  void clear( );
+
+  /// Returns a copy of \e self as an IndexArray.
+  IndexArrayPtr toIndexArray( ) const;
+
+  /// Returns whether all the indices are lower than \e nbIndices.
+  bool isValid( size_t nbIndices ) const;
+
+protected:
+  std::vector<offset_type> __offsets;
+  std::vector<uint_t> __indices;
+};
+
+/// CSRIndexArray Pointer
+typedef RCPtr<CSRIndexArray> CSRIndexArrayPtr;
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+// __csrindexarray_h__
+#endif
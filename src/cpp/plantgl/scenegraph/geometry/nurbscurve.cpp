@@ -372,12 +372,13 @@ RealArray2Ptr NurbsCurve::computeDerivatesBasisFunctions(int n,real_t u, int spa
 Point4ArrayPtr  NurbsCurve::deriveAtH(real_t u, int d, int span ) const {
     int du = ( d < (int)__degree ? d : __degree);
     Point4ArrayPtr ders(new Point4Array(d+1, Vector4::ORIGIN));
-    RealArray2Ptr derF = computeDerivatesBasisFunctions(du,u,span) ;
+    real_t * derF = (real_t *)alloca((du+1)*(__degree+1)*sizeof(real_t));
+    derivatesBasisFunctions(du,u,span,__degree,__knotList,derF) ;
 
     for(int k=du;k>=0;--k){
         ders->setAt(k,Vector4(0,0,0,0)) ;
         for(int j=__degree;j>=0;--j){
-            ders->setAt(k, ders->getAt(k) + __ctrlPointList->getAt(span-__degree+j).wtoxyz()*derF->getAt(k,j)) ;
+            ders->setAt(k, ders->getAt(k) + __ctrlPointList->getAt(span-__degree+j).wtoxyz()*derF[k*(__degree+1)+j]) ;
         }
     }
     return ders;
@@ -438,15 +439,13 @@ Point3ArrayPtr NurbsCurve::getDerivativesAt(real_t u) const {
 
 
 
-Vector3 NurbsCurve::getPointAt(real_t u) const{
-    GEOM_ASSERT( (getFirstKnot() -u ) < GEOM_EPSILON &&  !((u - getLastKnot()) > GEOM_EPSILON));
-
-    uint_t span = findSpan(u);
-    RealArrayPtr _basisFunctions = computeBasisFunctions(span,u);
+/// Combine the control points of \b span with the basis values \b N.
+static inline Vector3 nurbsCurvePoint(const Point4ArrayPtr& ctrlPoints, uint_t degree,
+                                      uint_t span, const real_t * N){
     Vector4 Cw(0.0,0.0,0.0,0.0);
-    for (uint_t j = 0; j <= __degree; j++) {
-        Vector4 Pj = __ctrlPointList->getAt( span - __degree + j ).wtoxyz();
-        Cw += Pj * _basisFunctions->getAt(j);
+    for (uint_t j = 0; j <= degree; j++) {
+        Vector4 Pj = ctrlPoints->getAt( span - degree + j ).wtoxyz();
+        Cw += Pj * N[j];
     }
 
     if (fabs(Cw.w()) < GEOM_TOLERANCE)
@@ -455,6 +454,29 @@ Vector3 NurbsCurve::getPointAt(real_t u) const{
     return Cw.project();
 }
 
+Vector3 NurbsCurve::getPointAt(real_t u) const{
+    GEOM_ASSERT( (getFirstKnot() -u ) < GEOM_EPSILON &&  !((u - getLastKnot()) > GEOM_EPSILON));
+
+    uint_t span = findSpan(u);
+    real_t * N = (real_t *)alloca((__degree+1)*sizeof(real_t));
+    basisFunctions(span,u,__degree,__knotList,N);
+    return nurbsCurvePoint(__ctrlPointList, __degree, span, N);
+}
+
+Point3ArrayPtr NurbsCurve::evaluate(const RealArrayPtr& u) const{
+    GEOM_ASSERT(u);
+    Point3ArrayPtr result(new Point3Array(u->size()));
+    real_t * N = (real_t *)alloca((__degree+1)*sizeof(real_t));
+    uint_t span = __degree;
+    Point3Array::iterator _itResult = result->begin();
+    for (RealArray::const_iterator _itU = u->begin(); _itU != u->end(); ++_itU, ++_itResult){
+        span = PGL::findSpan(*_itU,__degree,__knotList,span);
+        basisFunctions(span,*_itU,__degree,__knotList,N);
+        *_itResult = nurbsCurvePoint(__ctrlPointList, __degree, span, N);
+    }
+    return result;
+}
+
 Vector3 NurbsCurve::getTangentAt(real_t u) const {
     GEOM_ASSERT( (getFirstKnot() -u ) < GEOM_EPSILON &&  !((u - getLastKnot()) > GEOM_EPSILON));
     return getDerivativeAt( u, 1 );
@@ -566,13 +588,27 @@ PGL(findSpan)(real_t u,
 
 }
 
-RealArrayPtr
-PGL(basisFunctions)(uint_t span, real_t u, uint_t _degree, const RealArrayPtr& _knotList) {
-  RealArrayPtr BasisFunctions(new RealArray(_degree + 1));
+uint_t
+PGL(findSpan)(real_t u,
+     uint_t _degree,
+     const RealArrayPtr& _knotList,
+     uint_t hint ){
+    uint_t n = _knotList->size()-_degree -1;
+    // Neighbouring samples usually fall in the same or the next span.
+    if( hint >= _degree && hint < n ){
+        if( u >= _knotList->getAt(hint) && u < _knotList->getAt(hint+1) ) return hint;
+        if( hint + 1 < n && u >= _knotList->getAt(hint+1) && u < _knotList->getAt(hint+2) ) return hint+1;
+    }
+    return findSpan(u,_degree,_knotList);
+}
+
+void
+PGL(basisFunctions)(uint_t span, real_t u, uint_t _degree, const RealArrayPtr& _knotList, real_t * BasisFunctions) {
   if( span >= _knotList->size()-_degree - 1){ // for clamped vector only
+    BasisFunctions[0] = 0.0;
     for(uint_t _i = 0 ; _i <_degree ; _i ++)
-      BasisFunctions->setAt(_degree - _i ,1.0);
-    return BasisFunctions;
+      BasisFunctions[_degree - _i] = 1.0;
+    return;
   }
 
   /// memory set with alloca is automatically freed at the end of the function
@@ -580,7 +616,7 @@ PGL(basisFunctions)(uint_t span, real_t u, uint_t _degree, const RealArrayPtr& _
   real_t * right= &left[ _degree+1 ];
   real_t saved;
 
-  BasisFunctions->setAt(0,1.0);
+  BasisFunctions[0] = 1.0;
 
   for( uint_t j = 1 ; j <= _degree ; j++ ){
     left[j] = u - _knotList->getAt(span + 1 -j) ;
@@ -593,28 +629,42 @@ PGL(basisFunctions)(uint_t span, real_t u, uint_t _degree, const RealArrayPtr& _
                  << j << '-' << r << "] = " << left[j-r] << endl;
         }
         assert(right[r+1] + left[j-r] != 0);
-        real_t temp = BasisFunctions->getAt(r) / ( right[r+1] + left[j-r] );
-        BasisFunctions->setAt(r, saved + ( right[r+1] * temp ));
+        real_t temp = BasisFunctions[r] / ( right[r+1] + left[j-r] );
+        BasisFunctions[r] = saved + ( right[r+1] * temp );
         saved = left[j-r] * temp;
     }
-    BasisFunctions->setAt(j,saved);
+    BasisFunctions[j] = saved;
   }
+}
+
+RealArrayPtr
+PGL(basisFunctions)(uint_t span, real_t u, uint_t _degree, const RealArrayPtr& _knotList) {
+  RealArrayPtr BasisFunctions(new RealArray(_degree + 1));
+  basisFunctions(span, u, _degree, _knotList, &*BasisFunctions->begin());
   return BasisFunctions;
 }
 
 /* Algo A2.3 p72 Nurbs Book */
-RealArray2Ptr
-PGL(derivatesBasisFunctions)(int n,real_t u, int span,  uint_t _degree, const RealArrayPtr& _knotList ){
-  real_t * left = (real_t *) alloca(2*(_degree+1)*sizeof(real_t)) ;
-  real_t * right = &left[_degree+1] ;
+void
+PGL(derivatesBasisFunctions)(int n,real_t u, int span,  uint_t _degree, const RealArrayPtr& _knotList, real_t * ders ){
+  const int p1 = _degree+1;
+  /// left, right, ndu and a all live on the stack.
+  real_t * left = (real_t *) alloca((2*p1 + 3*p1*p1)*sizeof(real_t)) ;
+  real_t * right = &left[p1] ;
+  real_t * ndu = &right[p1] ;
+  real_t * a = &ndu[p1*p1] ;
+  // a has only two rows in use but is addressed with a stride of p1.
+  std::fill(ndu, ndu + 3*p1*p1, real_t(0));
+  std::fill(ders, ders + (n+1)*p1, real_t(0));
+
+#define NDU(i,j) ndu[(i)*p1+(j)]
+#define A(i,j) a[(i)*p1+(j)]
+#define DERS(i,j) ders[(i)*p1+(j)]
 
-  RealArray2 ndu(_degree+1,_degree+1) ;
   real_t saved,temp ;
   int r, j;
 
-  RealArray2Ptr ders(new RealArray2(n+1,_degree+1));
-
-  ndu.setAt(0,0,1.0) ;
+  NDU(0,0) = 1.0 ;
 
   for(j=1; j <= (int)_degree ;j++){
       left[j] = u-_knotList->getAt(span+1-j) ;
@@ -623,25 +673,24 @@ PGL(derivatesBasisFunctions)(int n,real_t u, int span,  uint_t _degree, const Re
 
       for(r=0;r<j ; r++){
           // Lower triangle
-          ndu.setAt(j,r,right[r+1]+left[j-r]) ;
-          temp = ndu.getAt(r,j-1)/ndu.getAt(j,r) ;
+          NDU(j,r) = right[r+1]+left[j-r] ;
+          temp = NDU(r,j-1)/NDU(j,r) ;
           // Upper triangle
-          ndu.setAt(r,j,saved+right[r+1] * temp) ;
+          NDU(r,j) = saved+right[r+1] * temp ;
           saved = left[j-r] * temp ;
       }
 
-      ndu.setAt(j,j,saved) ;
+      NDU(j,j) = saved ;
   }
 
   for(j=_degree;j>=0;--j)
-      ders->setAt(0,j,ndu.getAt(j,_degree)) ;
+      DERS(0,j) = NDU(j,_degree) ;
 
   // Compute the derivatives
-  RealArray2 a(_degree+1,_degree+1) ;
   for(r=0;r<=(int)_degree;r++){
       int s1,s2 ;
       s1 = 0 ; s2 = 1 ; // alternate rows in array a
-      a.setAt(0,0,1.0) ;
+      A(0,0) = 1.0 ;
       // Compute the kth derivative
       for(int k=1;k<=n;k++){
           real_t d ;
@@ -650,8 +699,8 @@ PGL(derivatesBasisFunctions)(int n,real_t u, int span,  uint_t _degree, const Re
           rk = r-k ; pk = _degree-k ;
 
           if(r>=k){
-              a.setAt(s2,0,(a.getAt(s1,0)/ndu.getAt(pk+1,rk))) ;
-              d = a.getAt(s2,0)*ndu.getAt(rk,pk) ;
+              A(s2,0) = A(s1,0)/NDU(pk+1,rk) ;
+              d = A(s2,0)*NDU(rk,pk) ;
           }
 
           if(rk>=-1){
@@ -669,15 +718,15 @@ PGL(derivatesBasisFunctions)(int n,real_t u, int span,  uint_t _degree, const Re
           }
 
           for(j=j1;j<=j2;j++){
-              a.setAt(s2,j,((a.getAt(s1,j)-a.getAt(s1,j-1))/ndu.getAt(pk+1,rk+j))) ;
-              d += a.getAt(s2,j)*ndu.getAt(rk+j,pk) ;
+              A(s2,j) = (A(s1,j)-A(s1,j-1))/NDU(pk+1,rk+j) ;
+              d += A(s2,j)*NDU(rk+j,pk) ;
           }
 
       if(r<=pk){
-        a.setAt(s2,k,-(a.getAt(s1,k-1))/ndu.getAt(pk+1,r)) ;
-        d += a.getAt(s2,k)*ndu.getAt(r,pk) ;
+        A(s2,k) = -A(s1,k-1)/NDU(pk+1,r) ;
+        d += A(s2,k)*NDU(r,pk) ;
       }
-      ders->setAt(k,r, d) ;
+      DERS(k,r) = d ;
       j = s1 ; s1 = s2 ; s2 = j ; // Switch rows
     }
   }
@@ -686,11 +735,24 @@ PGL(derivatesBasisFunctions)(int n,real_t u, int span,  uint_t _degree, const Re
   r = _degree ;
   for(int k=1;k<=n;k++){
       for(j=_degree;j>=0;--j)
-          ders->setAt(k,j,ders->getAt(k,j)*r) ;
+          DERS(k,j) *= r ;
       r *= _degree-k ;
   }
-  return ders;
 
+#undef NDU
+#undef A
+#undef DERS
+}
+
+RealArray2Ptr
+PGL(derivatesBasisFunctions)(int n,real_t u, int span,  uint_t _degree, const RealArrayPtr& _knotList ){
+  real_t * buffer = (real_t *) alloca((n+1)*(_degree+1)*sizeof(real_t)) ;
+  derivatesBasisFunctions(n, u, span, _degree, _knotList, buffer);
+  RealArray2Ptr ders(new RealArray2(n+1,_degree+1));
+  for(int k = 0; k <= n; ++k)
+      for(uint_t j = 0; j <= _degree; ++j)
+          ders->setAt(k,j,buffer[k*(_degree+1)+j]);
+  return ders;
 }
 
 /* ----------------------------------------------------------------------- */
@@ -942,15 +1004,13 @@ uint_t NurbsCurve2D::findSpan(real_t u) const {
     return PGL::findSpan(u,__degree,__knotList);
 }
 
-Vector2 NurbsCurve2D::getPointAt(real_t u) const{
-  GEOM_ASSERT( (getFirstKnot() -u ) < GEOM_EPSILON &&  !((u - getLastKnot()) > GEOM_EPSILON));
-
-  uint_t span = findSpan(u);
-  RealArrayPtr _basisFunctions = basisFunctions(span,u,__degree,__knotList);
+/// Combine the control points of \b span with the basis values \b N.
+static inline Vector2 nurbsCurve2DPoint(const Point3ArrayPtr& ctrlPoints, uint_t degree,
+                                        uint_t span, const real_t * N){
   Vector3 Cw(0.0,0.0,0.0);
-  for (uint_t j = 0; j <= __degree; j++) {
-      Vector3 Pj = __ctrlPointList->getAt( span - __degree + j ).ztoxy();
-      Cw += Pj * _basisFunctions->getAt(j);
+  for (uint_t j = 0; j <= degree; j++) {
+      Vector3 Pj = ctrlPoints->getAt( span - degree + j ).ztoxy();
+      Cw += Pj * N[j];
   }
 
   if (fabs(Cw.z()) < GEOM_TOLERANCE)
@@ -959,6 +1019,29 @@ Vector2 NurbsCurve2D::getPointAt(real_t u) const{
   return Cw.project();
 }
 
+Vector2 NurbsCurve2D::getPointAt(real_t u) const{
+  GEOM_ASSERT( (getFirstKnot() -u ) < GEOM_EPSILON &&  !((u - getLastKnot()) > GEOM_EPSILON));
+
+  uint_t span = findSpan(u);
+  real_t * N = (real_t *)alloca((__degree+1)*sizeof(real_t));
+  basisFunctions(span,u,__degree,__knotList,N);
+  return nurbsCurve2DPoint(__ctrlPointList, __degree, span, N);
+}
+
+Point2ArrayPtr NurbsCurve2D::evaluate(const RealArrayPtr& u) const{
+  GEOM_ASSERT(u);
+  Point2ArrayPtr result(new Point2Array(u->size()));
+  real_t * N = (real_t *)alloca((__degree+1)*sizeof(real_t));
+  uint_t span = __degree;
+  Point2Array::iterator _itResult = result->begin();
+  for (RealArray::const_iterator _itU = u->begin(); _itU != u->end(); ++_itU, ++_itResult){
+      span = PGL::findSpan(*_itU,__degree,__knotList,span);
+      basisFunctions(span,*_itU,__degree,__knotList,N);
+      *_itResult = nurbsCurve2DPoint(__ctrlPointList, __degree, span, N);
+  }
+  return result;
+}
+
 /* Algo A2.3 p72 Nurbs Book */
 RealArray2Ptr NurbsCurve2D::computeDerivatesBasisFunctions(int n,real_t u, int span ) const {
     return derivatesBasisFunctions(n,u,span,__degree,__knotList);
@@ -967,12 +1050,13 @@ RealArray2Ptr NurbsCurve2D::computeDerivatesBasisFunctions(int n,real_t u, int s
 Point3ArrayPtr  NurbsCurve2D::deriveAtH(real_t u, int d, int span ) const {
     int du = ( d < (int)__degree ? d : __degree);
     Point3ArrayPtr ders(new Point3Array(d+1));
-    RealArray2Ptr derF = computeDerivatesBasisFunctions(du,u,span) ;
+    real_t * derF = (real_t *)alloca((du+1)*(__degree+1)*sizeof(real_t));
+    derivatesBasisFunctions(du,u,span,__degree,__knotList,derF) ;
 
     for(int k=du;k>=0;--k){
         ders->setAt(k,Vector3(0,0,0)) ;
         for(int j=__degree;j>=0;--j){
-            ders->setAt(k, ders->getAt(k) + __ctrlPointList->getAt(span-__degree+j).ztoxy()*derF->getAt(k,j)) ;
+            ders->setAt(k, ders->getAt(k) + __ctrlPointList->getAt(span-__degree+j).ztoxy()*derF[k*(__degree+1)+j]) ;
         }
     }
     return ders;
@@ -180,6 +180,12 @@ public:
   */
   virtual Vector3 getPointAt(real_t u) const;
 
+  /*!
+     Compute the points on the NURBS for all the parameters in \b u.
+     Knot spans are reused between neighbouring parameters.
+  */
+  Point3ArrayPtr evaluate(const RealArrayPtr& u) const;
+
   /* Returns the \e Tangent for u = \e u.
       (see the Nurbs book p.12)
      \pre
@@ -407,6 +413,12 @@ public:
   */
   virtual Vector2 getPointAt(real_t u) const;
 
+  /*!
+     Compute the points on the NURBS for all the parameters in \b u.
+     Knot spans are reused between neighbouring parameters.
+  */
+  Point2ArrayPtr evaluate(const RealArrayPtr& u) const;
+
   /* Returns the \e Tangent for u = \e u.
       (see the Nurbs book p.12)
      \pre
@@ -438,6 +450,12 @@ typedef RCPtr<NurbsCurve2D> NurbsCurve2DPtr;
 uint_t SG_API findSpan(real_t u,  uint_t _degree,
         const RealArrayPtr& _knotList);
 
+/*! Determine the knot Span index, testing first the span \b hint
+    and the one following it before falling back to a binary search.
+*/
+uint_t SG_API findSpan(real_t u,  uint_t _degree,
+        const RealArrayPtr& _knotList, uint_t hint);
+
 /*! \brief Compute the Basis Functions Values
   Algo 2.2 From The Nurbs Book p70
 */
@@ -445,6 +463,14 @@ RealArrayPtr SG_API basisFunctions(uint_t span, real_t u,
                    uint_t _degree,
                    const RealArrayPtr& _knotList );
 
+/*! \brief Compute the Basis Functions Values into \b result
+  that must hold \b _degree + 1 values. No allocation is made.
+*/
+void SG_API basisFunctions(uint_t span, real_t u,
+                   uint_t _degree,
+                   const RealArrayPtr& _knotList,
+                   real_t * result );
+
 /*!
   \brief Compute the Derivates Basis Functions Values
   Algo A2.3 p72 Nurbs Book
@@ -455,6 +481,17 @@ RealArray2Ptr SG_API derivatesBasisFunctions(int n, real_t u,
                       uint_t _degree,
                       const RealArrayPtr& _knotList );
 
+/*!
+  \brief Compute the Derivates Basis Functions Values into \b result,
+  stored row by row as a (n+1) x (_degree+1) matrix. Workspace is
+  taken on the stack.
+*/
+void SG_API derivatesBasisFunctions(int n, real_t u,
+                      int span,
+                      uint_t _degree,
+                      const RealArrayPtr& _knotList,
+                      real_t * result );
+
 /* ----------------------------------------------------------------------- */
 
 PGL_END_NAMESPACE
@@ -51,6 +51,10 @@
 #include <plantgl/tool/util_array.h>
 #include <plantgl/scenegraph/container/pointmatrix.h>
 #include <plantgl/scenegraph/container/pointarray.h>
+#ifdef _WIN32
+#include <malloc.h>
+#define alloca _alloca
+#endif
 //#include <iostream>
 
 PGL_USING_NAMESPACE
@@ -425,20 +429,22 @@ Point4MatrixPtr  NurbsPatch::deriveAtH(real_t u, real_t v, int d, int uspan, int
     int dv = ( d < (int)__vdegree ? d : __vdegree);
 
     Point4MatrixPtr patchders(new Point4Matrix(d+1,d+1, Vector4::ORIGIN));
-    RealArray2Ptr UderF = derivatesBasisFunctions(du,u,uspan,__udegree,__uKnotList);
-    RealArray2Ptr VderF = derivatesBasisFunctions(dv,v,vspan,__vdegree,__vKnotList);
+    real_t * UderF = (real_t *)alloca(((du+1)*(__udegree+1)+(dv+1)*(__vdegree+1))*sizeof(real_t));
+    real_t * VderF = UderF + (du+1)*(__udegree+1);
+    derivatesBasisFunctions(du,u,uspan,__udegree,__uKnotList,UderF);
+    derivatesBasisFunctions(dv,v,vspan,__vdegree,__vKnotList,VderF);
 
     for(int k=0;k<=du;++k){
         Point4Array temp(__vdegree+1, Vector4::ORIGIN) ;
         for(int s=0;s<=__vdegree;++s){
             for(int r=0;r<=__udegree;++r){
-                temp[s] +=  UderF->getAt(k,r)*__ctrlPointMatrix->getAt(uspan-__udegree+r,vspan-__vdegree+s).wtoxyz() ;
+                temp[s] +=  UderF[k*(__udegree+1)+r]*__ctrlPointMatrix->getAt(uspan-__udegree+r,vspan-__vdegree+s).wtoxyz() ;
             }
         }
         int dd = ( (d-k) < dv ? (d-k) : dv); //min(d-k,dv) ;
         for(int r=0;r<=dd;++r){
             for(int s=0;s<=__vdegree;++s){
-                patchders->getAt(k,r) += VderF->getAt(r,s)*temp[s] ;  
+                patchders->getAt(k,r) += VderF[r*(__vdegree+1)+s]*temp[s] ;  
             }
         }
     }
@@ -514,10 +520,12 @@ Point3MatrixPtr NurbsPatch::getDerivativesAt(real_t u,real_t v) const {
 Vector3 NurbsPatch::getPointAt(real_t u, real_t v) const{
   GEOM_ASSERT( u >= getFirstUKnot() && u <= getLastUKnot() && v>= getFirstVKnot() && v<= getLastVKnot());
 
+  real_t * Nu = (real_t *)alloca((__udegree+__vdegree+2)*sizeof(real_t));
+  real_t * Nv = Nu + __udegree + 1;
   uint_t uspan = findSpan(u,__udegree,__uKnotList);
-  RealArrayPtr Nu = basisFunctions(uspan, u, __udegree, __uKnotList);
+  basisFunctions(uspan, u, __udegree, __uKnotList, Nu);
   uint_t vspan = findSpan(v,__vdegree,__vKnotList);
-  RealArrayPtr Nv = basisFunctions(vspan, v, __vdegree, __vKnotList);
+  basisFunctions(vspan, v, __vdegree, __vKnotList, Nv);
   Vector4 Sw( 0 , 0 , 0 ,0 );
 
   uint_t uind = uspan - __udegree;
@@ -533,20 +541,67 @@ Vector3 NurbsPatch::getPointAt(real_t u, real_t v) const{
              NurbsPatch.getPointAt which is  coherent.
            */
           Vector4 ipt = __ctrlPointMatrix->getAt(uind+k,vind).wtoxyz();
-          temp += (ipt *  (Nu->getAt(k))) ;
+          temp += (ipt *  Nu[k]) ;
 
       }
-      Sw += temp * Nv->getAt(l);
+      Sw += temp * Nv[l];
   }
 
-
-
   if (fabs(Sw.w()) < GEOM_TOLERANCE)
     return Vector3(Sw.x(),Sw.y(),Sw.z());
 
   return Sw.project();
 }
 
+Point3ArrayPtr NurbsPatch::evaluate(const RealArrayPtr& u, const RealArrayPtr& v) const{
+  GEOM_ASSERT(u && v);
+  const uint_t nbU = u->size();
+  const uint_t nbV = v->size();
+  const uint_t up1 = __udegree + 1;
+  const uint_t vp1 = __vdegree + 1;
+  Point3ArrayPtr result(new Point3Array(nbU * nbV));
+  if (nbU == 0 || nbV == 0) return result;
+
+  // V spans and basis values are shared by all the rows of the grid.
+  std::vector<uint_t> vspans(nbV);
+  std::vector<real_t> Nv(nbV * vp1);
+  uint_t vspan = __vdegree;
+  for (uint_t j = 0; j < nbV; ++j){
+      vspan = PGL::findSpan(v->getAt(j),__vdegree,__vKnotList,vspan);
+      vspans[j] = vspan;
+      basisFunctions(vspan, v->getAt(j), __vdegree, __vKnotList, &Nv[j*vp1]);
+  }
+
+  // For each u, control points are first combined along u (the inner
+  // sum of getPointAt) for every v index, then reused for all the v.
+  const uint_t vdim = __ctrlPointMatrix->getColumnNb();
+  std::vector<Vector4> uCombined(vdim);
+  real_t * Nu = (real_t *)alloca(up1*sizeof(real_t));
+  uint_t uspan = __udegree;
+  Point3Array::iterator _itResult = result->begin();
+  for (uint_t i = 0; i < nbU; ++i){
+      uspan = PGL::findSpan(u->getAt(i),__udegree,__uKnotList,uspan);
+      basisFunctions(uspan, u->getAt(i), __udegree, __uKnotList, Nu);
+      uint_t uind = uspan - __udegree;
+      for (uint_t vind = 0; vind < vdim; ++vind){
+          Vector4 temp( 0 , 0 , 0 ,0 );
+          for (uint_t k = 0 ; k < up1 ; k++ )
+              temp += (__ctrlPointMatrix->getAt(uind+k,vind).wtoxyz() * Nu[k]);
+          uCombined[vind] = temp;
+      }
+      for (uint_t j = 0; j < nbV; ++j, ++_itResult){
+          const real_t * _Nv = &Nv[j*vp1];
+          uint_t vind = vspans[j] - __vdegree;
+          Vector4 Sw( 0 , 0 , 0 ,0 );
+          for (uint_t l = 0 ; l < vp1 ; l++ )
+              Sw += uCombined[vind+l] * _Nv[l];
+          if (fabs(Sw.w()) < GEOM_TOLERANCE) *_itResult = Vector3(Sw.x(),Sw.y(),Sw.z());
+          else *_itResult = Sw.project();
+      }
+  }
+  return result;
+}
+
 
 Vector3 NurbsPatch::getUTangentAt(real_t u, real_t v) const {
     GEOM_ASSERT( u >= getFirstUKnot( ) && u <= getLastUKnot( ) && v>= getFirstVKnot( ) && v<=getLastVKnot( ));
@@ -577,7 +632,8 @@ LineicModelPtr NurbsPatch::getIsoUSectionAt(real_t u) const
   GEOM_ASSERT( u >= getFirstUKnot( ) && u <= getLastUKnot( ) );
 
   uint_t uspan = findSpan(u,__udegree,__uKnotList);
-  RealArrayPtr Nu = basisFunctions(uspan, u, __udegree, __uKnotList);
+  real_t * Nu = (real_t *)alloca((__udegree+1)*sizeof(real_t));
+  basisFunctions(uspan, u, __udegree, __uKnotList, Nu);
   uint_t vdim = __ctrlPointMatrix->getColumnNb();
   Point4ArrayPtr temp(new Point4Array(vdim));
   uint_t uind = uspan - __udegree;
@@ -586,7 +642,7 @@ LineicModelPtr NurbsPatch::getIsoUSectionAt(real_t u) const
       Vector4 vec;
       for (uint_t k = 0 ; k <= __udegree ; k++ ){
          Vector4 pk = __ctrlPointMatrix->getAt(uind +k,l).wtoxyz();
-         vec += pk *  (Nu->getAt(k)) ;
+         vec += pk *  Nu[k] ;
       }
       vec.x() /= vec.w();
       vec.y() /= vec.w();
@@ -601,13 +657,14 @@ LineicModelPtr NurbsPatch::getIsoVSectionAt(real_t v) const
   GEOM_ASSERT(  v>= getFirstVKnot( ) && v<=getLastVKnot( ) );
 
   uint_t vspan = findSpan(v,__vdegree,__vKnotList);
-  RealArrayPtr Nv = basisFunctions(vspan, v, __vdegree, __vKnotList);
+  real_t * Nv = (real_t *)alloca((__vdegree+1)*sizeof(real_t));
+  basisFunctions(vspan, v, __vdegree, __vKnotList, Nv);
   uint_t udim = __ctrlPointMatrix->getRowNb();
   Point4ArrayPtr temp(new Point4Array(udim));
   for (uint_t l = 0 ; l < udim ; l++ ){
       Vector4 vec;
       for (uint_t k = 0 ; k <= __vdegree ; k++ )
-          vec += (__ctrlPointMatrix->getAt(l,vspan - __vdegree +k).wtoxyz() *  (Nv->getAt(k))) ;
+          vec += (__ctrlPointMatrix->getAt(l,vspan - __vdegree +k).wtoxyz() *  Nv[k]) ;
       vec.x() /= vec.w();
       vec.y() /= vec.w();
       vec.z() /= vec.w();
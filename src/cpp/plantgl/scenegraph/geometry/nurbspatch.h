@@ -220,6 +220,11 @@ public:
       - \e v must be in [0,1];*/
   virtual Vector3 getPointAt(real_t u,real_t v) const;
 
+  /*! Returns the grid of \e Points for all the parameters in \e u and \e v.
+      Point (u[i],v[j]) is stored at index i * v.size() + j. Knot spans and
+      basis values are reused between neighbouring samples. */
+  Point3ArrayPtr evaluate(const RealArrayPtr& u, const RealArrayPtr& v) const;
+
   /* Returns the \e Metric for  u = \e u and v = \e v.
       (see Differential Geometry, Kreyszig p. 82)
      \author Michael Walker
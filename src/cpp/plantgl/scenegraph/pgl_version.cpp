@@ -126,6 +126,9 @@ std::vector<std::string> __getPGLSupportedExtensions() {
 #endif
 #ifdef PGL_WITHOUT_QT
     ADD_EXTENSION(PGL_NO_QT_GUI)
+#endif
+#ifdef PGL_WITH_PROFILE
+    ADD_EXTENSION(PROFILE)
 #endif
    return res;
 }
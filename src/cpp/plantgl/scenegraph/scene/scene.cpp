@@ -52,6 +52,9 @@
 #include <plantgl/tool/bfstream.h>
 #include <plantgl/tool/dirnames.h>
 #include <plantgl/tool/util_mutex.h>
+#include <plantgl/tool/util_taskscheduler.h>
+#include <plantgl/tool/util_profile.h>
+#include <memory>
 
 #include <algorithm>
 
@@ -79,8 +82,9 @@ Scene::Scene(unsigned int size ) :
 #ifdef PGL_THREAD_SUPPORT
    __mutex = new PglMutex();
 #endif
+  __registered = false;
 #ifdef WITH_POOL
-      POOL.registerScene(this);
+  if (POOL.isAutoRegistration()) registerInPool();
 #endif
   GEOM_ASSERT(isValid());
 }
@@ -91,8 +95,9 @@ Scene::Scene(const Scene& scene) :
 #ifdef PGL_THREAD_SUPPORT
    __mutex = new PglMutex();
 #endif
+  __registered = false;
 #ifdef WITH_POOL
-      POOL.registerScene(this);
+  if (POOL.isAutoRegistration()) registerInPool();
 #endif
   scene.lock();
   __shapeList = std::vector<Shape3DPtr>(scene.__shapeList);
@@ -106,8 +111,9 @@ Scene::Scene(const Scene::const_iterator begin, const Scene::const_iterator end)
 #ifdef PGL_THREAD_SUPPORT
    __mutex = new PglMutex();
 #endif
+  __registered = false;
 #ifdef WITH_POOL
-      POOL.registerScene(this);
+  if (POOL.isAutoRegistration()) registerInPool();
 #endif
   __shapeList = std::vector<Shape3DPtr>(begin, end);
   GEOM_ASSERT(isValid());
@@ -130,8 +136,9 @@ Scene::Scene(const string& filename, const std::string& format, ostream& errlog,
 #ifdef PGL_THREAD_SUPPORT
    __mutex = new PglMutex();
 #endif
+  __registered = false;
 #ifdef WITH_POOL
-      POOL.registerScene(this);
+  if (POOL.isAutoRegistration()) registerInPool();
 #endif
     read(filename,format,errlog,max_error);
     GEOM_ASSERT(isValid());
@@ -144,8 +151,9 @@ Scene::Scene(const SceneObjectSymbolTable& table) :
 #ifdef PGL_THREAD_SUPPORT
    __mutex = new PglMutex();
 #endif
+  __registered = false;
 #ifdef WITH_POOL
-      POOL.registerScene(this);
+  if (POOL.isAutoRegistration()) registerInPool();
 #endif
   convert(table);
   GEOM_ASSERT(isValid());
@@ -200,7 +208,7 @@ void Scene::convert( const SceneObjectSymbolTable& table ){
 
 Scene::~Scene( ){
 #ifdef WITH_POOL
-      POOL.unregisterScene(this);
+  if (__registered) POOL.unregisterScene(this);
 #endif
 #ifdef PGL_THREAD_SUPPORT
     if (__mutex)delete __mutex;
@@ -253,6 +261,18 @@ void Scene::add( const Shape3DPtr& shape ) {
   unlock();
 }
 
+void Scene::add( const std::vector<Shape3DPtr>& shapes ) {
+  lock();
+  __shapeList.insert(__shapeList.end(),shapes.begin(),shapes.end());
+  unlock();
+}
+
+void Scene::reserve( uint_t size ) {
+  lock();
+  __shapeList.reserve(size);
+  unlock();
+}
+
   /** Remove a shape to the \e self
       \pre
       - shape must be non null and valid. */
@@ -278,6 +298,7 @@ void Scene::erase( Scene::iterator it )
 /* ----------------------------------------------------------------------- */
 
 bool Scene::apply( Action& action ) {
+  PGL_PROFILE_ZONE("Scene::apply");
   bool _result;
   if( ! (_result = action.beginProcess()))return false;
   lock();
@@ -346,6 +367,60 @@ bool Scene::applyAppearanceOnly( Action& action ) {
   return _result;
 }
 
+/* ----------------------------------------------------------------------- */
+
+ParallelAction::~ParallelAction( ) {
+}
+
+template<bool GeometryOnly>
+static bool applyOnRanges( const vector<Shape3DPtr>& shapes, ParallelAction& paction, uint_t grainsize ) {
+  size_t nbshapes = shapes.size();
+  if (nbshapes == 0) return true;
+  if (grainsize == 0) grainsize = std::max<size_t>(1, nbshapes / (4 * (TaskScheduler::get().nbThreads() + 1)));
+  size_t nbranges = (nbshapes + grainsize - 1) / grainsize;
+
+  // actions are created by the calling thread since createAction is not required to be thread safe.
+  vector<std::unique_ptr<Action> > actions(nbranges);
+  for (size_t r = 0; r < nbranges; ++r) actions[r].reset(paction.createAction());
+  vector<uchar_t> results(nbranges, 1);
+
+  parallel_for(0, nbranges, [&](size_t r) {
+    Action& action = *actions[r];
+    if (!action.beginProcess()) { results[r] = 0; return; }
+    size_t end = std::min<size_t>(nbshapes, (r + 1) * grainsize);
+    for (size_t i = r * grainsize; i < end; ++i)
+      if (! (GeometryOnly ? shapes[i]->applyGeometryOnly(action) : shapes[i]->apply(action))) results[r] = 0;
+    action.endProcess();
+  }, 1);
+
+  bool _result = true;
+  for (size_t r = 0; r < nbranges; ++r) {
+    if (!results[r]) _result = false;
+    if (!paction.reduce(*actions[r])) _result = false;
+  }
+  return _result;
+}
+
+bool Scene::applyParallel( ParallelAction& action, uint_t grainsize ) {
+  PGL_PROFILE_ZONE("Scene::applyParallel");
+  lock();
+  bool _result;
+  try { _result = applyOnRanges<false>(__shapeList, action, grainsize); }
+  catch(...) { unlock(); throw; }
+  unlock();
+  return _result;
+}
+
+bool Scene::applyGeometryOnlyParallel( ParallelAction& action, uint_t grainsize ) {
+  PGL_PROFILE_ZONE("Scene::applyGeometryOnlyParallel");
+  lock();
+  bool _result;
+  try { _result = applyOnRanges<true>(__shapeList, action, grainsize); }
+  catch(...) { unlock(); throw; }
+  unlock();
+  return _result;
+}
+
 /* ----------------------------------------------------------------------- */
 uint_t Scene::size( ) const {
   lock();
@@ -480,6 +555,30 @@ void Scene::merge( const ScenePtr& scene ) {
   unlock();
 }
 
+void Scene::merge( std::vector<Shape3DPtr>&& shapes ) {
+  lock();
+  if (__shapeList.empty()) __shapeList.swap(shapes);
+  else __shapeList.insert(__shapeList.end(),std::make_move_iterator(shapes.begin()),std::make_move_iterator(shapes.end()));
+  unlock();
+  shapes.clear();
+}
+
+void Scene::mergeAndClear( const ScenePtr& scene ) {
+  GEOM_ASSERT((scene) && scene.get() != this);
+  std::vector<Shape3DPtr> shapes;
+  scene->lock();
+  shapes.swap(scene->__shapeList);
+  scene->unlock();
+  merge(std::move(shapes));
+}
+
+void Scene::registerInPool( ) {
+  if (!__registered) {
+    POOL.registerScene(this);
+    __registered = true;
+  }
+}
+
 /* ----------------------------------------------------------------------- */
 struct shapecmp{
     bool operator()(const Shape3DPtr& a, const Shape3DPtr& b)
@@ -556,7 +655,8 @@ void Scene::Pool::unregisterScene(const Scene * s)
   unlock();
 }
 
-Scene::Pool::Pool() {
+Scene::Pool::Pool() :
+  __autoRegistration(false) {
 #ifdef PGL_THREAD_SUPPORT
    __mutex = new PglMutex();
 #endif
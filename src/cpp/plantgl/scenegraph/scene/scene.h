@@ -50,6 +50,7 @@
 /* ----------------------------------------------------------------------- */
 
 #include <vector>
+#include <atomic>
 #include <plantgl/tool/util_hashmap.h>
 #include "plantgl/scenegraph/core/sceneobject.h"
 #include "shape.h"
@@ -69,6 +70,30 @@ class Scene;
 typedef RCPtr<Scene> ScenePtr;
 
 
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class ParallelAction
+   \brief Describes how to apply an Action on a Scene with several threads.
+
+   Each worker visits a range of shapes with its own action created by
+   createAction(). The per shape results should thus be accumulated by
+   the action itself. Once all ranges are processed, the actions are
+   given to reduce() in the order of the shapes.
+*/
+
+class SG_API ParallelAction
+{
+public:
+  virtual ~ParallelAction( );
+
+  /// Creates the action used by a worker. It is deleted after reduce.
+  virtual Action * createAction( ) = 0;
+
+  /// Merges the results of the action of a worker into \e self. Called sequentially.
+  virtual bool reduce( Action& action ) = 0;
+};
+
 /* ----------------------------------------------------------------------- */
 
 /**
@@ -138,6 +163,12 @@ public:
   // compatibility with stl
   inline void push_back( const Shape3DPtr& shape ) { add(shape); }
 
+  /// Adds a batch of shapes to \e self with a single lock.
+  void add( const std::vector<Shape3DPtr>& shapes );
+
+  /// Reserves memory for \e size shapes.
+  void reserve( uint_t size );
+
   /** Remove a shape to the \e self
       \pre
       - shape must be non null and valid. */
@@ -175,6 +206,14 @@ public:
       part is skipped. */
   bool applyAppearanceOnly( Action& action );
 
+  /** Applies in parallel the actions created by \e action to disjoint ranges
+      of shapes of \e self. Ranges contain \e grainsize shapes (0 for automatic). */
+  bool applyParallel( ParallelAction& action, uint_t grainsize = 0 );
+
+  /** Applies in parallel the actions created by \e action to the Geometry part
+      of disjoint ranges of shapes of \e self. */
+  bool applyGeometryOnlyParallel( ParallelAction& action, uint_t grainsize = 0 );
+
   /// Clears \e self.
   void clear( );
 
@@ -227,6 +266,20 @@ public:
       - \e subScene must be valid. */
   void merge( const ScenePtr& subScene );
 
+  /** Moves the shapes of \e shapes at the end of \e self with a single lock.
+      \e shapes is left empty. */
+  void merge( std::vector<Shape3DPtr>&& shapes );
+
+  /** Moves the shapes of \e subScene at the end of \e self. \e subScene is left empty. */
+  void mergeAndClear( const ScenePtr& subScene );
+
+  /** Registers \e self in the scene pool. Scenes are registered only on demand
+      or if the automatic registration of the pool is enabled. */
+  void registerInPool( );
+
+  /// Returns whether \e self is registered in the scene pool.
+  bool isRegisteredInPool( ) const { return __registered; }
+
   void lock() const ;
   void unlock() const;
 
@@ -259,6 +312,8 @@ protected:
 
   PglMutex* __mutex;
 
+  bool __registered;
+
 public:
 
     /// A Scene Pool class
@@ -273,6 +328,10 @@ public:
         // get all scene
         std::vector<ScenePtr> getScenes() const;
 
+        /// If enabled, all scenes are registered at construction. Disabled by default.
+        void setAutoRegistration(bool enabled) { __autoRegistration = enabled; }
+        bool isAutoRegistration() const { return __autoRegistration; }
+
     protected:
         void registerScene(Scene *);
         void unregisterScene(const Scene *);
@@ -283,6 +342,7 @@ public:
 
         PoolList __pool;
         PglMutex* __mutex;
+        std::atomic<bool> __autoRegistration;
     };
 
     // Singleton access
@@ -296,6 +356,38 @@ private:
 /// Scene Pointer
 typedef RCPtr<Scene> ScenePtr;
 
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class SceneBuilder
+   \brief Accumulates shapes without locking and publishes them in a Scene in one step.
+*/
+
+class SG_API SceneBuilder
+{
+public:
+  SceneBuilder( uint_t reserve = 0 ) { __shapeList.reserve(reserve); }
+
+  void reserve( uint_t size ) { __shapeList.reserve(size); }
+
+  void add( const Shape3DPtr& shape ) { __shapeList.push_back(shape); }
+  inline void push_back( const Shape3DPtr& shape ) { __shapeList.push_back(shape); }
+
+  void add( const ScenePtr& scene ) { __shapeList.insert(__shapeList.end(), scene->begin(), scene->end()); }
+
+  uint_t size( ) const { return __shapeList.size(); }
+  bool empty( ) const { return __shapeList.empty(); }
+
+  /// Moves the shapes at the end of \e scene with a single lock. The builder is left empty.
+  void publish( const ScenePtr& scene ) { scene->merge(std::move(__shapeList)); }
+
+  /// Returns a new scene containing the shapes. The builder is left empty.
+  ScenePtr build( ) { ScenePtr result(new Scene()); publish(result); return result; }
+
+protected:
+  std::vector<Shape3DPtr> __shapeList;
+};
+
 
 /* ----------------------------------------------------------------------- */
 
@@ -46,6 +46,7 @@
 #include <vector>
 #include <plantgl/tool/rcobject.h>
 #include <plantgl/tool/errormsg.h>
+#include <plantgl/tool/util_hashmap.h>
 
 
 PGL_BEGIN_NAMESPACE
@@ -183,6 +184,104 @@ public:
 
 };
 
+/// Iterator on the values of a map.
+template<class MapIterator, class T>
+struct mapped_value_iteratorT {
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef T& reference;
+
+    mapped_value_iteratorT() {}
+    mapped_value_iteratorT(MapIterator it) : __it(it) {}
+
+    inline T& operator*( ) const { return __it->second; }
+    inline T * operator->( ) const { return &(__it->second); }
+
+    inline mapped_value_iteratorT& operator++() { ++__it; return *this; }
+    inline mapped_value_iteratorT operator++(int) { mapped_value_iteratorT t = *this; ++__it; return t; }
+
+    inline bool operator==(const mapped_value_iteratorT& other) const { return __it == other.__it; }
+    inline bool operator!=(const mapped_value_iteratorT& other) const { return __it != other.__it; }
+
+protected:
+    MapIterator __it;
+};
+
+/**
+    A sparse container that only stores the non default cells in a hash map.
+    Reading a missing cell returns a default value. Writing it creates it.
+    Iteration is done only on the stored cells, in no particular order.
+*/
+template<class T, class EmptyPolicy = IsEmptyPolicy<T> >
+class HashContainer {
+public:
+
+  typedef T element_type;
+  typedef size_t CellId;
+  typedef pgl_hash_map<CellId, T> container_type;
+  typedef mapped_value_iteratorT<typename container_type::iterator, T> iterator;
+  typedef mapped_value_iteratorT<typename container_type::const_iterator, const T> const_iterator;
+protected:
+
+    HashContainer(size_t size = 0) : __values(), __size(size) {}
+
+    // The stored cells
+    container_type __values;
+    // The number of cells, stored or not
+    size_t __size;
+
+    static const T& default_value() { static const T value = T(); return value; }
+
+public:
+
+  inline const element_type& getAt(const CellId& cid) const
+    { typename container_type::const_iterator it = __values.find(cid);
+      return it == __values.end() ? default_value() : it->second; }
+
+  inline element_type& getAt(const CellId& cid)
+    { return __values[cid]; }
+
+    inline void setAt(const CellId& cid, const element_type& value)
+    { __values[cid] = value; }
+
+    inline bool is_empty(const CellId& cid) const
+    { typename container_type::const_iterator it = __values.find(cid);
+      return it == __values.end() || EmptyPolicy::is_empty(it->second); }
+
+    /// Return the number of cells, stored or not
+  inline size_t valuesize() const { return __size; }
+
+    /// Return the number of stored cells
+  inline size_t nbStoredCells() const { return __values.size(); }
+
+    /// Returns whether \e self is empty.
+    inline bool empty( ) const { return __size == 0; }
+
+    /// Returns a const iterator at the beginning of the stored cells.
+    inline const_iterator begin( ) const { return const_iterator(__values.begin()); }
+
+    /// Returns an iterator at the beginning of the stored cells.
+    inline iterator begin( ) { return iterator(__values.begin()); }
+
+    /// Returns a const iterator at the end of the stored cells.
+    inline const_iterator end( ) const { return const_iterator(__values.end()); }
+
+    /// Returns an iterator at the end of the stored cells.
+    inline iterator end( ) { return iterator(__values.end()); }
+
+    /// Clear \e self.
+    inline void clear( ) { __values.clear(); __size = 0; }
+
+    void initialize(const size_t size) {
+    __values.clear();
+    __size = size;
+  }
+
+};
+
 template <int N>
 class ArrayNIndexing {
 public:
@@ -0,0 +1,169 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+
+
+/* ----------------------------------------------------------------------- */
+
+#include "util_mappedfile.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* ----------------------------------------------------------------------- */
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+MappedFile::MappedFile(const std::string& fname) : __begin(NULL), __size(0)
+#ifdef _WIN32
+    , __file(INVALID_HANDLE_VALUE), __mapping(NULL)
+#endif
+{
+#ifdef _WIN32
+    __file = CreateFileA(fname.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (__file == INVALID_HANDLE_VALUE) throw std::runtime_error("Could not open file: " + fname);
+    LARGE_INTEGER size;
+    GetFileSizeEx((HANDLE)__file, &size);
+    __size = (size_t)size.QuadPart;
+    if (__size > 0) {
+        __mapping = CreateFileMappingA((HANDLE)__file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (__mapping) __begin = (const char *)MapViewOfFile((HANDLE)__mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+#else
+    int fd = open(fname.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Could not open file: " + fname);
+    struct stat st;
+    if (fstat(fd, &st) == 0) __size = (size_t)st.st_size;
+    if (__size > 0) {
+        void * data = mmap(NULL, __size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) __begin = (const char *)data;
+    }
+    close(fd);
+#endif
+    if (!__begin) {
+        release();
+        throw std::runtime_error("Could not map file: " + fname);
+    }
+}
+
+MappedFile::~MappedFile() { release(); }
+
+void MappedFile::release()
+{
+#ifdef _WIN32
+    if (__begin) UnmapViewOfFile(__begin);
+    if (__mapping) CloseHandle((HANDLE)__mapping);
+    if (__file != INVALID_HANDLE_VALUE) CloseHandle((HANDLE)__file);
+    __mapping = NULL; __file = INVALID_HANDLE_VALUE;
+#else
+    if (__begin) munmap((void *)__begin, __size);
+#endif
+    __begin = NULL;
+}
+
+/* ----------------------------------------------------------------------- */
+
+mappedfistream::MemoryBuffer::MemoryBuffer(const char * begin, const char * end)
+{
+    // The get area is never written to.
+    setg(const_cast<char *>(begin), const_cast<char *>(begin), const_cast<char *>(end));
+}
+
+const char * mappedfistream::MemoryBuffer::consume(size_t size)
+{
+    if (size > size_t(egptr() - gptr())) return NULL;
+    const char * result = gptr();
+    setg(eback(), gptr() + size, egptr());
+    return result;
+}
+
+std::streambuf::pos_type
+mappedfistream::MemoryBuffer::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    if (!(which & std::ios_base::in)) return pos_type(off_type(-1));
+    char * base = gptr();
+    if (dir == std::ios_base::beg) base = eback();
+    else if (dir == std::ios_base::end) base = egptr();
+    if (off < eback() - base || off > egptr() - base) return pos_type(off_type(-1));
+    setg(eback(), base + off, egptr());
+    return pos_type(off_type(gptr() - eback()));
+}
+
+std::streambuf::pos_type
+mappedfistream::MemoryBuffer::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+/* ----------------------------------------------------------------------- */
+
+mappedfistream::mappedfistream( const std::string& file_name, PglByteOrder byteorder ) :
+    fistream(__mstream, byteorder),
+    __file(file_name),
+    __buffer(__file.begin(), __file.end()),
+    __mstream(&__buffer)
+{
+}
+
+mappedfistream::~mappedfistream() { }
+
+const char * mappedfistream::consume( size_t size )
+{
+    if (!__mstream) return NULL;
+    const char * result = __buffer.consume(size);
+    if (!result) __mstream.setstate(std::ios_base::eofbit | std::ios_base::failbit);
+    return result;
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,134 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+
+
+#ifndef __util_mappedfile_h__
+#define __util_mappedfile_h__
+
+/*! \file util_mappedfile.h
+    \brief Read-only memory mapping of files and binary stream on top of it.
+*/
+
+/* ----------------------------------------------------------------------- */
+
+#include "tools_config.h"
+#include "bfstream.h"
+#include <streambuf>
+#include <istream>
+#include <string>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class MappedFile
+   \brief Read-only memory mapping of a whole file.
+   Throws std::runtime_error if the file cannot be opened, is empty or cannot be mapped.
+*/
+class TOOLS_API MappedFile {
+public:
+    MappedFile(const std::string& fname);
+    ~MappedFile();
+
+    const char * begin() const { return __begin; }
+    const char * end() const { return __begin + __size; }
+    size_t size() const { return __size; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    void release();
+
+    const char * __begin;
+    size_t __size;
+#ifdef _WIN32
+    void * __file;
+    void * __mapping;
+#endif
+};
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class mappedfistream
+   \brief A fistream reading a memory-mapped file.
+   Large chunks of data can be accessed in place with consume() instead of being copied.
+*/
+class TOOLS_API mappedfistream : public fistream
+{
+public:
+    mappedfistream( const std::string& file_name, PglByteOrder byteorder = PglBigEndian );
+
+    virtual ~mappedfistream();
+
+    /// Returns a pointer on the next \e size bytes and skips them, or NULL if fewer bytes remain.
+    const char * consume( size_t size );
+
+protected:
+    /// A read-only stream buffer on a memory area.
+    class MemoryBuffer : public std::streambuf {
+    public:
+        MemoryBuffer(const char * begin, const char * end);
+
+        const char * consume(size_t size);
+
+    protected:
+        virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which);
+        virtual pos_type seekpos(pos_type pos, std::ios_base::openmode which);
+    };
+
+    MappedFile __file;
+    MemoryBuffer __buffer;
+    std::istream __mstream;
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+#endif
@@ -0,0 +1,316 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+#include "util_profile.h"
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <algorithm>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+namespace profile {
+
+/* ----------------------------------------------------------------------- */
+
+namespace {
+
+struct ZoneEvent {
+    const char * name;
+    int64_t begin;
+    int64_t end;
+};
+
+struct CounterEvent {
+    const char * name;
+    int64_t time;
+    int64_t value;
+};
+
+/// The record of one thread. Its lock is only contended while a report is built.
+struct ThreadBuffer {
+    ThreadBuffer(uint32_t _id) : id(_id) {}
+
+    uint32_t id;
+    std::mutex mutex;
+    std::vector<ZoneEvent> zones;
+    std::vector<CounterEvent> counters;
+    std::vector<std::pair<const char *, int64_t> > totals;
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        zones.clear();
+        counters.clear();
+        totals.clear();
+    }
+};
+
+typedef std::chrono::steady_clock Clock;
+
+inline int64_t clockNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+struct Registry {
+    std::atomic<bool> recording;
+    /// Start of the record in nanoseconds since the clock epoch. Atomic since start() may run while zones are timed.
+    std::atomic<int64_t> origin;
+    std::mutex mutex;
+    // buffers outlive their threads so that the record of finished threads is kept.
+    std::vector<std::unique_ptr<ThreadBuffer> > buffers;
+
+    Registry() : recording(false), origin(clockNanoseconds()) {}
+};
+
+Registry& registry()
+{
+    static Registry * _registry = new Registry();
+    return *_registry;
+}
+
+ThreadBuffer& threadBuffer()
+{
+    static thread_local ThreadBuffer * _buffer = NULL;
+    if (!_buffer) {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.buffers.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer(uint32_t(reg.buffers.size()))));
+        _buffer = reg.buffers.back().get();
+    }
+    return *_buffer;
+}
+
+/// Escapes \e name for a JSON string.
+std::string jsonString(const char * name)
+{
+    std::string result("\"");
+    for (const char * c = name; *c; ++c) {
+        if (*c == '"' || *c == '\\') { result += '\\'; result += *c; }
+        else if ((unsigned char)*c < 0x20) result += ' ';
+        else result += *c;
+    }
+    result += '"';
+    return result;
+}
+
+}
+
+/* ----------------------------------------------------------------------- */
+
+void start()
+{
+    clear();
+    Registry& reg = registry();
+    reg.origin.store(clockNanoseconds(), std::memory_order_relaxed);
+    reg.recording.store(true, std::memory_order_release);
+}
+
+void stop()
+{
+    registry().recording.store(false, std::memory_order_release);
+}
+
+void clear()
+{
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& buffer : reg.buffers) buffer->clear();
+}
+
+bool isRecording()
+{
+    return registry().recording.load(std::memory_order_relaxed);
+}
+
+int64_t now()
+{
+    return clockNanoseconds() - registry().origin.load(std::memory_order_relaxed);
+}
+
+void count(const char * name, int64_t value)
+{
+    if (!isRecording()) return;
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    std::vector<std::pair<const char *, int64_t> >::iterator it = buffer.totals.begin();
+    while (it != buffer.totals.end() && it->first != name) ++it;
+    if (it == buffer.totals.end()) {
+        buffer.totals.push_back(std::pair<const char *, int64_t>(name, 0));
+        it = buffer.totals.end() - 1;
+    }
+    it->second += value;
+    CounterEvent event = { name, now(), it->second };
+    buffer.counters.push_back(event);
+}
+
+void record(const char * name, int64_t begin, int64_t end)
+{
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    ZoneEvent event = { name, begin, end };
+    buffer.zones.push_back(event);
+}
+
+/* ----------------------------------------------------------------------- */
+
+std::vector<ZoneStatistics> zoneStatistics()
+{
+    std::map<std::string, ZoneStatistics> stats;
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> block(buffer->mutex);
+        for (const ZoneEvent& zone : buffer->zones) {
+            double duration = (zone.end - zone.begin) * 1e-9;
+            std::map<std::string, ZoneStatistics>::iterator it = stats.find(zone.name);
+            if (it == stats.end()) {
+                ZoneStatistics s = { zone.name, 1, duration, duration, duration };
+                stats[zone.name] = s;
+            }
+            else {
+                ZoneStatistics& s = it->second;
+                ++s.calls;
+                s.total += duration;
+                s.min = std::min(s.min, duration);
+                s.max = std::max(s.max, duration);
+            }
+        }
+    }
+    std::vector<ZoneStatistics> result;
+    for (auto& it : stats) result.push_back(it.second);
+    std::stable_sort(result.begin(), result.end(), 
+                     [](const ZoneStatistics& a, const ZoneStatistics& b) { return a.total > b.total; });
+    return result;
+}
+
+std::vector<std::pair<std::string, int64_t> > counters()
+{
+    std::map<std::string, int64_t> totals;
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> block(buffer->mutex);
+        for (auto& total : buffer->totals) totals[total.first] += total.second;
+    }
+    return std::vector<std::pair<std::string, int64_t> >(totals.begin(), totals.end());
+}
+
+std::string report()
+{
+    std::vector<ZoneStatistics> zones = zoneStatistics();
+    std::vector<std::pair<std::string, int64_t> > values = counters();
+
+    size_t width = 20;
+    for (const ZoneStatistics& zone : zones) width = std::max(width, zone.name.size());
+    for (auto& value : values) width = std::max(width, value.first.size());
+
+    std::ostringstream stream;
+    char line[512];
+    std::snprintf(line, sizeof(line), "%-*s %10s %12s %12s %12s %12s\n", int(width), "Zone", "Calls", "Total (ms)", "Mean (ms)", "Min (ms)", "Max (ms)");
+    stream << line;
+    for (const ZoneStatistics& zone : zones) {
+        std::snprintf(line, sizeof(line), "%-*s %10lu %12.3f %12.3f %12.3f %12.3f\n", int(width), zone.name.c_str(), 
+                      (unsigned long)zone.calls, zone.total * 1e3, zone.total * 1e3 / zone.calls, zone.min * 1e3, zone.max * 1e3);
+        stream << line;
+    }
+    if (!values.empty()) {
+        std::snprintf(line, sizeof(line), "\n%-*s %20s\n", int(width), "Counter", "Value");
+        stream << line;
+        for (auto& value : values) {
+            std::snprintf(line, sizeof(line), "%-*s %20lld\n", int(width), value.first.c_str(), (long long)value.second);
+            stream << line;
+        }
+    }
+    return stream.str();
+}
+
+std::string toChromeTrace()
+{
+    std::ostringstream stream;
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    char line[64];
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> block(buffer->mutex);
+        // Chrome traces are in microseconds.
+        for (const ZoneEvent& zone : buffer->zones) {
+            stream << (first ? "\n" : ",\n");
+            first = false;
+            std::snprintf(line, sizeof(line), "%.3f,\"dur\":%.3f", zone.begin * 1e-3, (zone.end - zone.begin) * 1e-3);
+            stream << "{\"name\":" << jsonString(zone.name) << ",\"cat\":\"pgl\",\"ph\":\"X\",\"ts\":" << line 
+                   << ",\"pid\":0,\"tid\":" << buffer->id << "}";
+        }
+        for (const CounterEvent& counter : buffer->counters) {
+            stream << (first ? "\n" : ",\n");
+            first = false;
+            std::snprintf(line, sizeof(line), "%.3f", counter.time * 1e-3);
+            stream << "{\"name\":" << jsonString(counter.name) << ",\"cat\":\"pgl\",\"ph\":\"C\",\"ts\":" << line 
+                   << ",\"pid\":0,\"tid\":" << buffer->id << ",\"id\":" << buffer->id << ",\"args\":{\"value\":" << counter.value << "}}";
+        }
+    }
+    stream << "\n]}\n";
+    return stream.str();
+}
+
+bool writeChromeTrace(const std::string& filename)
+{
+    std::ofstream stream(filename.c_str(), std::ios::out | std::ios::binary);
+    if (!stream) return false;
+    stream << toChromeTrace();
+    return bool(stream);
+}
+
+/* ----------------------------------------------------------------------- */
+
+} // namespace profile
+
+PGL_END_NAMESPACE
@@ -0,0 +1,167 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+#ifndef __util_profile_h__
+#define __util_profile_h__
+
+/*! \file util_profile.h
+    \brief Lightweight instrumentation of PlantGL hot paths (pgl::profile).
+
+    Scoped zones measure the wall time spent in a block and counters 
+    accumulate quantities such as rasterized triangles or parsed bytes. 
+    Records are stored in per-thread buffers, so instrumented code running 
+    in the TaskScheduler workers does not contend on a shared lock. 
+    Nothing is recorded until start() is called, and the instrumentation 
+    macros compile to nothing when PGL_WITH_PROFILE is not defined.
+
+    Zone and counter names must be string literals (or any string outliving
+    the record).
+*/
+
+/* ----------------------------------------------------------------------- */
+
+#include "tools_config.h"
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+namespace profile {
+
+/* ----------------------------------------------------------------------- */
+
+/// Clears the previous record and starts recording zones and counters.
+TOOLS_API void start();
+
+/// Stops recording. The record is kept until the next start or clear.
+TOOLS_API void stop();
+
+/// Discards the current record.
+TOOLS_API void clear();
+
+/// Returns whether zones and counters are currently recorded.
+TOOLS_API bool isRecording();
+
+/// Adds \e value to the counter \e name of the calling thread.
+TOOLS_API void count(const char * name, int64_t value = 1);
+
+/// Records a zone of the calling thread. Times are in nanoseconds since start.
+TOOLS_API void record(const char * name, int64_t begin, int64_t end);
+
+/// Returns the number of nanoseconds elapsed since start.
+TOOLS_API int64_t now();
+
+/* ----------------------------------------------------------------------- */
+
+/*!
+  \class ScopedZone
+  \brief Records the time spent between its construction and its destruction.
+*/
+class ScopedZone {
+public:
+    inline ScopedZone(const char * name) : 
+        __name(isRecording() ? name : 0), __begin(__name ? now() : 0) {}
+
+    inline ~ScopedZone() { if (__name) record(__name, __begin, now()); }
+
+private:
+    ScopedZone(const ScopedZone&);
+    ScopedZone& operator=(const ScopedZone&);
+
+    const char * __name;
+    int64_t __begin;
+};
+
+/* ----------------------------------------------------------------------- */
+
+/// Aggregated timings of the zones sharing a same name. Times are in seconds.
+struct TOOLS_API ZoneStatistics {
+    std::string name;
+    size_t calls;
+    double total;
+    double min;
+    double max;
+};
+
+/// Returns the statistics of the recorded zones, sorted by decreasing total time.
+TOOLS_API std::vector<ZoneStatistics> zoneStatistics();
+
+/// Returns the values of the counters summed over all threads, sorted by name.
+TOOLS_API std::vector<std::pair<std::string, int64_t> > counters();
+
+/// Returns a text table of the zone statistics and of the counters.
+TOOLS_API std::string report();
+
+/// Returns the record in the Chrome trace event format (chrome://tracing, Perfetto).
+TOOLS_API std::string toChromeTrace();
+
+/// Writes the record in the Chrome trace event format in \e filename.
+TOOLS_API bool writeChromeTrace(const std::string& filename);
+
+/* ----------------------------------------------------------------------- */
+
+} // namespace profile
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#define __PGL_PROFILE_CONCAT(a, b) a##b
+#define __PGL_PROFILE_NAME(a, b) __PGL_PROFILE_CONCAT(a, b)
+
+#ifdef PGL_WITH_PROFILE
+/// Records the time spent until the end of the enclosing scope.
+#define PGL_PROFILE_ZONE(name) PGL(profile)::ScopedZone __PGL_PROFILE_NAME(__pgl_profile_zone_, __LINE__)(name)
+/// Adds \e value to the counter \e name.
+#define PGL_PROFILE_COUNT(name, value) do { if (PGL(profile)::isRecording()) PGL(profile)::count(name, value); } while(0)
+#else
+#define PGL_PROFILE_ZONE(name)
+#define PGL_PROFILE_COUNT(name, value) do { } while(0)
+#endif
+
+/* ----------------------------------------------------------------------- */
+
+// __util_profile_h__
+#endif
@@ -0,0 +1,253 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "util_taskscheduler.h"
+#include <cstdlib>
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+namespace {
+    // Scheduler and worker index of the calling thread.
+    thread_local TaskScheduler * CURRENT_SCHEDULER = NULL;
+    thread_local size_t CURRENT_INDEX = 0;
+}
+
+/* ----------------------------------------------------------------------- */
+
+TaskScheduler::TaskScheduler(size_t nbthreads):
+    __nbqueued(0),
+    __stop(false)
+{
+    start(nbthreads == 0 ? defaultNbThreads() : nbthreads);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    stop();
+}
+
+size_t TaskScheduler::defaultNbThreads()
+{
+    const char * envvalue = getenv("PGL_NUM_THREADS");
+    if (envvalue != NULL) {
+        int value = atoi(envvalue);
+        if (value > 0) return size_t(value);
+    }
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+TaskScheduler& TaskScheduler::get()
+{
+    static TaskScheduler SCHEDULER;
+    return SCHEDULER;
+}
+
+void TaskScheduler::setNbThreads(size_t nbthreads)
+{
+    if (nbthreads == 0) nbthreads = defaultNbThreads();
+    if (nbthreads == nbThreads()) return;
+    stop();
+    start(nbthreads);
+}
+
+void TaskScheduler::start(size_t nbthreads)
+{
+    __stop = false;
+    __queues.clear();
+    for (size_t i = 0; i <= nbthreads; ++i)
+        __queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+    for (size_t i = 0; i < nbthreads; ++i)
+        __workers.push_back(std::thread(&TaskScheduler::workerLoop, this, i));
+}
+
+void TaskScheduler::stop()
+{
+    __stop = true;
+    notifyAll();
+    for (std::vector<std::thread>::iterator it = __workers.begin(); it != __workers.end(); ++it)
+        it->join();
+    __workers.clear();
+}
+
+size_t TaskScheduler::currentIndex() const
+{
+    if (CURRENT_SCHEDULER == this) return CURRENT_INDEX;
+    return __workers.size();
+}
+
+void TaskScheduler::submit(Task task)
+{
+    WorkQueue& queue = *__queues[currentIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    ++__nbqueued;
+    {
+        // taking the lock ensures a thread checking for work in waitForWork does not miss the notification
+        std::lock_guard<std::mutex> lock(__idlemutex);
+    }
+    __idlecondition.notify_one();
+}
+
+bool TaskScheduler::popTask(Task& task)
+{
+    if (__nbqueued == 0) return false;
+    size_t nbqueues = __queues.size();
+    size_t self = currentIndex();
+
+    // own queue first, newest task (LIFO) for cache locality.
+    if (self < nbqueues - 1) {
+        WorkQueue& queue = *__queues[self];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            --__nbqueued;
+            return true;
+        }
+    }
+
+    // then steal the oldest task (FIFO) of the others, starting with the injection queue.
+    for (size_t i = 0; i < nbqueues; ++i) {
+        size_t victim = (nbqueues - 1 + self + 1 + i) % nbqueues;
+        if (victim == self && self < nbqueues - 1) continue;
+        WorkQueue& queue = *__queues[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            --__nbqueued;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskScheduler::tryRunOne()
+{
+    Task task;
+    if (popTask(task)) {
+        task();
+        return true;
+    }
+    return false;
+}
+
+void TaskScheduler::notifyAll()
+{
+    {
+        std::lock_guard<std::mutex> lock(__idlemutex);
+    }
+    __idlecondition.notify_all();
+}
+
+void TaskScheduler::waitForWork(const std::function<bool()>& done)
+{
+    std::unique_lock<std::mutex> lock(__idlemutex);
+    __idlecondition.wait(lock, [this, &done]() { return __nbqueued > 0 || done(); });
+}
+
+void TaskScheduler::workerLoop(size_t index)
+{
+    CURRENT_SCHEDULER = this;
+    CURRENT_INDEX = index;
+    while (true) {
+        if (!tryRunOne()) {
+            if (__stop) break;
+            waitForWork([this]() { return bool(__stop); });
+        }
+    }
+    CURRENT_SCHEDULER = NULL;
+}
+
+/* ----------------------------------------------------------------------- */
+
+TaskGroup::TaskGroup(TaskScheduler& scheduler):
+    __scheduler(scheduler),
+    __pending(0),
+    __exception()
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    try { wait(); }
+    catch(...) { }
+}
+
+void TaskGroup::run(TaskScheduler::Task task)
+{
+    ++__pending;
+    __scheduler.submit([this, task]() { execute(task); });
+}
+
+void TaskGroup::execute(const TaskScheduler::Task& task)
+{
+    try {
+        task();
+    }
+    catch(...) {
+        std::lock_guard<std::mutex> lock(__exceptionmutex);
+        if (!__exception) __exception = std::current_exception();
+    }
+    // once __pending reaches 0, wait() may return and the group be destroyed: 
+    // the scheduler must not be accessed through this afterwards.
+    TaskScheduler& scheduler = __scheduler;
+    if (--__pending == 0) scheduler.notifyAll();
+}
+
+void TaskGroup::wait()
+{
+    while (__pending > 0) {
+        // help executing tasks (of this group or others) instead of blocking
+        if (!__scheduler.tryRunOne())
+            __scheduler.waitForWork([this]() { return __pending == 0; });
+    }
+
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> lock(__exceptionmutex);
+        std::swap(exception, __exception);
+    }
+    if (exception) std::rethrow_exception(exception);
+}
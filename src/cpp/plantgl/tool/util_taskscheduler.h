@@ -0,0 +1,213 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+#ifndef __util_taskscheduler_h__
+#define __util_taskscheduler_h__
+
+/*! \file util_taskscheduler.h
+    \brief A work-stealing task scheduler shared by PlantGL parallel algorithms.
+*/
+
+/* ----------------------------------------------------------------------- */
+
+#include "tools_config.h"
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <algorithm>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/*!
+  \class TaskScheduler
+
+  \brief A pool of worker threads, each with its own task deque.
+
+  A worker pushes and pops tasks at the back of its own deque and steals 
+  from the front of the deques of the others when it becomes idle. Tasks 
+  submitted from a thread that is not a worker go to a shared injection queue. 
+  Idle workers sleep on a condition variable and are woken up when a task is 
+  submitted.
+
+  The number of worker threads defaults to the hardware concurrency and can be 
+  overridden with the PGL_NUM_THREADS environment variable or setNbThreads.
+*/
+
+class TaskGroup;
+
+class TOOLS_API TaskScheduler {
+public:
+    typedef std::function<void()> Task;
+
+    TaskScheduler(size_t nbthreads = 0);
+    ~TaskScheduler();
+
+    /// Number of worker threads. The thread waiting for a TaskGroup also executes tasks.
+    size_t nbThreads() const { return __workers.size(); }
+
+    /// Restart the pool with nbthreads workers (0 for the default). Must be called while no task is pending.
+    void setNbThreads(size_t nbthreads = 0);
+
+    /// Execute one pending task in the calling thread if any. Returns false if no task was found.
+    bool tryRunOne();
+
+    /// Default number of threads (PGL_NUM_THREADS or hardware concurrency).
+    static size_t defaultNbThreads();
+
+    /// The process-wide scheduler.
+    static TaskScheduler& get();
+
+protected:
+    friend class TaskGroup;
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void submit(Task task);
+    bool popTask(Task& task);
+    void workerLoop(size_t index);
+
+    void start(size_t nbthreads);
+    void stop();
+
+    /// Index of the calling thread in this scheduler, or nbThreads() for an external thread.
+    size_t currentIndex() const;
+
+    // Wake up the threads sleeping in waitForWork.
+    void notifyAll();
+    // Sleep until a task is queued or done() returns true.
+    void waitForWork(const std::function<bool()>& done);
+
+    std::vector<std::thread> __workers;
+    // one queue per worker plus the injection queue for external threads.
+    std::vector<std::unique_ptr<WorkQueue> > __queues;
+
+    std::atomic<size_t> __nbqueued;
+    std::atomic<bool> __stop;
+    std::mutex __idlemutex;
+    std::condition_variable __idlecondition;
+};
+
+/* ----------------------------------------------------------------------- */
+
+/*!
+  \class TaskGroup
+
+  \brief A set of tasks that can be waited for.
+
+  wait() does not poll : the waiting thread executes pending tasks and otherwise 
+  sleeps until a task is submitted or the group completes. Since a waiting worker 
+  keeps executing tasks, groups can be nested (a task can create and wait for its 
+  own group). The first exception thrown by a task is rethrown by wait().
+*/
+
+class TOOLS_API TaskGroup {
+public:
+    TaskGroup(TaskScheduler& scheduler = TaskScheduler::get());
+    ~TaskGroup();
+
+    void run(TaskScheduler::Task task);
+    void wait();
+
+    bool isCompleted() const { return __pending == 0; }
+    TaskScheduler& scheduler() { return __scheduler; }
+
+protected:
+    void execute(const TaskScheduler::Task& task);
+
+    TaskScheduler& __scheduler;
+    std::atomic<size_t> __pending;
+    std::mutex __exceptionmutex;
+    std::exception_ptr __exception;
+
+private:
+    TaskGroup(const TaskGroup&);
+    TaskGroup& operator=(const TaskGroup&);
+};
+
+/* ----------------------------------------------------------------------- */
+
+/// Call f(begin, end) on sub ranges of [begin,end) of at most grainsize elements (0 for automatic) in parallel.
+template<class Function>
+void parallel_for_range(size_t begin, size_t end, const Function& f, size_t grainsize = 0, TaskScheduler& scheduler = TaskScheduler::get())
+{
+    if (end <= begin) return;
+    size_t nbelements = end - begin;
+    if (grainsize == 0) grainsize = std::max<size_t>(1, nbelements / (4 * (scheduler.nbThreads() + 1)));
+    if (nbelements <= grainsize) { f(begin, end); return; }
+
+    TaskGroup group(scheduler);
+    for (size_t subbegin = begin + grainsize; subbegin < end; subbegin += grainsize) {
+        size_t subend = std::min(end, subbegin + grainsize);
+        group.run([&f, subbegin, subend]() { f(subbegin, subend); });
+    }
+    // the calling thread takes the first range
+    f(begin, begin + grainsize);
+    group.wait();
+}
+
+/// Call f(i) for each i of [begin,end) in parallel.
+template<class Function>
+void parallel_for(size_t begin, size_t end, const Function& f, size_t grainsize = 0, TaskScheduler& scheduler = TaskScheduler::get())
+{
+    parallel_for_range(begin, end, [&f](size_t subbegin, size_t subend) { for (size_t i = subbegin; i < subend; ++i) f(i); }, grainsize, scheduler);
+}
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __util_taskscheduler_h__
+#endif
@@ -5,6 +5,7 @@ if not pgl_support_extension('PGL_NO_QT_GUI'):
     from .gui import *
 
 from . import codec
+from . import profile
 
 from os.path import join as pj
 
@@ -0,0 +1,42 @@
+""" Recording of the time spent in the PlantGL hot paths (pgl.profile).
+
+    >>> import openalea.plantgl.all as pgl
+    >>> pgl.profile.start()
+    >>> # ... run some PlantGL algorithms
+    >>> pgl.profile.stop()
+    >>> print(pgl.profile.report())
+    >>> pgl.profile.write_chrome_trace('trace.json')
+
+    The trace can be loaded in chrome://tracing or https://ui.perfetto.dev.
+    Zones and counters are only recorded if PlantGL was compiled with 
+    PGL_WITH_PROFILE (see pgl_support_extension('PROFILE')).
+"""
+from contextlib import contextmanager
+
+from .scenegraph._pglsg import pgl_support_extension
+from .scenegraph._pglsg import pgl_profile_start as start
+from .scenegraph._pglsg import pgl_profile_stop as stop
+from .scenegraph._pglsg import pgl_profile_clear as clear
+from .scenegraph._pglsg import pgl_profile_is_recording as is_recording
+from .scenegraph._pglsg import pgl_profile_report as report
+from .scenegraph._pglsg import pgl_profile_zones as zones
+from .scenegraph._pglsg import pgl_profile_counters as counters
+from .scenegraph._pglsg import pgl_profile_chrome_trace as chrome_trace
+from .scenegraph._pglsg import pgl_profile_write_chrome_trace as write_chrome_trace
+
+
+def is_available():
+    """ Tell whether the PlantGL hot paths are instrumented """
+    return pgl_support_extension('PROFILE')
+
+@contextmanager
+def recording(tracefile = None):
+    """ Record the zones and counters of the enclosed block. 
+        The record is written in tracefile in the Chrome trace format if given. """
+    start()
+    try:
+        yield
+    finally:
+        stop()
+        if tracefile:
+            write_chrome_trace(tracefile)
@@ -110,6 +110,9 @@ void export_SpaceColonization();
 void export_SegIntersection();
 void export_Ray();
 void export_RayIntersection();
+void export_BVHRayCaster();
+void export_FormFactorEngine();
+void export_RadiositySolver();
 void export_Intersection();
 
 /* ----------------------------------------------------------------------- */
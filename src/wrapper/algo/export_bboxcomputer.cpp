@@ -73,6 +73,8 @@ void export_BBoxComputer()
     .add_property("boundingbox",d_getBBox,"Return the last computed Bounding Box.")
     .add_property("result",d_getBBox)
     ;
+
+  def("parallelBoundingBox",&parallelSceneBoundingBox,(boost::python::arg("scene"),boost::python::arg("grainsize")=0),"Compute the bounding box of a scene with several threads");
 }
 
 /* ----------------------------------------------------------------------- */
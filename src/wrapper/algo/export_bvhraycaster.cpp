@@ -0,0 +1,132 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#include <plantgl/python/export_refcountptr.h>
+#include <plantgl/python/extract_list.h>
+#include <plantgl/algo/raycasting/bvhraycaster.h>
+
+#include <boost/python.hpp>
+
+PGL_USING_NAMESPACE
+using namespace boost::python;
+#define bp boost::python
+
+object py_first_hit(BVHRayCaster * caster, const Ray& ray, real_t maxdist)
+{
+    RayHit hit;
+    if (caster->firstHit(ray, hit, maxdist)) return object(hit);
+    return object();
+}
+
+bp::list py_all_hits(BVHRayCaster * caster, const Ray& ray, real_t maxdist)
+{
+    std::vector<RayHit> hits;
+    caster->allHits(ray, hits, maxdist);
+    bp::list result;
+    for (std::vector<RayHit>::const_iterator it = hits.begin(); it != hits.end(); ++it) result.append(*it);
+    return result;
+}
+
+bp::list py_first_hits(BVHRayCaster * caster, bp::object pyrays, real_t maxdist)
+{
+    std::vector<Ray> rays = extract_vec<Ray>(pyrays)();
+    std::vector<RayHit> hits;
+    caster->firstHits(rays, hits, maxdist);
+    bp::list result;
+    for (std::vector<RayHit>::const_iterator it = hits.begin(); it != hits.end(); ++it)
+        result.append(it->isValid() ? object(*it) : object());
+    return result;
+}
+
+bp::list py_any_hits(BVHRayCaster * caster, bp::object pyrays, real_t maxdist)
+{
+    std::vector<Ray> rays = extract_vec<Ray>(pyrays)();
+    std::vector<uchar_t> hits;
+    caster->anyHits(rays, hits, maxdist);
+    bp::list result;
+    for (std::vector<uchar_t>::const_iterator it = hits.begin(); it != hits.end(); ++it) result.append(bool(*it));
+    return result;
+}
+
+bp::list py_all_hits_of_rays(BVHRayCaster * caster, bp::object pyrays, real_t maxdist)
+{
+    std::vector<Ray> rays = extract_vec<Ray>(pyrays)();
+    std::vector<RayHit> hits;
+    std::vector<size_t> offsets;
+    caster->allHits(rays, hits, offsets, maxdist);
+    bp::list result;
+    for (size_t i = 0; i < rays.size(); ++i) {
+        bp::list rayhits;
+        for (size_t j = offsets[i]; j < offsets[i + 1]; ++j) rayhits.append(hits[j]);
+        result.append(rayhits);
+    }
+    return result;
+}
+
+void export_BVHRayCaster()
+{
+  class_< RayHit > ("RayHit", "Intersection of a ray with a triangle of a BVHRayCaster.", init<>())
+      .def_readonly("triangle", &RayHit::triangle, "Position of the triangle in the TriangleSoup.")
+      .def_readonly("id", &RayHit::id, "Id of the shape of the triangle.")
+      .def_readonly("distance", &RayHit::distance, "Distance from the ray origin.")
+      .def_readonly("u", &RayHit::u, "Barycentric coordinate of the hit along the second vertex.")
+      .def_readonly("v", &RayHit::v, "Barycentric coordinate of the hit along the third vertex.")
+      .def("isValid", &RayHit::isValid)
+      ;
+
+  class_< BVHRayCaster, BVHRayCasterPtr, bases<RefCountObject>, boost::noncopyable >
+      ("BVHRayCaster", "Cast rays into the triangles of a scene using a bounding volume hierarchy built with the surface area heuristic.",
+       init<const ScenePtr&, bp::optional<const DiscretizationCachePtr&, uint32_t> >("BVHRayCaster(scene[, cache, maxleafsize])", (bp::arg("scene"), bp::arg("cache"), bp::arg("maxleafsize"))))
+      .def(init<const TriangleSoupPtr&, bp::optional<uint32_t> >("BVHRayCaster(trianglesoup[, maxleafsize])", (bp::arg("trianglesoup"), bp::arg("maxleafsize"))))
+      .def("__len__", &BVHRayCaster::size)
+      .def("size", &BVHRayCaster::size)
+      .def("getNbNodes", &BVHRayCaster::getNbNodes)
+      .def("getBoundingBox", &BVHRayCaster::getBoundingBox)
+      .def("getTriangleSoup", &BVHRayCaster::getTriangleSoup, return_value_policy<copy_const_reference>())
+      .def("firstHit", &py_first_hit, (bp::arg("ray"), bp::arg("maxdist") = REAL_MAX), "Return the closest RayHit of ray or None.")
+      .def("anyHit", &BVHRayCaster::anyHit, (bp::arg("ray"), bp::arg("maxdist") = REAL_MAX), "Return whether ray hits a triangle.")
+      .def("allHits", &py_all_hits_of_rays, (bp::arg("rays"), bp::arg("maxdist") = REAL_MAX), "Return the list of all RayHit sorted by distance of each ray. Rays are processed in parallel.")
+      .def("allHits", &py_all_hits, (bp::arg("ray"), bp::arg("maxdist") = REAL_MAX), "Return the list of all RayHit of ray sorted by distance.")
+      .def("firstHits", &py_first_hits, (bp::arg("rays"), bp::arg("maxdist") = REAL_MAX), "Return the closest RayHit or None of each ray. Rays are processed in parallel.")
+      .def("anyHits", &py_any_hits, (bp::arg("rays"), bp::arg("maxdist") = REAL_MAX), "Return whether each ray hits a triangle. Rays are processed in parallel.")
+      ;
+
+  implicitly_convertible< BVHRayCasterPtr, RefCountObjectPtr >();
+}
@@ -50,6 +50,14 @@ using namespace std;
 #define bp boost::python
 
 
+#ifdef PGL_WITH_CGAL
+void py_ds_process_soup(DepthSortEngine * engine, const TriangleSoupPtr& soup){
+    CompiledScenePtr compiled = dynamic_pointer_cast<CompiledScene>(soup);
+    if (is_valid_ptr(compiled)) engine->process(compiled);
+    else engine->process(soup);
+}
+#endif
+
 void export_DepthSortEngine()
 {
 #ifdef PGL_WITH_CGAL
@@ -57,6 +65,7 @@ void export_DepthSortEngine()
   class_< DepthSortEngine, bases<ProjectionEngine>, boost::noncopyable >
       ("DepthSortEngine", init<>("Construct a DepthSortEngine.") )
       .def("processTriangle", &DepthSortEngine::processTriangle)
+      .def("processTriangleSoup", &py_ds_process_soup, (bp::arg("trianglesoup")), "Process a TriangleSoup. A CompiledScene is updated first.")
       .def("getResult", &DepthSortEngine::getResult, (bp::arg("format")=Color4::eARGB, bp::arg("cameraCoordinates")=true))
       .def("getProjectionResult", &DepthSortEngine::getProjectionResult, (bp::arg("format")=Color4::eARGB, bp::arg("cameraCoordinates")=true))
       ;
@@ -47,6 +47,7 @@
 #include <plantgl/scenegraph/geometry/explicitmodel.h>
 #include <plantgl/scenegraph/geometry/triangleset.h>
 #include <plantgl/python/exception.h>
+#include <plantgl/python/export_refcountptr.h>
 
 /* ----------------------------------------------------------------------- */
 
@@ -68,6 +69,13 @@ void set_Dis_texCoord(Discretizer * obj, bool v){
   obj->computeTexCoord(v);
 }
 
+DiscretizationCachePtr get_Dis_sharedCache(Discretizer * obj){
+  return obj->getSharedCache();
+}
+void set_Dis_sharedCache(Discretizer * obj, DiscretizationCachePtr cache){
+  obj->setSharedCache(cache);
+}
+
 ExplicitModelPtr py_discretize( const GeometryPtr& obj) {
     if (!obj)throw PythonExc_ValueError("Cannot discretize empty object.");
     Discretizer d;
@@ -77,13 +85,39 @@ ExplicitModelPtr py_discretize( const GeometryPtr& obj) {
 
 /* ----------------------------------------------------------------------- */
 
+void export_DiscretizationCache()
+{
+  class_< DiscretizationCache, DiscretizationCachePtr, bases<RefCountObject>, boost::noncopyable >
+    ("DiscretizationCache", "A thread-safe cache of discretizations with a memory budget, that can be shared by several Discretizer. "
+     "The budget is split between 16 shards: a discretization larger than maxMemory/16 is not cached.",
+     init<bp::optional<size_t> >("DiscretizationCache(maxMemory = 256 Mb)", (bp::arg("maxMemory"))))
+    .def("globalCache", &DiscretizationCache::global)
+    .staticmethod("globalCache")
+    .def("invalidate", &DiscretizationCache::invalidate, (bp::arg("object")), "Remove the discretizations of a modified object.")
+    .def("clear", &DiscretizationCache::clear)
+    .def("purgeUnreferenced", &DiscretizationCache::purgeUnreferenced)
+    .add_property("maxMemory", &DiscretizationCache::getMaxMemory, &DiscretizationCache::setMaxMemory)
+    .def("getMemory", &DiscretizationCache::getMemory)
+    .def("__len__", &DiscretizationCache::size)
+    .def("getNbHits", &DiscretizationCache::getNbHits)
+    .def("getNbMisses", &DiscretizationCache::getNbMisses)
+    .def("getNbEvictions", &DiscretizationCache::getNbEvictions)
+    .def("resetStatistics", &DiscretizationCache::resetStatistics)
+    ;
+
+  implicitly_convertible< DiscretizationCachePtr, RefCountObjectPtr >();
+}
+
 void export_Discretizer()
 {
+  export_DiscretizationCache();
+
   class_< Discretizer,bases< Action >,boost::noncopyable >
     ("Discretizer", init<>("Discretizer() -> Compute the objects discretization" ))
     .def("clear",&Discretizer::clear)
     .add_property("discretization",d_getDiscretization, "Return the last computed discretization.")
     .add_property("texCoord",get_Dis_texCoord,set_Dis_texCoord)
+    .add_property("sharedCache",get_Dis_sharedCache,set_Dis_sharedCache)
     .add_property("result",d_getDiscretization)
     ;
 
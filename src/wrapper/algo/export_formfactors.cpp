@@ -0,0 +1,119 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#include <plantgl/python/export_refcountptr.h>
+#include <plantgl/algo/projection/formfactors.h>
+
+#include <boost/python.hpp>
+
+PGL_USING_NAMESPACE
+using namespace boost::python;
+#define bp boost::python
+
+template<class T>
+bp::list py_to_list(const std::vector<T>& values)
+{
+    bp::list result;
+    for (typename std::vector<T>::const_iterator it = values.begin(); it != values.end(); ++it) result.append(*it);
+    return result;
+}
+
+bp::tuple py_ffm_triplets(FormFactorMatrix * matrix)
+{
+    std::vector<uint32_t> rows, columns;
+    std::vector<real_t> values;
+    matrix->getTriplets(rows, columns, values);
+    return bp::make_tuple(py_to_list(rows), py_to_list(columns), py_to_list(values));
+}
+
+bp::tuple py_ffm_csr(FormFactorMatrix * matrix)
+{
+    return bp::make_tuple(py_to_list(matrix->getOffsets()), py_to_list(matrix->getColumns()), py_to_list(matrix->getValues()));
+}
+
+bp::tuple py_ffm_shape(FormFactorMatrix * matrix)
+{
+    return bp::make_tuple(matrix->getNbRows(), matrix->getNbColumns());
+}
+
+FormFactorMatrixPtr py_ffe_compute(FormFactorEngine * engine, bp::object begin, bp::object end)
+{
+    size_t b = (begin.is_none() ? 0 : extract<size_t>(begin)());
+    size_t e = (end.is_none() ? engine->size() : extract<size_t>(end)());
+    return engine->compute(b, e);
+}
+
+void export_FormFactorEngine()
+{
+  class_< FormFactorMatrix, FormFactorMatrixPtr, bases<RefCountObject>, boost::noncopyable >
+      ("FormFactorMatrix", "A sparse matrix of form factors in compressed sparse row format. Row i gives the receivers seen from emitter i.", init<bp::optional<size_t> >("FormFactorMatrix(nbColumns)"))
+      .def("__len__", &FormFactorMatrix::getNbRows)
+      .add_property("shape", &py_ffm_shape)
+      .def("getNbRows", &FormFactorMatrix::getNbRows)
+      .def("getNbColumns", &FormFactorMatrix::getNbColumns)
+      .def("getNbNonZeros", &FormFactorMatrix::getNbNonZeros)
+      .def("getRowSize", &FormFactorMatrix::getRowSize, (bp::arg("i")))
+      .def("getAt", &FormFactorMatrix::getAt, (bp::arg("i"), bp::arg("j")))
+      .def("getRowSum", &FormFactorMatrix::getRowSum, (bp::arg("i")))
+      .def("append", &FormFactorMatrix::append, (bp::arg("other")))
+      .def("scale", &FormFactorMatrix::scale, (bp::arg("factor")), "Multiply all the values by factor.")
+      .def("triplets", &py_ffm_triplets, "Return the lists (rows, columns, values) of the non zero values.")
+      .def("csr", &py_ffm_csr, "Return the lists (offsets, columns, values). Can be given to scipy.sparse.csr_matrix((values, columns, offsets)).")
+      .def("toDense", &FormFactorMatrix::toDense)
+      ;
+
+  implicitly_convertible< FormFactorMatrixPtr, RefCountObjectPtr >();
+
+  class_< FormFactorEngine, FormFactorEnginePtr, bases<RefCountObject>, boost::noncopyable >
+      ("FormFactorEngine", "Compute sparse form factors between triangles with hemispherical renderings distributed among threads. "
+                           "Receivers behind the emitter, farther than maxDistance or with an estimated solid angle lower than tolerance are culled.",
+       init<const Point3ArrayPtr&, const Index3ArrayPtr&, bp::optional<const Point3ArrayPtr&, bool> >
+          ("FormFactorEngine(points, triangles[, normals, ccw])", (bp::arg("points"), bp::arg("triangles"), bp::arg("normals") = Point3ArrayPtr(), bp::arg("ccw") = true)))
+      .def("__len__", &FormFactorEngine::size)
+      .add_property("discretization", &FormFactorEngine::getDiscretization, &FormFactorEngine::setDiscretization)
+      .add_property("solidangle", &FormFactorEngine::isSolidAngle, &FormFactorEngine::setSolidAngle)
+      .add_property("tolerance", &FormFactorEngine::getTolerance, &FormFactorEngine::setTolerance)
+      .add_property("maxDistance", &FormFactorEngine::getMaxDistance, &FormFactorEngine::setMaxDistance)
+      .def("compute", &py_ffe_compute, (bp::arg("begin") = object(), bp::arg("end") = object()), 
+           "Return the FormFactorMatrix of the emitters [begin, end) (all by default).")
+      ;
+
+  implicitly_convertible< FormFactorEnginePtr, RefCountObjectPtr >();
+}
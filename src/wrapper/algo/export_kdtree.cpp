@@ -49,6 +49,24 @@ using namespace boost::python;
 using namespace std;
 #define bp boost::python
 
+template<class KDTreeN>
+object kdtree_k_nearest_neighbors_mt(KDTreeN * kdtree, size_t k, bool withdistances)
+{
+    if (!withdistances) return object(kdtree->k_nearest_neighbors_mt(k));
+    RealArrayPtr distances;
+    CSRIndexArrayPtr result = kdtree->k_nearest_neighbors_mt(k, &distances);
+    return bp::make_tuple(result, distances);
+}
+
+template<class KDTreeN>
+object kdtree_r_nearest_neighbors_mt(KDTreeN * kdtree, real_t radius, bool withdistances)
+{
+    if (!withdistances) return object(kdtree->r_nearest_neighbors_mt(radius));
+    RealArrayPtr distances;
+    CSRIndexArrayPtr result = kdtree->r_nearest_neighbors_mt(radius, &distances);
+    return bp::make_tuple(result, distances);
+}
+
 template<class KDTreeN>
 class kdtree_func : public boost::python::def_visitor<kdtree_func<KDTreeN> >
 {
@@ -60,6 +78,10 @@ class kdtree_func : public boost::python::def_visitor<kdtree_func<KDTreeN> >
         c.def("k_closest_points", &KDTreeN::k_closest_points, (bp::arg("point"),bp::arg("k"),bp::arg("maxdist")= REAL_MAX),"Return the k closest points of point")
          .def("k_nearest_neighbors", &KDTreeN::k_nearest_neighbors,args("k"), "Return the k closest points for each point in the kdtree")
          .def("r_nearest_neighbors", &KDTreeN::r_nearest_neighbors,args("radius"), "Return points at a distance inf of radius for each point in the kdtree")
+         .def("k_nearest_neighbors_mt", &kdtree_k_nearest_neighbors_mt<KDTreeN>, (bp::arg("k"), bp::arg("withdistances") = false),
+              "Return the k closest points of each point as a CSRIndexArray, computed in parallel. If withdistances, return also the distances in a flat array.")
+         .def("r_nearest_neighbors_mt", &kdtree_r_nearest_neighbors_mt<KDTreeN>, (bp::arg("radius"), bp::arg("withdistances") = false),
+              "Return points at a distance inf of radius of each point as a CSRIndexArray, computed in parallel. If withdistances, return also the distances in a flat array.")
          .def("size", &KDTreeN::size, "Return the number of point in the kdtree.")
          .def("__len__", &KDTreeN::size, "Return the number of point in the kdtree.")
         ;
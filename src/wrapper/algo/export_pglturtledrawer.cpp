@@ -41,6 +41,7 @@
 
 
 #include <plantgl/algo/modelling/pglturtledrawer.h>
+#include <plantgl/algo/modelling/instancedturtledrawer.h>
 #include <plantgl/python/export_property.h>
 #include <plantgl/python/export_list.h>
 #include <plantgl/python/extract_list.h>
@@ -51,6 +52,8 @@ using namespace boost::python;
 PGL_USING_NAMESPACE
 
 
+size_t instanced_drawer_size(InstancedTurtleDrawer * drawer) { return drawer->getInstances().size(); }
+
 void export_PglTurtleDrawer()
 {
   class_< PglTurtleDrawer , boost::noncopyable, bases<TurtleDrawer> >("PglTurtleDrawer", init<>("PglTurtleDrawer() -> Create PglTurtleDrawer"))
@@ -59,4 +62,12 @@ void export_PglTurtleDrawer()
 
      implicitly_convertible<PglTurtleDrawerPtr, TurtleDrawerPtr>();
 
+  class_< InstancedTurtleDrawer , boost::noncopyable, bases<PglTurtleDrawer> >("InstancedTurtleDrawer", init<>("InstancedTurtleDrawer() -> Create a drawer that stores cylinders, frustums and spheres as instances and merges them into one TriangleSet per appearance."))
+    .def("expand", &InstancedTurtleDrawer::expand)
+    .def("getNonInstancedScene", &InstancedTurtleDrawer::getNonInstancedScene, return_value_policy<return_by_value>() )
+    .def("__len__", &instanced_drawer_size)
+    ;
+
+     implicitly_convertible<InstancedTurtleDrawerPtr, TurtleDrawerPtr>();
+
 }
@@ -64,6 +64,21 @@ void export_PointGrid()
      .def(pointgrid_func<Point4Grid>())
     ;
 
+  class_< SparsePoint2Grid, SparsePoint2GridPtr, boost::noncopyable > ("SparsePoint2Grid", init<Vector2, Point2ArrayPtr>
+     ( "Construct a regular grid from a set of 2D points that only stores its non empty voxels.", args("voxelsize","points") ))
+     .def(pointgrid_func<SparsePoint2Grid>())
+    ;
+
+  class_< SparsePoint3Grid, SparsePoint3GridPtr, boost::noncopyable > ("SparsePoint3Grid", init<Vector3, Point3ArrayPtr>
+     ( "Construct a regular grid from a set of 3D points that only stores its non empty voxels.", args("voxelsize","points") ))
+     .def(pointgrid_func<SparsePoint3Grid>())
+    ;
+
+  class_< SparsePoint4Grid, SparsePoint4GridPtr, boost::noncopyable > ("SparsePoint4Grid", init<Vector4, Point4ArrayPtr>
+     ( "Construct a regular grid from a set of 4D points that only stores its non empty voxels.", args("voxelsize","points") ))
+     .def(pointgrid_func<SparsePoint4Grid>())
+    ;
+
 }
 
 /* ----------------------------------------------------------------------- */
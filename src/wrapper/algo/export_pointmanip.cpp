@@ -236,11 +236,27 @@ boost::python::object py_select_pole_from_point(const Point3ArrayPtr& points, co
 	return make_pair_tuple(select_pole_from_point(points, startPoint, iterations, maxAngle));
 }
 
-#ifdef PGL_WITH_CGAL
 boost::python::object py_pointset_plane(const Point3ArrayPtr points, const Index &group) {
   return make_pair_tuple(pointset_plane(points, group));
 }
-#endif
+
+boost::python::dict translate_pointset_features(const PointSetFeatures& features) {
+  boost::python::dict result;
+  result["centers"] = features.centers;
+  result["normals"] = features.normals;
+  result["orientations"] = features.orientations;
+  result["eigenvalues"] = features.eigenvalues;
+  result["linearity"] = features.linearity;
+  result["planarity"] = features.planarity;
+  result["scattering"] = features.scattering;
+  result["curvature"] = features.curvature;
+  return result;
+}
+
+template<class GroupArrayPtr>
+boost::python::dict py_pointsets_features(const Point3ArrayPtr points, const GroupArrayPtr groups) {
+  return translate_pointset_features(pointsets_features(points, groups));
+}
 
 void export_PointManip() {
   def("contract_point2", &contract_point<Point2Array>, args("points", "radius"));
@@ -274,20 +290,31 @@ void export_PointManip() {
   def("connect_all_connex_components", &connect_all_connex_components, (bp::arg("points"), bp::arg("adjacencies"), bp::arg("verbose") = false));
 
 
-  def("r_neighborhood", &r_neighborhood, args("pid", "points", "adjacencies", "radius"));
+  def("r_neighborhood", (Index(*)(uint32_t, const Point3ArrayPtr&, const IndexArrayPtr&, const real_t)) &r_neighborhood, args("pid", "points", "adjacencies", "radius"));
+  def("r_neighborhood", (Index(*)(uint32_t, const Point3ArrayPtr&, const CSRIndexArrayPtr&, const real_t)) &r_neighborhood, args("pid", "points", "adjacencies", "radius"));
   def("r_neighborhoods", (IndexArrayPtr(*)(const Point3ArrayPtr, const IndexArrayPtr, const RealArrayPtr)) &r_neighborhoods, args("points", "adjacencies", "radii"));
   def("r_neighborhoods", (IndexArrayPtr(*)(const Point3ArrayPtr, const IndexArrayPtr, real_t, bool)) &r_neighborhoods, (bp::arg("points"), bp::arg("adjacencies"), bp::arg("radius"), bp::arg("verbose") = false));
   def("r_neighborhoods_mt", (IndexArrayPtr(*)(const Point3ArrayPtr, const IndexArrayPtr, real_t, bool)) &r_neighborhoods_mt, (bp::arg("points"), bp::arg("adjacencies"), bp::arg("radius"), bp::arg("verbose") = false));
+  def("r_neighborhoods_mt", (IndexArrayPtr(*)(const Point3ArrayPtr, const IndexArrayPtr, const RealArrayPtr)) &r_neighborhoods_mt, args("points", "adjacencies", "radii"));
+  def("r_neighborhoods", (CSRIndexArrayPtr(*)(const Point3ArrayPtr, const CSRIndexArrayPtr, real_t)) &r_neighborhoods, args("points", "adjacencies", "radius"));
+  def("r_neighborhoods_mt", (CSRIndexArrayPtr(*)(const Point3ArrayPtr, const CSRIndexArrayPtr, real_t)) &r_neighborhoods_mt, args("points", "adjacencies", "radius"));
   def("r_anisotropic_neighborhood", &r_anisotropic_neighborhood, args("pid", "points", "adjacencies", "radius", "direction", "alpha", "beta"));
   def("r_anisotropic_neighborhoods", (IndexArrayPtr (*)(const Point3ArrayPtr, const IndexArrayPtr, const RealArrayPtr, const Point3ArrayPtr, const real_t, const real_t)) &r_anisotropic_neighborhoods, args("points", "adjacencies", "radii", "directions", "alpha", "beta"));
   def("r_anisotropic_neighborhoods", (IndexArrayPtr (*)(const Point3ArrayPtr, const IndexArrayPtr, const real_t, const Point3ArrayPtr, const real_t, const real_t)) &r_anisotropic_neighborhoods, args("points", "adjacencies", "radius", "directions", "alpha", "beta"));
+  def("r_anisotropic_neighborhoods_mt", (IndexArrayPtr (*)(const Point3ArrayPtr, const IndexArrayPtr, const RealArrayPtr, const Point3ArrayPtr, const real_t, const real_t)) &r_anisotropic_neighborhoods_mt, args("points", "adjacencies", "radii", "directions", "alpha", "beta"));
+  def("r_anisotropic_neighborhoods_mt", (IndexArrayPtr (*)(const Point3ArrayPtr, const IndexArrayPtr, const real_t, const Point3ArrayPtr, const real_t, const real_t)) &r_anisotropic_neighborhoods_mt, args("points", "adjacencies", "radius", "directions", "alpha", "beta"));
 
-  def("k_neighborhood", &k_neighborhood, args("pid", "points", "adjacencies", "k"));
-  def("k_neighborhoods", &k_neighborhoods, args("points", "adjacencies", "k"));
+  def("k_neighborhood", (Index(*)(uint32_t, const Point3ArrayPtr, const IndexArrayPtr, const uint32_t)) &k_neighborhood, args("pid", "points", "adjacencies", "k"));
+  def("k_neighborhood", (Index(*)(uint32_t, const Point3ArrayPtr, const CSRIndexArrayPtr, const uint32_t)) &k_neighborhood, args("pid", "points", "adjacencies", "k"));
+  def("k_neighborhoods", (IndexArrayPtr(*)(const Point3ArrayPtr, const IndexArrayPtr, const uint32_t)) &k_neighborhoods, args("points", "adjacencies", "k"));
+  def("k_neighborhoods", (CSRIndexArrayPtr(*)(const Point3ArrayPtr, const CSRIndexArrayPtr, const uint32_t)) &k_neighborhoods, args("points", "adjacencies", "k"));
+  def("k_neighborhoods_mt", (CSRIndexArrayPtr(*)(const Point3ArrayPtr, const CSRIndexArrayPtr, const uint32_t)) &k_neighborhoods_mt, args("points", "adjacencies", "k"));
 
   def("density_from_r_neighborhood", &density_from_r_neighborhood, args("pid", "points", "adjacencies", "radius"));
   def("densities_from_r_neighborhood", (RealArrayPtr(*)(const Point3ArrayPtr, const IndexArrayPtr, const real_t)) &densities_from_r_neighborhood, args("points", "adjacencies", "radius"));
   def("densities_from_r_neighborhood", (RealArrayPtr(*)(const IndexArrayPtr, const real_t)) &densities_from_r_neighborhood, args("neighborhood", "radius"));
+  def("densities_from_r_neighborhood", (RealArrayPtr(*)(const Point3ArrayPtr, const CSRIndexArrayPtr, const real_t)) &densities_from_r_neighborhood, args("points", "adjacencies", "radius"));
+  def("densities_from_r_neighborhood", (RealArrayPtr(*)(const CSRIndexArrayPtr, const real_t)) &densities_from_r_neighborhood, args("neighborhood", "radius"));
 
   def("pointset_max_distance", (real_t (*)(uint32_t, const Point3ArrayPtr, const Index &)) &pointset_max_distance, args("pid", "points", "group"));
   def("pointset_max_distance", (real_t (*)(const Vector3 &, const Point3ArrayPtr, const Index &)) &pointset_max_distance, args("center", "points", "group"));
@@ -299,14 +326,21 @@ void export_PointManip() {
   def("pointset_covariance", &pointset_covariance, (arg("points"), arg("group") = Index()));
 
   def("density_from_k_neighborhood", &density_from_k_neighborhood, (bp::arg("pid"), bp::arg("points"), bp::arg("adjacencies"), bp::arg("k") = 0), "Compute density of a point according to its k neighboordhood. If k is 0, its value is deduced from adjacencies.");
-  def("densities_from_k_neighborhood", &densities_from_k_neighborhood, (bp::arg("points"), bp::arg("adjacencies"), bp::arg("k") = 0), "Compute local densities of a set of points according to their k neighboordhood. If k is 0, its value is deduced from adjacencies.");
+  def("densities_from_k_neighborhood", (RealArrayPtr(*)(const Point3ArrayPtr, const IndexArrayPtr, const uint32_t)) &densities_from_k_neighborhood, (bp::arg("points"), bp::arg("adjacencies"), bp::arg("k") = 0), "Compute local densities of a set of points according to their k neighboordhood. If k is 0, its value is deduced from adjacencies.");
+  def("densities_from_k_neighborhood", (RealArrayPtr(*)(const Point3ArrayPtr, const CSRIndexArrayPtr, const uint32_t)) &densities_from_k_neighborhood, (bp::arg("points"), bp::arg("adjacencies"), bp::arg("k") = 0));
 
-#ifdef PGL_WITH_CGAL
   def("pointset_plane", &py_pointset_plane, args("points", "group"));
   def("pointset_orientation", &pointset_orientation, args("points", "group"));
-  def("pointsets_orientations", &pointsets_orientations, args("points", "groups"));
+  def("pointsets_orientations", (Point3ArrayPtr(*)(const Point3ArrayPtr, const IndexArrayPtr)) &pointsets_orientations, args("points", "groups"));
+  def("pointsets_orientations", (Point3ArrayPtr(*)(const Point3ArrayPtr, const CSRIndexArrayPtr)) &pointsets_orientations, args("points", "groups"));
   def("pointset_normal", &pointset_normal, (bp::arg("points"), bp::arg("groups")));
-  def("pointsets_normals", &pointsets_normals, (bp::arg("points"), bp::arg("groups")));
+  def("pointsets_normals", (Point3ArrayPtr(*)(const Point3ArrayPtr, const IndexArrayPtr)) &pointsets_normals, (bp::arg("points"), bp::arg("groups")));
+  def("pointsets_normals", (Point3ArrayPtr(*)(const Point3ArrayPtr, const CSRIndexArrayPtr)) &pointsets_normals, (bp::arg("points"), bp::arg("groups")));
+  def("pointsets_features", &py_pointsets_features<IndexArrayPtr>, args("points", "groups"),
+      "Compute covariance features of each group in parallel. Return a dict with centers, normals, orientations, eigenvalues, linearity, planarity, scattering and curvature.");
+  def("pointsets_features", &py_pointsets_features<CSRIndexArrayPtr>, args("points", "groups"));
+
+#ifdef PGL_WITH_CGAL
   def("triangleset_orientation", &triangleset_orientation, args("points", "triangles"));
 
 #ifdef CGAL_AND_SVD_SOLVER_ENABLED
@@ -153,8 +153,8 @@ protected:
     std::ostringstream _mystream;
 };
 
-boost::python::object py_tobinarystring(ScenePtr scene, bool double_precision = true,  const char * comment = NULL) { 
-    std::string res = BinaryPrinter::tobinarystring(scene, double_precision, comment);
+boost::python::object py_tobinarystring(ScenePtr scene, bool double_precision = true,  const char * comment = NULL, bool compressed = false) { 
+    std::string res = BinaryPrinter::tobinarystring(scene, double_precision, comment, compressed);
     return object( handle<>( PyBytes_FromStringAndSize(res.c_str(), res.size()))); 
 }
 
@@ -167,6 +167,7 @@ void export_PglBinaryPrinter()
   class_< PyFileBinaryPrinter, bases< Printer >, boost::noncopyable>
       ("PglBinaryPrinter",init<const std::string&>("Binary Pgl Printer",args("filename")))
     .def("print",abp_print<PyFileBinaryPrinter>)
+    .add_property("compressed",&BinaryPrinter::isCompressed,&BinaryPrinter::setCompressed)
     .def("getCanonicalFilename",BinaryPrinter::getCanonicalFilename,args("filename"))
     .staticmethod("getCanonicalFilename");
     ;
@@ -175,8 +176,9 @@ void export_PglBinaryPrinter()
       ("PglStrBinaryPrinter",init<>("String Printer in PGL binary format" ))
       .def("print",abp_print<PyStrBinaryPrinter>)
       .def( "clear", &PyStrBinaryPrinter::clear)
+      .add_property("compressed",&BinaryPrinter::isCompressed,&BinaryPrinter::setCompressed)
       .add_property("result", &PyStrBinaryPrinter::result)
       ;
-    def("tobinarystring", &py_tobinarystring,(bp::arg("scene"),bp::arg("double_precision")=true,bp::arg("comment")=""));
+    def("tobinarystring", &py_tobinarystring,(bp::arg("scene"),bp::arg("double_precision")=true,bp::arg("comment")="",bp::arg("compressed")=false));
     def("frombinarystring", &py_frombinarystring);
 }
\ No newline at end of file
@@ -54,6 +54,8 @@ void export_ProjectionEngine()
       .def("lookAt", &ProjectionEngine::lookAt, bp::args("eye_position","target","up"))
       // .def("getBoundingBoxView", &ProjectionEngine::getBoundingBoxView)
       .def("camera", &get_camera)
+      .def("setCamera", &ProjectionEngine::setCamera, (bp::arg("camera")))
+      .add_property("discretizationcache", make_function(&ProjectionEngine::getDiscretizationCache, return_value_policy<copy_const_reference>()), &ProjectionEngine::setDiscretizationCache)
       
       .def("process", (void(ProjectionEngine::*)(TriangleSetPtr, AppearancePtr, uint32_t))&ProjectionEngine::process, (bp::arg("triangleset"),bp::arg("appearance"),bp::arg("id")))
       .def("process", (void(ProjectionEngine::*)(PolylinePtr, MaterialPtr, uint32_t))&ProjectionEngine::process, (bp::arg("polyline"),bp::arg("appearance"),bp::arg("id")))
@@ -0,0 +1,88 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#include <plantgl/python/export_refcountptr.h>
+#include <plantgl/python/extract_list.h>
+#include <plantgl/algo/projection/radiosity.h>
+
+#include <boost/python.hpp>
+#include <boost/python/make_constructor.hpp>
+
+PGL_USING_NAMESPACE
+using namespace boost::python;
+#define bp boost::python
+
+RadiositySolver * py_radiosity_from_blocks(bp::object blocks, size_t blockSize)
+{
+    return new RadiositySolver(extract_vec<FormFactorMatrixPtr>(blocks)(), blockSize);
+}
+
+void export_RadiositySolver()
+{
+  enum_<RadiositySolver::eMethod>("eRadiosityMethod")
+      .value("eJacobi", RadiositySolver::eJacobi)
+      .value("eGaussSeidel", RadiositySolver::eGaussSeidel)
+      .value("eProgressiveRefinement", RadiositySolver::eProgressiveRefinement)
+      .export_values()
+      ;
+
+  class_< RadiositySolver, RadiositySolverPtr, bases<RefCountObject>, boost::noncopyable >
+      ("RadiositySolver", "Solve the multiple scattering between triangles on several wavebands from a FormFactorMatrix, or a list of its blocks of rows. "
+                          "Energies and optical properties are RealArray2 with one row per triangle (or a single row) and one column per band.",
+       init<const FormFactorMatrixPtr&, bp::optional<size_t> >("RadiositySolver(formfactors[, blockSize])", (bp::arg("formfactors"), bp::arg("blockSize") = 65536)))
+      .def("__init__", make_constructor(&py_radiosity_from_blocks, default_call_policies(), (bp::arg("blocks"), bp::arg("blockSize") = 65536)), "RadiositySolver(list blocks[, blockSize])")
+      .def("__len__", &RadiositySolver::size)
+      .add_property("method", &RadiositySolver::getMethod, &RadiositySolver::setMethod)
+      .add_property("tolerance", &RadiositySolver::getTolerance, &RadiositySolver::setTolerance)
+      .add_property("maxIterations", &RadiositySolver::getMaxIterations, &RadiositySolver::setMaxIterations)
+      .add_property("reflectance", make_function(&RadiositySolver::getReflectance, return_value_policy<copy_const_reference>()), &RadiositySolver::setReflectance)
+      .add_property("transmittance", make_function(&RadiositySolver::getTransmittance, return_value_policy<copy_const_reference>()), &RadiositySolver::setTransmittance)
+      .def("solve", &RadiositySolver::solve, (bp::arg("incident")), "Solve for the incident energies. Return whether it converged.")
+      .def("getNbIterations", &RadiositySolver::getNbIterations)
+      .def("getResidual", &RadiositySolver::getResidual)
+      .def("getNbBands", &RadiositySolver::getNbBands)
+      .def("getIntercepted", &RadiositySolver::getIntercepted)
+      .def("getAbsorbed", &RadiositySolver::getAbsorbed)
+      .def("getReflected", &RadiositySolver::getReflected)
+      .def("getTransmitted", &RadiositySolver::getTransmitted)
+      ;
+
+  implicitly_convertible< RadiositySolverPtr, RefCountObjectPtr >();
+}
@@ -52,6 +52,7 @@
 #include <plantgl/scenegraph/core/smbtable.h>
 #endif
 #include <plantgl/algo/codec/scne_binaryparser.h>
+#include <plantgl/algo/codec/plyfile.h>
 #include <sstream>
 
 /* ----------------------------------------------------------------------- */
@@ -73,6 +74,73 @@ object pgl_read(const std::string& txt, const std::string& fname)
 
 #endif
 
+Point3ArrayPtr ply_points(PlyFileReader * reader) { return reader->getPoints(); }
+Color4ArrayPtr ply_colors(PlyFileReader * reader) { return reader->getColors(); }
+Point3ArrayPtr ply_normals(PlyFileReader * reader) { return reader->getNormals(); }
+Index3ArrayPtr ply_triangles(PlyFileReader * reader) { return reader->getTriangles(); }
+IndexArrayPtr ply_faces(PlyFileReader * reader) { return reader->getFaces(); }
+
+object ply_elements(PlyFileReader * reader)
+{
+    bp::list result;
+    const std::vector<PlyFileReader::Element>& elements = reader->getElements();
+    for (std::vector<PlyFileReader::Element>::const_iterator it = elements.begin(); it != elements.end(); ++it){
+        bp::list properties;
+        for (std::vector<PlyFileReader::Property>::const_iterator itp = it->properties.begin(); itp != it->properties.end(); ++itp)
+            properties.append(itp->name);
+        result.append(make_tuple(it->name, it->count, properties));
+    }
+    return result;
+}
+
+bool ply_write_scene(PlyFileWriter * writer, const std::string& fname, const ScenePtr& scene) 
+{ return writer->write(fname, scene); }
+
+bool ply_write_arrays(PlyFileWriter * writer, const std::string& fname, const Point3ArrayPtr& points, const Color4ArrayPtr& colors, const IndexArrayPtr& faces) 
+{ return writer->write(fname, points, colors, faces); }
+
+void export_PlyFile()
+{
+    {
+    scope ply = class_<PlyFileReader, boost::noncopyable>
+        ("PlyFileReader", "A PLY reader that memory-maps the file and decodes vertices and faces directly into arrays.", 
+         init<const std::string&>("PlyFileReader(fname) : open fname and parse its header.", (bp::arg("fname"))))
+        .def("read", &PlyFileReader::read, (bp::arg("content") = uint_t(PlyFileReader::AllContent)), 
+             "Decode the vertex and face elements. content is a combination of Points, Colors, Normals and Faces.")
+        .def("readProperty", &PlyFileReader::readProperty, (bp::arg("element"), bp::arg("property")))
+        .def("elements", &ply_elements, "Return the (name, count, property names) of each element of the file.")
+        .add_property("format", &PlyFileReader::getFormat)
+        .add_property("points", &ply_points)
+        .add_property("colors", &ply_colors)
+        .add_property("normals", &ply_normals)
+        .add_property("triangles", &ply_triangles, "The faces if all of them are triangles.")
+        .add_property("faces", &ply_faces, "The faces if some of them are not triangles.")
+        .def("toScene", &PlyFileReader::toScene)
+        ;
+
+    enum_<PlyFileReader::Content>("Content")
+        .value("Points", PlyFileReader::Points)
+        .value("Colors", PlyFileReader::Colors)
+        .value("Normals", PlyFileReader::Normals)
+        .value("Faces", PlyFileReader::Faces)
+        .value("AllContent", PlyFileReader::AllContent)
+        .export_values();
+
+    enum_<PlyFileReader::Format>("Format")
+        .value("Ascii", PlyFileReader::Ascii)
+        .value("BinaryLittleEndian", PlyFileReader::BinaryLittleEndian)
+        .value("BinaryBigEndian", PlyFileReader::BinaryBigEndian)
+        .export_values();
+    }
+
+    class_<PlyFileWriter>
+        ("PlyFileWriter", "A buffered binary PLY writer.", 
+         init<bp::optional<bool, size_t> >("PlyFileWriter(bigEndian = False, bufferSize = 1 Mb)", (bp::arg("bigEndian") = false, bp::arg("bufferSize") = size_t(1 << 20))))
+        .def("write", &ply_write_scene, (bp::arg("fname"), bp::arg("scene")))
+        .def("write", &ply_write_arrays, (bp::arg("fname"), bp::arg("points"), bp::arg("colors") = Color4ArrayPtr(), bp::arg("faces") = IndexArrayPtr()))
+        ;
+}
+
 void export_PglReader()
 {
 #ifdef PGL_WITH_BISONFLEX
@@ -80,4 +148,5 @@ void export_PglReader()
 #endif
     def("pglParserVerbose",&parserVerbose, (bp::arg("verbose")=true));
     def("isPglParserVerbose",&isParserVerbose);
+    export_PlyFile();
 }
@@ -217,5 +217,32 @@ void export_SpaceColonization()
         .def("junction_components",&GraphColonization::junction_components,(bp::arg("nodeid1"),bp::arg("nodeid2")))
         .def("junction_point",&GraphColonization::junction_point,(bp::arg("nodeid1"),bp::arg("nodeid2")))
         ;
+
+      class_< SpaceColonizationEngine, SpaceColonizationEnginePtr, bases<RefCountObject>, boost::noncopyable >
+        ("SpaceColonizationEngine", "Space colonization with incremental nearest node assignment of attractors and parallel growth steps.",
+         init<Point3ArrayPtr, real_t , real_t , real_t , Vector3, real_t >("Construct a SpaceColonizationEngine. A null voxelsize uses half the perception radius.",
+                          (bp::arg("attractors"),bp::arg("nodelength"),bp::arg("kill_radius"),bp::arg("perception_radius"),bp::arg("rootnode"),bp::arg("voxelsize")=0) ))
+        .def(init<Point3ArrayPtr, real_t , real_t , real_t , Point3ArrayPtr, Uint32Array1Ptr, real_t >("Construct a SpaceColonizationEngine from an initial skeleton.",
+                          (bp::arg("attractors"),bp::arg("nodelength"),bp::arg("kill_radius"),bp::arg("perception_radius"),bp::arg("initialskeletonnodes"),
+                           bp::arg("initialskeletonparent")=Uint32Array1Ptr(0),bp::arg("voxelsize")=0) ))
+        .def("run",&SpaceColonizationEngine::run, "Apply as many steps as it can")
+        .def("iterate",&SpaceColonizationEngine::iterate, args("nbsteps"), "Apply a given number of steps.")
+        .def("step",&SpaceColonizationEngine::step, "Apply one step. Return the number of created nodes.")
+        .def("atEnd",&SpaceColonizationEngine::atEnd)
+        .add_property("nodes",&SpaceColonizationEngine::get_nodes)
+        .add_property("parents",&SpaceColonizationEngine::get_parents)
+        .def("get_children",&SpaceColonizationEngine::get_children)
+        .add_property("grid",&SpaceColonizationEngine::get_grid)
+        .def("new_nodes",&SpaceColonizationEngine::get_new_nodes,return_value_policy<return_by_value>())
+        .def("nearest_nodes",&SpaceColonizationEngine::get_nearest_nodes)
+        .def("nbAliveAttractors",&SpaceColonizationEngine::nbAliveAttractors)
+        .def_readwrite("nodelength",&SpaceColonizationEngine::nodelength)
+        .def_readwrite("kill_radius",&SpaceColonizationEngine::kill_radius)
+        .def_readwrite("perception_radius",&SpaceColonizationEngine::perception_radius)
+        .def_readwrite("min_nb_pt_per_bud",&SpaceColonizationEngine::min_nb_pt_per_bud)
+        .def_readonly("nbIteration",&SpaceColonizationEngine::nbIteration)
+        ;
+
+      implicitly_convertible< SpaceColonizationEnginePtr, RefCountObjectPtr >();
 }
 
@@ -91,6 +91,7 @@ void export_SurfComputer()
     ;
 
   def("surface",(real_t(*)(const ScenePtr))&sceneSurface,"Compute surface of a scene");
+  def("parallelSurface",&parallelSceneSurface,(boost::python::arg("scene"),boost::python::arg("grainsize")=0),"Compute surface of a scene with several threads");
   def("surface",&surf_geom,"Compute surface of a geometry");
   def("surface",&surf_sh,"Compute surface of a shape");
   def("surface",(real_t(*)(const Vector2&,const Vector2&,const Vector2&))&surface,"Compute surface of a 2D triangle");
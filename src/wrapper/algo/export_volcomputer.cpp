@@ -79,6 +79,7 @@ void export_VolComputer()
     .add_property("result",  &VolComputer::getVolume)
     ;
   def("volume",(real_t(*)(const ScenePtr))&sceneVolume,"Compute volume of a scene");
+  def("parallelVolume",&parallelSceneVolume,(boost::python::arg("scene"),boost::python::arg("grainsize")=0),"Compute volume of a scene with several threads");
   def("volume",&vol_geom,"Compute volume of a geometry");
   def("volume",&vol_sh,"Compute volume of a shape");
 
@@ -32,6 +32,7 @@
 #include <plantgl/algo/projection/zbufferengine.h>
 #include <plantgl/python/export_refcountptr.h>
 #include <plantgl/python/boost_python.h>
+#include <plantgl/python/extract_list.h>
 
 PGL_USING_NAMESPACE
 TOOLS_USING_NAMESPACE
@@ -54,16 +55,75 @@ boost::python::object py_grabZBufferPoints(ZBufferEngine * ze, real_t jitter = 0
     }
 }
 
-boost::python::object py_idhistogram(ZBufferEngine * ze, bool solidangle = true){
-    pgl_hash_map<uint32_t,uint32_t> res = ze->idhistogram(solidangle);
+boost::python::object py_histogram_to_list(const ZBufferEngine::IdHistogram& res){
     boost::python::list bres;
-    for(pgl_hash_map<uint32_t,uint32_t>::const_iterator _it = res.begin(); _it != res.end(); ++_it){
+    for(ZBufferEngine::IdHistogram::const_iterator _it = res.begin(); _it != res.end(); ++_it){
       bres.append(boost::python::make_tuple(_it->first,_it->second));
     }
     return bres;
 }
+
+boost::python::object py_idhistogram(ZBufferEngine * ze, bool solidangle = true){
+    return py_histogram_to_list(ze->idhistogram(solidangle));
+}
+
+boost::python::object py_multiViewIdHistograms(boost::python::object geometry, boost::python::object cameras, 
+                                               uint16_t imageWidth, uint16_t imageHeight, 
+                                               bool solidangle = true, ZBufferEngine::eFaceCulling culling = ZBufferEngine::eNoCulling){
+    std::vector<ProjectionCameraPtr> ccameras = extract_vec<ProjectionCameraPtr>(cameras)();
+    boost::python::extract<TriangleSoupPtr> soup(geometry);
+    std::vector<ZBufferEngine::IdHistogram> res;
+    if (soup.check()) 
+        res = ZBufferEngine::multiViewIdHistograms(soup(), ccameras, imageWidth, imageHeight, solidangle, culling);
+    else 
+        res = ZBufferEngine::multiViewIdHistograms(boost::python::extract<ScenePtr>(geometry)(), ccameras, imageWidth, imageHeight, solidangle, culling);
+    boost::python::list bres;
+    for(std::vector<ZBufferEngine::IdHistogram>::const_iterator _it = res.begin(); _it != res.end(); ++_it){
+      bres.append(py_histogram_to_list(*_it));
+    }
+    return bres;
+}
+
+void py_process_soup(ZBufferEngine * ze, const TriangleSoupPtr& soup){
+    CompiledScenePtr compiled = dynamic_pointer_cast<CompiledScene>(soup);
+    if (is_valid_ptr(compiled)) ze->process(compiled);
+    else ze->process(soup);
+}
+
+void export_TriangleSoup()
+{
+  class_< TriangleSoup, TriangleSoupPtr, bases<RefCountObject>, boost::noncopyable > 
+      ("TriangleSoup", "The triangles of a scene tessellated and transformed in world space once, with the id of their shape.", init<>())
+      .def(init<const ScenePtr&, bp::optional<const DiscretizationCachePtr&> >("Tessellate the triangles of a scene.", (bp::arg("scene"), bp::arg("cache"))))
+      .def("__len__", &TriangleSoup::size)
+      .def("size", &TriangleSoup::size)
+      .def("empty", &TriangleSoup::empty)
+      .def("clear", &TriangleSoup::clear)
+      .def("addTriangle", &TriangleSoup::addTriangle, (bp::arg("v0"), bp::arg("v1"), bp::arg("v2"), bp::arg("id")))
+      .def("getIdAt", &TriangleSoup::getIdAt)
+      .def("getVertexAt", &TriangleSoup::getVertexAt, return_value_policy<copy_const_reference>())
+      .def("getColorAt", &TriangleSoup::getColorAt, return_value_policy<copy_const_reference>())
+      ;
+
+  implicitly_convertible< TriangleSoupPtr, RefCountObjectPtr >();
+
+  class_< CompiledScene, CompiledScenePtr, bases<TriangleSoup>, boost::noncopyable > 
+      ("CompiledScene", "A TriangleSoup bound to a scene. Only the shapes added or modified since last update are tessellated again.", init<const ScenePtr&, bp::optional<const DiscretizationCachePtr&> >((bp::arg("scene"), bp::arg("cache"))))
+      .add_property("scene", make_function(&CompiledScene::getScene, return_value_policy<copy_const_reference>()), &CompiledScene::setScene)
+      .add_property("discretizationcache", make_function(&CompiledScene::getDiscretizationCache, return_value_policy<copy_const_reference>()), &CompiledScene::setDiscretizationCache)
+      .def("update", &CompiledScene::update)
+      .def("isUpToDate", &CompiledScene::isUpToDate)
+      .def("invalidate", &CompiledScene::invalidate)
+      .def("invalidateShape", &CompiledScene::invalidateShape, (bp::arg("id")))
+      .def("getNbUpdatedShapes", &CompiledScene::getNbUpdatedShapes)
+      ;
+
+  implicitly_convertible< CompiledScenePtr, TriangleSoupPtr >();
+}
+
 void export_ZBufferEngine()
 {
+  export_TriangleSoup();
 
    enum_<ZBufferEngine::eRenderingStyle>("eRenderingStyle")
     .value("eColorBased",ZBufferEngine::eColorBased)
@@ -109,6 +169,15 @@ void export_ZBufferEngine()
       .def("getOrientationBuffer", &ZBufferEngine::getOrientationBuffer)
       .add_property("multithreaded",&ZBufferEngine::isMultiThreaded, &ZBufferEngine::setMultiThreaded)
       .add_property("faceculling",&ZBufferEngine::getFaceCulling, &ZBufferEngine::setFaceCulling)
+      .add_property("tiledrendering",&ZBufferEngine::isTiledRendering, &ZBufferEngine::setTiledRendering)
+      .add_property("tilesize",&ZBufferEngine::getTileSize, &ZBufferEngine::setTileSize)
+      .add_property("simdrendering",&ZBufferEngine::isSIMDRendering, &ZBufferEngine::setSIMDRendering)
+      .add_property("occlusionculling",&ZBufferEngine::isOcclusionCulling, &ZBufferEngine::setOcclusionCulling)
+      .add_property("fronttobackordering",&ZBufferEngine::isFrontToBackOrdering, &ZBufferEngine::setFrontToBackOrdering)
+      .def("getNbCulledTriangles", &ZBufferEngine::getNbCulledTriangles)
+      .def("getNbRasterizedTriangles", &ZBufferEngine::getNbRasterizedTriangles)
+      .def("getNbCulledShapes", &ZBufferEngine::getNbCulledShapes)
+      .def("resetCullingStatistics", &ZBufferEngine::resetCullingStatistics)
 
 
       .def("duplicateBuffer", (void(ZBufferEngine::*)(const Vector3&, const Vector3&, bool, const Color3&))&ZBufferEngine::duplicateBuffer,(bp::arg("from"), bp::arg("to")=600, bp::arg("useDefaultColor")=true, bp::arg("defaultcolor")=Color3(0,0,0)))
@@ -120,7 +189,12 @@ void export_ZBufferEngine()
       .def("grabZBufferPoints", &py_grabZBufferPoints,(bp::arg("jitter")=0, bp::arg("raywidth")=0))
       .def("grabSortedZBufferPoints", &ZBufferEngine::grabSortedZBufferPoints,(bp::arg("jitter")=0, bp::arg("raywidth")=0))
       .def("idhistogram", &py_idhistogram, (bp::arg("solidangle")=true))
+      .def("processTriangleSoup", &py_process_soup, (bp::arg("trianglesoup")), "Render a TriangleSoup. A CompiledScene is updated first.")
+      .def("multiViewIdHistograms", &py_multiViewIdHistograms, (bp::arg("scene"), bp::arg("cameras"), bp::arg("imageWidth")=200, bp::arg("imageHeight")=200, bp::arg("solidangle")=true, bp::arg("faceculling")=ZBufferEngine::eNoCulling),
+           "Render a scene or a TriangleSoup from each camera in parallel and return the idhistogram of each view. The scene is tessellated only once.")
+      .staticmethod("multiViewIdHistograms")
       ;
 
+      def("getZBufferKernelName", &getZBufferKernelName, "Name of the vectorized rasterization kernel used by ZBufferEngine (avx2, sse2 or scalar).");
       def("formFactors", &formFactors, (bp::arg("points"), bp::arg("triangles"), bp::arg("normals")=Point3ArrayPtr(0), bp::arg("ccw")=true, bp::arg("discretization")=200, bp::arg("solidangle")=200));
 }
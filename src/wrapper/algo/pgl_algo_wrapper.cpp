@@ -94,6 +94,8 @@ void module_algo()
     export_ProjectionCamera();
     export_ProjectionEngine();
     export_ZBufferEngine();
+    export_FormFactorEngine();
+    export_RadiositySolver();
     export_DepthSortEngine();
     export_ProjectionRenderer();
 
@@ -111,6 +113,7 @@ void module_algo()
     export_SegIntersection();
     export_Ray();
     export_RayIntersection();
+    export_BVHRayCaster();
     export_Intersection();
 
     // Grid export
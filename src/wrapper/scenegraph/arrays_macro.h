@@ -681,138 +681,134 @@ class_< ARRAY, ARRAY##Ptr, bases<RefCountObject> >( #ARRAY , init<size_t>(#ARRAY
   DEF_POINTEE( ARRAY ) \
   EXPORT_FUNCTION2( PREFIX, ARRAY)
 
-#ifdef USE_NUMPY
-#define PY_ARRAY_UNIQUE_SYMBOL PlantGL_NUMPY_API_SYMBOL
-#define NO_IMPORT_ARRAY
-#include <numpy/arrayobject.h>
+#if PGL_WITH_BOOST_NUMPY
+#include <boost/python/numpy.hpp>
+#include <cstring>
 #include <sstream>
+#include <type_traits>
 
-#define CHECK_TYPE( store, C_TYPE )\
-  if( typeid( C_TYPE ) == typeid( int ) )\
-    store = PyArray_INT; \
-  else if( typeid( C_TYPE ) == typeid( unsigned int ) )\
-    store = PyArray_UINT; \
-  else if( typeid( C_TYPE ) == typeid( long ) )\
-    store = PyArray_LONG; \
-  else if( typeid( C_TYPE ) == typeid( unsigned long ) )\
-    store = PyArray_ULONG; \
-  else if( typeid( C_TYPE ) == typeid( char ) )\
-    store = PyArray_BYTE; \
-  else if( typeid( C_TYPE ) == typeid( unsigned char ) )\
-    store = PyArray_UBYTE; \
-  else if( typeid( C_TYPE ) == typeid( float ) )\
-    store = PyArray_FLOAT; \
-  else if( typeid( C_TYPE ) == typeid( double ) )\
-    store = PyArray_DOUBLE; \
-  else\
-    {\
-    PyErr_SetString( PyExc_ValueError, "Error, the wanted type is unknown" );\
-    throw error_already_set();\
+/// First component of an element. Vector2/3/4 are polymorphic: their components do not start at the address of the element.
+template<class C_TYPE, class T>
+inline C_TYPE * numpy_element_data( T& elt, std::true_type /* scalar */ ) { return &elt; }
+
+template<class C_TYPE, class T>
+inline C_TYPE * numpy_element_data( T& elt, std::false_type /* tuple */ ) { return elt.data(); }
+
+template<class C_TYPE, class T>
+inline C_TYPE * numpy_element_data( T& elt ) { return numpy_element_data<C_TYPE>( elt, std::is_arithmetic<T>() ); }
+
+/// Strides (in bytes) of a numpy view on an array of NBCOMP components of type C_TYPE stored in elements of size ELEMSIZE.
+inline boost::python::tuple numpy_strides( size_t elemsize, size_t nbcomp, size_t compsize )
+{ return nbcomp == 0 ? boost::python::make_tuple( elemsize ) : boost::python::make_tuple( elemsize, compsize ); }
+
+inline boost::python::tuple numpy_shape( size_t nbelem, size_t nbcomp )
+{ return nbcomp == 0 ? boost::python::make_tuple( nbelem ) : boost::python::make_tuple( nbelem, nbcomp ); }
+
+/// Writable numpy view on the contiguous storage of an array. The view keeps the array alive.
+/// The view becomes invalid if the array is resized afterwards.
+template<class ARRAY, class C_TYPE>
+boost::python::numpy::ndarray array_to_ndarray( RCPtr<ARRAY> a, size_t nbcomp )
+{
+  namespace np = boost::python::numpy;
+  np::dtype dt = np::dtype::get_builtin<C_TYPE>();
+  if ( a->empty() ) return np::zeros( numpy_shape( 0, nbcomp ), dt );
+  C_TYPE * data = numpy_element_data<C_TYPE>( *a->begin() );
+  return np::from_data( data, dt,
+                        numpy_shape( a->size(), nbcomp ),
+                        numpy_strides( sizeof(typename ARRAY::element_type), nbcomp, sizeof(C_TYPE) ),
+                        boost::python::object( a ) );
+}
+
+/// Build an array from a numpy array. The data are cast to C_TYPE if needed
+/// and copied in one pass (a single memcpy when the layouts match, i.e. for elements without vptr).
+template<class ARRAY, class C_TYPE>
+ARRAY * array_from_ndarray( boost::python::numpy::ndarray a, size_t nbcomp )
+{
+  namespace np = boost::python::numpy;
+  size_t nbdim = ( nbcomp == 0 ? 1 : 2 );
+  if ( size_t(a.get_nd()) != nbdim ) {
+    std::stringstream ss;
+    ss << "The array as argument must have " << nbdim << " dimension(s)";
+    PyErr_SetString(PyExc_TypeError, ss.str().c_str() );
+    boost::python::throw_error_already_set();
+  }
+  if ( nbcomp != 0 && size_t(a.shape(1)) != nbcomp ) {
+    std::stringstream ss;
+    ss << "The second dimension of the argument must be of size " << nbcomp;
+    PyErr_SetString(PyExc_TypeError, ss.str().c_str() );
+    boost::python::throw_error_already_set();
+  }
+  np::dtype dt = np::dtype::get_builtin<C_TYPE>();
+  if ( !np::equivalent( a.get_dtype(), dt ) ) a = a.astype( dt );
+
+  size_t nbelem = a.shape(0);
+  size_t ncomp = ( nbcomp == 0 ? 1 : nbcomp );
+  ARRAY * result = new ARRAY( nbelem );
+  if ( nbelem == 0 ) return result;
+
+  const char * source = a.get_data();
+  const Py_intptr_t * strides = a.get_strides();
+  const size_t elemsize = sizeof(typename ARRAY::element_type);
+  C_TYPE * target = numpy_element_data<C_TYPE>( *result->begin() );
+  if ( ( a.get_flags() & np::ndarray::C_CONTIGUOUS ) && elemsize == ncomp * sizeof(C_TYPE) && 
+       (void *)target == (void *)&(*result->begin()) ) {
+    memcpy( target, source, nbelem * elemsize );
+  }
+  else {
+    const Py_intptr_t compstride = ( nbcomp == 0 ? 0 : strides[1] );
+    typename ARRAY::iterator it = result->begin();
+    for ( size_t i = 0; i < nbelem; ++i, ++it, source += strides[0] ) {
+      C_TYPE * elt = numpy_element_data<C_TYPE>( *it );
+      for ( size_t j = 0; j < ncomp; ++j )
+        elt[j] = *(const C_TYPE *)( source + j * compstride );
     }
+  }
+  return result;
+}
 
 #define EXPORT_NUMPY( PREFIX, T, ARRAY, DIM0, DIM1, C_TYPE ) \
-ARRAY##Ptr PREFIX##_fromnumpy( boost::python::object l ) \
-{\
-  size_t dim0 = DIM0;\
-  size_t dim1 = DIM1;\
-  PyObject* obj = l.ptr(); \
-  if( PyArray_Check( obj ) ) \
-    { \
-    PyArrayObject *a_obj = ( PyArrayObject* )obj; \
-    if( a_obj->nd != 2 )\
-      {\
-      PyErr_SetString(PyExc_TypeError, "The array as argument must have 2 dimensions" );\
-      throw error_already_set();\
-      }\
-    if( dim0 != 0 && a_obj->dimensions[ 0 ] != dim0 ) \
-      {\
-      std::stringstream ss;\
-      ss << "The first dimension of the argument must be of size " << dim0;\
-      PyErr_SetString(PyExc_TypeError, ss.str().c_str() );\
-      throw error_already_set();\
-      }\
-    if( dim1 != 0 && a_obj->dimensions[ 1 ] != dim1 ) \
-      {\
-      std::stringstream ss;\
-      ss << "The second dimension of the argument must be of size " << dim1;\
-      PyErr_SetString(PyExc_TypeError, ss.str().c_str() );\
-      throw error_already_set();\
-      }\
-    int a_type = 0; \
-    int a_require = NPY_CONTIGUOUS|NPY_FORCECAST; \
-    CHECK_TYPE( a_type, C_TYPE );\
-    PyObject *array = PyArray_FromArray( a_obj, PyArray_DescrFromType( a_type ), a_require ); \
-    if( array == NULL )\
-      {\
-      throw error_already_set();\
-      }\
-    int nb_elmt0 = PyArray_DIM( array, 0 ); \
-    int nb_elmt1 = PyArray_DIM( array, 1 ); \
-    int i, j; \
-    ARRAY##Ptr result = new ARRAY( nb_elmt0 ); \
-    for( i = 0 ; i < nb_elmt0 ; ++i ) \
-      {\
-      T elmt( nb_elmt1 );\
-      for( j = 0 ; j < nb_elmt1 ; ++j )\
-        {\
-        elmt.setAt( j, *( C_TYPE* )PyArray_GETPTR2( array, i, j ) );\
-        }\
-      result->setAt( i, elmt );\
-      }\
-    Py_DECREF( array );\
-    return result;\
-    } \
-  return PREFIX##_fromlist( l ); \
-}\
+ARRAY * PREFIX##_fromnumpy( boost::python::numpy::ndarray l ) \
+{ return array_from_ndarray<ARRAY, C_TYPE>( l, DIM1 ); } \
+boost::python::numpy::ndarray PREFIX##_tonumpy( ARRAY##Ptr a ) \
+{ return array_to_ndarray<ARRAY, C_TYPE>( a, DIM1 ); } \
 
 #define EXPORT_NUMPY_1DIM( PREFIX, T, ARRAY, DIM, C_TYPE ) \
-ARRAY##Ptr PREFIX##_fromnumpy( boost::python::object l ) \
-{\
-  size_t dim = DIM;\
-  PyObject* obj = l.ptr(); \
-  if( PyArray_Check( obj ) ) \
-    { \
-    PyArrayObject *a_obj = ( PyArrayObject* )obj; \
-    if( a_obj->nd != 1 )\
-      {\
-      PyErr_SetString(PyExc_TypeError, "The array as argument must have 1 dimension" );\
-      throw error_already_set();\
-      }\
-    if( dim != 0 && a_obj->dimensions[ 0 ] != dim ) \
-      {\
-      std::stringstream ss;\
-      ss << "The argument must be of size " << dim;\
-      PyErr_SetString(PyExc_TypeError, ss.str().c_str() );\
-      throw error_already_set();\
-      }\
-    int a_type = 0; \
-    int a_require = NPY_CONTIGUOUS|NPY_FORCECAST; \
-    CHECK_TYPE( a_type, C_TYPE );\
-    PyObject *array = PyArray_FromArray( a_obj, PyArray_DescrFromType( a_type ), a_require ); \
-    if( array == NULL )\
-      {\
-      throw error_already_set();\
-      }\
-    int nb_elmt = PyArray_DIM( array, 0 ); \
-    int i, j; \
-    ARRAY##Ptr result = new ARRAY( nb_elmt ); \
-    for( i = 0 ; i < nb_elmt ; ++i ) \
-      {\
-      result->setAt( i, *( C_TYPE*) PyArray_GETPTR1( array, i ) );\
-      }\
-    Py_DECREF( array );\
-    return result;\
-    } \
-  return PREFIX##_fromlist( l ); \
-}\
+  EXPORT_NUMPY( PREFIX, T, ARRAY, 0, 0, C_TYPE )
+
+/// Arrays of variable size elements have no contiguous storage and are only built from numpy arrays.
+#define EXPORT_NUMPY_RAGGED( PREFIX, T, ARRAY, C_TYPE ) \
+ARRAY * PREFIX##_fromnumpy( boost::python::numpy::ndarray l ) \
+{ \
+  if ( l.get_nd() != 2 ) { \
+    PyErr_SetString(PyExc_TypeError, "The array as argument must have 2 dimensions" ); \
+    boost::python::throw_error_already_set(); \
+  } \
+  l = l.astype( boost::python::numpy::dtype::get_builtin<C_TYPE>() ); \
+  size_t nbelem = l.shape(0), nbcomp = l.shape(1); \
+  const Py_intptr_t * strides = l.get_strides(); \
+  ARRAY * result = new ARRAY( nbelem ); \
+  for ( size_t i = 0; i < nbelem; ++i ) { \
+    T elt( nbcomp ); \
+    for ( size_t j = 0; j < nbcomp; ++j ) \
+      elt.setAt( j, *(const C_TYPE *)( l.get_data() + i * strides[0] + j * strides[1] ) ); \
+    result->setAt( i, elt ); \
+  } \
+  return result; \
+} \
+
+#define DEFINE_NUMPY_CONSTRUCTOR( PREFIX ) .def( "__init__", make_constructor( PREFIX##_fromnumpy ), "Build the array from a numpy array." )
 
-#define DEFINE_NUMPY( PREFIX ) .def( "__init__", make_constructor( PREFIX##_fromnumpy ) )
+#define DEFINE_NUMPY( PREFIX ) \
+    DEFINE_NUMPY_CONSTRUCTOR( PREFIX ) \
+    .def( "to_array", &PREFIX##_tonumpy, "Return a writable numpy view on the array data. The view keeps the array alive but is invalidated if the array is resized." )
 
 #else
 
 #define EXPORT_NUMPY( PREFIX, T, ARRAY, DIM0, DIM1, C_TYPE )
 #define EXPORT_NUMPY_1DIM( PREFIX, T, ARRAY, DIM, C_TYPE )
+#define EXPORT_NUMPY_RAGGED( PREFIX, T, ARRAY, C_TYPE )
 
+#define DEFINE_NUMPY_CONSTRUCTOR( PREFIX )
 #define DEFINE_NUMPY( PREFIX )
 
 #endif
@@ -71,7 +71,7 @@ EXPORT_NUMPY( c3a, Color3, Color3Array, 0, 3, uchar_t )
 EXPORT_NUMPY( c4a, Color4, Color4Array, 0, 4, uchar_t )
 EXPORT_NUMPY( i3a, Index3, Index3Array, 0, 3, uint_t )
 EXPORT_NUMPY( i4a, Index4, Index4Array, 0, 4, uint_t )
-EXPORT_NUMPY( inda, Index, IndexArray, 0, 0, uint_t )
+EXPORT_NUMPY_RAGGED( inda, Index, IndexArray, uint_t )
 EXPORT_NUMPY_1DIM( ra, real_t, RealArray, 0, real_t )
 EXPORT_NUMPY_1DIM( uia, uint32_t, UIntArray, 0, uint32_t)
 
@@ -278,7 +278,7 @@ void export_arrays()
   EXPORT_CONVERTER(Index4Array);
   EXPORT_ARRAY_CT( inda,IndexArray,  "IndexArray([Index([i,j,..]),...])" )
     .def( "triangulate", &IndexArray::triangulate)
-    DEFINE_NUMPY( inda );
+    DEFINE_NUMPY_CONSTRUCTOR( inda );
   EXPORT_CONVERTER(IndexArray);
 
   EXPORT_ARRAY_BT( ra, RealArray,  "RealArray([a,b,...])" )
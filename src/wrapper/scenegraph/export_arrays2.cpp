@@ -67,19 +67,54 @@ EXPORT_FUNCTION( p3m, Point3Matrix )
 EXPORT_FUNCTION( p4m, Point4Matrix )
 EXPORT_FUNCTION( ra,  RealArray2 )
 
+EXPORT_FUNCTION( ui32a,  Uint32Array2 )
+
 #if PGL_WITH_BOOST_NUMPY
-np::ndarray array_to_nparray(RealArray2 * data)
+/// Writable numpy view on the data of the array. The view keeps the array alive.
+template<class ARRAY>
+np::ndarray array2_to_nparray(RCPtr<ARRAY> data)
 {
-    np::dtype dt = np::dtype::get_builtin<real_t>();
-    size_t s = sizeof(real_t);
+    typedef typename ARRAY::element_type T;
+    np::dtype dt = np::dtype::get_builtin<T>();
+    size_t s = sizeof(T);
+    if (data->empty())
+        return np::zeros(bp::make_tuple(data->getColumnSize(), data->getRowSize()), dt);
 
-    np::ndarray array = np::from_data(data->data(),
+    np::ndarray array = np::from_data(&(*data->begin()),
                                       dt,
                                       bp::make_tuple(data->getColumnSize(), data->getRowSize()),
                                       bp::make_tuple(data->getRowSize()*s, s),
-                                      bp::object());
+                                      bp::object(data));
     return array;
 }
+
+/// Build an array from a 2D numpy array. Data are cast if needed and copied in one pass.
+template<class ARRAY>
+ARRAY * array2_from_nparray(np::ndarray array)
+{
+    typedef typename ARRAY::element_type T;
+    if (array.get_nd() != 2) {
+        PyErr_SetString(PyExc_TypeError, "The array as argument must have 2 dimensions" );
+        bp::throw_error_already_set();
+    }
+    np::dtype dt = np::dtype::get_builtin<T>();
+    if (!np::equivalent(array.get_dtype(), dt)) array = array.astype(dt);
+    size_t rows = array.shape(0), cols = array.shape(1);
+    ARRAY * result = new ARRAY(rows, cols);
+    if (rows * cols == 0) return result;
+
+    T * target = &(*result->begin());
+    if (array.get_flags() & np::ndarray::C_CONTIGUOUS) {
+        memcpy(target, array.get_data(), rows * cols * sizeof(T));
+    }
+    else {
+        const Py_intptr_t * strides = array.get_strides();
+        for (size_t i = 0; i < rows; ++i)
+            for (size_t j = 0; j < cols; ++j, ++target)
+                *target = *(const T *)(array.get_data() + i * strides[0] + j * strides[1]);
+    }
+    return result;
+}
 #endif
 
 void threshold_max_values(RealArray2 * data, real_t maxvalue) {
@@ -107,12 +142,21 @@ void export_arrays2()
   EXPORT_ARRAY_BT( ra, RealArray2 )
    .def(numarray2_func<RealArray2>())
 #if PGL_WITH_BOOST_NUMPY
-   .def("to_array",&array_to_nparray)
+   .def("__init__", make_constructor(&array2_from_nparray<RealArray2>), "RealArray2(numpy.ndarray)")
+   .def("to_array",&array2_to_nparray<RealArray2>)
 #endif
    .def("threshold_max_values",&threshold_max_values)
    .def("threshold_min_values",&threshold_min_values);
 
   EXPORT_CONVERTER(RealArray2);
+
+  EXPORT_ARRAY_BT( ui32a, Uint32Array2 )
+#if PGL_WITH_BOOST_NUMPY
+   .def("__init__", make_constructor(&array2_from_nparray<Uint32Array2>), "Uint32Array2(numpy.ndarray)")
+   .def("to_array",&array2_to_nparray<Uint32Array2>)
+#endif
+   ;
+  EXPORT_CONVERTER(Uint32Array2);
 }
 
 
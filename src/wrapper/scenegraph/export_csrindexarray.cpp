@@ -0,0 +1,114 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#include <plantgl/scenegraph/container/csrindexarray.h>
+#include <plantgl/python/export_refcountptr.h>
+#include <plantgl/python/exception.h>
+#include <boost/python.hpp>
+#include <boost/python/make_constructor.hpp>
+
+#if PGL_WITH_BOOST_NUMPY
+#include <boost/python/numpy.hpp>
+#define np boost::python::numpy
+#endif
+
+PGL_USING_NAMESPACE
+
+using namespace boost::python;
+#define bp boost::python
+
+CSRIndexArray * csr_fromindexarray( IndexArrayPtr array )
+{
+  return new CSRIndexArray(*array);
+}
+
+Index csr_getitem( CSRIndexArray * array, int i )
+{
+  if (i < 0) i += array->size();
+  if (i < 0 || i >= int(array->size())) throw PythonExc_IndexError();
+  CSRIndexArray::Row row = array->getAt(i);
+  return Index(row.begin(), row.end());
+}
+
+size_t csr_len( CSRIndexArray * array ) { return array->size(); }
+
+#if PGL_WITH_BOOST_NUMPY
+// The returned arrays share the memory of the CSRIndexArray and keep it alive.
+np::ndarray csr_offsets( CSRIndexArrayPtr array )
+{
+  const std::vector<CSRIndexArray::offset_type>& offsets = array->getOffsets();
+  return np::from_data(offsets.data(),
+                       np::dtype::get_builtin<CSRIndexArray::offset_type>(),
+                       bp::make_tuple(offsets.size()),
+                       bp::make_tuple(sizeof(CSRIndexArray::offset_type)),
+                       bp::object(array));
+}
+
+np::ndarray csr_indices( CSRIndexArrayPtr array )
+{
+  const std::vector<uint_t>& indices = array->getIndices();
+  return np::from_data(indices.data(),
+                       np::dtype::get_builtin<uint_t>(),
+                       bp::make_tuple(indices.size()),
+                       bp::make_tuple(sizeof(uint_t)),
+                       bp::object(array));
+}
+#endif
+
+void export_CSRIndexArray()
+{
+  class_<CSRIndexArray, CSRIndexArrayPtr, bases<RefCountObject>, boost::noncopyable>
+    ( "CSRIndexArray", "An array of lists of indices stored in compressed sparse row format.", init<optional<size_t> >("CSRIndexArray(int nbRows)", args("nbRows")) )
+    .def( "__init__", make_constructor( csr_fromindexarray ), "CSRIndexArray(IndexArray array)" )
+    .def( "__len__", &csr_len )
+    .def( "__getitem__", &csr_getitem )
+    .def( "getRowSize", &CSRIndexArray::getRowSize, args("i") )
+    .def( "getNbIndices", &CSRIndexArray::getNbIndices )
+    .def( "toIndexArray", &CSRIndexArray::toIndexArray )
+    .def( "isValid", &CSRIndexArray::isValid, args("nbIndices") )
+    .def( "clear", &CSRIndexArray::clear )
+#if PGL_WITH_BOOST_NUMPY
+    .def( "offsets", &csr_offsets, "Return a numpy view (uint64) on the row offsets. Its size is len(self)+1." )
+    .def( "indices", &csr_indices, "Return a numpy view (uint32) on the indices of all the rows." )
+#endif
+    ;
+
+  implicitly_convertible<CSRIndexArrayPtr, RefCountObjectPtr>();
+}
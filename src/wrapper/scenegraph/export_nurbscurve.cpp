@@ -120,19 +120,20 @@ void export_NurbsCurve()
      .staticmethod("fit")
      .def( "interpol", nurbs_interpol, "interpol(points [, parametrization, int degree, bool closed])", (bp::arg("points"),bp::arg("parametrization"),bp::arg("degree")=3,bp::arg("closed")=false) )
      .staticmethod("interpol")
+     .def( "evaluate", &NurbsCurve::evaluate, args("u"), "Point3Array evaluate([float] u). Compute the points of the curve for all the parameters in u." )
      .def( "getDerivativeAt", &NurbsCurve::getDerivativeAt, args("u","d") )
      .def( "getDerivativesAt", &NurbsCurve::getDerivativesAt, args("u") )
-     .def( "findSpan", &findSpan, args("u","degree","knotList"),
+     .def( "findSpan", (uint_t(*)(real_t,uint_t,const RealArrayPtr&))&findSpan, args("u","degree","knotList"),
            "int findSpan(float u,  int degree,  [float] knotList)."
            "Determine the knot Span index at a given u for degree and on the knot vector knotList."
            "See the Nurbs Book : A2.1 p68" )
      .staticmethod("findSpan")
-     .def( "basisFunctions", &basisFunctions, args("span","u","degree","knotList"),
+     .def( "basisFunctions", (RealArrayPtr(*)(uint_t,real_t,uint_t,const RealArrayPtr&))&basisFunctions, args("span","u","degree","knotList"),
         "[float] basisFunctions(int span, float u, int  degree, [float] knotList)."
         "Compute the Basis Functions values at a given u for degree and on the knot vector knotList."
         "See Algo 2.2 From The Nurbs Book p70.")
      .staticmethod("basisFunctions")
-     .def( "derivatesBasisFunctions", &derivatesBasisFunctions, args("n","u","span","degree","knotList"),
+     .def( "derivatesBasisFunctions", (RealArray2Ptr(*)(int,real_t,int,uint_t,const RealArrayPtr&))&derivatesBasisFunctions, args("n","u","span","degree","knotList"),
         "[float] derivatesBasisFunctions(int span, float u, int  _degree, [float] _knotList)."
         "Compute the n-th Derivative Basis Functions values at a given u for degree and on the knot vector knotList."
         "See Algo 2.2 From The Nurbs Book p70." )
@@ -261,6 +262,7 @@ void export_NurbsCurve2D()
      .DEC_BT_NR_PROPERTY_WD(degree,NurbsCurve2D,Degree,uint_t)
      .DEC_PTR_PROPERTY_WD(knotList,NurbsCurve2D,KnotList,RealArrayPtr)
      .def("setKnotListToDefault",&NurbsCurve2D::setKnotListToDefault)
+     .def( "evaluate", &NurbsCurve2D::evaluate, args("u"), "Point2Array evaluate([float] u). Compute the points of the curve for all the parameters in u." )
     ;
 
    implicitly_convertible< NurbsCurve2DPtr, BezierCurve2DPtr >();
@@ -44,6 +44,7 @@
 
 #include <plantgl/scenegraph/geometry/nurbspatch.h>
 #include <plantgl/scenegraph/container/pointmatrix.h>
+#include <plantgl/scenegraph/container/pointarray.h>
 #include <plantgl/tool/util_array.h>
 
 #include <plantgl/python/export_refcountptr.h>
@@ -118,6 +119,7 @@ void export_NurbsPatch()
     .def("getUTangentAt",&NurbsPatch::getUTangentAt,bp::args("u","v"))
     .def("getVTangentAt",&NurbsPatch::getVTangentAt,bp::args("u","v"))
     .def("getNormalAt",&NurbsPatch::getNormalAt,bp::args("u","v"))
+    .def("evaluate",&NurbsPatch::evaluate,bp::args("u","v"),"Point3Array evaluate([float] u, [float] v). Compute the grid of points for all the parameters in u and v. Point (u[i],v[j]) is at index i*len(v)+j.")
     .def("deriveAt",&NurbsPatch::deriveAt,bp::args("u","v","d","uspan","vspan"))
     .def("getDerivativeAt",&NurbsPatch::getDerivativeAt,bp::args("u","v","du","dv"),"Return the derivative at u and v. du and dv specify how many time you want to derive with respect to u and v.")
     .def("getDerivativesAt",&NurbsPatch::getDerivativesAt,bp::args("u","v"))
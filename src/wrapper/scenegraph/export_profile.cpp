@@ -0,0 +1,74 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright CIRAD/INRIA/INRA
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al. 
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *   This software is governed by the CeCILL-C license under French law and
+ *   abiding by the rules of distribution of free software.  You can  use, 
+ *   modify and/ or redistribute the software under the terms of the CeCILL-C
+ *   license as circulated by CEA, CNRS and INRIA at the following URL
+ *   "http://www.cecill.info". 
+ *
+ *   As a counterpart to the access to the source code and  rights to copy,
+ *   modify and redistribute granted by the license, users are provided only
+ *   with a limited warranty  and the software's author,  the holder of the
+ *   economic rights,  and the successive licensors  have only  limited
+ *   liability. 
+ *       
+ *   In this respect, the user's attention is drawn to the risks associated
+ *   with loading,  using,  modifying and/or developing or reproducing the
+ *   software by the user in light of its specific status of free software,
+ *   that may mean  that it is complicated to manipulate,  and  that  also
+ *   therefore means  that it is reserved for developers  and  experienced
+ *   professionals having in-depth computer knowledge. Users are therefore
+ *   encouraged to load and test the software's suitability as regards their
+ *   requirements in conditions enabling the security of their systems and/or 
+ *   data to be ensured and,  more generally, to use and operate it in the 
+ *   same conditions as regards security. 
+ *
+ *   The fact that you are presently reading this means that you have had
+ *   knowledge of the CeCILL-C license and that you accept its terms.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+#include <boost/python.hpp>
+#include <plantgl/tool/util_profile.h>
+
+PGL_USING_NAMESPACE
+using namespace boost::python;
+
+boost::python::list py_profile_zones() {
+  boost::python::list result;
+  std::vector<profile::ZoneStatistics> zones = profile::zoneStatistics();
+  for (std::vector<profile::ZoneStatistics>::const_iterator it = zones.begin(); it != zones.end(); ++it)
+    result.append(make_tuple(it->name, it->calls, it->total, it->min, it->max));
+  return result;
+}
+
+boost::python::dict py_profile_counters() {
+  boost::python::dict result;
+  std::vector<std::pair<std::string, int64_t> > values = profile::counters();
+  for (std::vector<std::pair<std::string, int64_t> >::const_iterator it = values.begin(); it != values.end(); ++it)
+    result[it->first] = it->second;
+  return result;
+}
+
+void export_Profile() {
+  def("pgl_profile_start", &profile::start, "Clear the previous record and start recording the profiling zones and counters.");
+  def("pgl_profile_stop", &profile::stop, "Stop recording the profiling zones and counters.");
+  def("pgl_profile_clear", &profile::clear, "Discard the profiling record.");
+  def("pgl_profile_is_recording", &profile::isRecording);
+  def("pgl_profile_report", &profile::report, "Text table of the recorded zones and counters.");
+  def("pgl_profile_zones", &py_profile_zones, "List of (name, calls, total, min, max) of the recorded zones. Times are in seconds.");
+  def("pgl_profile_counters", &py_profile_counters, "Dict of the recorded counters.");
+  def("pgl_profile_chrome_trace", &profile::toChromeTrace, "The record in the Chrome trace event format.");
+  def("pgl_profile_write_chrome_trace", &profile::writeChromeTrace, args("filename"), "Write the record in the Chrome trace event format.");
+}
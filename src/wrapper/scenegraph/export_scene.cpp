@@ -66,7 +66,7 @@ DEF_POINTEE(Scene)
 
 ScenePtr sc_fromlist( boost::python::list l )
 {
-  ScenePtr scene = ScenePtr(new Scene());
+  SceneBuilder scene(len(l));
   object iter_obj = boost::python::object( boost::python::handle<PyObject>( PyObject_GetIter( l.ptr() ) ) );
   while( 1 )
   {
@@ -77,21 +77,21 @@ ScenePtr sc_fromlist( boost::python::list l )
         boost::python::extract<GeometryPtr> geom( obj );
         if(geom.check()){
             GeometryPtr g = geom();
-            scene->add(Shape3DPtr(new Shape(g,Material::DEFAULT_MATERIAL)));
+            scene.add(Shape3DPtr(new Shape(g,Material::DEFAULT_MATERIAL)));
         }
         else {
             boost::python::extract<ScenePtr> sc( obj );
             if (sc.check()){
                 ScenePtr s = sc();
-                scene->merge(s);
+                scene.add(s);
             }
             else {
                 Shape3DPtr val = boost::python::extract<Shape3DPtr>( obj );
-                scene->add( val );
+                scene.add( val );
             }
         }
   }
-  return scene;
+  return scene.build();
 }
 
 Shape3DPtr sc_getitem( Scene* s, int pos )
@@ -203,6 +203,12 @@ object sp_scenes(Scene::Pool * pool){
 
 Scene::Pool& new_pool(object){ return Scene::pool(); }
 
+// scene ids are used to retrieve scenes from the pool
+size_t sc_getid(Scene * sc){
+    sc->registerInPool();
+    return sc->uid();
+}
+
 bool scene_is_valid(Scene * sc){
     PyStateSaver s;
     return sc->isValid();
@@ -226,8 +232,8 @@ void export_Scene()
     sc.def("add", (void (Scene::*)(const ShapePtr &) ) &Scene::add );
     sc.def("add", (void (Scene::*)(const Shape3DPtr &) )&Scene::add);
     sc.def("add", &sc_add2);
-    sc.def("add", &Scene::merge);
-    sc.def("merge", &Scene::merge);
+    sc.def("add", (void (Scene::*)(const ScenePtr &) )&Scene::merge);
+    sc.def("merge", (void (Scene::*)(const ScenePtr &) )&Scene::merge);
     sc.def("__len__", &Scene::size);
 
     sc.def("__getitem__", &sc_getitem);
@@ -249,7 +255,7 @@ void export_Scene()
     //sc.def("__delitem__", &sc_delitemslice);*/
 
     sc.def("clear", &Scene::clear);
-    sc.def("merge", &Scene::merge);
+    sc.def("merge", (void (Scene::*)(const ScenePtr &) )&Scene::merge);
     sc.def("find", &sc_find);
     sc.def("findSceneObject", &sc_findSceneObject);
     sc.def("index", &sc_index);
@@ -267,7 +273,11 @@ void export_Scene()
     sc.def("save", &sc_save);
     sc.def("save", &sc_save2);
     sc.def("sort", &Scene::sort);
-    sc.def("getId",&RefCountObject::uid);
+    sc.def("getId",&sc_getid, "Return the id of the scene and register it in the scene pool.");
+    sc.def("registerInPool",&Scene::registerInPool);
+    sc.def("isRegisteredInPool",&Scene::isRegisteredInPool);
+    sc.def("mergeAndClear",&Scene::mergeAndClear, "Move the shapes of the given scene at the end of self. The given scene is left empty.");
+    sc.def("reserve",&Scene::reserve);
     sc.def("getPglReferenceCount",&RefCountObject::use_count);
     sc.enable_pickling();
   ;
@@ -275,7 +285,8 @@ void export_Scene()
   class_<Scene::Pool, boost::noncopyable>("Pool","The scene pool. Allow you to access all scene in memory using their id.",no_init)
       .def("get", &Scene::Pool::get, "get scene from id.")
       .def("__getitem__", &Scene::Pool::get, "get scene from id.")
-      .def("getScenes", &sp_scenes , "get all scene.")
+      .def("getScenes", &sp_scenes , "get all registered scenes.")
+      .add_property("autoRegistration", &Scene::Pool::isAutoRegistration, &Scene::Pool::setAutoRegistration, "If enabled, all scenes are registered at construction. Otherwise scenes are registered when their id is requested.")
       ;
 
     sc.def("pool", &Scene::pool,return_value_policy<reference_existing_object>(),"Scene pool singleton access");
@@ -46,6 +46,7 @@
 void export_arrays();
 void export_arrays2();
 void export_index();
+void export_CSRIndexArray();
 void export_Color3();
 void export_Color4();
 void export_pointarrays();
@@ -137,5 +138,6 @@ void export_Function();
 void export_Plane();
 
 void export_Progress();
+void export_Profile();
 
 #endif
@@ -117,6 +117,7 @@ void module_sg()
     export_arrays();
     export_arrays2();
     export_index();
+    export_CSRIndexArray();
     export_Color3();
     export_Color4();
     export_pointarrays();
@@ -226,6 +227,7 @@ void module_sg()
     export_Plane();
 
     export_Progress();
+    export_Profile();
 
     scope().attr("PGL_VERSION_STR") = getPGLVersionString();
     scope().attr("PGL_VERSION") = PGL_VERSION;
@@ -36,6 +36,17 @@ def test_bbox_on_benchmark_objects(sceneobj):
     bbox_application(sceneobj)
 
 
+def test_parallel_scene_computations():
+    shapes = [Shape(Translated((i % 10, i // 10, 0), Sphere(0.1 + 0.01 * (i % 7))), id=i) for i in range(200)]
+    s = Scene(shapes)
+    ref = BoundingBox(s)
+    for grainsize in [0, 1, 7, 1000]:
+        b = parallelBoundingBox(s, grainsize)
+        assert norm(b.lowerLeftCorner - ref.lowerLeftCorner) < 1e-5
+        assert norm(b.upperRightCorner - ref.upperRightCorner) < 1e-5
+        assert abs(parallelSurface(s, grainsize) - surface(s)) < 1e-5 * surface(s)
+        assert abs(parallelVolume(s, grainsize) - volume(s)) < 1e-5 * volume(s)
+
 def apply_bbox_on_objects():
     for t in test_bbox_on_default_object():
         pass
@@ -73,6 +73,34 @@ def test_write_obj():
     s.read(get_filename('test_trumpet.obj'))
     assert s.isValid()
 
+def test_ply():
+    s = Scene([Shape(TriangleSet([(0,0,0),(1,0,0),(0,1,0),(1,1,1)],[(0,1,2),(1,3,2)]), Material(Color3(200,10,10))),
+               Shape(PointSet([(2,2,2),(3,3,3)]), Material(Color3(10,200,10)))])
+    fname = 'test_ply.ply'
+    s.save(fname)
+    s2 = Scene(fname)
+    os.remove(fname)
+    assert len(s2) == 1
+    ts = s2[0].geometry
+    assert type(ts) == TriangleSet
+    assert len(ts.pointList) == 6 and len(ts.indexList) == 2
+    assert ts.indexList[1] == Index3(1,3,2)
+    assert ts.colorList[0].red == 200 and ts.colorList[5].green == 200
+
+def test_ply_file_reader():
+    points = Point3Array([(0,0,0),(1,0,0),(0,1,0),(1,1,1)])
+    fname = 'test_plyreader.ply'
+    PlyFileWriter().write(fname, points, faces=IndexArray([[0,1,2],[1,3,2]]))
+    reader = PlyFileReader(fname)
+    assert reader.format == PlyFileReader.BinaryLittleEndian
+    assert [(name, count) for name, count, properties in reader.elements()] == [('vertex',4),('face',2)]
+    reader.read(PlyFileReader.Points | PlyFileReader.Faces)
+    assert list(reader.points) == list(points)
+    assert list(reader.triangles) == [Index3(0,1,2),Index3(1,3,2)]
+    assert list(reader.readProperty('vertex','z')) == [0,0,0,1]
+    del reader
+    os.remove(fname)
+
 def test_bgeom():
     g = Scene([Group([Sphere(),Box()])])
     g2 = frombinarystring(tobinarystring(g))
@@ -82,6 +110,31 @@ def test_bgeom():
     g2 = frombinarystring(tobinarystring(g))
     assert g2.isValid() and len(g) == len(g2)
 
+def test_bgeom_arrays():
+    points = Point3Array([Vector3(i,2*i,-i) for i in range(1000)])
+    indices = Index3Array([Index3(i,i+1,i+2) for i in range(998)])
+    colors = Color4Array([Color4(i%255,0,255-i%255,0) for i in range(1000)])
+    faces = IndexArray([Index(list(range(i,i+3+i%3))) for i in range(10)])
+    g = Scene([Shape(TriangleSet(points, indices, colorList=colors, colorPerVertex=True)),
+               Shape(FaceSet(points, faces))])
+    for compressed in [False, True]:
+        for fname in ['arrays.bgeom', None]:
+            if fname:
+                printer = PglBinaryPrinter(fname)
+                printer.compressed = compressed
+                printer.print(g)
+                del printer
+                g2 = Scene(fname)
+                os.remove(fname)
+            else:
+                g2 = frombinarystring(tobinarystring(g, compressed=compressed))
+            assert len(g2) == 2
+            ts, fs = g2[0].geometry, g2[1].geometry
+            assert list(ts.pointList) == list(points)
+            assert list(ts.indexList) == list(indices)
+            assert list(ts.colorList) == list(colors)
+            assert [list(i) for i in fs.indexList] == [list(i) for i in faces]
+
 def binary_str_benchmark(sceneobj):
     print(sceneobj)
     sceneobj2 = frombinarystring(tobinarystring(Scene([sceneobj])))
@@ -0,0 +1,55 @@
+from openalea.plantgl.all import *
+import numpy as np
+
+def test_point3array_view():
+    pts = Point3Array([(0,1,2),(3,4,5)])
+    view = pts.to_array()
+    assert view.shape == (2,3)
+    assert np.array_equal(view, [[0,1,2],[3,4,5]])
+    view[1,2] = 10
+    assert pts[1] == Vector3(3,4,10)
+    del pts
+    assert view[1,2] == 10
+
+def test_array_from_numpy():
+    data = np.arange(12, dtype=float).reshape(4,3)
+    pts = Point3Array(data)
+    assert len(pts) == 4 and pts[3] == Vector3(9,10,11)
+    pts = Point3Array(data[::2])
+    assert len(pts) == 2 and pts[1] == Vector3(6,7,8)
+    idx = Index3Array(np.array([[0,1,2],[2,3,0]]))
+    assert idx[1] == Index3(2,3,0)
+    assert np.array_equal(idx.to_array(), [[0,1,2],[2,3,0]])
+    r = RealArray(np.linspace(0,1,5))
+    assert np.allclose(r.to_array(), np.linspace(0,1,5))
+
+def test_pointarray_numpy_roundtrip():
+    for ptype, atype in [(Vector2, Point2Array), (Vector3, Point3Array), (Vector4, Point4Array)]:
+        dim = len(ptype())
+        data = np.arange(5*dim, dtype=float).reshape(5,dim) + 0.5
+        pts = atype(data)
+        assert [list(p) for p in pts] == data.tolist()
+        view = pts.to_array()
+        assert view.shape == (5,dim)
+        assert np.array_equal(view, data)
+        pts2 = atype(view)
+        assert [list(p) for p in pts2] == data.tolist()
+        # elements built from numpy remain valid objects
+        assert abs(norm(pts2[4]) - np.linalg.norm(data[4])) < 1e-8
+
+def test_array2_view():
+    a = RealArray2(np.arange(6, dtype=float).reshape(2,3))
+    v = a.to_array()
+    assert v.shape == (2,3)
+    v[1,1] = -1
+    assert a[1,1] == -1
+
+def test_zbuffer_views():
+    z = ZBufferEngine(40,30, renderingStyle=eIdBased)
+    z.setPerspectiveCamera(60,4/3.,0.1,1000)
+    z.lookAt((5,0,0),(0,0,0),(0,0,1))
+    z.process(Scene([Shape(Sphere(0.5),id=3)]))
+    depth = z.getDepthBuffer().to_array()
+    ids = z.getIdBuffer().to_array()
+    assert depth.shape == (40,30) == ids.shape
+    assert (ids == 3).any()
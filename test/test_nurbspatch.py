@@ -28,5 +28,64 @@ def test_tangents():
     assert (norm(patch3.getUTangentAt(0,0) - Vector3(0,0,1)) < 1e-5)
     assert (norm(patch3.getVTangentAt(0,0) - Vector3(0,1,0)) < 1e-5)
 
+def test_evaluate():
+    patch = NurbsPatch(  Point4Matrix([[(0, -0.5, 0, 1), (0, -0.166667, 0.2, 1), (0, 0.166667, 0, 2), (0, 0.5, 0, 1)], [(0, -0.5, 0.333333, 1), (0.3, -0.166667, 0.333333, 1), (0, 0.166667,0.333333, 1), (0, 0.5, 0.333333, 1)], [(0, -0.5, 0.666667, 1), (0, -0.166667, 0.666667, 1), (0.5, 0.166667, 0.666667, 1), (0, 0.5, 0.666667, 1)], [(0, -0.5, 1, 1), (0, -0.166667, 1, 1), (0, 0.166667, 1, 1), (0, 0.5, 1, 1)]]), udegree = 2, vdegree = 2 )
+    us = RealArray([i/10. for i in range(11)])
+    vs = RealArray([i/7. for i in range(8)])
+    points = patch.evaluate(us, vs)
+    assert len(points) == len(us) * len(vs)
+    for i, u in enumerate(us):
+        for j, v in enumerate(vs):
+            assert norm(points[i*len(vs)+j] - patch.getPointAt(u, v)) < 1e-10
+    # clamped knot vectors : the corners interpolate the corner control points
+    assert norm(points[0] - Vector3(0, -0.5, 0)) < 1e-10
+    assert norm(points[len(vs)-1] - Vector3(0, 0.5, 0)) < 1e-10
+    assert norm(points[(len(us)-1)*len(vs)] - Vector3(0, -0.5, 1)) < 1e-10
+    assert norm(points[-1] - Vector3(0, 0.5, 1)) < 1e-10
+
+    curve = NurbsCurve([(0,0,0,1),(1,1,0,2),(2,-1,0,1),(3,0,1,1),(4,1,0,1)], degree = 3)
+    cpoints = curve.evaluate(us)
+    for i, u in enumerate(us):
+        assert norm(cpoints[i] - curve.getPointAt(u)) < 1e-10
+    assert norm(cpoints[0] - Vector3(0,0,0)) < 1e-10
+    assert norm(cpoints[-1] - Vector3(4,1,0)) < 1e-10
+
+    curve2 = NurbsCurve2D([(0,0,1),(1,1,2),(2,-1,1),(3,0,1)])
+    c2points = curve2.evaluate(us)
+    for i, u in enumerate(us):
+        assert norm(c2points[i] - curve2.getPointAt(u)) < 1e-10
+
+def test_evaluate_linear():
+    us = RealArray([i/10. for i in range(11)])
+
+    # a degree 1 curve with unit weights is the polyline of its control points
+    curve = NurbsCurve([(0,0,0,1),(2,1,0,1),(2,3,1,1)], degree = 1)
+    cpoints = curve.evaluate(us)
+    for i, u in enumerate(us):
+        if u <= 0.5 : expected = Vector3(0,0,0) * (1 - 2*u) + Vector3(2,1,0) * (2*u)
+        else : expected = Vector3(2,1,0) * (2 - 2*u) + Vector3(2,3,1) * (2*u - 1)
+        assert norm(cpoints[i] - expected) < 1e-10
+
+    # with weights, a rational linear interpolation
+    w0, w1 = 1., 3.
+    curve2 = NurbsCurve2D([(0,0,w0),(1,2,w1)], degree = 1)
+    c2points = curve2.evaluate(us)
+    for i, u in enumerate(us):
+        expected = Vector2(0,0) * ((1-u)*w0) + Vector2(1,2) * (u*w1)
+        expected /= (1-u)*w0 + u*w1
+        assert norm(c2points[i] - expected) < 1e-10
+
+    # a degree 1 patch on 2x2 control points is the bilinear interpolation of the corners
+    patch = NurbsPatch(Point4Matrix([[(0,0,0,1), (0,1,0.5,1)], [(1,0,-0.5,1), (1.5,1,2,1)]]), udegree = 1, vdegree = 1)
+    p00, p01, p10, p11 = Vector3(0,0,0), Vector3(0,1,0.5), Vector3(1,0,-0.5), Vector3(1.5,1,2)
+    vs = RealArray([i/7. for i in range(8)])
+    points = patch.evaluate(us, vs)
+    for i, u in enumerate(us):
+        for j, v in enumerate(vs):
+            expected = p00 * ((1-u)*(1-v)) + p01 * ((1-u)*v) + p10 * (u*(1-v)) + p11 * (u*v)
+            assert norm(points[i*len(vs)+j] - expected) < 1e-10
+
 if __name__ == '__main__':
-    test_tangents()
\ No newline at end of file
+    test_tangents()
+    test_evaluate()
+    test_evaluate_linear()
\ No newline at end of file
@@ -109,6 +109,22 @@ def test_pointgrid_closest_dist3():
     p3list = [(0,0,0),(10,10,10)]+[(1.9,2.9,5),(3.1,1.1,5)]
     p3grid = Point3Grid(1*ID,p3list)
     closest_point(p3grid,p3list,Vector3(1.9,1.1,5),3)
+
+def test_sparsepoint3grid():
+    nbpoint = 2000
+    p3list = [random_point() for i in range(nbpoint)] + [Vector3(1000,1000,1000)]
+    # a dense grid would have 2000**3 voxels
+    sgrid = SparsePoint3Grid((0.5,0.5,0.5),p3list)
+    assert sgrid.size() > 1e9
+    center = Vector3(5.5,5.5,5.5)
+    radius = 2
+    pball = sgrid.query_ball_point(center,radius)
+    assert sorted(pball) == [i for i,p in enumerate(p3list) if norm(p-center) <= radius]
+    pcone = sgrid.query_points_in_cone(center,Vector3(0,0,1),radius,1.0)
+    assert set(pcone) <= set(pball)
+    assert sgrid.query_ball_point(Vector3(1000,1000,1000), 0.1) == [nbpoint]
+    sgrid.disable_point(nbpoint)
+    assert sgrid.query_ball_point(Vector3(1000,1000,1000), 0.1) == []
     
 if __name__ == '__main__':
     test_pointgrid_corners()
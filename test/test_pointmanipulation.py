@@ -1,5 +1,6 @@
 from openalea.plantgl.all import *
 from random import uniform, seed
+import pytest
 
 pointrange = (0,100)
 
@@ -38,8 +39,103 @@ def test_median_point():
 
 
 
+def test_csr_neighborhoods():
+   seed(1)
+   nbpoint = 20
+   points = Point3Array([Vector3(i,uniform(0,0.1),0) for i in range(nbpoint)])
+   adjacencies = IndexArray([[j for j in (i-1,i+1) if 0 <= j < nbpoint] for i in range(nbpoint)])
+   csradjacencies = CSRIndexArray(adjacencies)
+   assert len(csradjacencies) == nbpoint
+   assert csradjacencies.getNbIndices() == 2*(nbpoint-1)
+   assert list(csradjacencies[0]) == [1]
+   assert list(csradjacencies.toIndexArray()[5]) == [4,6]
+
+   radius = 3.5
+   refneighborhoods = r_neighborhoods(points, adjacencies, radius)
+   for neighborhoods in [r_neighborhoods(points, csradjacencies, radius), r_neighborhoods_mt(points, csradjacencies, radius)]:
+       assert len(neighborhoods) == nbpoint
+       for i in range(nbpoint):
+           assert sorted(neighborhoods[i]) == sorted(refneighborhoods[i])
+
+   refdensities = densities_from_r_neighborhood(points, adjacencies, radius)
+   densities = densities_from_r_neighborhood(points, csradjacencies, radius)
+   assert all([abs(a-b) < 1e-5 for a,b in zip(refdensities, densities)])
+
+   refk = k_neighborhoods(points, adjacencies, 4)
+   k = k_neighborhoods_mt(points, csradjacencies, 4)
+   for i in range(nbpoint):
+       assert sorted(k[i]) == sorted(refk[i])
+
+   offsets = csradjacencies.offsets()
+   indices = csradjacencies.indices()
+   assert len(offsets) == nbpoint+1 and offsets[-1] == len(indices)
+   assert list(indices[offsets[5]:offsets[6]]) == [4,6]
+
+@pytest.mark.skipif('KDTree3' not in globals(), reason='PlantGL built without ANN')
+def test_kdtree_batched_queries():
+   seed(2)
+   nbpoint = 300
+   points = Point3Array([random_point() for i in range(nbpoint)])
+   tree = KDTree3(points)
+   k = 5
+   refknn = tree.k_nearest_neighbors(k)
+   knn, distances = tree.k_nearest_neighbors_mt(k, True)
+   assert len(knn) == nbpoint and knn.getNbIndices() == nbpoint*k and len(distances) == nbpoint*k
+   for i in range(nbpoint):
+       ref = sorted([norm(points[i]-points[j]) for j in refknn[i]])[:k]
+       res = [norm(points[i]-points[j]) for j in knn[i]]
+       assert all([abs(a-b) < 1e-5 for a,b in zip(ref, res)])
+       assert all([abs(a-b) < 1e-5 for a,b in zip(res, distances[i*k:(i+1)*k])])
+
+   radius = 15
+   refrnn = tree.r_nearest_neighbors(radius)
+   rnn = tree.r_nearest_neighbors_mt(radius)
+   for i in range(nbpoint):
+       assert sorted(rnn[i]) == sorted(refrnn[i])
+
+def test_batched_r_neighborhoods():
+   nbpoint = 30
+   points = Point3Array([Vector3(i,0,0) for i in range(nbpoint)])
+   adjacencies = IndexArray([[j for j in (i-1,i+1) if 0 <= j < nbpoint] for i in range(nbpoint)])
+   radii = RealArray([1.5 + (i % 3) for i in range(nbpoint)])
+
+   neighborhoods = r_neighborhoods_mt(points, adjacencies, radii)
+   refneighborhoods = r_neighborhoods(points, adjacencies, radii)
+   for i in range(nbpoint):
+       expected = [j for j in range(nbpoint) if abs(i-j) <= radii[i]]
+       assert sorted(neighborhoods[i]) == expected
+       assert sorted(refneighborhoods[i]) == expected
+       assert list(r_neighborhood(i, points, adjacencies, radii[i])) == list(refneighborhoods[i])
+
+   directions = Point3Array([Vector3(1,0,0) for i in range(nbpoint)])
+   for radius in [radii, 2.5]:
+       ref = r_anisotropic_neighborhoods(points, adjacencies, radius, directions, 0.5, 1)
+       res = r_anisotropic_neighborhoods_mt(points, adjacencies, radius, directions, 0.5, 1)
+       for i in range(nbpoint):
+           assert sorted(res[i]) == sorted(ref[i])
+
+def test_pointsets_features():
+   seed(2)
+   # points on the plane z = 0.5 x, and on a line along y
+   plane = [Vector3(x,y,0.5*x) for x in range(5) for y in range(5)]
+   line = [Vector3(0,y,0) for y in range(10)]
+   points = Point3Array(plane+line)
+   groups = IndexArray([list(range(len(plane))), list(range(len(plane), len(plane)+len(line)))])
+   for g in [groups, CSRIndexArray(groups)]:
+       features = pointsets_features(points, g)
+       n = features['normals'][0]
+       assert abs(abs(n.x) - 1/5**0.5) < 1e-5 and abs(n.y) < 1e-5 and abs(abs(n.z) - 2/5**0.5) < 1e-5
+       assert features['planarity'][0] > 0.5 and features['curvature'][0] < 1e-5
+       assert abs(features['linearity'][1] - 1) < 1e-5
+       assert abs(abs(features['orientations'][1].y) - 1) < 1e-5
+       assert norm(features['centers'][1] - Vector3(0,4.5,0)) < 1e-5
+   normals = pointsets_normals(points, groups)
+   assert abs(normals[0].y) < 1e-5
+   center, normal = pointset_plane(points, groups[0])
+   assert norm(center - Vector3(2,2,1)) < 1e-5
+
+
+
 if __name__ == '__main__':
     for i in range(50):
         test_median_point()
-
-
@@ -0,0 +1,44 @@
+import openalea.plantgl.all as pgl
+import json, os, tempfile
+import pytest
+
+
+@pytest.mark.skipif(not pgl.profile.is_available(), reason='PlantGL built without profiling')
+def test_profile_scene():
+    s = pgl.Scene([pgl.Shape(pgl.Sphere(1,16,16)), pgl.Shape(pgl.Cylinder(0.5,2))])
+    pgl.profile.start()
+    assert pgl.profile.is_recording()
+    s.apply(pgl.Tesselator())
+    z = pgl.ZBufferEngine(200,200, renderingStyle=pgl.eIdBased)
+    z.setOrthographicCamera(-2,2,-2,2,0.1,100)
+    z.lookAt((10,0,0),(0,0,0),(0,0,1))
+    z.process(s)
+    pgl.profile.stop()
+    assert not pgl.profile.is_recording()
+
+    zones = dict((name, calls) for name, calls, total, mn, mx in pgl.profile.zones())
+    assert 'Scene::apply' in zones
+    assert 'ZBufferEngine::process' in zones
+    assert pgl.profile.counters()['zbuffer.triangles'] > 0
+    assert 'Scene::apply' in pgl.profile.report()
+
+    trace = json.loads(pgl.profile.chrome_trace())
+    names = set(e['name'] for e in trace['traceEvents'])
+    assert 'ZBufferEngine::process' in names
+
+    # nothing is recorded once stopped
+    s.apply(pgl.Tesselator())
+    assert dict((name, calls) for name, calls, total, mn, mx in pgl.profile.zones())['Scene::apply'] == zones['Scene::apply']
+
+@pytest.mark.skipif(not pgl.profile.is_available(), reason='PlantGL built without profiling')
+def test_profile_chrome_trace_file():
+    fname = os.path.join(tempfile.mkdtemp(), 'trace.json')
+    with pgl.profile.recording(fname):
+        pgl.Scene([pgl.Shape(pgl.Box())]).apply(pgl.BBoxComputer())
+    assert os.path.exists(fname)
+    with open(fname) as f:
+        trace = json.load(f)
+    assert len(trace['traceEvents']) > 0
+    os.remove(fname)
+    pgl.profile.clear()
+    assert len(pgl.profile.zones()) == 0
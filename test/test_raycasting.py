@@ -0,0 +1,30 @@
+from openalea.plantgl.all import *
+
+
+def test_bvhraycaster():
+    box = Shape(Box(Vector3(1,1,1)), Material(), 5)
+    sphere = Shape(Translated(Vector3(0,0,10),Sphere(1)), Material(), 6)
+    caster = BVHRayCaster(Scene([box, sphere]))
+    assert len(caster) > 0
+    bbox = caster.getBoundingBox()
+    assert abs(bbox.upperRightCorner.z - 11) < 1e-3
+
+    ray = Ray(Vector3(0.3,0.2,-5), Vector3(0,0,1))
+    hit = caster.firstHit(ray)
+    assert hit is not None and hit.id == 5
+    assert abs(hit.distance - 4) < 1e-5
+    assert 0 <= hit.u <= 1 and 0 <= hit.v <= 1 and hit.u + hit.v <= 1
+
+    hits = caster.allHits(ray)
+    assert [h.id for h in hits] == [5, 5, 6, 6]
+    assert all([h1.distance <= h2.distance for h1, h2 in zip(hits, hits[1:])])
+
+    assert caster.anyHit(ray)
+    assert not caster.anyHit(ray, 3.9)
+    assert caster.firstHit(Ray(Vector3(5,5,-5), Vector3(0,0,1))) is None
+
+    rays = [ray, Ray(Vector3(5,5,-5), Vector3(0,0,1)), Ray(Vector3(0.1,0.2,20), Vector3(0,0,-1))]
+    firsthits = caster.firstHits(rays)
+    assert firsthits[0].id == 5 and firsthits[1] is None and firsthits[2].id == 6
+    assert caster.anyHits(rays) == [True, False, True]
+    assert [len(h) for h in caster.allHits(rays)] == [4, 0, 4]
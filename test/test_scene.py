@@ -51,4 +51,18 @@ def test_scene3():
     scene.add(shape)
     assert scene.isValid()
 
-    
\ No newline at end of file
+    
+def test_scene_pool_registration():
+    scene = Scene()
+    assert not scene.isRegisteredInPool()
+    sid = scene.getId()
+    assert scene.isRegisteredInPool()
+    assert Scene.pool().get(sid).getId() == sid
+
+def test_scene_merge_and_clear():
+    shapes = [Shape(Sphere(), id = i) for i in range(10)]
+    sc1 = Scene(shapes[:4])
+    sc2 = Scene(shapes[4:])
+    sc1.mergeAndClear(sc2)
+    assert len(sc1) == 10 and len(sc2) == 0
+    assert [sh.id for sh in sc1] == list(range(10))
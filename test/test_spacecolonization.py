@@ -0,0 +1,39 @@
+from openalea.plantgl.all import *
+from random import uniform, seed
+
+
+def random_crown(nbpoints, center, radius):
+    points = []
+    while len(points) < nbpoints:
+        p = Vector3(uniform(-1,1), uniform(-1,1), uniform(-1,1))
+        if norm(p) <= 1:
+            points.append(center + p * radius)
+    return Point3Array(points)
+
+def test_spacecolonization_engine():
+    seed(1)
+    nodelength = 0.5
+    attractors = random_crown(2000, Vector3(0,0,10), 5)
+    engine = SpaceColonizationEngine(attractors, nodelength, 1, 3, Vector3(0,0,3))
+    engine.run()
+    assert engine.atEnd()
+    nodes, parents = engine.nodes, engine.parents
+    assert len(nodes) > 10 and len(nodes) == len(parents)
+    for i in range(1, len(nodes)):
+        assert parents[i] < i
+        assert abs(norm(nodes[i] - nodes[parents[i]]) - nodelength) < 1e-5
+    assert engine.nbAliveAttractors() < len(attractors)
+
+    nearest = engine.nearest_nodes()
+    for aid, nid in enumerate(nearest):
+        if nid != 2**32-1:
+            assert norm(attractors[aid] - nodes[nid]) <= engine.perception_radius
+
+def test_pointgrid_disable_points():
+    seed(2)
+    points = random_crown(1000, Vector3(0,0,0), 5)
+    grid = Point3Grid(1, points)
+    disabled = list(range(0, 1000, 3))
+    grid.disable_points(disabled)
+    enabled = set(grid.get_enabled_point_indices())
+    assert enabled == set(range(1000)) - set(disabled)
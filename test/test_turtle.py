@@ -76,6 +76,32 @@ def test_turtle_customgeometry():
     assert isinstance(a2, pgl.AsymmetricHull) 
     assert a.getPglId() == a2.getPglId()
 
+def test_instanced_drawer():
+    drawer = pgl.InstancedTurtleDrawer()
+    p = pgl.PglTurtle(drawer)
+    p.setColor(1)
+    for i in range(10):
+        p.F(1)
+        p.sphere(0.5)
+        p.left(10)
+    p.setColor(2)
+    p.F(1, 0.5)
+    assert len(drawer) == 21
+    sc = p.getScene()
+    assert len(sc) == 2
+    assert all(isinstance(sh.geometry, pgl.TriangleSet) for sh in sc)
+    ref = pgl.PglTurtle()
+    ref.setColor(1)
+    for i in range(10):
+        ref.F(1)
+        ref.sphere(0.5)
+        ref.left(10)
+    ref.setColor(2)
+    ref.F(1, 0.5)
+    b1, b2 = pgl.BoundingBox(sc), pgl.BoundingBox(ref.getScene())
+    assert pgl.norm(b1.lowerLeftCorner - b2.lowerLeftCorner) < 0.1
+    assert pgl.norm(b1.upperRightCorner - b2.upperRightCorner) < 0.1
+
 
 if __name__ == '__main__':
     import traceback as tb
@@ -164,6 +164,44 @@ def test_formfactors():
     result = formFactors(tr.pointList,tr.indexList,ccw=True,solidangle=False)
     print(result)
 
+def test_sparse_formfactors():
+    # a triangle centered at the origin facing a square of side 2 at distance 1. 
+    # The solid angle of the square seen from the origin is 4 asin(1/2) = 2pi/3 and 
+    # by symmetry each half of the square (split along a diagonal) covers pi/3.
+    points = Point3Array([(1,0,0),(-0.5,sqrt(3)/2,0),(-0.5,-sqrt(3)/2,0),
+                          (-1,-1,1),(1,-1,1),(1,1,1),(-1,1,1)])
+    triangles = Index3Array([(0,1,2),(3,5,4),(3,6,5)])
+    engine = FormFactorEngine(points,triangles,ccw=True)
+    engine.discretization = 200
+    sparse = engine.compute()
+    assert sparse.shape == (3, 3)
+    row = dict([(j,v) for i,j,v in zip(*sparse.triplets()) if i == 0])
+    assert sorted(row.keys()) == [1,2]
+    for j in [1,2]:
+        assert abs(row[j] - pi/3) < 0.03 * pi/3
+    engine.solidangle = False
+    counts = engine.compute()
+    rows, cols, values = counts.triplets()
+    assert all([v == int(v) for v in values])
+
+    tr = Scene('data/cube.obj')[0].geometry
+    t = Tesselator()
+    tr.apply(t)
+    tr = t.result
+    engine = FormFactorEngine(tr.pointList,tr.indexList,ccw=True)
+    engine.discretization = 50
+    sparse = engine.compute()
+    assert sparse.shape == (len(tr.indexList), len(tr.indexList))
+    rows, cols, values = sparse.triplets()
+    assert len(values) == sparse.getNbNonZeros()
+    # blocks of emitters give the same rows
+    block = engine.compute(0, 4)
+    block.append(engine.compute(4, len(engine)))
+    assert block.csr() == sparse.csr()
+    # a large tolerance culls every receiver
+    engine.tolerance = 1e6
+    assert engine.compute().getNbNonZeros() == 0
+
 def test_solidangle(view = False):
     angle = 359
     rangle = radians(angle)
@@ -202,10 +240,166 @@ def test_doublesphere(view = False):
     ## Light Interception
     
 
+def random_leaves(nb = 500, seed = 0):
+    from random import Random
+    rnd = Random(seed)
+    shapes = []
+    for i in range(nb):
+        pos = Vector3(rnd.uniform(-5,5),rnd.uniform(-5,5),rnd.uniform(0,5))
+        pts = [pos, pos+Vector3(rnd.uniform(-1,1),rnd.uniform(-1,1),rnd.uniform(-1,1)), pos+Vector3(rnd.uniform(-1,1),rnd.uniform(-1,1),rnd.uniform(-1,1))]
+        shapes.append(Shape(TriangleSet(pts, [list(range(3))]), Material((rnd.randint(0,255),100,100)), id=i))
+    return Scene(shapes)
+
+def render_leaves(scene, multithreaded, tiled, style = eIdAndColorBased, simd = True):
+    z = ZBufferEngine(400,400, renderingStyle=style)
+    z.setPerspectiveCamera(60,1,0.1,1000)
+    z.lookAt((20,0,2),(0,0,2),(0,0,1))
+    z.multithreaded = multithreaded
+    z.tiledrendering = tiled
+    z.simdrendering = simd
+    z.process(scene)
+    return z
+
+def test_tiledrendering():
+    s = random_leaves()
+    ref = render_leaves(s, False, False, simd = False)
+    for mt in [False, True]:
+        z = render_leaves(s, mt, True)
+        assert np.array_equal(z.getDepthBuffer().to_array(), ref.getDepthBuffer().to_array())
+        assert dict(z.idhistogram(False)) == dict(ref.idhistogram(False))
+        assert np.array_equal(z.getImage().to_array(), ref.getImage().to_array())
+
+def test_simdrendering():
+    print(getZBufferKernelName())
+    s = random_leaves()
+    for style in [eIdBased, eDepthOnly, eIdAndColorBased]:
+        ref = render_leaves(s, False, False, style, simd = False)
+        for mt, tiled in [(False, False), (True, True)]:
+            z = render_leaves(s, mt, tiled, style, simd = True)
+            assert np.array_equal(z.getDepthBuffer().to_array(), ref.getDepthBuffer().to_array())
+            if style & eIdBased:
+                assert dict(z.idhistogram(False)) == dict(ref.idhistogram(False))
+            if style & eColorBased:
+                assert np.array_equal(z.getImage().to_array(), ref.getImage().to_array())
+
+def test_occlusionculling():
+    # a dense cluster of leaves behind a wall
+    s = random_leaves(2000)
+    s.add(Shape(TriangleSet([(8,-20,-20),(8,20,-20),(8,20,20),(8,-20,20)], [(0,1,2),(0,2,3)]), id=5000))
+    s.add(Shape(Sphere(0.5), Material((255,0,0)), id=5001))
+    for style in [eIdBased, eIdAndColorBased]:
+        ref = render_leaves(s, False, False, style)
+        for mt, tiled in [(False, False), (True, True)]:
+            for order in [False, True]:
+                z = ZBufferEngine(400,400, renderingStyle=style)
+                z.setPerspectiveCamera(60,1,0.1,1000)
+                z.lookAt((20,0,2),(0,0,2),(0,0,1))
+                z.multithreaded = mt
+                z.tiledrendering = tiled
+                z.occlusionculling = True
+                z.fronttobackordering = order
+                z.process(s)
+                assert np.array_equal(z.getDepthBuffer().to_array(), ref.getDepthBuffer().to_array())
+                assert dict(z.idhistogram(False)) == dict(ref.idhistogram(False))
+                if order:
+                    assert z.getNbCulledTriangles() + z.getNbCulledShapes() > 0
+                z.resetCullingStatistics()
+                assert z.getNbCulledTriangles() == 0
+
+def test_discretizationcache():
+    sphere = Sphere(1)
+    s = Scene([Shape(Translated((0,3*i-6,2), sphere), id=i) for i in range(5)])
+    ref = render_leaves(s, False, False)
+    cache = DiscretizationCache()
+    for mt in [False, True]:
+        z = ZBufferEngine(400,400, renderingStyle=eIdAndColorBased)
+        z.setPerspectiveCamera(60,1,0.1,1000)
+        z.lookAt((20,0,2),(0,0,2),(0,0,1))
+        z.multithreaded = mt
+        z.discretizationcache = cache
+        z.process(s)
+        assert np.array_equal(z.getDepthBuffer().to_array(), ref.getDepthBuffer().to_array())
+    assert len(cache) > 0 and cache.getNbHits() > 0
+    cache.invalidate(sphere)
+    cache.maxMemory = 0
+    assert len(cache) == 0 and cache.getMemory() == 0
+
+def test_multiview():
+    s = random_leaves(200)
+    directions = [(20,0,2),(0,20,2),(-20,0,2),(0,0,20)]
+    references, cameras = [], []
+    for d in directions:
+        z = ZBufferEngine(100,100, renderingStyle=eIdBased, multithreaded=False)
+        z.setOrthographicCamera(-10,10,-10,10,0.1,100)
+        z.lookAt(d,(0,0,2),(0,0,1) if d[2] < 10 else (1,0,0))
+        z.process(s)
+        references.append(dict(z.idhistogram(False)))
+        cameras.append(z.camera())
+    soup = TriangleSoup(s)
+    assert len(soup) == len(s)
+    for geometry in [s, soup]:
+        histograms = ZBufferEngine.multiViewIdHistograms(geometry, cameras, 100, 100, solidangle=False)
+        assert len(histograms) == len(directions)
+        for h, ref in zip(histograms, references):
+            assert dict(h) == ref
+
+def test_compiledscene():
+    s = random_leaves(200)
+    compiled = CompiledScene(s)
+    assert len(compiled) == len(s)
+    assert compiled.isUpToDate()
+    assert not compiled.update()
+
+    s[3].geometry = TriangleSet([(0,0,0),(1,0,0),(0,1,0),(1,1,0)], [(0,1,2),(1,3,2)])
+    s.add(Shape(TriangleSet([(0,0,1),(1,0,1),(0,1,1)], [(0,1,2)]), id=1000))
+    assert not compiled.isUpToDate()
+    assert compiled.update()
+    assert compiled.getNbUpdatedShapes() == 2
+    assert len(compiled) == len(s) + 1
+
+    ref = render_leaves(s, False, False, eIdBased)
+    z = ZBufferEngine(400,400, renderingStyle=eIdBased, multithreaded=False)
+    z.setPerspectiveCamera(60,1,0.1,1000)
+    z.lookAt((20,0,2),(0,0,2),(0,0,1))
+    z.processTriangleSoup(compiled)
+    assert dict(z.idhistogram(False)) == dict(ref.idhistogram(False))
+
+
+def test_radiosity():
+    tr = Scene('data/cube.obj')[0].geometry
+    t = Tesselator()
+    tr.apply(t)
+    tr = t.result
+    engine = FormFactorEngine(tr.pointList,tr.indexList,ccw=True)
+    engine.discretization = 50
+    formfactors = engine.compute()
+    formfactors.scale(1/(2*pi))
+    n = len(tr.indexList)
+    incident = RealArray2([[1., 0.5] for i in range(n)])
+    results = []
+    for method, blockSize in [(eJacobi, 65536), (eGaussSeidel, 65536), (eProgressiveRefinement, 65536), (eJacobi, 5), (eProgressiveRefinement, 5)]:
+        solver = RadiositySolver(formfactors, blockSize)
+        solver.method = method
+        solver.reflectance = RealArray2([[0.1, 0.4]])
+        solver.transmittance = RealArray2([[0.05, 0.4]])
+        solver.tolerance = 1e-8
+        assert solver.solve(incident)
+        intercepted = solver.getIntercepted()
+        absorbed = solver.getAbsorbed()
+        for i in range(n):
+            for b in range(2):
+                assert intercepted[i,b] >= incident[i,b]
+                assert absorbed[i,b] <= intercepted[i,b]
+        results.append(intercepted)
+    for r in results[1:]:
+        for i in range(n):
+            for b in range(2):
+                assert abs(r[i,b] - results[0][i,b]) < 1e-5
+
 
 if __name__ == '__main__':
     #test_solidangle()
     #test_formfactors()
     #test_hemispheric_point()
     #test_projected_sphere(True)
-    test_doublesphere(True)
\ No newline at end of file
+    test_doublesphere(True)